@@ -67,7 +67,7 @@ macx {
     lessThan(QT_MAJOR_VERSION, 6): QT += macextras
 }
 
-QT += network widgets core multimedia svg
+QT += network widgets core multimedia svg concurrent
 
 greaterThan(QT_MAJOR_VERSION, 5): QT += openglwidgets core5compat
 
@@ -86,6 +86,8 @@ HEADERS +=  ../common/comic.h \
             ../common/bookmarks.h \
             bookmarks_dialog.h \
             render.h \
+            page_disk_cache.h \
+            image_filter_kernels.h \
             translator.h \
             goto_flow_widget.h \
             page_label_widget.h \
@@ -93,6 +95,7 @@ HEADERS +=  ../common/comic.h \
             width_slider.h \
             notifications_label_widget.h \
             ../common/pictureflow.h \
+            ../common/cover_image_cache.h \
             ../common/custom_widgets.h \
             ../common/check_new_version.h \
             ../common/qnaturalsorting.h \
@@ -124,6 +127,8 @@ SOURCES +=  ../common/comic.cpp \
             ../common/bookmarks.cpp \
             bookmarks_dialog.cpp \
             render.cpp \
+            page_disk_cache.cpp \
+            image_filter_kernels.cpp \
             translator.cpp \
             goto_flow_widget.cpp \
             page_label_widget.cpp \
@@ -131,6 +136,7 @@ SOURCES +=  ../common/comic.cpp \
             width_slider.cpp \
             notifications_label_widget.cpp \
             ../common/pictureflow.cpp \
+            ../common/cover_image_cache.cpp \
             ../common/custom_widgets.cpp \
             ../common/check_new_version.cpp \
             ../common/qnaturalsorting.cpp \
@@ -83,6 +83,11 @@ public:
     bool getUseSingleScrollStepToTurnPage() { return settings->value(USE_SINGLE_SCROLL_STEP_TO_TURN_PAGE, false).toBool(); }
     void setDisableScrollAnimation(bool b) { settings->setValue(DISABLE_SCROLL_ANIMATION, b); }
     bool getDisableScrollAnimation() { return settings->value(DISABLE_SCROLL_ANIMATION, false).toBool(); }
+    qint64 getPagesMemoryBudget() { return settings->value(PAGES_MEMORY_BUDGET, 512).toLongLong() * 1024 * 1024; }
+    bool getPagesDiskCache() { return settings->value(PAGES_DISK_CACHE, true).toBool(); }
+    qint64 getPagesDiskCacheSize() { return settings->value(PAGES_DISK_CACHE_SIZE, 256).toLongLong() * 1024 * 1024; }
+    int getPrefetchNextComicAt() { return settings->value(PREFETCH_NEXT_COMIC_AT, 75).toInt(); }
+    qint64 getPrefetchNextComicSize() { return settings->value(PREFETCH_NEXT_COMIC_SIZE, 64).toLongLong() * 1024 * 1024; }
 };
 
 #endif
@@ -0,0 +1,241 @@
+#include "image_filter_kernels.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YACREADER_FILTERS_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 is only used when the CPU supports it, the kernel is compiled with a target attribute so the rest of the binary keeps the baseline instruction set
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define YACREADER_FILTERS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// bands smaller than this are not worth a task
+const int minRowsPerBand = 64;
+
+// pages are filtered by the render pool workers, which already keep every core busy, so the
+// bands only run in parallel (in the global thread pool) when the filter is called from the GUI thread
+void forEachRowBand(int height, const std::function<void(int, int)> &work)
+{
+    QCoreApplication *app = QCoreApplication::instance();
+    bool mainThread = app != nullptr && QThread::currentThread() == app->thread();
+    int bands = mainThread ? qBound(1, QThread::idealThreadCount(), qMax(1, height / minRowsPerBand)) : 1;
+    if (bands == 1) {
+        work(0, height);
+        return;
+    }
+
+    int rowsPerBand = (height + bands - 1) / bands;
+    std::vector<std::pair<int, int>> ranges;
+    for (int start = 0; start < height; start += rowsPerBand) {
+        ranges.emplace_back(start, qMin(start + rowsPerBand, height));
+    }
+    QtConcurrent::blockingMap(ranges, [&work](const std::pair<int, int> &range) { work(range.first, range.second); });
+}
+
+inline QImage toRGB32(const QImage &image)
+{
+    return image.format() == QImage::Format_RGB32 ? image : image.convertToFormat(QImage::Format_RGB32);
+}
+
+void mapRow(QRgb *line, int from, int width, const uchar *table)
+{
+    for (int x = from; x < width; x++) {
+        QRgb p = line[x];
+        line[x] = 0xff000000u | (uint(table[(p >> 16) & 0xff]) << 16) | (uint(table[(p >> 8) & 0xff]) << 8) | table[p & 0xff];
+    }
+}
+
+#ifdef YACREADER_FILTERS_AVX2
+bool cpuHasAvx2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+__attribute__((target("avx2"))) void mapRowAvx2(QRgb *line, int width, const uchar *table, const int *table32)
+{
+    const __m256i mask = _mm256_set1_epi32(0xff);
+    const __m256i alpha = _mm256_set1_epi32(int(0xff000000u));
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(line + x));
+        __m256i b = _mm256_i32gather_epi32(table32, _mm256_and_si256(p, mask), 4);
+        __m256i g = _mm256_i32gather_epi32(table32, _mm256_and_si256(_mm256_srli_epi32(p, 8), mask), 4);
+        __m256i r = _mm256_i32gather_epi32(table32, _mm256_and_si256(_mm256_srli_epi32(p, 16), mask), 4);
+        __m256i result = _mm256_or_si256(_mm256_or_si256(alpha, b), _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(r, 16)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(line + x), result);
+    }
+    mapRow(line, x, width, table);
+}
+#endif
+
+// out[i] = sum of rows[k][i], the sums of a 5x5 neighbourhood still fit in 16 bits
+void sumRows(const quint16 *const *rows, int count, quint16 *out, int length)
+{
+    int i = 0;
+#ifdef YACREADER_FILTERS_SSE2
+    for (; i + 8 <= length; i += 8) {
+        __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[0] + i));
+        for (int k = 1; k < count; k++) {
+            acc = _mm_add_epi16(acc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[k] + i)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), acc);
+    }
+#endif
+    for (; i < length; i++) {
+        quint16 sum = 0;
+        for (int k = 0; k < count; k++) {
+            sum += rows[k][i];
+        }
+        out[i] = sum;
+    }
+}
+
+// horizontal pass of the box filter, each channel of the row is replaced by the sum of its 2 * radius + 1 neighbours
+void horizontalSums(const uchar *line, int width, int radius, quint16 *out)
+{
+    for (int c = 0; c < 4; c++) {
+        int sum = 0;
+        for (int k = -radius; k <= radius; k++) {
+            sum += line[qBound(0, k, width - 1) * 4 + c];
+        }
+        for (int x = 0; x < width; x++) {
+            out[x * 4 + c] = sum;
+            sum += line[qMin(x + radius + 1, width - 1) * 4 + c] - line[qMax(x - radius, 0) * 4 + c];
+        }
+    }
+}
+
+}
+
+QImage YACReader::applyChannelTable(const QImage &image, const uchar table[256])
+{
+    QImage result = toRGB32(image);
+    result.detach();
+    if (result.isNull())
+        return result;
+
+    const int width = result.width();
+#ifdef YACREADER_FILTERS_AVX2
+    int table32[256];
+    std::copy(table, table + 256, table32);
+    const bool avx2 = cpuHasAvx2();
+#endif
+
+    forEachRowBand(result.height(), [&](int from, int to) {
+        for (int y = from; y < to; y++) {
+            QRgb *line = reinterpret_cast<QRgb *>(result.scanLine(y));
+#ifdef YACREADER_FILTERS_AVX2
+            if (avx2) {
+                mapRowAvx2(line, width, table, table32);
+                continue;
+            }
+#endif
+            mapRow(line, 0, width, table);
+        }
+    });
+
+    return result;
+}
+
+QImage YACReader::boxFilter(const QImage &image, int radius)
+{
+    const QImage source = toRGB32(image);
+    if (source.isNull() || radius < 1)
+        return source;
+
+    const int width = source.width();
+    const int height = source.height();
+    const int length = width * 4;
+    const int window = 2 * radius + 1;
+
+    // the division by the window area is done with a table, the largest sum is 255 * window^2
+    std::vector<uchar> divide(255 * window * window + 1);
+    for (size_t i = 0; i < divide.size(); i++) {
+        divide[i] = uchar(i / (window * window));
+    }
+
+    QImage result(width, height, QImage::Format_RGB32);
+    forEachRowBand(height, [&](int from, int to) {
+        // horizontal sums of the rows needed by this band, including the ones shared with the neighbour bands
+        const int firstRow = from - radius;
+        const int rowCount = (to - from) + 2 * radius;
+        std::vector<quint16> sums(size_t(rowCount) * length);
+        for (int k = 0; k < rowCount; k++) {
+            int y = qBound(0, firstRow + k, height - 1);
+            horizontalSums(source.constScanLine(y), width, radius, sums.data() + size_t(k) * length);
+        }
+
+        std::vector<const quint16 *> rows(window);
+        std::vector<quint16> total(length);
+        for (int y = from; y < to; y++) {
+            for (int k = 0; k < window; k++) {
+                rows[k] = sums.data() + size_t(y - from + k) * length;
+            }
+            sumRows(rows.data(), window, total.data(), length);
+
+            uchar *line = result.scanLine(y);
+            for (int i = 0; i < length; i++) {
+                line[i] = divide[total[i]];
+            }
+        }
+    });
+
+    return result;
+}
+
+QImage YACReader::medianFilter(const QImage &image, int radius)
+{
+    const QImage source = toRGB32(image);
+    if (source.isNull() || radius < 1)
+        return source;
+
+    const int width = source.width();
+    const int height = source.height();
+    const int window = 2 * radius + 1;
+    const int middle = (window * window) / 2;
+
+    QImage result(width, height, QImage::Format_RGB32);
+    forEachRowBand(height, [&](int from, int to) {
+        std::vector<const QRgb *> lines(window);
+        std::vector<uchar> red(window * window), green(window * window), blue(window * window);
+        for (int y = from; y < to; y++) {
+            for (int k = 0; k < window; k++) {
+                lines[k] = reinterpret_cast<const QRgb *>(source.constScanLine(qBound(0, y - radius + k, height - 1)));
+            }
+
+            QRgb *line = reinterpret_cast<QRgb *>(result.scanLine(y));
+            for (int x = 0; x < width; x++) {
+                int n = 0;
+                for (int k = 0; k < window; k++) {
+                    for (int i = -radius; i <= radius; i++) {
+                        QRgb p = lines[k][qBound(0, x + i, width - 1)];
+                        red[n] = qRed(p);
+                        green[n] = qGreen(p);
+                        blue[n] = qBlue(p);
+                        n++;
+                    }
+                }
+                std::nth_element(red.begin(), red.begin() + middle, red.end());
+                std::nth_element(green.begin(), green.begin() + middle, green.end());
+                std::nth_element(blue.begin(), blue.begin() + middle, blue.end());
+                line[x] = qRgb(red[middle], green[middle], blue[middle]);
+            }
+        }
+    });
+
+    return result;
+}
@@ -0,0 +1,19 @@
+#ifndef IMAGE_FILTER_KERNELS_H
+#define IMAGE_FILTER_KERNELS_H
+
+#include <QImage>
+
+// Pixel kernels used by the page filters. They work on whole scanlines; called from the GUI
+// thread, big images are split in bands of rows processed in parallel. All of them return Format_RGB32 images.
+namespace YACReader {
+
+// maps the red, green and blue channels through the same table
+QImage applyChannelTable(const QImage &image, const uchar table[256]);
+// mean of the (2 * radius + 1)^2 neighbourhood, computed as two separable passes
+QImage boxFilter(const QImage &image, int radius);
+// per channel median of the (2 * radius + 1)^2 neighbourhood
+QImage medianFilter(const QImage &image, int radius);
+
+}
+
+#endif // IMAGE_FILTER_KERNELS_H
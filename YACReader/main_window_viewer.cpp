@@ -114,6 +114,8 @@ void MainWindowViewer::setupUI()
     connect(viewer, &Viewer::openNextComic, this, &MainWindowViewer::openNextComic);
     // detected start of comic
     connect(viewer, &Viewer::openPreviousComic, this, &MainWindowViewer::openPreviousComic);
+    // the reader is getting close to a sibling comic
+    connect(viewer, &Viewer::prefetchSiblingComic, this, &MainWindowViewer::prefetchSiblingComic);
 
     setCentralWidget(viewer);
     QScreen *screen = window()->screen();
@@ -911,7 +913,7 @@ void MainWindowViewer::openFolderFromPath(QString pathDir, QString atFileName)
     d.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
     QStringList list = d.entryList();
 
-    std::sort(list.begin(), list.end(), naturalSortLessThanCI);
+    naturalSort(list);
     int i = 0;
     foreach (QString path, list) {
         if (path.endsWith(atFileName))
@@ -1395,6 +1397,26 @@ void MainWindowViewer::openNextComic()
     }
 }
 
+void MainWindowViewer::prefetchSiblingComic(bool next)
+{
+    if (!siblingComics.isEmpty() && isClient) {
+        int currentIndex = siblingComics.indexOf(currentComicDB);
+        if (currentIndex == -1)
+            return;
+        int siblingIndex = currentIndex + (next ? 1 : -1);
+        if (siblingIndex >= 0 && siblingIndex < siblingComics.count()) {
+            const auto &sibling = siblingComics.at(siblingIndex);
+            viewer->prefetch(currentDirectory + sibling.path, sibling);
+        }
+        return;
+    }
+
+    auto pathFile = next ? nextComicPath : previousComicPath;
+    if (!pathFile.isEmpty()) {
+        viewer->prefetch(pathFile);
+    }
+}
+
 void MainWindowViewer::openLeftComic()
 {
     if (viewer->getIsMangaMode()) {
@@ -1439,7 +1461,7 @@ void MainWindowViewer::getSiblingComics(QString path, QString currentComic)
 #endif
     d.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
     QStringList list = d.entryList();
-    std::sort(list.begin(), list.end(), naturalSortLessThanCI);
+    naturalSort(list);
     int index = list.indexOf(currentComic);
     if (index == -1) // comic not found
     {
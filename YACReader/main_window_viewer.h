@@ -54,6 +54,7 @@ public slots:
     void newVersion();
     void openPreviousComic();
     void openNextComic();
+    void prefetchSiblingComic(bool next);
     void openLeftComic();
     void openRightComic();
     void openComicFromPath(QString pathFile);
@@ -12,6 +12,7 @@
 #include <QLabel>
 #include <QColorDialog>
 #include <QCheckBox>
+#include <QSpinBox>
 
 #include "yacreader_spin_slider_widget.h"
 #include "yacreader_flow_config_widget.h"
@@ -81,11 +82,40 @@ OptionsDialog::OptionsDialog(QWidget *parent)
 
     scrollBox->setLayout(scrollLayout);
 
+    auto pagesDiskCacheBox = new QGroupBox(tr("Pages disk cache"));
+    auto pagesDiskCacheLayout = new QHBoxLayout;
+
+    pagesDiskCache = new QCheckBox(tr("Keep the pages where the last comics were left to show them instantly"));
+    pagesDiskCacheSize = new QSpinBox();
+    pagesDiskCacheSize->setRange(16, 4096);
+    pagesDiskCacheSize->setSuffix(" MB");
+    connect(pagesDiskCache, &QCheckBox::toggled, pagesDiskCacheSize, &QWidget::setEnabled);
+
+    pagesDiskCacheLayout->addWidget(pagesDiskCache, 1);
+    pagesDiskCacheLayout->addWidget(pagesDiskCacheSize);
+
+    pagesDiskCacheBox->setLayout(pagesDiskCacheLayout);
+
+    auto prefetchNextComicBox = new QGroupBox(tr("Next comic"));
+    auto prefetchNextComicLayout = new QHBoxLayout;
+
+    prefetchNextComicAt = new QSpinBox();
+    prefetchNextComicAt->setRange(0, 100);
+    prefetchNextComicAt->setSuffix("%");
+    prefetchNextComicAt->setSpecialValueText(tr("Never"));
+
+    prefetchNextComicLayout->addWidget(new QLabel(tr("Start extracting the next comic after reading")), 1);
+    prefetchNextComicLayout->addWidget(prefetchNextComicAt);
+
+    prefetchNextComicBox->setLayout(prefetchNextComicLayout);
+
     layoutGeneral->addWidget(pathBox);
     layoutGeneral->addWidget(slideSizeBox);
     // layoutGeneral->addWidget(fitBox);
     layoutGeneral->addWidget(colorBox);
     layoutGeneral->addWidget(scrollBox);
+    layoutGeneral->addWidget(pagesDiskCacheBox);
+    layoutGeneral->addWidget(prefetchNextComicBox);
     layoutGeneral->addWidget(shortcutsBox);
     layoutGeneral->addStretch();
 
@@ -246,6 +276,10 @@ void OptionsDialog::saveOptions()
     settings->setValue(USE_SINGLE_SCROLL_STEP_TO_TURN_PAGE, useSingleScrollStepToTurnPage->isChecked());
     settings->setValue(DISABLE_SCROLL_ANIMATION, disableScrollAnimations->isChecked());
 
+    settings->setValue(PAGES_DISK_CACHE, pagesDiskCache->isChecked());
+    settings->setValue(PAGES_DISK_CACHE_SIZE, pagesDiskCacheSize->value());
+    settings->setValue(PREFETCH_NEXT_COMIC_AT, prefetchNextComicAt->value());
+
     YACReaderOptionsDialog::saveOptions();
 }
 
@@ -287,6 +321,11 @@ void OptionsDialog::restoreOptions(QSettings *settings)
     doNotTurnPageOnScroll->setChecked(settings->value(DO_NOT_TURN_PAGE_ON_SCROLL, false).toBool());
     useSingleScrollStepToTurnPage->setChecked(settings->value(USE_SINGLE_SCROLL_STEP_TO_TURN_PAGE, false).toBool());
     disableScrollAnimations->setChecked(settings->value(DISABLE_SCROLL_ANIMATION, false).toBool());
+
+    pagesDiskCache->setChecked(settings->value(PAGES_DISK_CACHE, true).toBool());
+    pagesDiskCacheSize->setValue(settings->value(PAGES_DISK_CACHE_SIZE, 256).toInt());
+    pagesDiskCacheSize->setEnabled(pagesDiskCache->isChecked());
+    prefetchNextComicAt->setValue(settings->value(PREFETCH_NEXT_COMIC_AT, 75).toInt());
 }
 
 void OptionsDialog::updateColor(const QColor &color)
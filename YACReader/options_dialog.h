@@ -10,6 +10,7 @@ class QPushButton;
 class QSlider;
 class QPushButton;
 class QRadioButton;
+class QSpinBox;
 class YACReaderSpinSliderWidget;
 
 class OptionsDialog : public YACReaderOptionsDialog
@@ -44,6 +45,11 @@ private:
     QCheckBox *useSingleScrollStepToTurnPage;
     QCheckBox *disableScrollAnimations;
 
+    QCheckBox *pagesDiskCache;
+    QSpinBox *pagesDiskCacheSize;
+
+    QSpinBox *prefetchNextComicAt;
+
     YACReaderSpinSliderWidget *brightnessS;
 
     YACReaderSpinSliderWidget *contrastS;
@@ -0,0 +1,161 @@
+#include "page_disk_cache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+#include "QsLog.h"
+
+namespace {
+const quint32 pageMagic = 0x59415043; // YAPC
+const quint32 pageVersion = 1;
+
+struct CachedComic {
+    QString path;
+    qint64 size;
+    QDateTime lastStored;
+};
+}
+
+PageDiskCache::PageDiskCache(qint64 maxSize, int maxComics)
+    : cachePath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/pages"), maxSize(maxSize), maxComics(maxComics)
+{
+}
+
+void PageDiskCache::setMaxSize(qint64 maxSize)
+{
+    QMutexLocker locker(&mutex);
+    this->maxSize = maxSize;
+}
+
+QString PageDiskCache::comicKey(const QString &path)
+{
+    QFileInfo info(path);
+    auto id = info.absoluteFilePath() + QString::number(info.size()) + QString::number(info.lastModified().toMSecsSinceEpoch());
+    return QCryptographicHash::hash(id.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+QString PageDiskCache::comicFolder(const QString &comicKey) const
+{
+    return cachePath + "/" + comicKey;
+}
+
+QString PageDiskCache::pageFileName(int page, const QString &parameters)
+{
+    return QString::number(page) + "_" + QCryptographicHash::hash(parameters.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+}
+
+QImage PageDiskCache::load(const QString &comicKey, int page, const QString &parameters) const
+{
+    if (comicKey.isEmpty()) {
+        return QImage();
+    }
+
+    QFile file(comicFolder(comicKey) + "/" + pageFileName(page, parameters));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QImage();
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    quint32 magic, version;
+    qint32 width, height, format, bytesPerLine;
+    stream >> magic >> version >> width >> height >> format >> bytesPerLine;
+    if (stream.status() != QDataStream::Ok || magic != pageMagic || version != pageVersion || width <= 0 || height <= 0 || format <= QImage::Format_Invalid || format >= QImage::NImageFormats) {
+        return QImage();
+    }
+
+    QImage image(width, height, static_cast<QImage::Format>(format));
+    if (image.isNull() || image.bytesPerLine() != bytesPerLine) {
+        return QImage();
+    }
+
+    // the pixels are stored as they are in memory, there is nothing to decode
+    auto size = static_cast<int>(image.sizeInBytes());
+    if (stream.readRawData(reinterpret_cast<char *>(image.bits()), size) != size) {
+        return QImage();
+    }
+
+    return image;
+}
+
+void PageDiskCache::store(const QString &comicKey, const QMap<int, QImage> &pages, const QString &parameters, const QSize &targetSize)
+{
+    QMutexLocker locker(&mutex);
+
+    if (comicKey.isEmpty() || maxSize <= 0) {
+        return;
+    }
+
+    QDir folder(comicFolder(comicKey));
+    folder.removeRecursively();
+    if (!folder.mkpath(".")) {
+        QLOG_ERROR() << "Unable to create the pages cache folder" << folder.absolutePath();
+        return;
+    }
+
+    for (auto it = pages.constBegin(); it != pages.constEnd(); ++it) {
+        QImage image = it.value();
+        if (image.isNull()) {
+            continue;
+        }
+
+        // covering the target size keeps the page sharp when it is fitted by width or by height
+        if (targetSize.isValid() && image.width() > targetSize.width() && image.height() > targetSize.height()) {
+            image = image.scaled(targetSize, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+        }
+        if (image.colorCount() > 0 || image.depth() < 8) {
+            image = image.convertToFormat(QImage::Format_RGB32);
+        }
+
+        QSaveFile file(folder.filePath(pageFileName(it.key(), parameters)));
+        if (!file.open(QIODevice::WriteOnly)) {
+            continue;
+        }
+
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_15);
+        stream << pageMagic << pageVersion << qint32(image.width()) << qint32(image.height()) << qint32(image.format()) << qint32(image.bytesPerLine());
+        stream.writeRawData(reinterpret_cast<const char *>(image.constBits()), static_cast<int>(image.sizeInBytes()));
+
+        if (!file.commit()) {
+            QLOG_ERROR() << "Unable to store page" << it.key() << "in the pages cache";
+        }
+    }
+
+    evict();
+}
+
+// removes the comics stored the longest time ago until the cache fits in its limits
+void PageDiskCache::evict()
+{
+    QList<CachedComic> comics;
+    const auto folders = QDir(cachePath).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const auto &folder : folders) {
+        CachedComic comic { folder.absoluteFilePath(), 0, QDateTime::fromMSecsSinceEpoch(0) };
+        const auto files = QDir(comic.path).entryInfoList(QDir::Files);
+        for (const auto &file : files) {
+            comic.size += file.size();
+            comic.lastStored = std::max(comic.lastStored, file.lastModified());
+        }
+        comics.append(comic);
+    }
+
+    std::sort(comics.begin(), comics.end(), [](const CachedComic &a, const CachedComic &b) { return a.lastStored > b.lastStored; });
+
+    qint64 totalSize = 0;
+    for (int i = 0; i < comics.size(); i++) {
+        totalSize += comics.at(i).size;
+        if (i >= maxComics || totalSize > maxSize) {
+            QDir(comics.at(i).path).removeRecursively();
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef PAGE_DISK_CACHE_H
+#define PAGE_DISK_CACHE_H
+
+#include <QImage>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+// Pages where the last comics were left, stored in the cache folder already rendered (rotation and filters applied),
+// scaled down to the size of the viewer and uncompressed, so reopening a comic can show them before its archive is extracted.
+// Each comic keeps only the pages stored the last time it was closed, the least recently stored comics are removed
+// when there are more than `maxComics` or they take more than `maxSize` bytes.
+class PageDiskCache
+{
+public:
+    PageDiskCache(qint64 maxSize, int maxComics = 50);
+
+    // the new size limit is applied the next time pages are stored. It can be called from any thread
+    void setMaxSize(qint64 maxSize);
+
+    // key for comics opened outside a library (no hash available), it changes if the file is modified
+    static QString comicKey(const QString &path);
+
+    // `parameters` identify how the pages were rendered, a page stored with other parameters is not returned
+    QImage load(const QString &comicKey, int page, const QString &parameters) const;
+    // replaces the pages stored for the comic, images bigger than `targetSize` are scaled down first. It can be called from any thread
+    void store(const QString &comicKey, const QMap<int, QImage> &pages, const QString &parameters, const QSize &targetSize);
+
+private:
+    QString comicFolder(const QString &comicKey) const;
+    static QString pageFileName(int page, const QString &parameters);
+    void evict();
+
+    QString cachePath;
+    qint64 maxSize;
+    int maxComics;
+    QMutex mutex;
+};
+
+#endif // PAGE_DISK_CACHE_H
@@ -6,12 +6,17 @@
 #include <QPixmap>
 #include <QApplication>
 #include <QImage>
+#include <QStringList>
+#include <QDir>
+#include <QFileInfo>
 
+#include <limits>
 #include <typeinfo>
 
 #include "comic_db.h"
 #include "yacreader_global_gui.h"
 #include "configuration.h"
+#include "image_filter_kernels.h"
 
 template<class T>
 inline const T &kClamp(const T &x, const T &low, const T &high)
@@ -39,88 +44,6 @@ inline int changeGamma(int value, int gamma)
     return kClamp(int(pow(value / 255.0, 100.0 / gamma) * 255), 0, 255);
 }
 
-inline int changeUsingTable(int value, const int table[])
-{
-    return table[value];
-}
-
-template<int operation(int, int)>
-static QImage changeImage(const QImage &image, int value)
-{
-    QImage im = image;
-    im.detach();
-    if (im.colorCount() == 0) /* truecolor */
-    {
-        if (im.format() != QImage::Format_RGB32) /* just in case */
-            im = im.convertToFormat(QImage::Format_RGB32);
-        int table[256];
-        for (int i = 0;
-             i < 256;
-             ++i)
-            table[i] = operation(i, value);
-        if (im.hasAlphaChannel()) {
-            for (int y = 0;
-                 y < im.height();
-                 ++y) {
-                QRgb *line = reinterpret_cast<QRgb *>(im.scanLine(y));
-                for (int x = 0;
-                     x < im.width();
-                     ++x)
-                    line[x] = qRgba(changeUsingTable(qRed(line[x]), table),
-                                    changeUsingTable(qGreen(line[x]), table),
-                                    changeUsingTable(qBlue(line[x]), table),
-                                    changeUsingTable(qAlpha(line[x]), table));
-            }
-        } else {
-            for (int y = 0;
-                 y < im.height();
-                 ++y) {
-                QRgb *line = reinterpret_cast<QRgb *>(im.scanLine(y));
-                for (int x = 0;
-                     x < im.width();
-                     ++x)
-                    line[x] = qRgb(changeUsingTable(qRed(line[x]), table),
-                                   changeUsingTable(qGreen(line[x]), table),
-                                   changeUsingTable(qBlue(line[x]), table));
-            }
-        }
-    } else {
-        QVector<QRgb> colors = im.colorTable();
-        for (int i = 0;
-             i < im.colorCount();
-             ++i)
-            colors[i] = qRgb(operation(qRed(colors[i]), value),
-                             operation(qGreen(colors[i]), value),
-                             operation(qBlue(colors[i]), value));
-        im.setColorTable(colors);
-    }
-    return im;
-}
-
-// brightness is multiplied by 100 in order to avoid floating point numbers
-QImage changeBrightness(const QImage &image, int brightness)
-{
-    if (brightness == 0) // no change
-        return image;
-    return changeImage<changeBrightness>(image, brightness);
-}
-
-// contrast is multiplied by 100 in order to avoid floating point numbers
-QImage changeContrast(const QImage &image, int contrast)
-{
-    if (contrast == 100) // no change
-        return image;
-    return changeImage<changeContrast>(image, contrast);
-}
-
-// gamma is multiplied by 100 in order to avoid floating point numbers
-QImage changeGamma(const QImage &image, int gamma)
-{
-    if (gamma == 100) // no change
-        return image;
-    return changeImage<changeGamma>(image, gamma);
-}
-
 //-----------------------------------------------------------------------------
 // MeanNoiseReductionFilter
 //-----------------------------------------------------------------------------
@@ -132,30 +55,8 @@ MeanNoiseReductionFilter::MeanNoiseReductionFilter(enum NeighborghoodSize ns)
 
 QImage MeanNoiseReductionFilter::setFilter(const QImage &image)
 {
-    int width = image.width();
-    int height = image.height();
-    QImage result(width, height, image.format());
     int filterSize = sqrt((float)neighborghoodSize);
-    int bound = filterSize / 2;
-    QRgb pix;
-    int r, g, b;
-    for (int j = bound; j < height - bound; j++) {
-        for (int i = bound; i < width - bound; i++) {
-            r = g = b = 0;
-            for (int y = j - bound; y <= j + bound; y++) {
-                for (int x = i - bound; x <= i + bound; x++) {
-                    pix = image.pixel(x, y);
-                    r += qRed(pix);
-                    g += qGreen(pix);
-                    b += qBlue(pix);
-                }
-            }
-            result.setPixel(i, j, QColor(r / neighborghoodSize, g / neighborghoodSize, b / neighborghoodSize).rgb());
-            // qDebug((QString::number(redChannel.at(4))+" "+QString::number(greenChannel.at(4))+" "+QString::number(blueChannel.at(4))).toAscii());
-            // qDebug((QString::number(redChannel.size())+" "+QString::number(greenChannel.size())+" "+QString::number(blueChannel.size())).toAscii());
-        }
-    }
-    return result;
+    return YACReader::boxFilter(image, filterSize / 2);
 }
 
 //-----------------------------------------------------------------------------
@@ -169,35 +70,60 @@ MedianNoiseReductionFilter::MedianNoiseReductionFilter(enum NeighborghoodSize ns
 
 QImage MedianNoiseReductionFilter::setFilter(const QImage &image)
 {
-    int width = image.width();
-    int height = image.height();
-    QImage result(width, height, image.format());
     int filterSize = sqrt((float)neighborghoodSize);
-    int bound = filterSize / 2;
-    QRgb pix;
-    QList<int> redChannel;
-    QList<int> greenChannel;
-    QList<int> blueChannel;
-    for (int j = bound; j < height - bound; j++) {
-        for (int i = bound; i < width - bound; i++) {
-            redChannel.clear();
-            greenChannel.clear();
-            blueChannel.clear();
-            for (int y = j - bound; y <= j + bound; y++) {
-                for (int x = i - bound; x <= i + bound; x++) {
-                    pix = image.pixel(x, y);
-                    redChannel.push_back(qRed(pix));
-                    greenChannel.push_back(qGreen(pix));
-                    blueChannel.push_back(qBlue(pix));
-                }
-            }
+    return YACReader::medianFilter(image, filterSize / 2);
+}
 
-            std::sort(redChannel.begin(), redChannel.end());
-            std::sort(greenChannel.begin(), greenChannel.end());
-            std::sort(blueChannel.begin(), blueChannel.end());
-            result.setPixel(i, j, QColor(redChannel.at(4), greenChannel.at(4), blueChannel.at(4)).rgb());
+//-----------------------------------------------------------------------------
+// ChannelFilter
+//-----------------------------------------------------------------------------
+QImage ChannelFilter::setFilter(const QImage &image)
+{
+    return applyFilters(image, QVector<ImageFilter *>() << this);
+}
+
+QImage applyFilters(const QImage &image, const QVector<ImageFilter *> &filters)
+{
+    QImage result = image;
+    uchar table[256];
+    bool pendingTable = false;
+
+    auto applyPendingTable = [&]() {
+        if (!pendingTable)
+            return;
+        if (result.colorCount() == 0) {
+            result = YACReader::applyChannelTable(result, table);
+        } else {
+            QVector<QRgb> colors = result.colorTable();
+            for (auto &color : colors)
+                color = qRgb(table[qRed(color)], table[qGreen(color)], table[qBlue(color)]);
+            result.setColorTable(colors);
+        }
+        pendingTable = false;
+    };
+
+    for (auto *filter : filters) {
+        auto channelFilter = dynamic_cast<ChannelFilter *>(filter);
+        if (channelFilter == nullptr) {
+            applyPendingTable();
+            result = filter->setFilter(result);
+            continue;
         }
+
+        int level = channelFilter->currentLevel();
+        if (level == channelFilter->neutralLevel()) // no change
+            continue;
+
+        if (!pendingTable) {
+            for (int i = 0; i < 256; i++)
+                table[i] = i;
+            pendingTable = true;
+        }
+        for (int i = 0; i < 256; i++)
+            table[i] = channelFilter->map(table[i], level);
     }
+    applyPendingTable();
+
     return result;
 }
 
@@ -205,160 +131,123 @@ QImage MedianNoiseReductionFilter::setFilter(const QImage &image)
 // BrightnessFilter
 //-----------------------------------------------------------------------------
 BrightnessFilter::BrightnessFilter(int l)
-    : ImageFilter()
+    : ChannelFilter()
 {
     level = l;
 }
 
-QImage BrightnessFilter::setFilter(const QImage &image)
+int BrightnessFilter::currentLevel() const
 {
-    /*int width = image.width();
-        int height = image.height();
-        QImage result(width,height,image.format());
-
-        for(int j=0;j<height;j++){
-                for(int i=0;i<width;i++){
-                        result.setPixel(i,j,QColor(image.pixel(i,j)).light(level).rgb());
-                }
-        }
-        return result;*/
     if (level == -1) {
         QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
-        return changeBrightness(image, settings.value(BRIGHTNESS, 0).toInt());
-    } else {
-        return changeBrightness(image, level);
+        return settings.value(BRIGHTNESS, 0).toInt();
     }
+    return level;
+}
+
+// brightness is multiplied by 100 in order to avoid floating point numbers
+int BrightnessFilter::map(int value, int level) const
+{
+    return changeBrightness(value, level);
 }
 
 //-----------------------------------------------------------------------------
 // ContrastFilter
 //-----------------------------------------------------------------------------
 ContrastFilter::ContrastFilter(int l)
-    : ImageFilter()
+    : ChannelFilter()
 {
     level = l;
 }
 
-QImage ContrastFilter::setFilter(const QImage &image)
+int ContrastFilter::currentLevel() const
 {
-    /*int width = image.width();
-        int height = image.height();
-        QImage result(width,height,image.format());
-
-        int min,max,v;
-        min = 0;
-        max = 255;
-        int sum = 0;
-
-        QVector<int> hist(256,0);
-
-        for(int j=0;j<height;j++){
-                for(int i=0;i<width;i++){
-                        hist[QColor(image.pixel(i,j)).lightness()]++;
-                        sum++;
-                }
-        }
-
-        long double count = sum;
-        long double new_count = 0.0;
-        long double percentage,next_percentage;
-
-        for (int i = 0; i < 254; i++)
-        {
-                new_count += hist[i];
-                percentage = new_count/count;
-                next_percentage = (new_count+hist[i+1])/count;
-                if(fabs (percentage - 0.006) < fabs (next_percentage - 0.006))
-                {
-                        min = i+1;
-                        break;
-                }
-        }
-
-        new_count=0.0;
-        for (int i = 255; i > 1; i--)
-        {
-                new_count += hist[i];
-                percentage = new_count/count;
-                next_percentage = (new_count+hist[i-1])/count;
-                if(fabs (percentage - 0.006) < fabs (next_percentage - 0.006))
-                {
-                        max = i-1;
-                        break;
-                }
-        }
-        QColor c;
-        int range = max - min;
-        for(int j=0;j<height;j++){
-                for(int i=0;i<width;i++){
-                        c = QColor(image.pixel(i,j));
-                        result.setPixel(i,j,c.light(((c.lightness()-min)/range*1.0)*255).rgb());
-                }
-        }
-
-        return result;*/
     if (level == -1) {
         QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
-        return changeContrast(image, settings.value(CONTRAST, 100).toInt());
-    } else {
-        return changeContrast(image, level);
+        return settings.value(CONTRAST, 100).toInt();
     }
+    return level;
 }
+
+// contrast is multiplied by 100 in order to avoid floating point numbers
+int ContrastFilter::map(int value, int level) const
+{
+    return changeContrast(value, level);
+}
+
 //-----------------------------------------------------------------------------
-// ContrastFilter
+// GammaFilter
 //-----------------------------------------------------------------------------
 GammaFilter::GammaFilter(int l)
-    : ImageFilter()
+    : ChannelFilter()
 {
     level = l;
 }
 
-QImage GammaFilter::setFilter(const QImage &image)
+int GammaFilter::currentLevel() const
 {
     if (level == -1) {
         QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
-        return changeGamma(image, settings.value(GAMMA, 100).toInt());
-    } else {
-        return changeGamma(image, level);
+        return settings.value(GAMMA, 100).toInt();
     }
+    return level;
+}
+
+// gamma is multiplied by 100 in order to avoid floating point numbers
+int GammaFilter::map(int value, int level) const
+{
+    return changeGamma(value, level);
 }
 
 //-----------------------------------------------------------------------------
 // PageRender
 //-----------------------------------------------------------------------------
-PageRender::PageRender()
-    : QThread()
-{
-}
-PageRender::PageRender(Render *r, int np, const QByteArray &rd, QImage *p, unsigned int d, QVector<ImageFilter *> f)
-    : QThread(),
+PageRender::PageRender(Render *r, int np, const QByteArray &rd, const QImage &i, quint64 t, std::shared_ptr<std::atomic<bool>> c, unsigned int d, const QVector<ImageFilter *> &f)
+    : QRunnable(),
       numPage(np),
       data(rd),
-      page(p),
+      image(i),
+      ticket(t),
+      cancelled(std::move(c)),
       degrees(d),
-      filters(f),
       render(r)
 {
+    for (auto *filter : f) {
+        filters.push_back(filter->clone());
+    }
+}
+
+PageRender::~PageRender()
+{
+    qDeleteAll(filters);
 }
 
 void PageRender::run()
 {
-    QMutexLocker locker(&(render->mutex));
+    if (*cancelled)
+        return;
 
-    QImage img;
-    img.loadFromData(data);
+    QImage img = image;
+    if (img.isNull()) {
+        img.loadFromData(data);
+    }
     if (degrees > 0) {
         QTransform m;
         m.rotate(degrees);
         img = img.transformed(m, Qt::SmoothTransformation);
     }
-    for (int i = 0; i < filters.size(); i++) {
-        img = filters[i]->setFilter(img);
+    if (!*cancelled) {
+        img = applyFilters(img, filters);
     }
 
-    *page = img;
+    if (*cancelled)
+        return;
 
-    emit pageReady(numPage);
+    auto render = this->render;
+    auto ticket = this->ticket;
+    auto numPage = this->numPage;
+    QMetaObject::invokeMethod(
+            render, [render, ticket, numPage, img] { render->pageRendered(ticket, numPage, img); }, Qt::QueuedConnection);
 }
 
 //-----------------------------------------------------------------------------
@@ -366,27 +255,31 @@ void PageRender::run()
 //-----------------------------------------------------------------------------
 
 Render::Render()
-    : comic(nullptr), doublePage(false), doubleMangaPage(false), currentIndex(0), numLeftPages(4), numRightPages(4), loadedComic(false), imageRotation(0)
+    : comic(nullptr), doublePage(false), doubleMangaPage(false), currentIndex(0), numLeftPages(4), numRightPages(4), prefetchedComic(nullptr), loadedComic(false), imageRotation(0), lastRenderTicket(0)
 {
     int size = numLeftPages + numRightPages + 1;
     currentPageBufferedIndex = numLeftPages;
     for (int i = 0; i < size; i++) {
         buffer.push_back(new QImage());
-        pageRenders.push_back(0);
+        pageRenders.push_back(PendingRender());
     }
 
+    renderPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), size));
+
     filters.push_back(new BrightnessFilter());
     filters.push_back(new ContrastFilter());
     filters.push_back(new GammaFilter());
+
+    updatePageDiskCache();
 }
 
 Render::~Render()
 {
-    for (auto *pr : pageRenders) {
-        if (pr != nullptr && pr->wait()) {
-            delete pr;
-        }
+    for (auto &pendingRender : pageRenders) {
+        cancelPageRender(pendingRender);
     }
+    renderPool.clear();
+    renderPool.waitForDone();
 
     // TODO move to share_ptr
     for (auto *filter : filters) {
@@ -399,6 +292,13 @@ Render::~Render()
         comic->thread()->quit();
         comic->thread()->wait();
     }
+
+    if (prefetchedComic != nullptr) {
+        prefetchedComic->invalidate();
+        prefetchedComic->deleteLater();
+        prefetchedComic->thread()->quit();
+        prefetchedComic->thread()->wait();
+    }
 }
 // Este método se encarga de forzar el renderizado de las páginas.
 // Actualiza el buffer según es necesario.
@@ -408,21 +308,16 @@ void Render::render()
     updateBuffer();
     if (buffer[currentPageBufferedIndex]->isNull()) {
         if (pagesReady.size() > 0) {
-            if (pagesReady[currentIndex]) {
-                pageRenders[currentPageBufferedIndex] = new PageRender(this, currentIndex, comic->getRawData()->at(currentIndex), buffer[currentPageBufferedIndex], imageRotation, filters);
+            if (pagesReady[currentIndex] && pageRenders[currentPageBufferedIndex].ticket == 0) {
+                startPageRender(currentIndex, currentPageBufferedIndex);
             } else
                 // las páginas no están listas, y se están cargando en el cómic
                 emit processingPage(); // para evitar confusiones esta señal debería llamarse de otra forma
 
-            // si se ha creado un hilo para renderizar la página actual, se arranca
-            if (pageRenders[currentPageBufferedIndex] != 0) {
-                // se conecta la señal pageReady del hilo, con el SLOT prepareAvailablePage
-                connect(pageRenders[currentPageBufferedIndex], &PageRender::pageReady, this, &Render::prepareAvailablePage);
-                // se emite la señal de procesando, debido a que los hilos se arrancan aquí
+            // si se ha lanzado el renderizado de la página actual, se avisa de que se está procesando
+            if (pageRenders[currentPageBufferedIndex].ticket != 0) {
                 if (filters.size() > 0)
                     emit processingPage();
-                pageRenders[currentPageBufferedIndex]->start();
-                pageRenders[currentPageBufferedIndex]->setPriority(QThread::TimeCriticalPriority);
             } else
                 // en qué caso sería necesario hacer esto??? //TODO: IMPORTANTE, puede que no sea necesario.
                 emit processingPage();
@@ -615,6 +510,16 @@ void Render::setRotation(int degrees)
     Q_UNUSED(degrees)
 }
 
+void Render::setTargetPageSize(const QSize &size)
+{
+    targetPageSize = size;
+#ifndef NO_PDF
+    if (auto pdfComic = qobject_cast<PDFComic *>(comic)) {
+        pdfComic->setTargetSize(targetPageSize);
+    }
+#endif
+}
+
 void Render::setComic(Comic *c)
 {
     if (comic != nullptr) {
@@ -651,10 +556,23 @@ void Render::update()
 //-----------------------------------------------------------------------------
 void Render::load(const QString &path, int atPage)
 {
-    createComic(path);
+    auto prefetched = takePrefetchedComic(path);
+    createComic(path, prefetched);
     if (comic != nullptr) {
-        loadComic(path, atPage);
-        startLoad();
+        int page = atPage;
+        if (prefetched == nullptr) {
+            loadComic(path, atPage);
+        }
+        if (page == -1) {
+            page = comic->bm->getLastPage();
+        }
+        comicCacheKey = PageDiskCache::comicKey(path);
+        if (prefetched == nullptr) {
+            startLoad();
+            showCachedPages(page);
+        } else {
+            adoptComic(page);
+        }
     }
 }
 
@@ -682,17 +600,96 @@ void Render::load(const QString &path, const ComicDB &comicDB)
                 filters[i]->setLevel(comicDB.info.gamma);
         }
     }
-    createComic(path);
+    auto prefetched = takePrefetchedComic(path);
+    createComic(path, prefetched);
     if (comic != nullptr) {
-        loadComic(path, comicDB);
-        startLoad();
+        comicCacheKey = comicDB.info.hash;
+        if (prefetched == nullptr) {
+            loadComic(path, comicDB);
+            startLoad();
+            showCachedPages(qMax(0, comicDB.info.currentPage - 1));
+        } else {
+            adoptComic(qMax(0, comicDB.info.currentPage - 1));
+        }
+    }
+}
+
+void Render::prefetch(const QString &path, const ComicDB &comicDB)
+{
+    if (auto fileComic = newPrefetchComic(path)) {
+        fileComic->load(path, comicDB);
+        startPrefetch(fileComic, path);
+    }
+}
+
+void Render::prefetch(const QString &path, int atPage)
+{
+    if (auto fileComic = newPrefetchComic(path)) {
+        fileComic->load(path, atPage);
+        startPrefetch(fileComic, path);
+    }
+}
+
+void Render::cancelPrefetch()
+{
+    if (prefetchedComic != nullptr) {
+        prefetchedComic->invalidate();
+        prefetchedComic->disconnect();
+        prefetchedComic->deleteLater();
+        prefetchedComic = nullptr;
+        prefetchedPath.clear();
     }
 }
 
-void Render::createComic(const QString &path)
+FileComic *Render::newPrefetchComic(const QString &path)
+{
+    if (prefetchedComic != nullptr && prefetchedPath == QDir::cleanPath(path)) {
+        return nullptr;
+    }
+    cancelPrefetch();
+
+    // folders are read page by page and PDF pages are rendered at the size of the viewer, there is nothing to extract
+    QFileInfo info(path);
+    if (!info.isFile() || info.suffix().compare("pdf", Qt::CaseInsensitive) == 0) {
+        return nullptr;
+    }
+
+    auto fileComic = new FileComic();
+    qint64 budget = Configuration::getConfiguration().getPagesMemoryBudget();
+    qint64 prefetchBudget = Configuration::getConfiguration().getPrefetchNextComicSize();
+    fileComic->setMemoryBudget(budget > 0 ? qMin(budget, prefetchBudget) : prefetchBudget);
+    return fileComic;
+}
+
+void Render::startPrefetch(FileComic *fileComic, const QString &path)
+{
+    prefetchedComic = fileComic;
+    prefetchedPath = QDir::cleanPath(path);
+    startComicThread(fileComic);
+}
+
+Comic *Render::takePrefetchedComic(const QString &path)
+{
+    if (prefetchedComic == nullptr) {
+        return nullptr;
+    }
+
+    if (prefetchedPath != QDir::cleanPath(path) || prefetchedComic->hasBeenAnErrorOpening()) {
+        cancelPrefetch();
+        return nullptr;
+    }
+
+    auto prefetched = prefetchedComic;
+    prefetchedComic = nullptr;
+    prefetchedPath.clear();
+    return prefetched;
+}
+
+void Render::createComic(const QString &path, Comic *prefetched)
 {
     previousIndex = currentIndex = 0;
     pagesEmited.clear();
+    comicCacheKey.clear();
 
     if (comic != nullptr) {
         comic->invalidate();
@@ -701,7 +698,7 @@ void Render::createComic(const QString &path)
         QCoreApplication::sendPostedEvents(this);
         comic->deleteLater();
     }
-    comic = FactoryComic::newComic(path);
+    comic = prefetched != nullptr ? prefetched : FactoryComic::newComic(path);
 
     if (comic == nullptr) // archivo no encontrado o no válido
     {
@@ -710,14 +707,27 @@ void Render::createComic(const QString &path)
         return;
     }
 
+    if (auto fileComic = qobject_cast<FileComic *>(comic)) {
+        // a prefetched comic is already running within its small budget, it can't be switched to unlimited (0)
+        qint64 budget = Configuration::getConfiguration().getPagesMemoryBudget();
+        fileComic->setMemoryBudget(budget > 0 || prefetched == nullptr ? budget : std::numeric_limits<qint64>::max());
+    }
+#ifndef NO_PDF
+    if (auto pdfComic = qobject_cast<PDFComic *>(comic)) {
+        pdfComic->setImagePassthrough(true);
+        pdfComic->setTargetSize(targetPageSize);
+        pdfComic->setMemoryBudget(Configuration::getConfiguration().getPagesMemoryBudget());
+    }
+#endif
+
     connect(comic, QOverload<>::of(&Comic::errorOpening), this, QOverload<>::of(&Render::errorOpening), Qt::QueuedConnection);
     connect(comic, QOverload<QString>::of(&Comic::errorOpening), this, QOverload<QString>::of(&Render::errorOpening), Qt::QueuedConnection);
     connect(comic, &Comic::crcErrorFound, this, &Render::crcError, Qt::QueuedConnection);
     connect(comic, QOverload<>::of(&Comic::errorOpening), this, &Render::reset, Qt::QueuedConnection);
     connect(comic, QOverload<int>::of(&Comic::imageLoaded), this, &Render::pageRawDataReady, Qt::QueuedConnection);
     connect(comic, QOverload<int>::of(&Comic::imageLoaded), this, QOverload<int>::of(&Render::imageLoaded), Qt::QueuedConnection);
+    connect(comic, &Comic::imageUnloaded, this, &Render::pageRawDataUnloaded, Qt::QueuedConnection);
     connect(comic, &Comic::openAt, this, &Render::renderAt, Qt::QueuedConnection);
-    connect(comic, QOverload<unsigned int>::of(&Comic::numPages), this, QOverload<unsigned int>::of(&Render::numPages), Qt::QueuedConnection);
     connect(comic, QOverload<unsigned int>::of(&Comic::numPages), this, QOverload<unsigned int>::of(&Render::setNumPages), Qt::QueuedConnection);
     connect(comic, QOverload<int, const QByteArray &>::of(&Comic::imageLoaded), this, QOverload<int, const QByteArray &>::of(&Render::imageLoaded), Qt::QueuedConnection);
     connect(comic, &Comic::isBookmark, this, &Render::currentPageIsBookmark, Qt::QueuedConnection);
@@ -739,6 +749,39 @@ void Render::loadComic(const QString &path, int atPage)
 }
 
 void Render::startLoad()
+{
+    startComicThread(comic);
+
+    invalidate();
+    loadedComic = true;
+    update();
+}
+
+void Render::adoptComic(int page)
+{
+    invalidate();
+    loadedComic = true;
+    update();
+    showCachedPages(page);
+
+    // setNumPages ignores the number of pages if it arrives again
+    unsigned int pages = comic->numPages();
+    if (pages > 0) {
+        setNumPages(pages);
+        renderAt(comic->getIndex());
+        for (int i = 0; i < int(pages); i++) {
+            if (comic->pageIsLoaded(i)) {
+                pageRawDataReady(i);
+                emit imageLoaded(i);
+                emit imageLoaded(i, comic->getRawPage(i));
+            }
+        }
+    }
+    emit bookmarksUpdated();
+    update();
+}
+
+void Render::startComicThread(Comic *comic)
 {
     QThread *thread = nullptr;
 
@@ -756,14 +799,14 @@ void Render::startLoad()
 
     if (thread != nullptr)
         thread->start();
-
-    invalidate();
-    loadedComic = true;
-    update();
 }
 
 void Render::renderAt(int page)
 {
+    // the comic may start somewhere else than where it was left (e.g. the bookmarked page no longer exists)
+    if (!cachedPages.isEmpty() && page != currentIndex) {
+        invalidate();
+    }
     previousIndex = currentIndex = page;
     emit pageChanged(page);
 }
@@ -857,7 +900,11 @@ bool Render::hasLoadedComic()
 
 void Render::setNumPages(unsigned int numPages)
 {
+    if (numPages > 0 && pagesReady.size() == int(numPages)) {
+        return;
+    }
     pagesReady.fill(false, numPages);
+    emit this->numPages(numPages);
 }
 
 void Render::pageRawDataReady(int page)
@@ -874,6 +921,12 @@ void Render::pageRawDataReady(int page)
             }
 
             pagesReady[pagesEmited.at(i)] = true;
+            if (cachedPages.contains(pagesEmited.at(i))) {
+                int bufferedIndex = currentPageBufferedIndex + pagesEmited.at(i) - currentIndex;
+                if (bufferedIndex >= 0 && bufferedIndex < buffer.size() && pageRenders[bufferedIndex].ticket == 0) {
+                    startPageRender(pagesEmited.at(i), bufferedIndex);
+                }
+            }
             if (pagesEmited.at(i) == currentIndex)
                 update();
             else {
@@ -887,6 +940,13 @@ void Render::pageRawDataReady(int page)
     }
 }
 
+void Render::pageRawDataUnloaded(int page)
+{
+    if (page >= 0 && page < pagesReady.size()) {
+        pagesReady[page] = false;
+    }
+}
+
 // sólo se renderiza la página, si ha habido un cambio de página
 void Render::goTo(int index)
 {
@@ -919,7 +979,6 @@ void Render::rotateLeft()
 // Calcula el número de nuevas páginas que hay que buferear y si debe hacerlo por la izquierda o la derecha (según sea el sentido de la lectura)
 void Render::updateBuffer()
 {
-    QMutexLocker locker(&mutex);
     int windowSize = currentIndex - previousIndex;
 
     if (windowSize > 0) // add pages to right pages and remove on the left
@@ -927,13 +986,9 @@ void Render::updateBuffer()
         windowSize = qMin(windowSize, buffer.size());
         for (int i = 0; i < windowSize; i++) {
             // renders
-            PageRender *pr = pageRenders.front();
+            cancelPageRender(pageRenders.front());
             pageRenders.pop_front();
-            if (pr != nullptr) {
-                if (pr->wait())
-                    delete pr;
-            }
-            pageRenders.push_back(0);
+            pageRenders.push_back(PendingRender());
 
             // images
 
@@ -949,13 +1004,9 @@ void Render::updateBuffer()
             windowSize = qMin(windowSize, buffer.size());
             for (int i = 0; i < windowSize; i++) {
                 // renders
-                PageRender *pr = pageRenders.back();
+                cancelPageRender(pageRenders.back());
                 pageRenders.pop_back();
-                if (pr != nullptr) {
-                    if (pr->wait())
-                        delete pr;
-                }
-                pageRenders.push_front(0);
+                pageRenders.push_front(PendingRender());
 
                 // images
                 buffer.push_front(new QImage());
@@ -979,43 +1030,82 @@ void Render::fillBuffer()
         if ((currentIndex + i < (int)comic->numPages()) &&
             buffer[currentPageBufferedIndex + i]->isNull() &&
             i <= numRightPages &&
-            pageRenders[currentPageBufferedIndex + i] == 0 &&
+            pageRenders[currentPageBufferedIndex + i].ticket == 0 &&
             pagesReady[currentIndex + i]) // preload next pages
         {
-            pageRenders[currentPageBufferedIndex + i] = new PageRender(this, currentIndex + i, comic->getRawData()->at(currentIndex + i), buffer[currentPageBufferedIndex + i], imageRotation, filters);
-            connect(pageRenders[currentPageBufferedIndex + i], &PageRender::pageReady, this, &Render::prepareAvailablePage);
-            pageRenders[currentPageBufferedIndex + i]->start();
+            startPageRender(currentIndex + i, currentPageBufferedIndex + i);
         }
 
         if ((currentIndex - i > 0) &&
             buffer[currentPageBufferedIndex - i]->isNull() &&
             i <= numLeftPages &&
-            pageRenders[currentPageBufferedIndex - i] == 0 &&
+            pageRenders[currentPageBufferedIndex - i].ticket == 0 &&
             pagesReady[currentIndex - i]) // preload previous pages
         {
-            pageRenders[currentPageBufferedIndex - i] = new PageRender(this, currentIndex - i, comic->getRawData()->at(currentIndex - i), buffer[currentPageBufferedIndex - i], imageRotation, filters);
-            connect(pageRenders[currentPageBufferedIndex - i], &PageRender::pageReady, this, &Render::prepareAvailablePage);
-            pageRenders[currentPageBufferedIndex - i]->start();
+            startPageRender(currentIndex - i, currentPageBufferedIndex - i);
+        }
+    }
+}
+
+// the raw data of a page can be released by the comic if it doesn't fit in memory, in that case the page is no longer ready
+// pages closer to the current one get a higher priority in the pool, so turning pages never waits behind the preloading
+bool Render::startPageRender(int page, int bufferedIndex)
+{
+    QByteArray rawData = comic->getRawPage(page);
+    QImage image;
+    if (rawData.isEmpty()) {
+        // comics that keep their pages decoded have no raw data
+        image = comic->getPageImage(page);
+        if (image.isNull()) {
+            pagesReady[page] = false;
+            return false;
+        }
+    }
+
+    PendingRender &pendingRender = pageRenders[bufferedIndex];
+    pendingRender.ticket = ++lastRenderTicket;
+    pendingRender.cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    int priority = buffer.size() - qAbs(page - currentIndex);
+    renderPool.start(new PageRender(this, page, rawData, image, pendingRender.ticket, pendingRender.cancelled, imageRotation, filters), priority);
+    return true;
+}
+
+void Render::cancelPageRender(PendingRender &pendingRender)
+{
+    if (pendingRender.ticket != 0) {
+        *pendingRender.cancelled = true;
+        pendingRender = PendingRender();
+    }
+}
+
+// called in this object's thread when a PageRender finishes, renders that are no longer in the buffer are dropped
+void Render::pageRendered(quint64 ticket, int page, const QImage &image)
+{
+    for (int i = 0; i < pageRenders.size(); i++) {
+        if (pageRenders[i].ticket == ticket) {
+            *buffer[i] = image;
+            pageRenders[i] = PendingRender();
+            cachedPages.remove(page);
+            prepareAvailablePage(page);
+            return;
         }
     }
 }
 
 // Método que debe ser llamado cada vez que la estructura del buffer se vuelve inconsistente con el modo de lectura actual.
-// se terminan todos los hilos en ejecución y se libera la memoria (de hilos e imágenes)
+// se cancelan todos los renderizados pendientes y se libera la memoria de las imágenes
 void Render::invalidate()
 {
     for (int i = 0; i < pageRenders.size(); i++) {
-        if (pageRenders[i] != 0) {
-            pageRenders[i]->wait();
-            delete pageRenders[i];
-            pageRenders[i] = 0;
-        }
+        cancelPageRender(pageRenders[i]);
     }
 
     for (int i = 0; i < buffer.size(); i++) {
         delete buffer[i];
         buffer[i] = new QImage();
     }
+    cachedPages.clear();
 }
 
 void Render::doublePageSwitch()
@@ -1073,6 +1163,79 @@ void Render::removeBookmark()
 void Render::save()
 {
     comic->saveBookmarks();
+    storeCachedPages();
+}
+
+QString Render::pageCacheParameters() const
+{
+    QStringList parameters { QString::number(imageRotation) };
+    for (auto filter : filters) {
+        if (auto channelFilter = dynamic_cast<ChannelFilter *>(filter)) {
+            parameters << QString::number(channelFilter->currentLevel());
+        }
+    }
+    return parameters.join(",");
+}
+
+void Render::showCachedPages(int page)
+{
+    if (pageDiskCache == nullptr || comicCacheKey.isEmpty() || page < 0) {
+        return;
+    }
+
+    auto parameters = pageCacheParameters();
+    QImage image = pageDiskCache->load(comicCacheKey, page, parameters);
+    if (image.isNull()) {
+        return;
+    }
+
+    previousIndex = currentIndex = page;
+    *buffer[currentPageBufferedIndex] = image;
+    cachedPages.insert(page);
+    if (doublePage) {
+        QImage nextImage = pageDiskCache->load(comicCacheKey, page + 1, parameters);
+        if (!nextImage.isNull()) {
+            *buffer[currentPageBufferedIndex + 1] = nextImage;
+            cachedPages.insert(page + 1);
+        }
+    }
+
+    prepareAvailablePage(currentIndex);
+}
+
+void Render::updatePageDiskCache()
+{
+    if (!Configuration::getConfiguration().getPagesDiskCache()) {
+        // the pages being stored keep their own reference to the cache
+        pageDiskCache.reset();
+        return;
+    }
+
+    auto maxSize = Configuration::getConfiguration().getPagesDiskCacheSize();
+    if (pageDiskCache == nullptr) {
+        pageDiskCache = std::make_shared<PageDiskCache>(maxSize);
+    } else {
+        pageDiskCache->setMaxSize(maxSize);
+    }
+}
+
+void Render::storeCachedPages()
+{
+    if (pageDiskCache == nullptr || comicCacheKey.isEmpty() || buffer[currentPageBufferedIndex]->isNull()) {
+        return;
+    }
+
+    QMap<int, QImage> pages;
+    pages.insert(currentIndex, *buffer[currentPageBufferedIndex]);
+    if (doublePage && !buffer[currentPageBufferedIndex + 1]->isNull()) {
+        pages.insert(currentIndex + 1, *buffer[currentPageBufferedIndex + 1]);
+    }
+
+    auto cache = pageDiskCache;
+    auto key = comicCacheKey;
+    auto parameters = pageCacheParameters();
+    auto size = targetPageSize;
+    renderPool.start([cache, key, pages, parameters, size] { cache->store(key, pages, parameters, size); });
 }
 
 Bookmarks *Render::getBookmarks()
@@ -5,9 +5,15 @@
 #include <QPixmap>
 #include <QPainter>
 #include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
 #include <QByteArray>
 #include <QVector>
+#include <QSet>
+#include <atomic>
+#include <memory>
 #include "comic.h"
+#include "page_disk_cache.h"
 //-----------------------------------------------------------------------------
 // FILTERS
 //-----------------------------------------------------------------------------
@@ -24,6 +30,8 @@ public:
     ImageFilter() {};
     virtual ~ImageFilter() {};
     virtual QImage setFilter(const QImage &image) = 0;
+    // page renders work on their own copy, the levels can change while they are running
+    virtual ImageFilter *clone() const = 0;
     inline int getLevel() { return level; };
     inline void setLevel(int l) { level = l; };
 
@@ -38,6 +46,7 @@ public:
                              LARGE = 25 };
     MeanNoiseReductionFilter(enum NeighborghoodSize ns = SMALL);
     QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new MeanNoiseReductionFilter(*this); }
 
 private:
     enum NeighborghoodSize neighborghoodSize;
@@ -50,58 +59,80 @@ public:
                              LARGE = 25 };
     MedianNoiseReductionFilter(enum NeighborghoodSize ns = SMALL);
     QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new MedianNoiseReductionFilter(*this); }
 
 private:
     enum NeighborghoodSize neighborghoodSize;
 };
 
-class BrightnessFilter : public ImageFilter
+// filters that map each channel value on its own, consecutive ones are fused in a single pass over the image
+class ChannelFilter : public ImageFilter
 {
 public:
-    BrightnessFilter(int l = -1);
     QImage setFilter(const QImage &image) override;
+    // the level to apply, a level of -1 is read from the settings
+    virtual int currentLevel() const = 0;
+    virtual int neutralLevel() const = 0;
+    virtual int map(int value, int level) const = 0;
+};
+
+class BrightnessFilter : public ChannelFilter
+{
+public:
+    BrightnessFilter(int l = -1);
+    ImageFilter *clone() const override { return new BrightnessFilter(*this); }
+    int currentLevel() const override;
+    int neutralLevel() const override { return 0; }
+    int map(int value, int level) const override;
 };
 
-class ContrastFilter : public ImageFilter
+class ContrastFilter : public ChannelFilter
 {
 public:
     ContrastFilter(int l = -1);
-    QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new ContrastFilter(*this); }
+    int currentLevel() const override;
+    int neutralLevel() const override { return 100; }
+    int map(int value, int level) const override;
 };
 
-class GammaFilter : public ImageFilter
+class GammaFilter : public ChannelFilter
 {
 public:
     GammaFilter(int l = -1);
-    QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new GammaFilter(*this); }
+    int currentLevel() const override;
+    int neutralLevel() const override { return 100; }
+    int map(int value, int level) const override;
 };
 
+// applies the filters in order, runs of ChannelFilters are combined in one lookup table
+QImage applyFilters(const QImage &image, const QVector<ImageFilter *> &filters);
+
 //-----------------------------------------------------------------------------
 // RENDER
 //-----------------------------------------------------------------------------
 
-class PageRender : public QThread
+// Renders one page (decode, rotation and filters) in Render's thread pool.
+// It never touches the buffer: the result is handed back to Render in its own thread,
+// and Render discards it if the page has left the buffer in the meantime.
+class PageRender : public QRunnable
 {
-    Q_OBJECT
 public:
-    PageRender();
-    PageRender(Render *render, int numPage, const QByteArray &rawData, QImage *page, unsigned int degrees = 0, QVector<ImageFilter *> filters = QVector<ImageFilter *>());
+    PageRender(Render *render, int numPage, const QByteArray &rawData, const QImage &image, quint64 ticket, std::shared_ptr<std::atomic<bool>> cancelled, unsigned int degrees = 0, const QVector<ImageFilter *> &filters = QVector<ImageFilter *>());
+    ~PageRender() override;
     int getNumPage() { return numPage; };
-    void setData(const QByteArray &rawData) { data = rawData; };
-    void setPage(QImage *p) { page = p; };
-    void setRotation(unsigned int d) { degrees = d; };
-    void setFilters(QVector<ImageFilter *> f) { filters = f; };
 
 private:
     int numPage;
     QByteArray data;
-    QImage *page;
+    QImage image;
+    quint64 ticket;
+    std::shared_ptr<std::atomic<bool>> cancelled;
     unsigned int degrees;
     QVector<ImageFilter *> filters;
     void run() override;
     Render *render;
-signals:
-    void pageReady(int);
 };
 //-----------------------------------------------------------------------------
 // RENDER
@@ -147,11 +178,14 @@ public slots:
     void setManga(bool manga);
     void doubleMangaPageSwitch();
     void setRotation(int degrees);
+    // size in pixels of the area used to show the pages, documents that are rendered (PDF) use it to choose their resolution
+    void setTargetPageSize(const QSize &size);
     void setComic(Comic *c);
     void prepareAvailablePage(int page);
     void update();
     void setNumPages(unsigned int numPages);
     void pageRawDataReady(int page);
+    void pageRawDataUnloaded(int page);
     //--comic interface
     void nextPage();
     void previousPage();
@@ -159,10 +193,19 @@ public slots:
     void previousDoublePage();
     void load(const QString &path, const ComicDB &comic);
     void load(const QString &path, int atPage);
-    void createComic(const QString &path);
+    // applies PAGES_DISK_CACHE and PAGES_DISK_CACHE_SIZE, called when the options change
+    void updatePageDiskCache();
+    // starts extracting the first pages of a comic that is likely to be opened next within a small memory budget,
+    // load() takes it over if it opens the same comic and it is discarded otherwise (only archives are prefetched)
+    void prefetch(const QString &path, const ComicDB &comic);
+    void prefetch(const QString &path, int atPage);
+    void cancelPrefetch();
+    void createComic(const QString &path, Comic *prefetched = nullptr);
     void loadComic(const QString &path, const ComicDB &comic);
     void loadComic(const QString &path, int atPage);
     void startLoad();
+    // like startLoad() for a prefetched comic, the signals it emitted before being connected are replayed from its state
+    void adoptComic(int page);
     void rotateRight();
     void rotateLeft();
     unsigned int getIndex();
@@ -209,9 +252,27 @@ private:
     int currentPageBufferedIndex;
     int numLeftPages;
     int numRightPages;
-    QList<PageRender *> pageRenders;
+    // a render in flight for each buffer position, ticket 0 means there is none
+    struct PendingRender {
+        quint64 ticket = 0;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+    QList<PendingRender> pageRenders;
     QList<QImage *> buffer;
+    Comic *prefetchedComic;
+    QString prefetchedPath;
+    FileComic *newPrefetchComic(const QString &path);
+    void startPrefetch(FileComic *fileComic, const QString &path);
+    Comic *takePrefetchedComic(const QString &path);
+    static void startComicThread(Comic *comic);
     void loadAll();
+    bool startPageRender(int page, int bufferedIndex);
+    void cancelPageRender(PendingRender &pendingRender);
+    void pageRendered(quint64 ticket, int page, const QImage &image);
+    // shows the pages stored in the disk cache the last time the comic was closed while it is being extracted
+    void showCachedPages(int page);
+    void storeCachedPages();
+    QString pageCacheParameters() const;
     void updateRightPages();
     void updateLeftPages();
     bool loadedComic;
@@ -219,7 +280,13 @@ private:
     QVector<bool> pagesReady;
     int imageRotation;
     QVector<ImageFilter *> filters;
-    QMutex mutex;
+    quint64 lastRenderTicket;
+    QSize targetPageSize;
+    QThreadPool renderPool;
+    std::shared_ptr<PageDiskCache> pageDiskCache;
+    QString comicCacheKey;
+    // pages in the buffer that come from the disk cache, they are rendered again when their data is ready
+    QSet<int> cachedPages;
 
     friend class PageRender;
 };
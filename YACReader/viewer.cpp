@@ -37,6 +37,9 @@ Viewer::Viewer(QWidget *parent)
       drag(false),
       shouldOpenNext(false),
       shouldOpenPrevious(false),
+      nextComicPrefetched(false),
+      previousComicPrefetched(false),
+      lastPrefetchCheckPage(0),
       magnifyingGlassShown(false),
       restoreMagnifyingGlass(false)
 {
@@ -190,6 +193,7 @@ void Viewer::createConnections()
     connect(render, &Render::processingPage, this, &Viewer::setLoadingMessage);
     connect(render, &Render::currentPageIsBookmark, this, &Viewer::pageIsBookmark);
     connect(render, &Render::pageChanged, this, &Viewer::updateInformation);
+    connect(render, &Render::pageChanged, this, &Viewer::checkSiblingPrefetch);
 
     connect(render, &Render::isLast, this, &Viewer::showIsLastMessage);
     connect(render, &Render::isCover, this, &Viewer::showIsCoverMessage);
@@ -215,6 +219,9 @@ void Viewer::prepareForOpening()
     }
 
     informationLabel->setText("...");
+
+    nextComicPrefetched = previousComicPrefetched = false;
+    lastPrefetchCheckPage = 0;
 }
 
 void Viewer::open(QString pathFile, int atPage)
@@ -229,6 +236,38 @@ void Viewer::open(QString pathFile, const ComicDB &comic)
     render->load(pathFile, comic);
 }
 
+void Viewer::prefetch(QString pathFile, int atPage)
+{
+    render->prefetch(pathFile, atPage);
+}
+
+void Viewer::prefetch(QString pathFile, const ComicDB &comic)
+{
+    render->prefetch(pathFile, comic);
+}
+
+// the next comic is prefetched once the configured part of the comic has been read, the previous one when the reader
+// goes back through the same part at the beginning of the comic
+void Viewer::checkSiblingPrefetch(int page)
+{
+    bool forward = page >= lastPrefetchCheckPage;
+    lastPrefetchCheckPage = page;
+
+    int threshold = Configuration::getConfiguration().getPrefetchNextComicAt();
+    int pages = render->hasLoadedComic() ? int(render->numPages()) : 0;
+    if (threshold <= 0 || pages <= 0) {
+        return;
+    }
+
+    if (forward && !nextComicPrefetched && (page + 1) * 100 >= threshold * pages) {
+        nextComicPrefetched = true;
+        emit prefetchSiblingComic(true);
+    } else if (!forward && !previousComicPrefetched && page * 100 <= (100 - threshold) * pages) {
+        previousComicPrefetched = true;
+        emit prefetchSiblingComic(false);
+    }
+}
+
 void Viewer::showMessageErrorOpening()
 {
     QMessageBox::critical(this, tr("Not found"), tr("Comic not found"));
@@ -691,6 +730,7 @@ void Viewer::wheelEvent(QWheelEvent *event)
 
 void Viewer::resizeEvent(QResizeEvent *event)
 {
+    render->setTargetPageSize(viewport()->size() * devicePixelRatioF());
     updateContentSize();
     goToFlow->updateSize();
     goToFlow->move((width() - goToFlow->width()) / 2, height() - goToFlow->height());
@@ -981,6 +1021,7 @@ void Viewer::updateOptions()
     goToFlow->setFlowType(Configuration::getConfiguration().getFlowType());
     updateBackgroundColor(Configuration::getConfiguration().getBackgroundColor());
     updateContentSize();
+    render->updatePageDiskCache();
 }
 
 void Viewer::updateBackgroundColor(const QColor &color)
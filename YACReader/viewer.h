@@ -45,6 +45,9 @@ public slots:
     void prepareForOpening();
     void open(QString pathFile, int atPage = -1);
     void open(QString pathFile, const ComicDB &comic);
+    // extracts the first pages of a comic that is likely to be opened next, see Render::prefetch
+    void prefetch(QString pathFile, int atPage = -1);
+    void prefetch(QString pathFile, const ComicDB &comic);
     void prev();
     void next();
     void left();
@@ -155,6 +158,12 @@ private:
     bool shouldOpenNext;
     bool shouldOpenPrevious;
 
+    // the sibling comics are requested once per comic, when the reader gets close to them
+    bool nextComicPrefetched;
+    bool previousComicPrefetched;
+    int lastPrefetchCheckPage;
+    void checkSiblingPrefetch(int page);
+
 private:
     //! Magnifying glass
     MagnifyingGlass *mglass;
@@ -202,6 +211,7 @@ signals:
     void reset();
     void openNextComic();
     void openPreviousComic();
+    void prefetchSiblingComic(bool next);
     void zoomUpdated(int);
     void magnifyingGlassVisibilityChanged(bool visible);
 
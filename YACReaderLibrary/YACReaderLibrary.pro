@@ -82,6 +82,7 @@ HEADERS += comic_flow.h \
   folder_content_view.h \
   initial_comic_info_extractor.h \
   libraries_update_coordinator.h \
+  library_change_journal.h \
   library_comic_opener.h \
   library_creator.h \
   library_window.h \
@@ -103,13 +104,18 @@ HEADERS += comic_flow.h \
   ./db/folder_item.h \
   ./db/folder_model.h \
   ./db/comic_model.h \
-  ./db/comic_item.h \
+  ./db/comic_rows.h \
+  ./db/library_write_batch.h \
+  ./db/library_indexes.h \
+  ./db/library_queries.h \
+  ./db/library_schema.h \
   ../common/comic_db.h \
   ../common/folder.h \
   ../common/library_item.h \
   ../common/comic.h \
   ../common/bookmarks.h \
   ../common/pictureflow.h \
+  ../common/cover_image_cache.h \
   ../common/release_acquire_atomic.h \
   ../common/worker_thread.h \
   ../common/custom_widgets.h \
@@ -130,6 +136,7 @@ HEADERS += comic_flow.h \
   yacreader_libraries.h \
   ../common/exit_check.h \
   comics_view.h \
+  cover_image_provider.h \
   classic_comics_view.h \
   empty_folder_widget.h \
   no_search_results_widget.h \
@@ -169,6 +176,7 @@ SOURCES += comic_flow.cpp \
     folder_content_view.cpp \
     initial_comic_info_extractor.cpp \
     libraries_update_coordinator.cpp \
+    library_change_journal.cpp \
     library_comic_opener.cpp \
     library_creator.cpp \
     library_window.cpp \
@@ -191,13 +199,15 @@ SOURCES += comic_flow.cpp \
     ./db/folder_item.cpp \
     ./db/folder_model.cpp \
     ./db/comic_model.cpp \
-    ./db/comic_item.cpp \
+    ./db/comic_rows.cpp \
+    ./db/library_write_batch.cpp \
     ../common/comic_db.cpp \
     ../common/folder.cpp \
     ../common/library_item.cpp \
     ../common/comic.cpp \
     ../common/bookmarks.cpp \
     ../common/pictureflow.cpp \
+    ../common/cover_image_cache.cpp \
     ../common/custom_widgets.cpp \
     ../common/qnaturalsorting.cpp \
     no_libraries_widget.cpp \
@@ -215,6 +225,7 @@ SOURCES += comic_flow.cpp \
     yacreader_libraries.cpp \
     ../common/exit_check.cpp \
     comics_view.cpp \
+    cover_image_provider.cpp \
     classic_comics_view.cpp \
     empty_folder_widget.cpp \
     no_search_results_widget.cpp \
@@ -1,4 +1,5 @@
 #include "comic_flow.h"
+#include "cover_image_cache.h"
 #include "worker_thread.h"
 
 #include "yacreader_global.h"
@@ -89,7 +90,7 @@ void ComicFlow::updateImageData()
                 QString fname = imageFiles[i];
 
                 workerIndex = i;
-                worker->performTask([fname] { return QImage { fname }; });
+                worker->performTask([fname] { return CoverImageCache::instance().load(fname); });
                 return;
             }
     }
@@ -2,6 +2,7 @@
 #include "comic.h"
 #include "comic_files_manager.h"
 #include "comic_db.h"
+#include "cover_image_provider.h"
 
 #include "QsLog.h"
 
@@ -31,10 +32,14 @@ ComicsView::ComicsView(QWidget *parent)
                 }
             });
 
+    view->engine()->addImageProvider(CoverImageProvider::id, new CoverImageProvider());
+
     auto comicDB = new ComicDB();
     auto comicInfo = &(comicDB->info);
     QQmlContext *ctxt = view->rootContext();
 
+    ctxt->setContextProperty("coverPrefetcher", new CoverPrefetcher(this));
+
     ctxt->setContextProperty("comic", comicDB);
     ctxt->setContextProperty("comicInfo", comicInfo);
 
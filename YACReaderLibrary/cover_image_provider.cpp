@@ -0,0 +1,133 @@
+#include "cover_image_provider.h"
+
+#include <QThreadPool>
+
+#include "cover_image_cache.h"
+
+namespace {
+QThreadPool *coverPool()
+{
+    static QThreadPool *pool = [] {
+        auto threadPool = new QThreadPool();
+        threadPool->setMaxThreadCount(qBound(2, QThread::idealThreadCount() / 2, 6));
+        return threadPool;
+    }();
+    return pool;
+}
+
+// covers requested by the views go before the prefetched ones
+const int visiblePriority = 1;
+const int prefetchPriority = 0;
+}
+
+const QString CoverImageProvider::id = "cover";
+
+QUrl CoverImageProvider::url(const QString &fileName)
+{
+    return QUrl("image://" + id + "/" + QString::fromLatin1(QUrl::toPercentEncoding(fileName)));
+}
+
+QString CoverImageProvider::fileName(const QUrl &url)
+{
+    if (url.scheme() != "image" || url.host() != id) {
+        return QString();
+    }
+
+    return fileNameFromId(url.path(QUrl::FullyEncoded).mid(1));
+}
+
+// QML passes the id pretty decoded (non ASCII characters aren't percent encoded but the delimiters and '%' are),
+// a fully encoded id is ASCII, so UTF-8 covers both
+QString CoverImageProvider::fileNameFromId(const QString &id)
+{
+    return QUrl::fromPercentEncoding(id.toUtf8());
+}
+
+QQuickImageResponse *CoverImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    // a dimension that is not set in sourceSize doesn't constrain the cover
+    QSize size;
+    if (requestedSize.width() > 0 || requestedSize.height() > 0) {
+        size = QSize(qMax(0, requestedSize.width()), qMax(0, requestedSize.height()));
+    }
+
+    auto response = new CoverImageResponse(fileNameFromId(id), size);
+    coverPool()->start(response, visiblePriority);
+    return response;
+}
+
+CoverImageResponse::CoverImageResponse(const QString &fileName, const QSize &size)
+    : fileName(fileName), size(size), canceled(false)
+{
+    setAutoDelete(false);
+}
+
+QQuickTextureFactory *CoverImageResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(image);
+}
+
+void CoverImageResponse::cancel()
+{
+    canceled = true;
+}
+
+void CoverImageResponse::run()
+{
+    if (!canceled) {
+        image = CoverImageCache::instance().load(fileName, size);
+    }
+    emit finished();
+}
+
+CoverPrefetcher::CoverPrefetcher(QObject *parent)
+    : QObject(parent), generation(std::make_shared<QAtomicInteger<quint64>>(0))
+{
+}
+
+CoverPrefetcher::~CoverPrefetcher()
+{
+    generation->fetchAndAddOrdered(1);
+}
+
+void CoverPrefetcher::prefetch(QAbstractItemModel *model, int from, int count, const QSize &size)
+{
+    if (model == nullptr || size.isEmpty()) {
+        return;
+    }
+
+    int role = model->roleNames().key("cover_image", -1);
+    if (role == -1) {
+        return;
+    }
+
+    int to = qMin(model->rowCount(), from + count);
+    QStringList fileNames;
+    for (int row = qMax(0, from); row < to; row++) {
+        auto fileName = CoverImageProvider::fileName(model->data(model->index(row, 0), role).toUrl());
+        if (!fileName.isEmpty()) {
+            fileNames << fileName;
+        }
+    }
+
+    // views call it every time they scroll, most of the calls ask for the same covers
+    if (fileNames == lastFileNames && size == lastSize) {
+        return;
+    }
+    lastFileNames = fileNames;
+    lastSize = size;
+
+    quint64 current = generation->fetchAndAddOrdered(1) + 1;
+    for (const auto &fileName : std::as_const(fileNames)) {
+        if (CoverImageCache::instance().contains(fileName, size)) {
+            continue;
+        }
+
+        auto prefetchCover = [fileName, size, current, generation = generation] {
+            if (generation->loadAcquire() == current) {
+                CoverImageCache::instance().load(fileName, size);
+            }
+        };
+        coverPool()->start(prefetchCover, prefetchPriority);
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef COVER_IMAGE_PROVIDER_H
+#define COVER_IMAGE_PROVIDER_H
+
+#include <QAbstractItemModel>
+#include <QAtomicInteger>
+#include <QQuickAsyncImageProvider>
+#include <QRunnable>
+#include <QStringList>
+#include <QUrl>
+
+#include <atomic>
+#include <memory>
+
+// Serves the covers of the QML views from CoverImageCache as `image://cover/<percent encoded file path>`, the covers are
+// decoded in a pool of threads at the `sourceSize` of the Image (the box they have to fill, like PreserveAspectCrop).
+class CoverImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    static const QString id;
+    static QUrl url(const QString &fileName);
+    static QString fileName(const QUrl &url);
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+private:
+    static QString fileNameFromId(const QString &id);
+};
+
+class CoverImageResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    CoverImageResponse(const QString &fileName, const QSize &size);
+
+    QQuickTextureFactory *textureFactory() const override;
+    void cancel() override;
+    void run() override;
+
+private:
+    QString fileName;
+    QSize size;
+    QImage image;
+    std::atomic_bool canceled;
+};
+
+// Decodes the covers that are about to be shown. The QML views call it while they scroll with the rows of the next
+// screen in the scroll direction, each call replaces the covers that are still pending.
+class CoverPrefetcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CoverPrefetcher(QObject *parent = nullptr);
+    ~CoverPrefetcher() override;
+
+    // `size` is the size in pixels requested by the delegates, the URLs are read from the `cover_image` role of `model`
+    Q_INVOKABLE void prefetch(QAbstractItemModel *model, int from, int count, const QSize &size);
+
+private:
+    std::shared_ptr<QAtomicInteger<quint64>> generation; // prefetches from previous calls are skipped
+    QStringList lastFileNames;
+    QSize lastSize;
+};
+
+#endif // COVER_IMAGE_PROVIDER_H
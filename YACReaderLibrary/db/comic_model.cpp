@@ -4,25 +4,27 @@
 #include <QStringBuilder>
 #include <limits>
 
-#include "comic_item.h"
 #include "comic_model.h"
 #include "data_base_management.h"
+#include "library_queries.h"
 #include "qnaturalsorting.h"
 #include "comic_db.h"
 #include "db_helper.h"
 #include "reading_list_model.h"
+#include "cover_image_cache.h"
+#include "cover_image_provider.h"
 
 // ci.number,ci.title,c.fileName,ci.numPages,c.id,c.parentId,c.path,ci.hash,ci.read
 #include "QsLog.h"
 
-auto defaultFolderContentSortFunction = [](const ComicItem *c1, const ComicItem *c2) {
-    if (c1->data(ComicModel::Number).isNull() && c2->data(ComicModel::Number).isNull()) {
-        return naturalSortLessThanCI(c1->data(ComicModel::FileName).toString(), c2->data(ComicModel::FileName).toString());
+auto defaultFolderContentSortFunction = [](const ComicRows::Row &c1, const ComicRows::Row &c2) {
+    if (c1.data(ComicModel::Number).isNull() && c2.data(ComicModel::Number).isNull()) {
+        return naturalSortLessThanCI(c1.data(ComicModel::FileName).toString(), c2.data(ComicModel::FileName).toString());
     } else {
-        if (c1->data(ComicModel::Number).isNull() == false && c2->data(ComicModel::Number).isNull() == false) {
-            return naturalSortLessThanCI(c1->data(ComicModel::Number).toString(), c2->data(ComicModel::Number).toString());
+        if (c1.data(ComicModel::Number).isNull() == false && c2.data(ComicModel::Number).isNull() == false) {
+            return naturalSortLessThanCI(c1.data(ComicModel::Number).toString(), c2.data(ComicModel::Number).toString());
         } else {
-            return c2->data(ComicModel::Number).isNull();
+            return c2.data(ComicModel::Number).isNull();
         }
     }
 };
@@ -35,7 +37,6 @@ ComicModel::ComicModel(QObject *parent)
 
 ComicModel::~ComicModel()
 {
-    qDeleteAll(_data);
 }
 
 int ComicModel::columnCount(const QModelIndex &parent) const
@@ -43,7 +44,7 @@ int ComicModel::columnCount(const QModelIndex &parent) const
     Q_UNUSED(parent)
     if (_data.isEmpty())
         return 0;
-    return _data.first()->columnCount() + 1 /* + the number of calculated columns */;
+    return ComicRows::columnCount() + 1 /* + the number of calculated columns */;
 }
 
 bool ComicModel::canDropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) const
@@ -70,55 +71,34 @@ bool ComicModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int
 
     QList<qulonglong> comicIds = YACReader::mimeDataToComicsIds(data);
     QList<int> currentIndexes;
-    int i;
     foreach (qulonglong id, comicIds) {
-        i = 0;
-        foreach (ComicItem *item, _data) {
-            if (item->data(Id) == id) {
-                currentIndexes << i;
-                break;
-            }
-            i++;
-        }
+        int i = rowForId(id);
+        if (i != -1)
+            currentIndexes << i;
     }
 
     std::sort(currentIndexes.begin(), currentIndexes.end());
-    QList<ComicItem *> resortedData;
 
-    if (currentIndexes.contains(row)) // no resorting
+    if (currentIndexes.isEmpty() || currentIndexes.contains(row)) // no resorting
         return false;
 
-    ComicItem *destinationItem;
-    if (row == -1 || row >= _data.length())
-        destinationItem = 0;
-    else
-        destinationItem = _data.at(row);
+    bool moveToTheEnd = row == -1 || row >= _data.size();
 
     QList<int> newSorting;
 
-    i = 0;
-    foreach (ComicItem *item, _data) {
+    for (int i = 0; i < _data.size(); i++) {
         if (!currentIndexes.contains(i)) {
 
-            if (item == destinationItem) {
-                foreach (int index, currentIndexes) {
-                    resortedData << _data.at(index);
-                    newSorting << index;
-                }
+            if (!moveToTheEnd && i == row) {
+                newSorting << currentIndexes;
             }
 
-            resortedData << item;
             newSorting << i;
         }
-
-        i++;
     }
 
-    if (destinationItem == 0) {
-        foreach (int index, currentIndexes) {
-            resortedData << _data.at(index);
-            newSorting << index;
-        }
+    if (moveToTheEnd) {
+        newSorting << currentIndexes;
     }
 
     QLOG_TRACE() << newSorting;
@@ -126,38 +106,33 @@ bool ComicModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int
     int tempRow = row;
 
     if (tempRow < 0)
-        tempRow = _data.count();
+        tempRow = _data.size();
 
     foreach (qulonglong id, comicIds) {
-        int i = 0;
-        foreach (ComicItem *item, _data) {
-            if (item->data(Id) == id) {
-                beginMoveRows(parent, i, i, parent, tempRow);
+        int i = rowForId(id);
+        if (i != -1) {
+            beginMoveRows(parent, i, i, parent, tempRow);
 
-                bool skipElement = i == tempRow || i + 1 == tempRow;
-
-                if (!skipElement) {
-                    if (i > tempRow)
-                        _data.move(i, tempRow);
-                    else
-                        _data.move(i, tempRow - 1);
-                }
-
-                endMoveRows();
+            bool skipElement = i == tempRow || i + 1 == tempRow;
 
+            if (!skipElement) {
                 if (i > tempRow)
-                    tempRow++;
-
-                break;
+                    _data.move(i, tempRow);
+                else
+                    _data.move(i, tempRow - 1);
             }
-            i++;
+
+            endMoveRows();
+
+            if (i > tempRow)
+                tempRow++;
         }
     }
 
     // TODO fix selection
     QList<qulonglong> allComicIds;
-    foreach (ComicItem *item, _data) {
-        allComicIds << item->data(Id).toULongLong();
+    for (int i = 0; i < _data.size(); i++) {
+        allComicIds << _data.id(i);
     }
     QString connectionName = "";
     {
@@ -185,7 +160,7 @@ bool ComicModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int
     // endMoveRows();
 
     emit resortedIndexes(newSorting);
-    int destSelectedIndex = row < 0 ? _data.length() : row;
+    int destSelectedIndex = row < 0 ? _data.size() : row;
 
     if (destSelectedIndex > currentIndexes.at(0))
         emit newSelectedIndex(index(qMax(0, destSelectedIndex - 1), 0, parent));
@@ -245,6 +220,7 @@ QHash<int, QByteArray> ComicModel::roleNames() const
     roles[RatingRole] = "rating";
     roles[HasBeenOpenedRole] = "has_been_opened";
     roles[CoverPathRole] = "cover_path";
+    roles[CoverImageRole] = "cover_image";
     roles[PublicationDate] = "date";
     roles[ReadableTitle] = "readable_title";
     roles[AddedRole] = "added_date";
@@ -287,44 +263,46 @@ QVariant ComicModel::data(const QModelIndex &index, int role) const
     // TODO check here if any view is asking for TableModel::Roles
     // these roles will be used from QML/GridView
 
-    auto item = static_cast<ComicItem *>(index.internalPointer());
+    ComicRows::Row item(_data, index.row());
 
     auto sizeString = [=] {
-        return QString::number(item->data(ComicModel::Hash).toString().right(item->data(ComicModel::Hash).toString().length() - 40).toInt() / 1024.0 / 1024.0, 'f', 2) + "Mb";
+        return QString::number(item.data(ComicModel::Hash).toString().right(item.data(ComicModel::Hash).toString().length() - 40).toInt() / 1024.0 / 1024.0, 'f', 2) + "Mb";
     };
 
     if (role == NumberRole)
-        return item->data(Number);
+        return item.data(Number);
     else if (role == TitleRole)
-        return item->data(Title).isNull() ? item->data(FileName) : item->data(Title);
+        return item.data(Title).isNull() ? item.data(FileName) : item.data(Title);
     else if (role == ReadableTitle) {
         QString title;
-        if (!item->data(Number).isNull()) {
-            title = title % "#" % item->data(Number).toString() % " ";
+        if (!item.data(Number).isNull()) {
+            title = title % "#" % item.data(Number).toString() % " ";
         }
-        return QVariant(title % (item->data(Title).isNull() ? item->data(FileName).toString() : item->data(Title).toString()));
+        return QVariant(title % (item.data(Title).isNull() ? item.data(FileName).toString() : item.data(Title).toString()));
     } else if (role == FileNameRole)
-        return item->data(FileName);
+        return item.data(FileName);
     else if (role == RatingRole)
-        return item->data(Rating);
+        return item.data(Rating);
     else if (role == CoverPathRole)
-        return getCoverUrlPathForComicHash(item->data(Hash).toString());
+        return getCoverUrlPathForComicHash(item.data(Hash).toString());
+    else if (role == CoverImageRole)
+        return getCoverImageUrlForComicHash(item.data(Hash).toString());
     else if (role == NumPagesRole)
-        return item->data(NumPages);
+        return item.data(NumPages);
     else if (role == CurrentPageRole)
-        return item->data(CurrentPage);
+        return item.data(CurrentPage);
     else if (role == ReadColumnRole)
-        return item->data(ReadColumn).toBool();
+        return item.data(ReadColumn).toBool();
     else if (role == HasBeenOpenedRole)
-        return item->data(HasBeenOpened);
+        return item.data(HasBeenOpened);
     else if (role == IdRole)
-        return item->data(Id);
+        return item.data(Id);
     else if (role == PublicationDateRole)
-        return QVariant(localizedDate(item->data(PublicationDate).toString()));
+        return QVariant(localizedDate(item.data(PublicationDate).toString()));
     else if (role == AddedRole)
-        return item->data(Added);
+        return item.data(Added);
     else if (role == TypeRole)
-        return item->data(Type);
+        return item.data(Type);
     else if (role == ShowRecentRole)
         return showRecent;
     else if (role == RecentRangeRole)
@@ -332,32 +310,32 @@ QVariant ComicModel::data(const QModelIndex &index, int role) const
     else if (role == SizeRole)
         return sizeString();
     else if (role == SeriesRole)
-        return item->data(Series);
+        return item.data(Series);
     else if (role == VolumeRole)
-        return item->data(Volume);
+        return item.data(Volume);
     else if (role == StoryArcRole)
-        return item->data(StoryArc);
+        return item.data(StoryArc);
 
     if (role != Qt::DisplayRole)
         return QVariant();
 
     if (index.column() == ComicModel::Hash)
-        return item->data(ComicModel::Hash).toString();
+        return item.data(ComicModel::Hash).toString();
     if (index.column() == ComicModel::Size)
         return sizeString();
     if (index.column() == ComicModel::ReadColumn)
-        return (item->data(ComicModel::CurrentPage).toInt() == item->data(ComicModel::NumPages).toInt() || item->data(ComicModel::ReadColumn).toBool()) ? QVariant(tr("yes")) : QVariant(tr("no"));
+        return (item.data(ComicModel::CurrentPage).toInt() == item.data(ComicModel::NumPages).toInt() || item.data(ComicModel::ReadColumn).toBool()) ? QVariant(tr("yes")) : QVariant(tr("no"));
     if (index.column() == ComicModel::CurrentPage)
-        return item->data(ComicModel::HasBeenOpened).toBool() ? item->data(index.column()) : QVariant("-");
+        return item.data(ComicModel::HasBeenOpened).toBool() ? item.data(index.column()) : QVariant("-");
 
     if (index.column() == ComicModel::Rating)
         return QVariant();
 
     if (index.column() == ComicModel::PublicationDate) {
-        return QVariant(localizedDate(item->data(PublicationDate).toString()));
+        return QVariant(localizedDate(item.data(PublicationDate).toString()));
     }
 
-    return item->data(index.column());
+    return item.data(index.column());
 }
 
 Qt::ItemFlags ComicModel::flags(const QModelIndex &index) const
@@ -417,7 +395,7 @@ QVariant ComicModel::headerData(int section, Qt::Orientation orientation,
     }
 
     if (orientation == Qt::Vertical && role == Qt::DecorationRole) {
-        QString fileName = _data.value(section)->data(ComicModel::FileName).toString();
+        QString fileName = _data.value(section, ComicModel::FileName).toString();
         QFileInfo fi(fileName);
         QString ext = fi.suffix();
 
@@ -452,7 +430,7 @@ QModelIndex ComicModel::index(int row, int column, const QModelIndex &parent)
     if (!hasIndex(row, column, parent))
         return QModelIndex();
 
-    return createIndex(row, column, _data.at(row));
+    return createIndex(row, column);
 }
 
 QModelIndex ComicModel::parent(const QModelIndex &index) const
@@ -467,7 +445,7 @@ int ComicModel::rowCount(const QModelIndex &parent) const
         return 0;
 
     if (!parent.isValid())
-        return _data.count();
+        return _data.size();
 
     return 0;
 }
@@ -476,9 +454,8 @@ QStringList ComicModel::getPaths(const QString &_source)
 {
     QStringList paths;
     QString source = _source + "/.yacreaderlibrary/covers/";
-    QList<ComicItem *>::ConstIterator itr;
-    for (itr = _data.constBegin(); itr != _data.constEnd(); itr++) {
-        QString hash = (*itr)->data(ComicModel::Hash).toString();
+    for (int i = 0; i < _data.size(); i++) {
+        QString hash = _data.value(i, ComicModel::Hash).toString();
         paths << source + hash + ".jpg";
     }
 
@@ -487,17 +464,15 @@ QStringList ComicModel::getPaths(const QString &_source)
 
 #define COMIC_MODEL_QUERY_FIELDS "ci.number,ci.title,c.fileName,ci.numPages,c.id,c.parentId,c.path,ci.hash,ci.read,ci.currentPage,ci.rating,ci.hasBeenOpened,ci.date,ci.added,ci.type,ci.lastTimeOpened,ci.series,ci.volume,ci.storyArc"
 
-QList<ComicItem *> ComicModel::createFolderModelData(unsigned long long folderId, const QString &databasePath) const
+ComicRows ComicModel::createFolderModelData(unsigned long long folderId, const QString &databasePath) const
 {
-    QList<ComicItem *> modelData;
+    ComicRows modelData;
 
     QString connectionName = "";
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(databasePath);
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " "
-                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                            "WHERE c.parentId = :parentId");
+        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " " FOLDER_COMICS_FROM);
         selectQuery.bindValue(":parentId", folderId);
         selectQuery.exec();
 
@@ -517,7 +492,6 @@ void ComicModel::setupFolderModelData(unsigned long long int folderId, const QSt
     sourceId = folderId;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -527,19 +501,15 @@ void ComicModel::setupFolderModelData(unsigned long long int folderId, const QSt
     endResetModel();
 }
 
-QList<ComicItem *> ComicModel::createLabelModelData(unsigned long long parentLabel, const QString &databasePath) const
+ComicRows ComicModel::createLabelModelData(unsigned long long parentLabel, const QString &databasePath) const
 {
-    QList<ComicItem *> modelData;
+    ComicRows modelData;
 
     QString connectionName = "";
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(databasePath);
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " "
-                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                            "INNER JOIN comic_label cl ON (c.id == cl.comic_id) "
-                            "WHERE cl.label_id = :parentLabelId "
-                            "ORDER BY cl.ordering");
+        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " " LABEL_COMICS_FROM);
         selectQuery.bindValue(":parentLabelId", parentLabel);
         selectQuery.exec();
         modelData = createModelDataForList(selectQuery);
@@ -557,7 +527,6 @@ void ComicModel::setupLabelModelData(unsigned long long parentLabel, const QStri
     sourceId = parentLabel;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -567,9 +536,9 @@ void ComicModel::setupLabelModelData(unsigned long long parentLabel, const QStri
     endResetModel();
 }
 
-QList<ComicItem *> ComicModel::createReadingListData(unsigned long long parentReadingList, const QString &databasePath, bool &enableResorting) const
+ComicRows ComicModel::createReadingListData(unsigned long long parentReadingList, const QString &databasePath, bool &enableResorting) const
 {
-    QList<ComicItem *> modelData;
+    ComicRows modelData;
 
     QString connectionName = "";
     {
@@ -591,15 +560,11 @@ QList<ComicItem *> ComicModel::createReadingListData(unsigned long long parentRe
 
         foreach (qulonglong id, ids) {
             QSqlQuery selectQuery(db);
-            selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " "
-                                "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                                "INNER JOIN comic_reading_list crl ON (c.id == crl.comic_id) "
-                                "WHERE crl.reading_list_id = :parentReadingList "
-                                "ORDER BY crl.ordering");
+            selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " " READING_LIST_COMICS_FROM);
             selectQuery.bindValue(":parentReadingList", id);
             selectQuery.exec();
 
-            modelData << createModelDataForList(selectQuery);
+            modelData.append(selectQuery);
         }
         connectionName = db.connectionName();
     }
@@ -614,7 +579,6 @@ void ComicModel::setupReadingListModelData(unsigned long long parentReadingList,
     sourceId = parentReadingList;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -624,19 +588,15 @@ void ComicModel::setupReadingListModelData(unsigned long long parentReadingList,
     endResetModel();
 }
 
-QList<ComicItem *> ComicModel::createFavoritesModelData(const QString &databasePath) const
+ComicRows ComicModel::createFavoritesModelData(const QString &databasePath) const
 {
-    QList<ComicItem *> modelData;
+    ComicRows modelData;
 
     QString connectionName = "";
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(databasePath);
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " "
-                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                            "INNER JOIN comic_default_reading_list cdrl ON (c.id == cdrl.comic_id) "
-                            "WHERE cdrl.default_reading_list_id = :parentDefaultListId "
-                            "ORDER BY cdrl.ordering");
+        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " " DEFAULT_READING_LIST_COMICS_FROM);
         selectQuery.bindValue(":parentDefaultListId", 1);
         selectQuery.exec();
         modelData = createModelDataForList(selectQuery);
@@ -654,7 +614,6 @@ void ComicModel::setupFavoritesModelData(const QString &databasePath)
     sourceId = -1;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -664,18 +623,15 @@ void ComicModel::setupFavoritesModelData(const QString &databasePath)
     endResetModel();
 }
 
-QList<ComicItem *> ComicModel::createReadingModelData(const QString &databasePath) const
+ComicRows ComicModel::createReadingModelData(const QString &databasePath) const
 {
-    QList<ComicItem *> modelData;
+    ComicRows modelData;
 
     QString connectionName = "";
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(databasePath);
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " "
-                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                            "WHERE ci.hasBeenOpened = 1 AND ci.read = 0 "
-                            "ORDER BY ci.lastTimeOpened DESC");
+        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " " READING_COMICS_FROM);
         selectQuery.exec();
 
         modelData = createModelDataForList(selectQuery);
@@ -693,7 +649,6 @@ void ComicModel::setupReadingModelData(const QString &databasePath)
     sourceId = -1;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -703,18 +658,15 @@ void ComicModel::setupReadingModelData(const QString &databasePath)
     endResetModel();
 }
 
-QList<ComicItem *> ComicModel::createRecentModelData(const QString &databasePath) const
+ComicRows ComicModel::createRecentModelData(const QString &databasePath) const
 {
-    QList<ComicItem *> modelData;
+    ComicRows modelData;
 
     QString connectionName = "";
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(databasePath);
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " "
-                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                            "WHERE ci.added > :limit "
-                            "ORDER BY ci.added DESC");
+        selectQuery.prepare("SELECT " COMIC_MODEL_QUERY_FIELDS " " RECENT_COMICS_FROM);
         selectQuery.bindValue(":limit", QDateTime::currentDateTime().addDays(-recentDays).toSecsSinceEpoch());
         selectQuery.exec();
 
@@ -733,7 +685,6 @@ void ComicModel::setupRecentModelData(const QString &databasePath)
     sourceId = -1;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -743,7 +694,7 @@ void ComicModel::setupRecentModelData(const QString &databasePath)
     endResetModel();
 }
 
-void ComicModel::setModelData(QList<ComicItem *> *data, const QString &databasePath)
+void ComicModel::setModelData(ComicRows *data, const QString &databasePath)
 {
     enableResorting = false;
     mode = SearchResult;
@@ -753,15 +704,11 @@ void ComicModel::setModelData(QList<ComicItem *> *data, const QString &databaseP
 
     beginResetModel();
 
-    qDeleteAll(_data);
-
-    _data.clear();
-
-    _data.append(*data);
+    takeData(std::move(*data));
 
     endResetModel();
 
-    emit searchNumResults(_data.length());
+    emit searchNumResults(_data.size());
 
     delete data;
 }
@@ -769,55 +716,59 @@ void ComicModel::setModelData(QList<ComicItem *> *data, const QString &databaseP
 QString ComicModel::getComicPath(QModelIndex mi)
 {
     if (mi.isValid())
-        return _data.at(mi.row())->data(ComicModel::Path).toString();
+        return _data.value(mi.row(), ComicModel::Path).toString();
     return "";
 }
 
-QList<ComicItem *> ComicModel::createModelData(QSqlQuery &sqlquery) const
+ComicRows ComicModel::createModelData(QSqlQuery &sqlquery) const
 {
-    QList<ComicItem *> modelData;
-
-    int numColumns = sqlquery.record().count();
-
-    while (sqlquery.next()) {
-        QList<QVariant> data;
-
-        for (int i = 0; i < numColumns; i++)
-            data << sqlquery.value(i);
+    ComicRows modelData;
+    modelData.append(sqlquery);
 
-        modelData.append(new ComicItem(data));
-    }
-
-    std::sort(modelData.begin(), modelData.end(), defaultFolderContentSortFunction);
+    modelData.sort(defaultFolderContentSortFunction);
 
     return modelData;
 }
 
 // the sorting is done in the sql query
-QList<ComicItem *> ComicModel::createModelDataForList(QSqlQuery &sqlquery) const
+ComicRows ComicModel::createModelDataForList(QSqlQuery &sqlquery) const
 {
-    QList<ComicItem *> modelData;
+    ComicRows modelData;
+    modelData.append(sqlquery);
 
-    int numColumns = sqlquery.record().count();
+    return modelData;
+}
 
-    while (sqlquery.next()) {
-        QList<QVariant> data;
-        for (int i = 0; i < numColumns; i++)
-            data << sqlquery.value(i);
+// must be called between beginResetModel and endResetModel
+void ComicModel::takeData(ComicRows &&data)
+{
+    _data = std::move(data);
+}
 
-        modelData.append(new ComicItem(data));
+int ComicModel::rowForId(qulonglong id) const
+{
+    for (int i = 0; i < _data.size(); i++) {
+        if (_data.id(i) == id)
+            return i;
     }
+    return -1;
+}
 
-    return modelData;
+void ComicModel::insertRowAt(int row, const ComicRows &rows, int sourceRow)
+{
+    beginInsertRows(QModelIndex(), row, row);
+    _data.insert(row, rows, sourceRow);
+    endInsertRows();
 }
 
-void ComicModel::takeData(const QList<ComicItem *> &data)
+void ComicModel::removeRowAt(int row)
 {
-    qDeleteAll(_data);
-    _data = data;
+    beginRemoveRows(QModelIndex(), row, row);
+    _data.remove(row);
+    endRemoveRows();
 }
 
-void ComicModel::takeUpdatedData(const QList<ComicItem *> &updatedData, std::function<bool(ComicItem *, ComicItem *)> comparator)
+void ComicModel::takeUpdatedData(const ComicRows &updatedData, std::function<bool(const ComicRows::Row &, const ComicRows::Row &)> comparator)
 {
     int lenght = _data.size();
     int lenghtUpdated = updatedData.size();
@@ -825,16 +776,12 @@ void ComicModel::takeUpdatedData(const QList<ComicItem *> &updatedData, std::fun
     int i; // index of the internal data
     int j; // index of the updated children
     for (i = 0, j = 0; i < lenght && j < lenghtUpdated;) {
-        auto comic = _data.at(i);
-        auto updatedComic = updatedData.at(j);
-
-        auto sameComic = comic->data(ComicModel::Id) == updatedComic->data(ComicModel::Id);
+        auto sameComic = _data.id(i) == updatedData.id(j);
         if (sameComic) {
-            if (comic->getData() != updatedComic->getData()) {
-                auto modelIndexToUpdate = index(i, 0, QModelIndex());
-
-                comic->setData(updatedComic->getData());
+            if (!_data.sameValues(i, updatedData, j)) {
+                _data.replace(i, updatedData, j);
 
+                auto modelIndexToUpdate = index(i, 0, QModelIndex());
                 emit dataChanged(modelIndexToUpdate, modelIndexToUpdate);
             }
 
@@ -843,15 +790,11 @@ void ComicModel::takeUpdatedData(const QList<ComicItem *> &updatedData, std::fun
             continue;
         }
 
-        auto lessThan = comparator(comic, updatedComic);
+        auto lessThan = comparator(ComicRows::Row(_data, i), ComicRows::Row(updatedData, j));
 
         // comic added
         if (!lessThan) {
-            beginInsertRows(QModelIndex(), i, i);
-
-            _data.insert(i, updatedComic);
-
-            endInsertRows();
+            insertRowAt(i, updatedData, j);
 
             i++;
             j++;
@@ -861,11 +804,7 @@ void ComicModel::takeUpdatedData(const QList<ComicItem *> &updatedData, std::fun
 
         // comic removed
         if (lessThan) {
-            beginRemoveRows(QModelIndex(), i, i);
-
-            _data.removeAt(i);
-
-            endRemoveRows();
+            removeRowAt(i);
 
             lenght--;
             continue;
@@ -874,23 +813,16 @@ void ComicModel::takeUpdatedData(const QList<ComicItem *> &updatedData, std::fun
 
     // add remaining comics
     for (; j < lenghtUpdated; j++) {
-        beginInsertRows(QModelIndex(), i, i);
-
-        _data.append(updatedData.at(j));
-
-        endInsertRows();
+        insertRowAt(i, updatedData, j);
 
         i++;
     }
 
-    // remove remaining comics {
-    for (; i < lenght; i++) {
-        beginRemoveRows(QModelIndex(), i, i);
-
-        delete _data.at(i);
-        _data.removeAt(i);
+    // remove remaining comics
+    while (i < lenght) {
+        removeRowAt(i);
 
-        endRemoveRows();
+        lenght--;
     }
 }
 
@@ -901,7 +833,7 @@ ComicDB ComicModel::getComic(const QModelIndex &mi)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         bool found;
-        c = DBHelper::loadComic(_data.at(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+        c = DBHelper::loadComic(_data.id(mi.row()), db, found);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -916,7 +848,7 @@ ComicDB ComicModel::_getComic(const QModelIndex &mi)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         bool found;
-        c = DBHelper::loadComic(_data.at(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+        c = DBHelper::loadComic(_data.id(mi.row()), db, found);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -926,14 +858,14 @@ ComicDB ComicModel::_getComic(const QModelIndex &mi)
 
 QVector<YACReaderComicReadStatus> ComicModel::getReadList()
 {
-    int numComics = _data.count();
+    int numComics = _data.size();
     QVector<YACReaderComicReadStatus> readList(numComics);
     for (int i = 0; i < numComics; i++) {
-        if (_data.value(i)->data(ComicModel::ReadColumn).toBool())
+        if (_data.value(i, ComicModel::ReadColumn).toBool())
             readList[i] = YACReader::Read;
-        else if (_data.value(i)->data(ComicModel::CurrentPage).toInt() == _data.value(i)->data(ComicModel::NumPages).toInt())
+        else if (_data.value(i, ComicModel::CurrentPage).toInt() == _data.value(i, ComicModel::NumPages).toInt())
             readList[i] = YACReader::Read;
-        else if (_data.value(i)->data(ComicModel::HasBeenOpened).toBool())
+        else if (_data.value(i, ComicModel::HasBeenOpened).toBool())
             readList[i] = YACReader::Opened;
         else
             readList[i] = YACReader::Unread;
@@ -954,10 +886,10 @@ QList<ComicDB> ComicModel::getAllComics()
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         db.transaction();
 
-        int numComics = _data.count();
+        int numComics = _data.size();
         for (int i = 0; i < numComics; i++) {
             bool found;
-            comics.append(DBHelper::loadComic(_data.value(i)->data(ComicModel::Id).toULongLong(), db, found));
+            comics.append(DBHelper::loadComic(_data.id(i), db, found));
         }
 
         db.commit();
@@ -985,18 +917,18 @@ QVector<YACReaderComicReadStatus> ComicModel::setComicsRead(QList<QModelIndex> l
         db.transaction();
         foreach (QModelIndex mi, list) {
             if (read == YACReader::Read) {
-                _data.value(mi.row())->setData(ComicModel::ReadColumn, QVariant(true));
+                _data.setValue(mi.row(), ComicModel::ReadColumn, QVariant(true));
                 bool found;
-                ComicDB c = DBHelper::loadComic(_data.value(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+                ComicDB c = DBHelper::loadComic(_data.id(mi.row()), db, found);
                 c.info.read = true;
                 DBHelper::update(&(c.info), db);
             }
             if (read == YACReader::Unread) {
-                _data.value(mi.row())->setData(ComicModel::ReadColumn, QVariant(false));
-                _data.value(mi.row())->setData(ComicModel::CurrentPage, QVariant(1));
-                _data.value(mi.row())->setData(ComicModel::HasBeenOpened, QVariant(false));
+                _data.setValue(mi.row(), ComicModel::ReadColumn, QVariant(false));
+                _data.setValue(mi.row(), ComicModel::CurrentPage, QVariant(1));
+                _data.setValue(mi.row(), ComicModel::HasBeenOpened, QVariant(false));
                 bool found;
-                ComicDB c = DBHelper::loadComic(_data.value(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+                ComicDB c = DBHelper::loadComic(_data.id(mi.row()), db, found);
                 c.info.read = false;
                 c.info.currentPage = 1;
                 c.info.hasBeenOpened = false;
@@ -1022,7 +954,7 @@ void ComicModel::setComicsType(QList<QModelIndex> list, FileType type)
         db.transaction();
         foreach (QModelIndex mi, list) {
             bool found;
-            ComicDB c = DBHelper::loadComic(_data.value(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+            ComicDB c = DBHelper::loadComic(_data.id(mi.row()), db, found);
             c.info.type = QVariant::fromValue(type);
             DBHelper::update(&(c.info), db);
         }
@@ -1039,11 +971,11 @@ qint64 ComicModel::asignNumbers(QList<QModelIndex> list, int startingNumber)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         db.transaction();
-        idFirst = _data.value(list[0].row())->data(ComicModel::Id).toULongLong();
+        idFirst = _data.id(list[0].row());
         int i = 0;
         foreach (QModelIndex mi, list) {
             bool found;
-            ComicDB c = DBHelper::loadComic(_data.value(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+            ComicDB c = DBHelper::loadComic(_data.id(mi.row()), db, found);
             c.info.number = startingNumber + i;
             c.info.edited = true;
             DBHelper::update(&(c.info), db);
@@ -1059,15 +991,7 @@ qint64 ComicModel::asignNumbers(QList<QModelIndex> list, int startingNumber)
 }
 QModelIndex ComicModel::getIndexFromId(quint64 id)
 {
-    QList<ComicItem *>::ConstIterator itr;
-    int i = 0;
-    for (itr = _data.constBegin(); itr != _data.constEnd(); itr++) {
-        if ((*itr)->data(ComicModel::Id).toULongLong() == id)
-            break;
-        i++;
-    }
-
-    return index(i, 0);
+    return index(rowForId(id), 0);
 }
 
 // TODO completely inefficiently
@@ -1100,16 +1024,11 @@ void ComicModel::removeInTransaction(int row)
 {
     auto dbTransaction = QSqlDatabase::database(_databaseConnection);
     bool found;
-    ComicDB c = DBHelper::loadComic(_data.at(row)->data(ComicModel::Id).toULongLong(), dbTransaction, found);
+    ComicDB c = DBHelper::loadComic(_data.id(row), dbTransaction, found);
 
     DBHelper::removeFromDB(&c, dbTransaction);
-    beginRemoveRows(QModelIndex(), row, row);
-
-    removeRow(row);
-    delete _data.at(row);
-    _data.removeAt(row);
 
-    endRemoveRows();
+    removeRowAt(row);
 }
 
 void ComicModel::reloadContinueReading()
@@ -1128,13 +1047,13 @@ void ComicModel::reload()
         setupFavoritesModelData(_databasePath); // TODO we need a comparator
         break;
     case Reading:
-        takeUpdatedData(createReadingModelData(_databasePath), [](const ComicItem *c1, const ComicItem *c2) {
-            return c1->data(ComicModel::LastTimeOpened).toDateTime() > c2->data(ComicModel::LastTimeOpened).toDateTime();
+        takeUpdatedData(createReadingModelData(_databasePath), [](const ComicRows::Row &c1, const ComicRows::Row &c2) {
+            return c1.data(ComicModel::LastTimeOpened).toDateTime() > c2.data(ComicModel::LastTimeOpened).toDateTime();
         });
         break;
     case Recent:
-        takeUpdatedData(createRecentModelData(_databasePath), [](const ComicItem *c1, const ComicItem *c2) {
-            return c1->data(ComicModel::Added).toDateTime() > c2->data(ComicModel::Added).toDateTime();
+        takeUpdatedData(createRecentModelData(_databasePath), [](const ComicRows::Row &c1, const ComicRows::Row &c2) {
+            return c1.data(ComicModel::Added).toDateTime() > c2.data(ComicModel::Added).toDateTime();
         });
         break;
     case Label:
@@ -1156,20 +1075,13 @@ void ComicModel::remove(int row)
 
 void ComicModel::reload(const ComicDB &comic)
 {
-    int row = 0;
-    bool found = false;
-    foreach (ComicItem *item, _data) {
-        if (item->data(ComicModel::Id).toULongLong() == comic.id) {
-            found = true;
-            item->setData(ComicModel::ReadColumn, comic.info.read);
-            item->setData(ComicModel::CurrentPage, comic.info.currentPage);
-            item->setData(ComicModel::HasBeenOpened, true);
-            break;
-        }
-        row++;
-    }
-    if (found)
+    int row = rowForId(comic.id);
+    if (row != -1) {
+        _data.setValue(row, ComicModel::ReadColumn, comic.info.read);
+        _data.setValue(row, ComicModel::CurrentPage, comic.info.currentPage);
+        _data.setValue(row, ComicModel::HasBeenOpened, true);
         emit dataChanged(index(row, ReadColumn), index(row, HasBeenOpened), QVector<int>() << ReadColumnRole << CurrentPageRole << HasBeenOpenedRole);
+    }
 }
 
 void ComicModel::resetComicRating(const QModelIndex &mi)
@@ -1180,7 +1092,7 @@ void ComicModel::resetComicRating(const QModelIndex &mi)
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
 
         comic.info.rating = 0;
-        _data[mi.row()]->setData(ComicModel::Rating, 0);
+        _data.setValue(mi.row(), ComicModel::Rating, 0);
         DBHelper::update(&(comic.info), db);
 
         emit dataChanged(mi, mi);
@@ -1191,19 +1103,19 @@ void ComicModel::resetComicRating(const QModelIndex &mi)
 
 void ComicModel::notifyCoverChange(const ComicDB &comic)
 {
-    auto it = std::find_if(_data.begin(), _data.end(), [comic](ComicItem *item) { return item->data(ComicModel::Id).toULongLong() == comic.id; });
-    auto itemIndex = std::distance(_data.begin(), it);
-    auto item = _data[itemIndex];
+    CoverImageCache::instance().remove(_databasePath + "/covers/" + comic.info.hash + ".jpg");
+
+    auto itemIndex = rowForId(comic.id);
+    if (itemIndex == -1)
+        return;
+
+    ComicRows item;
+    item.append(_data, itemIndex);
 
     // emiting a dataChage doesn't work in QML for some reason, CoverPathRole is requested but the view doesn't update the image
     // removing and reading again works with the flow views without any additional code, but it's not the best solution
-    beginRemoveRows(QModelIndex(), itemIndex, itemIndex);
-    _data.removeAt(itemIndex);
-    endRemoveRows();
-
-    beginInsertRows(QModelIndex(), itemIndex, itemIndex);
-    _data.insert(itemIndex, item);
-    endInsertRows();
+    removeRowAt(itemIndex);
+    insertRowAt(itemIndex, item, 0);
 
     // this doesn't work in QML -> emit dataChanged(index(itemIndex, 0), index(itemIndex, 0), QVector<int>() << CoverPathRole);
 }
@@ -1214,6 +1126,11 @@ QUrl ComicModel::getCoverUrlPathForComicHash(const QString &hash) const
     return QUrl::fromLocalFile(_databasePath + "/covers/" + hash + ".jpg");
 }
 
+QUrl ComicModel::getCoverImageUrlForComicHash(const QString &hash) const
+{
+    return CoverImageProvider::url(_databasePath + "/covers/" + hash + ".jpg");
+}
+
 void ComicModel::addComicsToFavorites(const QList<qulonglong> &comicIds)
 {
     addComicsToFavorites(getIndexesFromIds(comicIds));
@@ -1352,10 +1269,7 @@ void ComicModel::deleteComicsFromModel(const QList<QModelIndex> &comicsList)
     QListIterator<QModelIndex> it(comicsList);
     it.toBack();
     while (it.hasPrevious()) {
-        int row = it.previous().row();
-        beginRemoveRows(QModelIndex(), row, row);
-        _data.removeAt(row);
-        endRemoveRows();
+        removeRowAt(it.previous().row());
     }
 
     if (_data.isEmpty())
@@ -1369,7 +1283,7 @@ bool ComicModel::isFavorite(const QModelIndex &index)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
 
-        isFavorite = DBHelper::isFavoriteComic(_data[index.row()]->data(Id).toLongLong(), db);
+        isFavorite = DBHelper::isFavoriteComic(_data.id(index.row()), db);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -1409,7 +1323,7 @@ void ComicModel::updateRating(int rating, QModelIndex mi)
         // TODO optimize update
 
         comic.info.rating = rating;
-        _data[mi.row()]->setData(ComicModel::Rating, rating);
+        _data.setValue(mi.row(), ComicModel::Rating, rating);
         DBHelper::update(&(comic.info), db);
 
         emit dataChanged(mi, mi);
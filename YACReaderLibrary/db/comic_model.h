@@ -9,11 +9,10 @@
 #include <QUrl>
 
 #include "yacreader_global_gui.h"
+#include "comic_rows.h"
 
 class ComicDB;
 
-class ComicItem;
-
 using namespace YACReader;
 
 class ComicModel : public QAbstractItemModel
@@ -71,6 +70,7 @@ public:
         SeriesRole,
         VolumeRole,
         StoryArcRole,
+        CoverImageRole,
     };
 
     enum Mode {
@@ -136,6 +136,8 @@ public:
     void notifyCoverChange(const ComicDB &comic);
 
     Q_INVOKABLE QUrl getCoverUrlPathForComicHash(const QString &hash) const;
+    // cover served by CoverImageProvider, used by the QML views
+    Q_INVOKABLE QUrl getCoverImageUrlForComicHash(const QString &hash) const;
 
     void addComicsToFavorites(const QList<QModelIndex> &comicsList);
     void addComicsToLabel(const QList<QModelIndex> &comicsList, qulonglong labelId);
@@ -169,24 +171,27 @@ public slots:
     void addComicsToLabel(const QList<qulonglong> &comicIds, qulonglong labelId);
     void addComicsToReadingList(const QList<qulonglong> &comicIds, qulonglong readingListId);
 
-    void setModelData(QList<ComicItem *> *data, const QString &databasePath);
+    void setModelData(ComicRows *data, const QString &databasePath);
 
 protected:
 private:
-    QList<ComicItem *> createModelData(QSqlQuery &sqlquery) const;
-    QList<ComicItem *> createModelDataForList(QSqlQuery &sqlquery) const;
-
-    QList<ComicItem *> createFolderModelData(unsigned long long parentLabel, const QString &databasePath) const;
-    QList<ComicItem *> createLabelModelData(unsigned long long parentLabel, const QString &databasePath) const;
-    QList<ComicItem *> createReadingListData(unsigned long long parentReadingList, const QString &databasePath, bool &enableResorting) const;
-    QList<ComicItem *> createFavoritesModelData(const QString &databasePath) const;
-    QList<ComicItem *> createReadingModelData(const QString &databasePath) const;
-    QList<ComicItem *> createRecentModelData(const QString &databasePath) const;
-
-    void takeData(const QList<ComicItem *> &data);
-    void takeUpdatedData(const QList<ComicItem *> &updatedData, std::function<bool(ComicItem *, ComicItem *)> comparator);
+    ComicRows createModelData(QSqlQuery &sqlquery) const;
+    ComicRows createModelDataForList(QSqlQuery &sqlquery) const;
+
+    ComicRows createFolderModelData(unsigned long long parentLabel, const QString &databasePath) const;
+    ComicRows createLabelModelData(unsigned long long parentLabel, const QString &databasePath) const;
+    ComicRows createReadingListData(unsigned long long parentReadingList, const QString &databasePath, bool &enableResorting) const;
+    ComicRows createFavoritesModelData(const QString &databasePath) const;
+    ComicRows createReadingModelData(const QString &databasePath) const;
+    ComicRows createRecentModelData(const QString &databasePath) const;
+
+    void takeData(ComicRows &&data);
+    void takeUpdatedData(const ComicRows &updatedData, std::function<bool(const ComicRows::Row &, const ComicRows::Row &)> comparator);
+    int rowForId(qulonglong id) const;
+    void insertRowAt(int row, const ComicRows &rows, int sourceRow);
+    void removeRowAt(int row);
     ComicDB _getComic(const QModelIndex &mi);
-    QList<ComicItem *> _data;
+    ComicRows _data;
 
     QString _databasePath;
     QString _databaseConnection;
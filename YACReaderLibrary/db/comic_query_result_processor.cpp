@@ -1,6 +1,5 @@
 #include "comic_query_result_processor.h"
 
-#include "comic_item.h"
 #include "comic_model.h"
 #include "data_base_management.h"
 #include "qnaturalsorting.h"
@@ -36,32 +35,22 @@ void YACReader::ComicQueryResultProcessor::createModelData(const QString &filter
     });
 }
 
-QList<ComicItem *> *YACReader::ComicQueryResultProcessor::modelData(QSqlQuery &sqlquery)
+ComicRows *YACReader::ComicQueryResultProcessor::modelData(QSqlQuery &sqlquery)
 {
-    auto list = new QList<ComicItem *>();
+    auto rows = new ComicRows();
+    rows->append(sqlquery);
 
-    int numColumns = sqlquery.record().count();
-
-    while (sqlquery.next()) {
-        QList<QVariant> data;
-
-        for (int i = 0; i < numColumns; i++)
-            data << sqlquery.value(i);
-
-        list->append(new ComicItem(data));
-    }
-
-    std::sort(list->begin(), list->end(), [](const ComicItem *c1, const ComicItem *c2) {
-        if (c1->data(ComicModel::Number).isNull() && c2->data(ComicModel::Number).isNull()) {
-            return naturalSortLessThanCI(c1->data(ComicModel::FileName).toString(), c2->data(ComicModel::FileName).toString());
+    rows->sort([](const ComicRows::Row &c1, const ComicRows::Row &c2) {
+        if (c1.data(ComicModel::Number).isNull() && c2.data(ComicModel::Number).isNull()) {
+            return naturalSortLessThanCI(c1.data(ComicModel::FileName).toString(), c2.data(ComicModel::FileName).toString());
         } else {
-            if (c1->data(ComicModel::Number).isNull() == false && c2->data(ComicModel::Number).isNull() == false) {
-                return c1->data(ComicModel::Number).toInt() < c2->data(ComicModel::Number).toInt();
+            if (c1.data(ComicModel::Number).isNull() == false && c2.data(ComicModel::Number).isNull() == false) {
+                return c1.data(ComicModel::Number).toInt() < c2.data(ComicModel::Number).toInt();
             } else {
-                return c2->data(ComicModel::Number).isNull();
+                return c2.data(ComicModel::Number).isNull();
             }
         }
     });
 
-    return list;
+    return rows;
 }
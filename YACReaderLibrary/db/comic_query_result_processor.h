@@ -7,7 +7,7 @@
 #include "yacreader_global.h"
 #include "concurrent_queue.h"
 
-class ComicItem;
+class ComicRows;
 
 namespace YACReader {
 
@@ -20,12 +20,12 @@ public:
 public slots:
     void createModelData(const QString &filter, const QString &databasePath);
 signals:
-    void newData(QList<ComicItem *> *, const QString &);
+    void newData(ComicRows *, const QString &);
 
 private:
     ConcurrentQueue querySearchQueue;
 
-    static QList<ComicItem *> *modelData(QSqlQuery &sqlquery);
+    static ComicRows *modelData(QSqlQuery &sqlquery);
 };
 };
 
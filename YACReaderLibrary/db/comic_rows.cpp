@@ -0,0 +1,265 @@
+#include "comic_rows.h"
+
+#include "comic_model.h"
+
+#include <QSqlRecord>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+namespace {
+const qint64 nullInteger = std::numeric_limits<qint64>::min();
+}
+
+ComicRows::ComicRows()
+{
+    int numTexts = 0, numIntegers = 0, numReals = 0;
+    for (const auto &column : columns()) {
+        switch (column.kind) {
+        case Kind::Text:
+        case Kind::SharedText:
+            numTexts++;
+            break;
+        case Kind::Integer:
+            numIntegers++;
+            break;
+        case Kind::Real:
+            numReals++;
+            break;
+        case Kind::Id:
+            break;
+        }
+    }
+
+    texts.resize(numTexts);
+    integers.resize(numIntegers);
+    reals.resize(numReals);
+}
+
+// in the same order as ComicModel::Columns
+const QVector<ComicRows::ColumnDescription> &ComicRows::columns()
+{
+    static const QVector<ColumnDescription> columns = {
+        { "number", Kind::SharedText, 0 },
+        { "title", Kind::Text, 1 },
+        { "fileName", Kind::Text, 2 },
+        { "numPages", Kind::Integer, 0 },
+        { "id", Kind::Id, 0 },
+        { "parentId", Kind::Integer, 1 },
+        { "path", Kind::Text, 3 },
+        { "hash", Kind::Text, 4 },
+        { "read", Kind::Integer, 2 },
+        { "currentPage", Kind::Integer, 3 },
+        { "rating", Kind::Real, 0 },
+        { "hasBeenOpened", Kind::Integer, 4 },
+        { "date", Kind::SharedText, 5 },
+        { "added", Kind::Integer, 5 },
+        { "type", Kind::Integer, 6 },
+        { "lastTimeOpened", Kind::Integer, 7 },
+        { "series", Kind::SharedText, 6 },
+        { "volume", Kind::SharedText, 7 },
+        { "storyArc", Kind::SharedText, 8 },
+    };
+    static_assert(ComicModel::StoryArc + 1 == 19, "ComicRows::columns() must describe every ComicModel column");
+
+    return columns;
+}
+
+int ComicRows::columnCount()
+{
+    return columns().size();
+}
+
+QString ComicRows::shared(const QString &text)
+{
+    if (text.isNull())
+        return text;
+
+    auto it = sharedTexts.constFind(text);
+    if (it != sharedTexts.constEnd())
+        return it.value();
+
+    sharedTexts.insert(text, text);
+    return text;
+}
+
+template<typename Function>
+void ComicRows::forEachColumn(Function function)
+{
+    function(ids);
+    for (auto &column : texts)
+        function(column);
+    for (auto &column : integers)
+        function(column);
+    for (auto &column : reals)
+        function(column);
+}
+
+void ComicRows::append(QSqlQuery &query)
+{
+    const auto &descriptions = columns();
+    auto record = query.record();
+    QVector<int> fieldIndexes;
+    for (const auto &column : descriptions)
+        fieldIndexes << record.indexOf(column.field);
+
+    while (query.next()) {
+        for (int i = 0; i < descriptions.size(); i++) {
+            const auto &column = descriptions.at(i);
+            QVariant value = fieldIndexes.at(i) >= 0 ? query.value(fieldIndexes.at(i)) : QVariant();
+            switch (column.kind) {
+            case Kind::Text:
+                texts[column.slot].append(value.isNull() ? QString() : value.toString());
+                break;
+            case Kind::SharedText:
+                texts[column.slot].append(value.isNull() ? QString() : shared(value.toString()));
+                break;
+            case Kind::Integer:
+                integers[column.slot].append(value.isNull() ? nullInteger : value.toLongLong());
+                break;
+            case Kind::Real:
+                reals[column.slot].append(value.isNull() ? std::nan("") : value.toDouble());
+                break;
+            case Kind::Id:
+                ids.append(value.toULongLong());
+                break;
+            }
+        }
+    }
+}
+
+void ComicRows::append(const ComicRows &other, int otherRow)
+{
+    insert(size(), other, otherRow);
+}
+
+void ComicRows::insert(int row, const ComicRows &other, int otherRow)
+{
+    ids.insert(row, other.ids.at(otherRow));
+    for (int i = 0; i < texts.size(); i++)
+        texts[i].insert(row, other.texts.at(i).at(otherRow));
+    for (int i = 0; i < integers.size(); i++)
+        integers[i].insert(row, other.integers.at(i).at(otherRow));
+    for (int i = 0; i < reals.size(); i++)
+        reals[i].insert(row, other.reals.at(i).at(otherRow));
+}
+
+void ComicRows::replace(int row, const ComicRows &other, int otherRow)
+{
+    ids[row] = other.ids.at(otherRow);
+    for (int i = 0; i < texts.size(); i++)
+        texts[i][row] = other.texts.at(i).at(otherRow);
+    for (int i = 0; i < integers.size(); i++)
+        integers[i][row] = other.integers.at(i).at(otherRow);
+    for (int i = 0; i < reals.size(); i++)
+        reals[i][row] = other.reals.at(i).at(otherRow);
+}
+
+void ComicRows::remove(int row)
+{
+    forEachColumn([row](auto &column) { column.remove(row); });
+}
+
+void ComicRows::move(int from, int to)
+{
+    if (from == to)
+        return;
+
+    forEachColumn([from, to](auto &column) {
+        if (from < to)
+            std::rotate(column.begin() + from, column.begin() + from + 1, column.begin() + to + 1);
+        else
+            std::rotate(column.begin() + to, column.begin() + from, column.begin() + from + 1);
+    });
+}
+
+void ComicRows::clear()
+{
+    forEachColumn([](auto &column) { column.clear(); });
+    sharedTexts.clear();
+}
+
+QVariant ComicRows::value(int row, int column) const
+{
+    if (row < 0 || row >= size() || column < 0 || column >= columnCount())
+        return QVariant();
+
+    const auto &description = columns().at(column);
+    switch (description.kind) {
+    case Kind::Text:
+    case Kind::SharedText: {
+        const auto &text = texts.at(description.slot).at(row);
+        return text.isNull() ? QVariant() : QVariant(text);
+    }
+    case Kind::Integer: {
+        auto integer = integers.at(description.slot).at(row);
+        return integer == nullInteger ? QVariant() : QVariant(integer);
+    }
+    case Kind::Real: {
+        auto real = reals.at(description.slot).at(row);
+        return std::isnan(real) ? QVariant() : QVariant(real);
+    }
+    case Kind::Id:
+        return QVariant(qlonglong(ids.at(row)));
+    }
+
+    return QVariant();
+}
+
+void ComicRows::setValue(int row, int column, const QVariant &value)
+{
+    const auto &description = columns().at(column);
+    switch (description.kind) {
+    case Kind::Text:
+        texts[description.slot][row] = value.isNull() ? QString() : value.toString();
+        break;
+    case Kind::SharedText:
+        texts[description.slot][row] = value.isNull() ? QString() : shared(value.toString());
+        break;
+    case Kind::Integer:
+        integers[description.slot][row] = value.isNull() ? nullInteger : value.toLongLong();
+        break;
+    case Kind::Real:
+        reals[description.slot][row] = value.isNull() ? std::nan("") : value.toDouble();
+        break;
+    case Kind::Id:
+        ids[row] = value.toULongLong();
+        break;
+    }
+}
+
+bool ComicRows::sameValues(int row, const ComicRows &other, int otherRow) const
+{
+    if (ids.at(row) != other.ids.at(otherRow))
+        return false;
+    for (int i = 0; i < texts.size(); i++)
+        if (texts.at(i).at(row) != other.texts.at(i).at(otherRow) || texts.at(i).at(row).isNull() != other.texts.at(i).at(otherRow).isNull())
+            return false;
+    for (int i = 0; i < integers.size(); i++)
+        if (integers.at(i).at(row) != other.integers.at(i).at(otherRow))
+            return false;
+    for (int i = 0; i < reals.size(); i++) {
+        auto a = reals.at(i).at(row), b = other.reals.at(i).at(otherRow);
+        if (a != b && !(std::isnan(a) && std::isnan(b)))
+            return false;
+    }
+    return true;
+}
+
+void ComicRows::sort(const std::function<bool(const Row &, const Row &)> &lessThan)
+{
+    QVector<int> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return lessThan(Row(*this, a), Row(*this, b)); });
+
+    forEachColumn([&order](auto &column) {
+        std::remove_reference_t<decltype(column)> sorted;
+        sorted.reserve(column.size());
+        for (int i : order)
+            sorted.append(column.at(i));
+        column = sorted;
+    });
+}
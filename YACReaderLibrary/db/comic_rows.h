@@ -0,0 +1,80 @@
+#ifndef COMIC_ROWS_H
+#define COMIC_ROWS_H
+
+#include <QHash>
+#include <QSqlQuery>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+
+// Rows shown by ComicModel, stored by column (see ComicModel::Columns).
+// Each column is a typed vector, SQL NULLs are preserved and the strings that repeat a lot
+// between comics (series, volume, story arc, date) share their data.
+class ComicRows
+{
+public:
+    // read only view of a row, used by the sorting functions
+    class Row
+    {
+    public:
+        Row(const ComicRows &rows, int row)
+            : rows(&rows), row(row) { }
+        QVariant data(int column) const { return rows->value(row, column); }
+
+    private:
+        const ComicRows *rows;
+        int row;
+    };
+
+    ComicRows();
+
+    static int columnCount();
+    int size() const { return ids.size(); }
+    bool isEmpty() const { return ids.isEmpty(); }
+
+    // appends the rows returned by the query, the columns are found by name so queries that don't select all the fields can be used
+    void append(QSqlQuery &query);
+    void append(const ComicRows &other, int otherRow);
+    void insert(int row, const ComicRows &other, int otherRow);
+    void replace(int row, const ComicRows &other, int otherRow);
+    void remove(int row);
+    // same semantics as QList::move
+    void move(int from, int to);
+    void clear();
+
+    QVariant value(int row, int column) const;
+    void setValue(int row, int column, const QVariant &value);
+    qulonglong id(int row) const { return ids.at(row); }
+    bool sameValues(int row, const ComicRows &other, int otherRow) const;
+
+    void sort(const std::function<bool(const Row &, const Row &)> &lessThan);
+
+private:
+    enum class Kind { Text,
+                      SharedText,
+                      Integer,
+                      Real,
+                      Id };
+    struct ColumnDescription {
+        const char *field;
+        Kind kind;
+        int slot; // position in the vectors of its kind
+    };
+    static const QVector<ColumnDescription> &columns();
+
+    QString shared(const QString &text);
+    template<typename Function>
+    void forEachColumn(Function function);
+
+    QVector<qulonglong> ids;
+    QVector<QVector<QString>> texts;
+    QVector<QVector<qint64>> integers;
+    QVector<QVector<double>> reals;
+    QHash<QString, QString> sharedTexts;
+};
+
+Q_DECLARE_METATYPE(ComicRows *)
+
+#endif // COMIC_ROWS_H
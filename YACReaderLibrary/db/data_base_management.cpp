@@ -4,83 +4,20 @@
 #include "initial_comic_info_extractor.h"
 #include "check_new_version.h"
 #include "db_helper.h"
+#include "library_indexes.h"
+#include "library_queries.h"
+#include "library_schema.h"
 
 #include "QsLog.h"
 
+#include <limits>
+
 using namespace YACReader;
 
-static QString fields = "title,"
-
-                        "coverPage,"
-                        "numPages,"
-
-                        "number,"
-                        "isBis,"
-                        "count,"
-
-                        "volume,"
-                        "storyArc,"
-                        "arcNumber,"
-                        "arcCount,"
-
-                        "genere,"
-
-                        "writer,"
-                        "penciller,"
-                        "inker,"
-                        "colorist,"
-                        "letterer,"
-                        "coverArtist,"
-
-                        "date,"
-                        "publisher,"
-                        "format,"
-                        "color,"
-                        "ageRating,"
-
-                        "synopsis,"
-                        "characters,"
-                        "notes,"
-
-                        "hash,"
-                        "edited,"
-                        "read,"
-
-                        "comicVineID,"
-
-                        "hasBeenOpened,"
-                        "rating,"
-                        "currentPage,"
-                        "bookmark1,"
-                        "bookmark2,"
-                        "bookmark3,"
-                        "brightness,"
-                        "contrast,"
-                        "gamma,"
-                        // new 7.1 fields
-                        "comicVineID,"
-                        // new 9.5 fields
-                        "lastTimeOpened,"
-                        //"coverSizeRatio," cover may have changed since the info was exported...
-                        //"originalCoverSize," // h/w
-                        // new 9.8 fields
-                        // "manga," //removed in 9.13
-                        // new 9.13 fields
-                        "added,"
-                        "type,"
-                        "editor,"
-                        "imprint,"
-                        "teams,"
-                        "locations,"
-                        "series,"
-                        "alternateSeries,"
-                        "alternateNumber,"
-                        "alternateCount,"
-                        "languageISO,"
-                        "seriesGroup,"
-                        "mainCharacterOrTeam,"
-                        "review,"
-                        "tags";
+namespace {
+// comic_info fields carried by the comics info packs besides hash and edited
+const QStringList infoFields = comicsInfoFields();
+}
 
 DataBaseManagement::DataBaseManagement()
     : QObject(), dataBasesList()
@@ -94,6 +31,9 @@ QSqlDatabase DataBaseManagement::createDatabase(QString name, QString path)
 
 QSqlDatabase DataBaseManagement::createDatabase(QString dest)
 {
+    // pooled connections could be pointing to a database that has been replaced
+    invalidatePooledDatabases();
+
     QString threadId = QString::number((long long)QThread::currentThreadId(), 16);
     QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", dest + threadId);
     db.setDatabaseName(dest);
@@ -154,6 +94,119 @@ QSqlDatabase DataBaseManagement::loadDatabaseFromFile(QString filePath)
     return db;
 }
 
+namespace {
+// connections pooled by one thread, QThreadStorage deletes them when the thread finishes
+struct PooledConnections {
+    int generation = 0;
+    QHash<QString, QString> connectionNames; // database path -> connection name
+    QHash<QString, QHash<QString, std::shared_ptr<QSqlQuery>>> statements; // connection name -> sql -> prepared query
+
+    void close(const QString &path)
+    {
+        auto connectionName = connectionNames.take(path);
+        statements.remove(connectionName);
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+
+    void close()
+    {
+        statements.clear();
+        for (const auto &connectionName : std::as_const(connectionNames)) {
+            QSqlDatabase::removeDatabase(connectionName);
+        }
+        connectionNames.clear();
+    }
+
+    ~PooledConnections()
+    {
+        close();
+    }
+};
+
+QThreadStorage<PooledConnections *> pooledConnections;
+QAtomicInt pooledConnectionsGeneration;
+const QString pooledConnectionPrefix = "pooled:";
+}
+
+QSqlDatabase DataBaseManagement::pooledDatabase(const QString &path)
+{
+    if (!pooledConnections.hasLocalData()) {
+        pooledConnections.setLocalData(new PooledConnections);
+    }
+    auto connections = pooledConnections.localData();
+
+    int generation = pooledConnectionsGeneration.loadAcquire();
+    if (connections->generation != generation) {
+        connections->close();
+        connections->generation = generation;
+    }
+
+    if (!QFile::exists(path + "/library.ydb")) {
+        if (connections->connectionNames.contains(path)) {
+            connections->close(path);
+        }
+        return QSqlDatabase();
+    }
+
+    auto connectionName = connections->connectionNames.value(path);
+    if (!connectionName.isEmpty()) {
+        return QSqlDatabase::database(connectionName, false);
+    }
+
+    QString threadId = QString::number((long long)QThread::currentThreadId(), 16);
+    connectionName = pooledConnectionPrefix + path + threadId;
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(path + "/library.ydb");
+    if (!db.open()) {
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+        return QSqlDatabase();
+    }
+
+    QSettings settings(YACReader::getSettingsPath() + "/YACReaderLibrary.ini", QSettings::IniFormat);
+    settings.beginGroup("libraryConfig");
+
+    QSqlQuery pragma(db);
+    pragma.exec("PRAGMA foreign_keys = ON");
+    // WAL lets the readers work while the library is being written. It is kept in the file and its shared memory index
+    // doesn't work across machines, so libraries in network drives always use (or go back to) the rollback journal
+    bool wal = settings.value(DB_WAL_JOURNAL, true).toBool() && !YACReader::isNetworkFileSystem(path);
+    pragma.exec(QString("PRAGMA journal_mode = %1").arg(wal ? "WAL" : "DELETE"));
+    pragma.exec(QString("PRAGMA cache_size = -%1").arg(settings.value(DB_CACHE_SIZE, 8).toLongLong() * 1024));
+    pragma.exec(QString("PRAGMA mmap_size = %1").arg(settings.value(DB_MMAP_SIZE, 64).toLongLong() * 1024 * 1024));
+    pragma.finish();
+
+    connections->connectionNames.insert(path, connectionName);
+    return db;
+}
+
+std::shared_ptr<QSqlQuery> DataBaseManagement::pooledQuery(const QSqlDatabase &db, const QString &sql)
+{
+    auto connectionName = db.connectionName();
+    if (!connectionName.startsWith(pooledConnectionPrefix) || !pooledConnections.hasLocalData()) {
+        auto query = std::make_shared<QSqlQuery>(db);
+        query->prepare(sql);
+        return query;
+    }
+
+    auto &statements = pooledConnections.localData()->statements[connectionName];
+    auto query = statements.value(sql);
+    if (query == nullptr) {
+        query = std::make_shared<QSqlQuery>(db);
+        query->prepare(sql);
+        statements.insert(sql, query);
+    } else {
+        // a previous user could leave the statement active, it would keep a read transaction open
+        query->finish();
+    }
+    return query;
+}
+
+void DataBaseManagement::invalidatePooledDatabases()
+{
+    pooledConnectionsGeneration.fetchAndAddRelease(1);
+}
+
 bool DataBaseManagement::createTables(QSqlDatabase &database)
 {
     bool success = true;
@@ -164,30 +217,12 @@ bool DataBaseManagement::createTables(QSqlDatabase &database)
 
         // FOLDER (representa una carpeta en disco)
         QSqlQuery queryFolder(database);
-        queryFolder.prepare("CREATE TABLE folder ("
-                            "id INTEGER PRIMARY KEY,"
-                            "parentId INTEGER NOT NULL,"
-                            "name TEXT NOT NULL,"
-                            "path TEXT NOT NULL,"
-                            // new 7.1 fields
-                            "finished BOOLEAN DEFAULT 0," // reading
-                            "completed BOOLEAN DEFAULT 1," // collecting
-                            // new 9.5 fields
-                            "numChildren INTEGER,"
-                            "firstChildHash TEXT,"
-                            "customImage TEXT,"
-                            // new 9.8 fields
-                            "manga BOOLEAN DEFAULT 0," // deprecated 9.13
-                            // new 9.13 fields
-                            "type INTEGER DEFAULT 0," // 0 = comic, 1 = manga, 2 = manga left to right, 3 = webcomic, 4 = 4koma
-                            "added INTEGER,"
-                            "updated INTEGER," // updated when the folder gets new content
-                            "FOREIGN KEY(parentId) REFERENCES folder(id) ON DELETE CASCADE)");
+        queryFolder.prepare(folderTableSchema());
         success = success && queryFolder.exec();
 
         // COMIC (representa un cómic en disco, contiene el nombre de fichero)
         QSqlQuery queryComic(database);
-        queryComic.prepare("CREATE TABLE comic (id INTEGER PRIMARY KEY, parentId INTEGER NOT NULL, comicInfoId INTEGER NOT NULL,  fileName TEXT NOT NULL, path TEXT, FOREIGN KEY(parentId) REFERENCES folder(id) ON DELETE CASCADE, FOREIGN KEY(comicInfoId) REFERENCES comic_info(id))");
+        queryComic.prepare(comicTableSchema());
         success = success && queryComic.exec();
         // queryComic.finish();
         // DB INFO
@@ -203,6 +238,12 @@ bool DataBaseManagement::createTables(QSqlDatabase &database)
 
         // 8.0> tables
         success = success && DataBaseManagement::createV8Tables(database);
+
+        // 9.15> full text search, it is optional
+        DataBaseManagement::createFullTextIndex(database);
+
+        // 9.16> indexes
+        success = success && DataBaseManagement::createIndexes(database);
     }
 
     return success;
@@ -211,80 +252,7 @@ bool DataBaseManagement::createTables(QSqlDatabase &database)
 bool DataBaseManagement::createComicInfoTable(QSqlDatabase &database, QString tableName)
 {
     QSqlQuery queryComicInfo(database);
-    queryComicInfo.prepare("CREATE TABLE " + tableName + " ("
-                                                         "id INTEGER PRIMARY KEY,"
-                                                         "title TEXT,"
-
-                                                         "coverPage INTEGER DEFAULT 1,"
-                                                         "numPages INTEGER,"
-
-                                                         "number TEXT," // changed to text from INTEGER (9.13)
-                                                         "isBis BOOLEAN,"
-                                                         "count INTEGER,"
-
-                                                         "volume TEXT,"
-                                                         "storyArc TEXT,"
-                                                         "arcNumber TEXT," // changed to text from INTEGER (9.13)
-                                                         "arcCount INTEGER,"
-
-                                                         "genere TEXT,"
-
-                                                         "writer TEXT,"
-                                                         "penciller TEXT,"
-                                                         "inker TEXT,"
-                                                         "colorist TEXT,"
-                                                         "letterer TEXT,"
-                                                         "coverArtist TEXT,"
-
-                                                         "date TEXT," // publication date dd/mm/yyyy --> se mostrará en 3 campos diferentes
-                                                         "publisher TEXT,"
-                                                         "format TEXT,"
-                                                         "color BOOLEAN,"
-                                                         "ageRating TEXT,"
-
-                                                         "synopsis TEXT,"
-                                                         "characters TEXT,"
-                                                         "notes TEXT,"
-
-                                                         "hash TEXT UNIQUE NOT NULL,"
-                                                         "edited BOOLEAN DEFAULT 0,"
-                                                         "read BOOLEAN DEFAULT 0,"
-                                                         // new 7.0 fields
-
-                                                         "hasBeenOpened BOOLEAN DEFAULT 0,"
-                                                         "rating REAL DEFAULT 0," // changed to REAL from INTEGER (9.13)
-                                                         "currentPage INTEGER DEFAULT 1, "
-                                                         "bookmark1 INTEGER DEFAULT -1, "
-                                                         "bookmark2 INTEGER DEFAULT -1, "
-                                                         "bookmark3 INTEGER DEFAULT -1, "
-                                                         "brightness INTEGER DEFAULT -1, "
-                                                         "contrast INTEGER DEFAULT -1, "
-                                                         "gamma INTEGER DEFAULT -1, "
-                                                         // new 7.1 fields
-                                                         "comicVineID TEXT,"
-                                                         // new 9.5 fields
-                                                         "lastTimeOpened INTEGER,"
-                                                         "coverSizeRatio REAL,"
-                                                         "originalCoverSize STRING," // h/w
-                                                         // new 9.8 fields
-                                                         "manga BOOLEAN DEFAULT 0," // deprecated 9.13
-                                                         // new 9.13 fields
-                                                         "added INTEGER,"
-                                                         "type INTEGER DEFAULT 0," // 0 = comic, 1 = manga, 2 = manga left to right, 3 = webcomic, 4 = 4koma
-                                                         "editor TEXT,"
-                                                         "imprint TEXT,"
-                                                         "teams TEXT,"
-                                                         "locations TEXT,"
-                                                         "series TEXT,"
-                                                         "alternateSeries TEXT,"
-                                                         "alternateNumber TEXT,"
-                                                         "alternateCount INTEGER,"
-                                                         "languageISO TEXT,"
-                                                         "seriesGroup TEXT,"
-                                                         "mainCharacterOrTeam TEXT,"
-                                                         "review TEXT,"
-                                                         "tags TEXT"
-                                                         ")");
+    queryComicInfo.prepare(comicInfoTableSchema(tableName));
 
     return queryComicInfo.exec();
 }
@@ -292,470 +260,386 @@ bool DataBaseManagement::createComicInfoTable(QSqlDatabase &database, QString ta
 bool DataBaseManagement::createV8Tables(QSqlDatabase &database)
 {
     bool success = true;
-    {
-        // 8.0> tables
-        // LABEL
-        QSqlQuery queryLabel(database);
-        success = success && queryLabel.exec("CREATE TABLE label (id INTEGER PRIMARY KEY, "
-                                             "name TEXT NOT NULL, "
-                                             "color TEXT NOT NULL, "
-                                             "ordering INTEGER NOT NULL); "); // order depends on the color
-
-        QSqlQuery queryIndexLabel(database);
-        success = success && queryIndexLabel.exec("CREATE INDEX label_ordering_index ON label (ordering)");
-
-        // COMIC LABEL
-        QSqlQuery queryComicLabel(database);
-        success = success && queryComicLabel.exec("CREATE TABLE comic_label ("
-                                                  "comic_id INTEGER, "
-                                                  "label_id INTEGER, "
-                                                  "ordering INTEGER, " // TODO order????
-                                                  "FOREIGN KEY(label_id) REFERENCES label(id) ON DELETE CASCADE, "
-                                                  "FOREIGN KEY(comic_id) REFERENCES comic(id) ON DELETE CASCADE, "
-                                                  "PRIMARY KEY(label_id, comic_id))");
-
-        QSqlQuery queryIndexComicLabel(database);
-        success = success && queryIndexComicLabel.exec("CREATE INDEX comic_label_ordering_index ON label (ordering)");
-
-        // READING LIST
-        QSqlQuery queryReadingList(database);
-        success = success && queryReadingList.exec("CREATE TABLE reading_list ("
-                                                   "id INTEGER PRIMARY KEY, "
-                                                   "parentId INTEGER, "
-                                                   "ordering INTEGER DEFAULT 0, " // only use it if the parentId is NULL
-                                                   "name TEXT NOT NULL, "
-                                                   "finished BOOLEAN DEFAULT 0, "
-                                                   "completed BOOLEAN DEFAULT 1, "
-                                                   "manga BOOLEAN DEFAULT 0, " // TODO never used, replace with `type`
-                                                   "FOREIGN KEY(parentId) REFERENCES reading_list(id) ON DELETE CASCADE)");
-
-        QSqlQuery queryIndexReadingList(database);
-        success = success && queryIndexReadingList.exec("CREATE INDEX reading_list_ordering_index ON label (ordering)");
-
-        // COMIC READING LIST
-        QSqlQuery queryComicReadingList(database);
-        success = success && queryComicReadingList.exec("CREATE TABLE comic_reading_list ("
-                                                        "reading_list_id INTEGER, "
-                                                        "comic_id INTEGER, "
-                                                        "ordering INTEGER, "
-                                                        "FOREIGN KEY(reading_list_id) REFERENCES reading_list(id) ON DELETE CASCADE, "
-                                                        "FOREIGN KEY(comic_id) REFERENCES comic(id) ON DELETE CASCADE, "
-                                                        "PRIMARY KEY(reading_list_id, comic_id))");
-
-        QSqlQuery queryIndexComicReadingList(database);
-        success = success && queryIndexComicReadingList.exec("CREATE INDEX comic_reading_list_ordering_index ON label (ordering)");
-
-        // DEFAULT READING LISTS
-        QSqlQuery queryDefaultReadingList(database);
-        success = success && queryDefaultReadingList.exec("CREATE TABLE default_reading_list ("
-                                                          "id INTEGER PRIMARY KEY, "
-                                                          "name TEXT NOT NULL"
-                                                          // TODO icon????
-                                                          ")");
-
-        // COMIC DEFAULT READING LISTS
-        QSqlQuery queryComicDefaultReadingList(database);
-        success = success && queryComicDefaultReadingList.exec("CREATE TABLE comic_default_reading_list ("
-                                                               "comic_id INTEGER, "
-                                                               "default_reading_list_id INTEGER, "
-                                                               "ordering INTEGER, " // order????
-                                                               "FOREIGN KEY(default_reading_list_id) REFERENCES default_reading_list(id) ON DELETE CASCADE, "
-                                                               "FOREIGN KEY(comic_id) REFERENCES comic(id) ON DELETE CASCADE,"
-                                                               "PRIMARY KEY(default_reading_list_id, comic_id))");
-
-        QSqlQuery queryIndexComicDefaultReadingList(database);
-        success = success && queryIndexComicDefaultReadingList.exec("CREATE INDEX comic_default_reading_list_ordering_index ON label (ordering)");
-
-        // INSERT DEFAULT READING LISTS
-        QSqlQuery queryInsertDefaultReadingList(database);
-        // if(!queryInsertDefaultReadingList.prepare())
-
-        // 1 Favorites
-        // queryInsertDefaultReadingList.bindValue(":name", "Favorites");
-        success = success && queryInsertDefaultReadingList.exec("INSERT INTO default_reading_list (name) VALUES (\"Favorites\")");
-
-        // Reading doesn't need its onw list
+    const auto statements = v8TablesSchema();
+    for (const auto &statement : statements) {
+        QSqlQuery query(database);
+        success = success && query.exec(statement);
     }
     return success;
 }
 
-void DataBaseManagement::exportComicsInfo(QString source, QString dest)
+bool DataBaseManagement::createIndexes(QSqlDatabase &database)
 {
-    QString connectionName = "";
+    const auto indexes = libraryIndexes();
+    for (const auto &index : indexes) {
+        QSqlQuery query(database);
+        if (!query.exec(index)) {
+            QLOG_ERROR() << "Unable to create index :" << query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DataBaseManagement::createFullTextIndex(QSqlDatabase &database)
+{
+    database.transaction();
+
+    bool success = true;
+    const auto statements = fullTextIndexSchema();
+    for (const auto &statement : statements) {
+        QSqlQuery query(database);
+        success = success && query.exec(statement);
+    }
+
+    if (success) {
+        database.commit();
+    } else {
+        // SQLite built without FTS5, searches keep using LIKE
+        QLOG_WARN() << "Unable to create the full text search index:" << database.lastError().text();
+        database.rollback();
+    }
+
+    return success;
+}
+
+bool DataBaseManagement::hasFullTextIndex(const QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    query.exec("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name IN ('comic_info_fts', 'comic_fts', 'folder_fts')");
+    return query.next() && query.value(0).toInt() == 3;
+}
+
+namespace {
+// JSON lines packs start with a header line followed by one object per comic with its non null fields
+const QString comicsInfoFormat = "yacreader-comics-info";
+const int comicsInfoFormatVersion = 1;
+// comics upserted by each statement, the progress is reported between them
+const int comicsInfoBatchSize = 5000;
+
+bool isJsonLinesPack(const QString &path)
+{
+    return path.endsWith(".jsonl", Qt::CaseInsensitive);
+}
+
+bool execQuery(QSqlQuery &query)
+{
+    if (!query.exec()) {
+        QLOG_ERROR() << "Comics info:" << query.lastError().text() << query.lastQuery();
+        return false;
+    }
+    return true;
+}
+
+bool execQuery(const QSqlDatabase &db, const QString &sql)
+{
+    QSqlQuery query(db);
+    query.prepare(sql);
+    return execQuery(query);
+}
+
+// Upserts the comics info of `table` into the comic_info table of the library, one statement for each range of rowids,
+// see comicsInfoUpsertQuery
+class ComicsInfoUpsert
+{
+public:
+    ComicsInfoUpsert(const QSqlDatabase &db, const QString &table, const QStringList &fields, bool keepMissing = false)
+        : upsertedComics(0), checkCovers(fields.contains("coverPage")), coversQuery(db), upsertQuery(db)
+    {
+        upsertQuery.prepare(comicsInfoUpsertQuery(table, fields, keepMissing));
+        if (checkCovers) {
+            coversQuery.prepare(comicsInfoChangedCoversQuery(table));
+        }
+    }
+
+    bool exec(qint64 fromRowId, qint64 toRowId)
     {
-        QSqlDatabase destDB = loadDatabaseFromFile(dest);
+        // the covers of the comics whose cover page changes have to be extracted again
+        if (checkCovers) {
+            coversQuery.bindValue(":from", fromRowId);
+            coversQuery.bindValue(":to", toRowId);
+            if (!execQuery(coversQuery)) {
+                return false;
+            }
+            while (coversQuery.next()) {
+                changedCovers << coversQuery.value(0).toString();
+            }
+        }
 
-        QSqlQuery attach(destDB);
-        attach.prepare("ATTACH DATABASE '" + QDir().toNativeSeparators(dest) + "' AS dest;");
-        attach.exec();
+        upsertQuery.bindValue(":from", fromRowId);
+        upsertQuery.bindValue(":to", toRowId);
+        if (!execQuery(upsertQuery)) {
+            return false;
+        }
+        upsertedComics += upsertQuery.numRowsAffected();
+        return true;
+    }
 
-        QSqlQuery attach2(destDB);
-        attach2.prepare("ATTACH DATABASE '" + QDir().toNativeSeparators(source) + "' AS source;");
-        attach2.exec();
+    QStringList changedCovers;
+    qint64 upsertedComics;
 
-        QSqlQuery queryDBInfo(destDB);
-        queryDBInfo.prepare("CREATE TABLE dest.db_info (version TEXT NOT NULL)");
-        queryDBInfo.exec();
+private:
+    bool checkCovers;
+    QSqlQuery coversQuery;
+    QSqlQuery upsertQuery;
+};
 
-        QSqlQuery query("INSERT INTO dest.db_info (version) "
-                        "VALUES ('" DB_VERSION "')",
-                        destDB);
-        query.exec();
+void extractCovers(const QSqlDatabase &db, const QString &libraryDatabase, const QStringList &hashes)
+{
+    QString basePath = QString(libraryDatabase).remove("/.yacreaderlibrary/library.ydb");
+
+    QSqlQuery getComic(db);
+    getComic.prepare(COMIC_BY_HASH_QUERY);
+    for (const auto &hash : hashes) {
+        getComic.bindValue(":hash", hash);
+        if (execQuery(getComic) && getComic.next()) {
+            QString path = basePath + getComic.value(0).toString();
+            int coverPage = getComic.value(1).toInt();
+            InitialComicInfoExtractor ie(path, basePath + "/.yacreaderlibrary/covers/" + hash + ".jpg", coverPage);
+            ie.extract();
+        }
+    }
+}
 
-        QSqlQuery exportData(destDB);
-        exportData.prepare("CREATE TABLE dest.comic_info AS SELECT " + fields +
-                           " FROM source.comic_info WHERE source.comic_info.edited = 1 OR source.comic_info.comicVineID IS NOT NULL");
-        exportData.exec();
-        connectionName = destDB.connectionName();
+bool exportComicsInfoDatabase(const QString &source, const QString &dest)
+{
+    // the pack is created from scratch next to the destination and only replaces it once it is complete,
+    // the file dialog has already asked before replacing it
+    QTemporaryFile tempFile(dest + ".XXXXXX");
+    if (!tempFile.open()) {
+        QLOG_ERROR() << "Unable to create the comics info pack" << dest << tempFile.errorString();
+        return false;
     }
+    tempFile.close();
 
+    QString connectionName = tempFile.fileName() + QString::number((long long)QThread::currentThreadId(), 16);
+    bool success = false;
+    {
+        QSqlDatabase destDB = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        destDB.setDatabaseName(tempFile.fileName());
+        if (!destDB.open()) {
+            QLOG_ERROR() << "Unable to create the comics info pack" << dest << destDB.lastError().text();
+        } else {
+            QSqlQuery attach(destDB);
+            attach.prepare("ATTACH DATABASE :source AS source");
+            attach.bindValue(":source", QDir::toNativeSeparators(source));
+            if (execQuery(attach)) {
+                success = destDB.transaction() &&
+                        execQuery(destDB, "CREATE TABLE db_info (version TEXT NOT NULL)") &&
+                        execQuery(destDB, "INSERT INTO db_info (version) VALUES ('" DB_VERSION "')") &&
+                        execQuery(destDB, "CREATE TABLE comic_info AS SELECT hash,edited," + infoFields.join(",") +
+                                                  " FROM source.comic_info WHERE edited = 1 OR comicVineID IS NOT NULL");
+                success = success ? destDB.commit() : (destDB.rollback(), false);
+                execQuery(destDB, "DETACH DATABASE source");
+            }
+        }
+    }
     QSqlDatabase::removeDatabase(connectionName);
+
+    if (success) {
+        QFile::remove(dest);
+        success = QFile::rename(tempFile.fileName(), dest);
+        if (success) {
+            tempFile.setAutoRemove(false);
+        } else {
+            QLOG_ERROR() << "Unable to replace the comics info pack" << dest;
+        }
+    }
+
+    return success;
 }
 
-// TODO_METADATA: validate imported info
-bool DataBaseManagement::importComicsInfo(QString source, QString dest)
+bool exportComicsInfoJsonLines(const QString &source, const QString &dest)
 {
-    QString error;
-    QString driver;
-    QStringList hashes;
+    QSaveFile file(dest);
+    if (!file.open(QIODevice::WriteOnly)) {
+        QLOG_ERROR() << "Unable to create the comics info pack" << dest;
+        return false;
+    }
 
-    bool b = false;
+    QString connectionName;
+    bool success = false;
+    {
+        QSqlDatabase sourceDB = DataBaseManagement::loadDatabaseFromFile(source);
+        connectionName = sourceDB.connectionName();
+
+        QSqlQuery selectInfo(sourceDB);
+        selectInfo.setForwardOnly(true);
+        selectInfo.prepare("SELECT hash,edited," + infoFields.join(",") + " FROM comic_info WHERE edited = 1 OR comicVineID IS NOT NULL");
+        if (execQuery(selectInfo)) {
+            QJsonObject header { { "format", comicsInfoFormat }, { "version", comicsInfoFormatVersion } };
+            file.write(QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n');
+
+            while (selectInfo.next()) {
+                auto record = selectInfo.record();
+                QJsonObject info;
+                for (int i = 0; i < record.count(); i++) {
+                    if (!record.isNull(i)) {
+                        info.insert(record.fieldName(i), QJsonValue::fromVariant(record.value(i)));
+                    }
+                }
+                file.write(QJsonDocument(info).toJson(QJsonDocument::Compact) + '\n');
+            }
+            success = file.commit();
+        }
+    }
+    if (!connectionName.isEmpty()) {
+        QSqlDatabase::removeDatabase(connectionName);
+    }
 
-    QString sourceDBconnection = "";
-    QString destDBconnection = "";
+    return success;
+}
 
+bool importComicsInfoDatabase(const QString &source, const QString &dest, const DataBaseManagement::ProgressCallback &progress)
+{
+    QString connectionName;
+    bool success = false;
     {
-        QSqlDatabase sourceDB = loadDatabaseFromFile(source);
-        QSqlDatabase destDB = loadDatabaseFromFile(dest);
-
-        QSqlQuery pragma("PRAGMA synchronous=OFF", destDB);
-
-        QSqlQuery newInfo(sourceDB);
-        newInfo.prepare("SELECT * FROM comic_info");
-        newInfo.exec();
-        destDB.transaction();
-        int cp;
-        while (newInfo.next()) // cada tupla deberá ser insertada o actualizada
-        {
-            QSqlQuery update(destDB);
-            update.prepare("UPDATE comic_info SET "
-                           "title = :title,"
-
-                           "coverPage = :coverPage,"
-                           "numPages = :numPages,"
-
-                           "number = :number,"
-                           "isBis = :isBis,"
-                           "count = :count,"
-
-                           "volume = :volume,"
-                           "storyArc = :storyArc,"
-                           "arcNumber = :arcNumber,"
-                           "arcCount = :arcCount,"
-
-                           "genere = :genere,"
-
-                           "writer = :writer,"
-                           "penciller = :penciller,"
-                           "inker = :inker,"
-                           "colorist = :colorist,"
-                           "letterer = :letterer,"
-                           "coverArtist = :coverArtist,"
-
-                           "date = :date,"
-                           "publisher = :publisher,"
-                           "format = :format,"
-                           "color = :color,"
-                           "ageRating = :ageRating,"
-
-                           "synopsis = :synopsis,"
-                           "characters = :characters,"
-                           "notes = :notes,"
-
-                           "read = :read,"
-                           "edited = :edited,"
-                           // new 7.0 fields
-                           "hasBeenOpened = :hasBeenOpened,"
-
-                           "currentPage = :currentPage,"
-                           "bookmark1 = :bookmark1,"
-                           "bookmark2 = :bookmark2,"
-                           "bookmark3 = :bookmark3,"
-                           "brightness = :brightness,"
-                           "contrast = :contrast, "
-                           "gamma = :gamma,"
-                           "rating = :rating,"
-
-                           // new 7.1 fields
-                           "comicVineID = :comicVineID,"
-
-                           // new 9.5 fields
-                           "lastTimeOpened = :lastTimeOpened,"
-
-                           //"coverSizeRatio = :coverSizeRatio,"
-                           //"originalCoverSize = :originalCoverSize,"
-                           //--
-
-                           // new 9.8 fields
-                           // "manga = :manga," //removed in 9.13
-
-                           // new 9.13 fields
-                           "added = :added,"
-                           "type = :type," // 0 = comic, 1 = manga, 2 = manga left to right, 3 = webcomic,
-                           "editor = :editor,"
-                           "imprint = :imprint,"
-                           "teams = :teams,"
-                           "locations = :locations,"
-                           "series = :series,"
-                           "alternateSeries = :alternateSeries,"
-                           "alternateNumber = :alternateNumber,"
-                           "alternateCount = :alternateCount,"
-                           "languageISO = :languageISO,"
-                           "seriesGroup = :seriesGroup,"
-                           "mainCharacterOrTeam = :mainCharacterOrTeam,"
-                           "review = :review,"
-                           "tags = :tags"
-
-                           //--
-                           " WHERE hash = :hash ");
-
-            QSqlQuery insert(destDB);
-            insert.prepare("INSERT INTO comic_info "
-                           "(title,"
-                           "coverPage,"
-                           "numPages,"
-                           "number,"
-                           "isBis,"
-                           "count,"
-                           "volume,"
-                           "storyArc,"
-                           "arcNumber,"
-                           "arcCount,"
-                           "genere,"
-                           "writer,"
-                           "penciller,"
-                           "inker,"
-                           "colorist,"
-                           "letterer,"
-                           "coverArtist,"
-                           "date,"
-                           "publisher,"
-                           "format,"
-                           "color,"
-                           "ageRating,"
-                           "synopsis,"
-                           "characters,"
-                           "notes,"
-                           "read,"
-                           "edited,"
-                           "comicVineID,"
-                           "lastTimeOpened,"
-                           "coverSizeRatio,"
-                           "added,"
-                           "type,"
-                           "editor,"
-                           "imprint,"
-                           "teams,"
-                           "locations,"
-                           "series,"
-                           "alternateSeries,"
-                           "alternateNumber,"
-                           "alternateCount,"
-                           "languageISO,"
-                           "seriesGroup,"
-                           "mainCharacterOrTeam,"
-                           "review,"
-                           "hash)"
-
-                           "VALUES (:title,"
-                           ":coverPage,"
-                           ":numPages,"
-                           ":number,"
-                           ":isBis,"
-                           ":count,"
-
-                           ":volume,"
-                           ":storyArc,"
-                           ":arcNumber,"
-                           ":arcCount,"
-
-                           ":genere,"
-
-                           ":writer,"
-                           ":penciller,"
-                           ":inker,"
-                           ":colorist,"
-                           ":letterer,"
-                           ":coverArtist,"
-
-                           ":date,"
-                           ":publisher,"
-                           ":format,"
-                           ":color,"
-                           ":ageRating,"
-
-                           ":synopsis,"
-                           ":characters,"
-                           ":notes,"
-
-                           ":read,"
-                           ":edited,"
-                           ":comicVineID,"
-
-                           ":lastTimeOpened,"
-
-                           ":coverSizeRatio,"
-                           ":originalCoverSize,"
-
-                           ":added,"
-                           ":type,"
-                           ":editor,"
-                           ":imprint,"
-                           ":teams,"
-                           ":locations,"
-                           ":series,"
-                           ":alternateSeries,"
-                           ":alternateNumber,"
-                           ":alternateCount,"
-                           ":languageISO,"
-                           ":seriesGroup,"
-                           ":mainCharacterOrTeam,"
-                           ":review,"
-                           ":tags,"
-
-                           ":hash )");
-
-            QSqlRecord record = newInfo.record();
-            cp = record.value("coverPage").toInt();
-            if (cp > 1) {
-                QSqlQuery checkCoverPage(destDB);
-                checkCoverPage.prepare("SELECT coverPage FROM comic_info where hash = :hash");
-                checkCoverPage.bindValue(":hash", record.value("hash").toString());
-                checkCoverPage.exec();
-                bool extract = false;
-                if (checkCoverPage.next()) {
-                    extract = checkCoverPage.record().value("coverPage").toInt() != cp;
+        QSqlDatabase destDB = DataBaseManagement::loadDatabaseFromFile(dest);
+        connectionName = destDB.connectionName();
+
+        QSqlQuery attach(destDB);
+        attach.prepare("ATTACH DATABASE :source AS source");
+        attach.bindValue(":source", QDir::toNativeSeparators(source));
+        if (execQuery(attach)) {
+            // packs exported by older versions don't have all the fields
+            QSet<QString> sourceFields;
+            QSqlQuery tableInfo(destDB);
+            tableInfo.prepare("PRAGMA source.table_info(comic_info)");
+            if (execQuery(tableInfo)) {
+                while (tableInfo.next()) {
+                    sourceFields.insert(tableInfo.value(1).toString());
+                }
+            }
+            QStringList fields;
+            for (const auto &field : infoFields) {
+                if (sourceFields.contains(field)) {
+                    fields << field;
                 }
-                if (extract)
-                    hashes.append(record.value("hash").toString());
             }
 
-            bindValuesFromRecord(record, update);
+            QSqlQuery range(destDB);
+            range.prepare("SELECT COUNT(*), MAX(rowid) FROM source.comic_info");
+            if (!sourceFields.contains("hash")) {
+                QLOG_ERROR() << "Invalid comics info pack" << source;
+            } else if (execQuery(range) && range.next()) {
+                qint64 total = range.value(0).toLongLong();
+                qint64 maxRowId = range.value(1).toLongLong();
+                range.finish();
+
+                ComicsInfoUpsert upsert(destDB, "source.comic_info", fields);
+                success = destDB.transaction();
+                for (qint64 from = 0; success && from < maxRowId; from += comicsInfoBatchSize) {
+                    success = upsert.exec(from, from + comicsInfoBatchSize);
+                    if (progress) {
+                        progress(qMin(upsert.upsertedComics, total), total);
+                    }
+                }
+                success = success ? destDB.commit() : (destDB.rollback(), false);
 
-            update.bindValue(":edited", 1);
+                if (success) {
+                    extractCovers(destDB, dest, upsert.changedCovers);
+                }
+            }
+            execQuery(destDB, "DETACH DATABASE source");
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
 
-            update.exec();
+    return success;
+}
 
-            if (update.numRowsAffected() == 0) {
+bool importComicsInfoJsonLines(const QString &source, const QString &dest, const DataBaseManagement::ProgressCallback &progress)
+{
+    QFile file(source);
+    if (!file.open(QIODevice::ReadOnly)) {
+        QLOG_ERROR() << "Unable to open the comics info pack" << source;
+        return false;
+    }
 
-                bindValuesFromRecord(record, insert);
-                insert.bindValue(":edited", 1);
-                insert.bindValue(":read", 0);
+    QJsonParseError error;
+    auto header = QJsonDocument::fromJson(file.readLine(), &error).object();
+    if (error.error != QJsonParseError::NoError || header.value("format").toString() != comicsInfoFormat || header.value("version").toInt() > comicsInfoFormatVersion) {
+        QLOG_ERROR() << "Invalid comics info pack" << source;
+        return false;
+    }
 
-                insert.exec();
-            }
+    QString connectionName;
+    bool success = false;
+    {
+        QSqlDatabase destDB = DataBaseManagement::loadDatabaseFromFile(dest);
+        connectionName = destDB.connectionName();
+
+        // the comics are staged in a temporary table and upserted in batches, the pack is never fully in memory.
+        // Like with .ydb packs only the fields a comic carries are merged, a missing key (or a null one) keeps the library value
+        auto columns = QStringList { "hash" } + infoFields;
+        QStringList placeholders;
+        for (int i = 0; i < columns.size(); i++) {
+            placeholders << "?";
         }
 
-        destDB.commit();
-        QString hash;
-        foreach (hash, hashes) {
-            QSqlQuery getComic(destDB);
-            getComic.prepare("SELECT c.path,ci.coverPage FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) where ci.hash = :hash");
-            getComic.bindValue(":hash", hash);
-            getComic.exec();
-            if (getComic.next()) {
-                QString basePath = QString(dest).remove("/.yacreaderlibrary/library.ydb");
-                QString path = basePath + getComic.record().value("path").toString();
-                int coverPage = getComic.record().value("coverPage").toInt();
-                InitialComicInfoExtractor ie(path, basePath + "/.yacreaderlibrary/covers/" + hash + ".jpg", coverPage);
-                ie.extract();
+        success = destDB.transaction() && execQuery(destDB, createComicsInfoStagingTableQuery());
+        if (success) {
+            QSqlQuery stage(destDB);
+            stage.prepare("INSERT INTO temp.imported_info (" + columns.join(",") + ") VALUES (" + placeholders.join(",") + ")");
+            ComicsInfoUpsert upsert(destDB, "temp.imported_info", infoFields, true);
+            auto flush = [&]() {
+                return upsert.exec(0, std::numeric_limits<qint64>::max()) && execQuery(destDB, "DELETE FROM temp.imported_info");
+            };
+
+            int staged = 0;
+            while (success && !file.atEnd()) {
+                auto line = file.readLine().trimmed();
+                if (line.isEmpty()) {
+                    continue;
+                }
+
+                auto info = QJsonDocument::fromJson(line, &error).object();
+                if (error.error != QJsonParseError::NoError || !info.value("hash").isString()) {
+                    QLOG_WARN() << "Skipping invalid comic info in" << source << "at" << file.pos();
+                    continue;
+                }
+
+                for (int i = 0; i < columns.size(); i++) {
+                    stage.bindValue(i, info.value(columns.at(i)).toVariant());
+                }
+                success = execQuery(stage);
+
+                if (success && ++staged == comicsInfoBatchSize) {
+                    success = flush();
+                    staged = 0;
+                    if (progress) {
+                        progress(file.pos(), file.size());
+                    }
+                }
+            }
+            success = success && flush();
+            success = success ? destDB.commit() : (destDB.rollback(), false);
+
+            if (success) {
+                if (progress) {
+                    progress(file.size(), file.size());
+                }
+                extractCovers(destDB, dest, upsert.changedCovers);
             }
         }
-        sourceDBconnection = sourceDB.connectionName();
-        destDBconnection = sourceDB.connectionName();
+        execQuery(destDB, "DROP TABLE IF EXISTS temp.imported_info");
     }
+    QSqlDatabase::removeDatabase(connectionName);
 
-    QSqlDatabase::removeDatabase(sourceDBconnection);
-    QSqlDatabase::removeDatabase(destDBconnection);
+    return success;
+}
+}
 
-    return b;
+bool DataBaseManagement::exportComicsInfo(QString source, QString dest)
+{
+    return isJsonLinesPack(dest) ? exportComicsInfoJsonLines(source, dest) : exportComicsInfoDatabase(source, dest);
 }
 
-// TODO: update fields
-// TODO fix these bindings
-void DataBaseManagement::bindValuesFromRecord(const QSqlRecord &record, QSqlQuery &query)
+// TODO_METADATA: validate imported info
+bool DataBaseManagement::importComicsInfo(QString source, QString dest, const ProgressCallback &progress)
 {
-    bindValue("title", record, query);
-
-    bindValue("coverPage", record, query);
-    bindValue("numPages", record, query);
-
-    bindValue("number", record, query);
-    bindValue("isBis", record, query);
-    bindValue("count", record, query);
-
-    bindValue("volume", record, query);
-    bindValue("storyArc", record, query);
-    bindValue("arcNumber", record, query);
-    bindValue("arcCount", record, query);
-
-    bindValue("genere", record, query);
-
-    bindValue("writer", record, query);
-    bindValue("penciller", record, query);
-    bindValue("inker", record, query);
-    bindValue("colorist", record, query);
-    bindValue("letterer", record, query);
-    bindValue("coverArtist", record, query);
-
-    bindValue("date", record, query);
-    bindValue("publisher", record, query);
-    bindValue("format", record, query);
-    bindValue("color", record, query);
-    bindValue("ageRating", record, query);
-
-    bindValue("synopsis", record, query);
-    bindValue("characters", record, query);
-    bindValue("notes", record, query);
-
-    bindValue("read", record, query);
-    bindValue("edited", record, query);
-
-    bindValue("hasBeenOpened", record, query);
-    bindValue("currentPage", record, query);
-    bindValue("publisher", record, query);
-    bindValue("bookmark1", record, query);
-    bindValue("bookmark2", record, query);
-    bindValue("bookmark3", record, query);
-    bindValue("brightness", record, query);
-    bindValue("contrast", record, query);
-    bindValue("gamma", record, query);
-    bindValue("rating", record, query);
-
-    bindValue("comicVineID", record, query);
-
-    bindValue("lastTimeOpened", record, query);
-
-    bindValue("coverSizeRatio", record, query);
-    bindValue("originalCoverSize", record, query);
-
-    bindValue("added", record, query);
-    bindValue("type", record, query);
-    bindValue("editor", record, query);
-    bindValue("imprint", record, query);
-    bindValue("teams", record, query);
-    bindValue("locations", record, query);
-    bindValue("series", record, query);
-    bindValue("alternateSeries", record, query);
-    bindValue("alternateNumber", record, query);
-    bindValue("alternateCount", record, query);
-    bindValue("languageISO", record, query);
-    bindValue("seriesGroup", record, query);
-    bindValue("mainCharacterOrTeam", record, query);
-    bindValue("review", record, query);
-    bindValue("tags", record, query);
-
-    bindValue("hash", record, query);
+    return isJsonLinesPack(source) ? importComicsInfoJsonLines(source, dest, progress) : importComicsInfoDatabase(source, dest, progress);
 }
 
 bool DataBaseManagement::addColumns(const QString &tableName, const QStringList &columnDefs, const QSqlDatabase &db)
@@ -791,13 +675,6 @@ bool DataBaseManagement::addConstraint(const QString &tableName, const QString &
     return returnValue;
 }
 
-void DataBaseManagement::bindValue(const QString &name, const QSqlRecord &record, QSqlQuery &query)
-{
-    if (!record.value(name).isNull()) {
-        query.bindValue(":" + name, record.value(name));
-    }
-}
-
 QString DataBaseManagement::checkValidDB(const QString &fullPath)
 {
     QString versionString = "";
@@ -860,6 +737,8 @@ bool DataBaseManagement::updateToCurrentVersion(const QString &path)
     bool pre9_8 = false;
     bool pre9_13 = false;
     bool pre9_14 = false;
+    bool pre9_15 = false;
+    bool pre9_16 = false;
 
     QString fullPath = path + "/library.ydb";
 
@@ -877,6 +756,10 @@ bool DataBaseManagement::updateToCurrentVersion(const QString &path)
         pre9_13 = true;
     if (compareVersions(DataBaseManagement::checkValidDB(fullPath), "9.14.0") < 0)
         pre9_14 = true;
+    if (compareVersions(DataBaseManagement::checkValidDB(fullPath), "9.15.0") < 0)
+        pre9_15 = true;
+    if (compareVersions(DataBaseManagement::checkValidDB(fullPath), "9.16.0") < 0)
+        pre9_16 = true;
 
     QString connectionName = "";
     bool returnValue = true;
@@ -1077,6 +960,16 @@ bool DataBaseManagement::updateToCurrentVersion(const QString &path)
                 }
             }
 
+            // full text search index, a SQLite build without FTS5 can't create it but the database is still usable
+            if (pre9_15) {
+                createFullTextIndex(db);
+            }
+
+            if (pre9_16) {
+                bool successCreatingIndexes = createIndexes(db);
+                returnValue = returnValue && successCreatingIndexes;
+            }
+
             if (returnValue) {
                 QSqlQuery updateVersion(db);
                 updateVersion.prepare("UPDATE db_info SET "
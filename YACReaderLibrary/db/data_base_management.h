@@ -5,6 +5,9 @@
 #include <QtSql>
 #include <QSqlDatabase>
 
+#include <functional>
+#include <memory>
+
 #include "folder_model.h"
 
 class ComicsInfoExporter : public QThread
@@ -34,13 +37,13 @@ class DataBaseManagement : public QObject
     Q_OBJECT
 private:
     QList<QString> dataBasesList;
-    static void bindValue(const QString &name, const QSqlRecord &record, QSqlQuery &query);
-    static void bindValuesFromRecord(const QSqlRecord &record, QSqlQuery &query);
-
     static bool addColumns(const QString &tableName, const QStringList &columnDefs, const QSqlDatabase &db);
     static bool addConstraint(const QString &tableName, const QString &constraint, const QSqlDatabase &db);
 
 public:
+    // units processed and total units of a long operation
+    using ProgressCallback = std::function<void(qint64 done, qint64 total)>;
+
     DataBaseManagement();
     // crea una base de datos y todas sus tablas
     static QSqlDatabase createDatabase(QString name, QString path);
@@ -48,12 +51,27 @@ public:
     // carga una base de datos desde la ruta path
     static QSqlDatabase loadDatabase(QString path);
     static QSqlDatabase loadDatabaseFromFile(QString path);
+    // connection to the database in path owned by the calling thread, it is reused by later calls from the same thread
+    // and closed when the thread finishes, so it must not be removed with QSqlDatabase::removeDatabase
+    static QSqlDatabase pooledDatabase(const QString &path);
+    // query with sql already prepared, pooled connections keep their prepared statements around so they are only prepared once
+    // don't use it for queries that may be nested with the same sql while they are still active
+    static std::shared_ptr<QSqlQuery> pooledQuery(const QSqlDatabase &db, const QString &sql);
+    // closes the pooled connections of all the threads the next time they are used (e.g. after a database is recreated)
+    static void invalidatePooledDatabases();
     static bool createTables(QSqlDatabase &database);
     static bool createComicInfoTable(QSqlDatabase &database, QString tableName);
     static bool createV8Tables(QSqlDatabase &database);
+    // secondary indexes used by the lookups of the apps, see library_indexes.h
+    static bool createIndexes(QSqlDatabase &database);
+    // FTS5 index of the text fields used by the search engine, it fails if SQLite is built without FTS5
+    static bool createFullTextIndex(QSqlDatabase &database);
+    static bool hasFullTextIndex(const QSqlDatabase &database);
 
-    static void exportComicsInfo(QString source, QString dest);
-    static bool importComicsInfo(QString source, QString dest);
+    // comics info packs are databases with a comic_info table (.ydb) or JSON lines files (.jsonl), read and written
+    // with a few set-based statements in one transaction. The JSON lines are staged in batches, so they can be streamed
+    static bool exportComicsInfo(QString source, QString dest);
+    static bool importComicsInfo(QString source, QString dest, const ProgressCallback &progress = nullptr);
 
     static QString checkValidDB(const QString &fullPath); // retorna "" si la DB es inválida ó la versión si es válida.
     static int compareVersions(const QString &v1, const QString v2); // retorna <0 si v1 < v2, 0 si v1 = v2 y >0 si v1 > v2
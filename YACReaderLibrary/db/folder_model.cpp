@@ -1,7 +1,9 @@
 #include "folder_model.h"
 
 #include "folder_item.h"
+#include "cover_image_provider.h"
 #include "data_base_management.h"
+#include "library_queries.h"
 #include "folder.h"
 #include "db_helper.h"
 #include "qnaturalsorting.h"
@@ -95,6 +97,7 @@ QHash<int, QByteArray> FolderModel::roleNames() const
     roles[CompletedRole] = "is_completed";
     roles[IdRole] = "id";
     roles[CoverPathRole] = "cover_path";
+    roles[CoverImageRole] = "cover_image";
     roles[FolderNameRole] = "name";
     roles[NumChildrenRole] = "num_children";
     roles[TypeRole] = "type";
@@ -130,7 +133,7 @@ void FolderModel::reload()
             QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
 
             QSqlQuery selectQuery(db);
-            selectQuery.prepare("SELECT * FROM folder WHERE parentId = :parentId and id <> 1");
+            selectQuery.prepare(SUBFOLDERS_QUERY);
             selectQuery.bindValue(":parentId", rootItem->id);
             selectQuery.exec();
 
@@ -306,6 +309,9 @@ QVariant FolderModel::data(const QModelIndex &index, int role) const
     if (role == FolderModel::CoverPathRole)
         return getCoverUrlPathForComicHash(item->data(FirstChildHash).toString());
 
+    if (role == FolderModel::CoverImageRole)
+        return getCoverImageUrlForComicHash(item->data(FirstChildHash).toString());
+
     if (role == FolderModel::NumChildrenRole)
         return item->data(NumChildren);
 
@@ -625,7 +631,7 @@ QStringList FolderModel::getSubfoldersNames(const QModelIndex &mi)
     }
     QSqlDatabase::removeDatabase(connectionName);
 
-    std::sort(result.begin(), result.end(), naturalSortLessThanCI);
+    naturalSort(result);
     return result;
 }
 
@@ -653,7 +659,7 @@ FolderModel *FolderModel::getSubfoldersModel(const QModelIndex &mi)
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
 
         QSqlQuery selectQuery(db); // TODO check
-        selectQuery.prepare("SELECT * FROM folder WHERE parentId = :parentId and id <> 1");
+        selectQuery.prepare(SUBFOLDERS_QUERY);
         selectQuery.bindValue(":parentId", id);
         selectQuery.exec();
 
@@ -749,7 +755,7 @@ QModelIndex FolderModel::addFolderAtParent(const QString &folderName, const QMod
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         newFolder.id = DBHelper::insert(&newFolder, db);
-        DBHelper::updateChildrenInfo(parentItem->id, db);
+        DBHelper::updateChildrenInfo({ parentItem->id }, db);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -787,6 +793,11 @@ QUrl FolderModel::getCoverUrlPathForComicHash(const QString &hash) const
     return QUrl::fromLocalFile(_databasePath + "/covers/" + hash + ".jpg");
 }
 
+QUrl FolderModel::getCoverImageUrlForComicHash(const QString &hash) const
+{
+    return CoverImageProvider::url(_databasePath + "/covers/" + hash + ".jpg");
+}
+
 void FolderModel::setShowRecent(bool showRecent)
 {
     if (this->showRecent == showRecent)
@@ -823,8 +834,7 @@ void FolderModel::deleteFolder(const QModelIndex &mi)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         DBHelper::removeFromDB(&f, db);
-        auto folder = DBHelper::updateChildrenInfo(item->parent()->id, db);
-        DBHelper::propagateFolderUpdatesToParent(folder, db);
+        DBHelper::updateChildrenInfo({ item->parent()->id }, db);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -837,8 +847,7 @@ void FolderModel::updateFolderChildrenInfo(qulonglong folderId)
     QString connectionName = "";
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
-        auto folder = DBHelper::updateChildrenInfo(folderId, db);
-        DBHelper::propagateFolderUpdatesToParent(folder, db);
+        DBHelper::updateChildrenInfo({ folderId }, db);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -80,6 +80,8 @@ public:
     QModelIndex addFolderAtParent(const QString &folderName, const QModelIndex &parent);
 
     Q_INVOKABLE QUrl getCoverUrlPathForComicHash(const QString &hash) const;
+    // cover served by CoverImageProvider, used by the QML views
+    Q_INVOKABLE QUrl getCoverImageUrlForComicHash(const QString &hash) const;
 
     void setShowRecent(bool showRecent);
     void setRecentRange(int days);
@@ -109,6 +111,7 @@ public:
         UpdatedRole,
         ShowRecentRole,
         RecentRangeRole,
+        CoverImageRole,
     };
 
     bool isSubfolder;
@@ -0,0 +1,29 @@
+#ifndef LIBRARY_INDEXES_H
+#define LIBRARY_INDEXES_H
+
+#include <QStringList>
+
+// Secondary indexes of the library database (9.16), they are created with the tables and by the migration of older databases.
+// They follow the lookups made by DBHelper, the models and the server: children of a folder (sorted by name), comics by
+// comic_info, the contents of labels and reading lists in their order, and the comics recently added or being read.
+// tests/library_query_plan_test checks that those queries don't scan whole tables, update it when a query changes.
+inline QStringList libraryIndexes()
+{
+    return QStringList()
+            << "CREATE INDEX IF NOT EXISTS folder_parent_name_index ON folder (parentId, name)"
+            << "CREATE INDEX IF NOT EXISTS comic_parent_file_name_index ON comic (parentId, fileName)"
+            << "CREATE INDEX IF NOT EXISTS comic_comic_info_index ON comic (comicInfoId)"
+            << "CREATE INDEX IF NOT EXISTS comic_info_added_index ON comic_info (added)"
+            // only the comics being read, the index stays small
+            << "CREATE INDEX IF NOT EXISTS comic_info_reading_index ON comic_info (lastTimeOpened) WHERE hasBeenOpened = 1 AND read = 0"
+            << "CREATE INDEX IF NOT EXISTS reading_list_parent_ordering_index ON reading_list (parentId, ordering)"
+            << "CREATE INDEX IF NOT EXISTS comic_label_label_ordering_index ON comic_label (label_id, ordering, comic_id)"
+            << "CREATE INDEX IF NOT EXISTS comic_reading_list_list_ordering_index ON comic_reading_list (reading_list_id, ordering, comic_id)"
+            << "CREATE INDEX IF NOT EXISTS comic_default_reading_list_list_ordering_index ON comic_default_reading_list (default_reading_list_id, ordering, comic_id)"
+            // deleting a comic looks for the rows that reference it (ON DELETE CASCADE)
+            << "CREATE INDEX IF NOT EXISTS comic_label_comic_index ON comic_label (comic_id)"
+            << "CREATE INDEX IF NOT EXISTS comic_reading_list_comic_index ON comic_reading_list (comic_id)"
+            << "CREATE INDEX IF NOT EXISTS comic_default_reading_list_comic_index ON comic_default_reading_list (comic_id)";
+}
+
+#endif // LIBRARY_INDEXES_H
@@ -0,0 +1,184 @@
+#ifndef LIBRARY_QUERIES_H
+#define LIBRARY_QUERIES_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+// Queries of the library database made in the hot paths of DBHelper, LibraryWriteBatch, the models and the server.
+// tests/library_query_plan_test runs them through EXPLAIN QUERY PLAN against a big library, a query added or changed
+// in one of those paths should be defined here and checked there. The lists of comics only share the part of the query
+// after the selected fields (the *_FROM macros), the fields don't change the plan.
+
+// folders
+#define SUBFOLDERS_QUERY "SELECT * FROM folder WHERE parentId = :parentId and id <> 1"
+#define SUBFOLDERS_COUNT_QUERY "SELECT count(*) FROM folder WHERE parentId = :parentId and id <> 1"
+#define FOLDER_BY_NAME_QUERY "SELECT * FROM folder WHERE parentId = :parentId AND name = :folderName"
+#define FOLDER_COMICS_FROM "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.parentId = :parentId"
+#define FOLDER_COMICS_COUNT_QUERY "SELECT count(*) FROM comic c WHERE c.parentId = :parentId"
+#define UPDATE_FOLDER_COMICS_TYPE_QUERY "UPDATE comic_info SET type = :type WHERE id IN (SELECT ci.id FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.parentId = :parentId)"
+
+inline QString foldersByIdQuery(const QString &ids)
+{
+    return "SELECT * FROM folder WHERE id IN (" + ids + ")";
+}
+
+// folder aggregates (numChildren and firstChildHash), see DBHelper::updateChildrenInfo
+#define FOLDER_PARENT_QUERY "SELECT parentId, path FROM folder WHERE id = :id"
+#define FOLDER_AGGREGATES_SUBFOLDERS_QUERY "SELECT name, firstChildHash FROM folder WHERE parentId = :parentId AND id <> 1"
+#define FOLDER_AGGREGATES_QUERY "SELECT numChildren, firstChildHash FROM folder WHERE id = :id"
+#define UPDATE_FOLDER_AGGREGATES_QUERY "UPDATE folder SET numChildren = :numChildren, firstChildHash = :firstChildHash WHERE id = :id"
+
+// repair pass, all the folders are recomputed in one statement:
+// subtree lists every (folder, descendant) pair with a key that sorts the descendants in depth first order,
+// and the cover of a folder is the first comic of the first folder of its subtree that has comics.
+// Names are compared case insensitively, the natural order is only applied by the incremental updates.
+inline QString repairFolderAggregatesQuery()
+{
+    return "WITH RECURSIVE subtree(rootId, folderId, sortKey) AS ("
+           "    SELECT id, id, '' FROM folder WHERE id <> 1 "
+           "    UNION ALL "
+           "    SELECT s.rootId, f.id, s.sortKey || char(1) || f.name "
+           "    FROM subtree s INNER JOIN folder f ON (f.parentId = s.folderId AND f.id <> 1)"
+           "), "
+           "covers(folderId, hash) AS ("
+           "    SELECT rootId, hash FROM ("
+           "        SELECT s.rootId, ci.hash, ROW_NUMBER() OVER (PARTITION BY s.rootId ORDER BY s.sortKey COLLATE NOCASE, c.fileName COLLATE NOCASE) AS position "
+           "        FROM subtree s INNER JOIN comic c ON (c.parentId = s.folderId) INNER JOIN comic_info ci ON (c.comicInfoId = ci.id)"
+           "    ) WHERE position = 1"
+           "), "
+           "counts(folderId, numChildren) AS ("
+           "    SELECT f.id, (SELECT COUNT(*) FROM folder sf WHERE sf.parentId = f.id AND sf.id <> 1) + (SELECT COUNT(*) FROM comic c WHERE c.parentId = f.id) "
+           "    FROM folder f WHERE f.id <> 1"
+           ") "
+           "UPDATE folder SET numChildren = counts.numChildren, firstChildHash = COALESCE(covers.hash, '') "
+           "FROM counts LEFT JOIN covers ON (covers.folderId = counts.folderId) "
+           "WHERE folder.id = counts.folderId";
+}
+
+// same result for SQLite < 3.33 (no UPDATE ... FROM), the subtree of every folder is walked by its own subquery
+inline QString repairFolderAggregatesLegacyQuery()
+{
+    return "UPDATE folder SET "
+           "numChildren = (SELECT COUNT(*) FROM folder sf WHERE sf.parentId = folder.id AND sf.id <> 1) + (SELECT COUNT(*) FROM comic c WHERE c.parentId = folder.id), "
+           "firstChildHash = COALESCE(("
+           "    WITH RECURSIVE subtree(folderId, sortKey) AS ("
+           "        SELECT folder.id, '' "
+           "        UNION ALL "
+           "        SELECT f.id, s.sortKey || char(1) || f.name "
+           "        FROM subtree s INNER JOIN folder f ON (f.parentId = s.folderId AND f.id <> 1)"
+           "    ) "
+           "    SELECT ci.hash FROM subtree s INNER JOIN comic c ON (c.parentId = s.folderId) INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
+           "    ORDER BY s.sortKey COLLATE NOCASE, c.fileName COLLATE NOCASE LIMIT 1"
+           "), '') "
+           "WHERE id <> 1";
+}
+
+// sets the `updated` date of the folders in `ids` and their ancestors (the root folder excluded)
+inline QString updateFoldersAndAncestorsQuery(const QString &ids)
+{
+    return "WITH RECURSIVE ancestors(id) AS ("
+           "SELECT id FROM folder WHERE id IN (" + ids + ") "
+           "UNION "
+           "SELECT f.parentId FROM folder f INNER JOIN ancestors a ON (f.id = a.id)) "
+           "UPDATE folder SET updated = :updated "
+           "WHERE id IN (SELECT id FROM ancestors) AND id NOT IN (0, 1)";
+}
+
+// comics
+#define COMIC_INFO_BY_HASH_QUERY "SELECT * FROM comic_info WHERE hash = :hash"
+#define COMIC_BY_ID_QUERY "SELECT c.id,c.parentId,c.fileName,c.path,ci.hash FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.id = :id"
+#define COMIC_BY_HASH_QUERY "SELECT c.path,ci.coverPage FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE ci.hash = :hash"
+
+inline QString comicsByIdQuery(const QString &ids)
+{
+    return "SELECT * FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.id IN (" + ids + ")";
+}
+
+// labels and reading lists
+#define IS_FAVORITE_COMIC_QUERY "SELECT * FROM comic_default_reading_list cl WHERE cl.comic_id = :comic_id AND cl.default_reading_list_id = 1"
+#define REMOVE_LABEL_FROM_COMIC_QUERY "DELETE FROM comic_label WHERE comic_id = :comic_id AND label_id = :label_id"
+#define READING_LIST_SUBLISTS_QUERY "SELECT id FROM reading_list WHERE parentId = :parentId ORDER BY ordering ASC"
+#define LABEL_COMICS_FROM "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) INNER JOIN comic_label cl ON (c.id == cl.comic_id) WHERE cl.label_id = :parentLabelId ORDER BY cl.ordering"
+#define READING_LIST_COMICS_FROM "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) INNER JOIN comic_reading_list crl ON (c.id == crl.comic_id) WHERE crl.reading_list_id = :parentReadingList ORDER BY crl.ordering"
+#define DEFAULT_READING_LIST_COMICS_FROM "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) INNER JOIN comic_default_reading_list cdrl ON (c.id == cdrl.comic_id) WHERE cdrl.default_reading_list_id = :parentDefaultListId ORDER BY cdrl.ordering"
+#define READING_COMICS_FROM "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE ci.hasBeenOpened = 1 AND ci.read = 0 ORDER BY ci.lastTimeOpened DESC"
+#define RECENT_COMICS_FROM "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE ci.added > :limit ORDER BY ci.added DESC"
+
+// server (v2 API)
+#define FOLDER_CONTENT_SUBFOLDERS_QUERY "SELECT id, name FROM folder WHERE parentId = :parentId AND id <> 1"
+#define FOLDER_CONTENT_COMICS_QUERY "SELECT id, fileName FROM comic WHERE parentId = :parentId"
+#define LABEL_CONTENT_QUERY "SELECT comic_id FROM comic_label WHERE label_id = :labelId ORDER BY ordering"
+#define READING_LIST_CONTENT_QUERY "SELECT comic_id FROM comic_reading_list WHERE reading_list_id = :readingListId ORDER BY ordering"
+
+// comics info packs, see DataBaseManagement::importComicsInfo
+
+// comic_info fields carried by the comics info packs besides hash and edited
+inline QStringList comicsInfoFields()
+{
+    return {
+        "title",
+        "coverPage", "numPages",
+        "number", "isBis", "count",
+        "volume", "storyArc", "arcNumber", "arcCount",
+        "genere",
+        "writer", "penciller", "inker", "colorist", "letterer", "coverArtist",
+        "date", "publisher", "format", "color", "ageRating",
+        "synopsis", "characters", "notes",
+        "read",
+        // new 7.0 fields
+        "hasBeenOpened", "rating", "currentPage", "bookmark1", "bookmark2", "bookmark3", "brightness", "contrast", "gamma",
+        // new 7.1 fields
+        "comicVineID",
+        // new 9.5 fields
+        "lastTimeOpened",
+        // "coverSizeRatio", "originalCoverSize": the cover may have changed since the info was exported...
+        // new 9.8 fields
+        // "manga", removed in 9.13
+        // new 9.13 fields
+        "added", "type", "editor", "imprint", "teams", "locations", "series", "alternateSeries", "alternateNumber",
+        "alternateCount", "languageISO", "seriesGroup", "mainCharacterOrTeam", "review", "tags"
+    };
+}
+
+// the JSON lines packs are staged in this table before being upserted
+inline QString createComicsInfoStagingTableQuery()
+{
+    return "CREATE TEMP TABLE imported_info (" + (QStringList { "hash" } + comicsInfoFields()).join(",") + ")";
+}
+
+// Upserts the rows of `table` (an attached pack or the staging table) with rowid in (:from, :to] into comic_info.
+// The info from the pack replaces the one in the library, with `keepMissing` the NULL fields of the pack are the ones
+// a comic doesn't carry and keep the values of the library. Missing fields in new comics get the defaults of comic_info
+inline QString comicsInfoUpsertQuery(const QString &table, const QStringList &fields, bool keepMissing)
+{
+    static const QHash<QString, QString> defaults = {
+        { "coverPage", "1" }, { "read", "0" }, { "hasBeenOpened", "0" }, { "rating", "0" }, { "currentPage", "1" },
+        { "bookmark1", "-1" }, { "bookmark2", "-1" }, { "bookmark3", "-1" },
+        { "brightness", "-1" }, { "contrast", "-1" }, { "gamma", "-1" }, { "type", "0" }
+    };
+
+    QStringList values, updates;
+    for (const auto &field : fields) {
+        values << (defaults.contains(field) ? "IFNULL(" + field + "," + defaults.value(field) + ")" : field);
+        updates << field + (keepMissing ? " = IFNULL(excluded." + field + "," + field + ")" : " = excluded." + field);
+    }
+    values << "hash"
+           << "1";
+    updates << "edited = 1";
+
+    // the WHERE clause is needed, SQLite would parse ON CONFLICT as a join constraint without it
+    return "INSERT INTO main.comic_info (" + (fields + QStringList { "hash", "edited" }).join(",") + ") "
+           "SELECT " + values.join(",") + " FROM " + table + " "
+           "WHERE rowid > :from AND rowid <= :to AND hash IS NOT NULL "
+           "ON CONFLICT(hash) DO UPDATE SET " + updates.join(",");
+}
+
+// comics of `table` with rowid in (:from, :to] whose cover page changes, their covers have to be extracted again
+inline QString comicsInfoChangedCoversQuery(const QString &table)
+{
+    return "SELECT s.hash FROM " + table + " s INNER JOIN main.comic_info ci ON (ci.hash = s.hash) "
+           "WHERE s.rowid > :from AND s.rowid <= :to AND s.coverPage > 1 AND s.coverPage <> ci.coverPage";
+}
+
+#endif // LIBRARY_QUERIES_H
@@ -0,0 +1,250 @@
+#ifndef LIBRARY_SCHEMA_H
+#define LIBRARY_SCHEMA_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// Statements that create the tables of the library database, run by DataBaseManagement::createTables and the migrations.
+// tests/library_query_plan_test builds its library with them too, so the plans it checks are the ones of the real schema.
+
+// COMIC INFO (representa la información de un cómic, cada cómic tendrá un idéntificador único formado por un hash sha1'de los primeros 512kb' + su tamaño en bytes)
+inline QString comicInfoTableSchema(const QString &tableName = "comic_info")
+{
+    return "CREATE TABLE " + tableName + " ("
+                                         "id INTEGER PRIMARY KEY,"
+                                         "title TEXT,"
+
+                                         "coverPage INTEGER DEFAULT 1,"
+                                         "numPages INTEGER,"
+
+                                         "number TEXT," // changed to text from INTEGER (9.13)
+                                         "isBis BOOLEAN,"
+                                         "count INTEGER,"
+
+                                         "volume TEXT,"
+                                         "storyArc TEXT,"
+                                         "arcNumber TEXT," // changed to text from INTEGER (9.13)
+                                         "arcCount INTEGER,"
+
+                                         "genere TEXT,"
+
+                                         "writer TEXT,"
+                                         "penciller TEXT,"
+                                         "inker TEXT,"
+                                         "colorist TEXT,"
+                                         "letterer TEXT,"
+                                         "coverArtist TEXT,"
+
+                                         "date TEXT," // publication date dd/mm/yyyy --> se mostrará en 3 campos diferentes
+                                         "publisher TEXT,"
+                                         "format TEXT,"
+                                         "color BOOLEAN,"
+                                         "ageRating TEXT,"
+
+                                         "synopsis TEXT,"
+                                         "characters TEXT,"
+                                         "notes TEXT,"
+
+                                         "hash TEXT UNIQUE NOT NULL,"
+                                         "edited BOOLEAN DEFAULT 0,"
+                                         "read BOOLEAN DEFAULT 0,"
+                                         // new 7.0 fields
+
+                                         "hasBeenOpened BOOLEAN DEFAULT 0,"
+                                         "rating REAL DEFAULT 0," // changed to REAL from INTEGER (9.13)
+                                         "currentPage INTEGER DEFAULT 1, "
+                                         "bookmark1 INTEGER DEFAULT -1, "
+                                         "bookmark2 INTEGER DEFAULT -1, "
+                                         "bookmark3 INTEGER DEFAULT -1, "
+                                         "brightness INTEGER DEFAULT -1, "
+                                         "contrast INTEGER DEFAULT -1, "
+                                         "gamma INTEGER DEFAULT -1, "
+                                         // new 7.1 fields
+                                         "comicVineID TEXT,"
+                                         // new 9.5 fields
+                                         "lastTimeOpened INTEGER,"
+                                         "coverSizeRatio REAL,"
+                                         "originalCoverSize STRING," // h/w
+                                         // new 9.8 fields
+                                         "manga BOOLEAN DEFAULT 0," // deprecated 9.13
+                                         // new 9.13 fields
+                                         "added INTEGER,"
+                                         "type INTEGER DEFAULT 0," // 0 = comic, 1 = manga, 2 = manga left to right, 3 = webcomic, 4 = 4koma
+                                         "editor TEXT,"
+                                         "imprint TEXT,"
+                                         "teams TEXT,"
+                                         "locations TEXT,"
+                                         "series TEXT,"
+                                         "alternateSeries TEXT,"
+                                         "alternateNumber TEXT,"
+                                         "alternateCount INTEGER,"
+                                         "languageISO TEXT,"
+                                         "seriesGroup TEXT,"
+                                         "mainCharacterOrTeam TEXT,"
+                                         "review TEXT,"
+                                         "tags TEXT"
+                                         ")";
+}
+
+// FOLDER (representa una carpeta en disco)
+inline QString folderTableSchema()
+{
+    return "CREATE TABLE folder ("
+           "id INTEGER PRIMARY KEY,"
+           "parentId INTEGER NOT NULL,"
+           "name TEXT NOT NULL,"
+           "path TEXT NOT NULL,"
+           // new 7.1 fields
+           "finished BOOLEAN DEFAULT 0," // reading
+           "completed BOOLEAN DEFAULT 1," // collecting
+           // new 9.5 fields
+           "numChildren INTEGER,"
+           "firstChildHash TEXT,"
+           "customImage TEXT,"
+           // new 9.8 fields
+           "manga BOOLEAN DEFAULT 0," // deprecated 9.13
+           // new 9.13 fields
+           "type INTEGER DEFAULT 0," // 0 = comic, 1 = manga, 2 = manga left to right, 3 = webcomic, 4 = 4koma
+           "added INTEGER,"
+           "updated INTEGER," // updated when the folder gets new content
+           "FOREIGN KEY(parentId) REFERENCES folder(id) ON DELETE CASCADE)";
+}
+
+// COMIC (representa un cómic en disco, contiene el nombre de fichero)
+inline QString comicTableSchema()
+{
+    return "CREATE TABLE comic (id INTEGER PRIMARY KEY, parentId INTEGER NOT NULL, comicInfoId INTEGER NOT NULL,  fileName TEXT NOT NULL, path TEXT, FOREIGN KEY(parentId) REFERENCES folder(id) ON DELETE CASCADE, FOREIGN KEY(comicInfoId) REFERENCES comic_info(id))";
+}
+
+// 8.0> tables, labels and reading lists, with the default reading lists
+inline QStringList v8TablesSchema()
+{
+    return QStringList()
+            // LABEL
+            << "CREATE TABLE label (id INTEGER PRIMARY KEY, "
+               "name TEXT NOT NULL, "
+               "color TEXT NOT NULL, "
+               "ordering INTEGER NOT NULL); " // order depends on the color
+            << "CREATE INDEX label_ordering_index ON label (ordering)"
+            // COMIC LABEL
+            << "CREATE TABLE comic_label ("
+               "comic_id INTEGER, "
+               "label_id INTEGER, "
+               "ordering INTEGER, " // TODO order????
+               "FOREIGN KEY(label_id) REFERENCES label(id) ON DELETE CASCADE, "
+               "FOREIGN KEY(comic_id) REFERENCES comic(id) ON DELETE CASCADE, "
+               "PRIMARY KEY(label_id, comic_id))"
+            << "CREATE INDEX comic_label_ordering_index ON label (ordering)"
+            // READING LIST
+            << "CREATE TABLE reading_list ("
+               "id INTEGER PRIMARY KEY, "
+               "parentId INTEGER, "
+               "ordering INTEGER DEFAULT 0, " // only use it if the parentId is NULL
+               "name TEXT NOT NULL, "
+               "finished BOOLEAN DEFAULT 0, "
+               "completed BOOLEAN DEFAULT 1, "
+               "manga BOOLEAN DEFAULT 0, " // TODO never used, replace with `type`
+               "FOREIGN KEY(parentId) REFERENCES reading_list(id) ON DELETE CASCADE)"
+            << "CREATE INDEX reading_list_ordering_index ON label (ordering)"
+            // COMIC READING LIST
+            << "CREATE TABLE comic_reading_list ("
+               "reading_list_id INTEGER, "
+               "comic_id INTEGER, "
+               "ordering INTEGER, "
+               "FOREIGN KEY(reading_list_id) REFERENCES reading_list(id) ON DELETE CASCADE, "
+               "FOREIGN KEY(comic_id) REFERENCES comic(id) ON DELETE CASCADE, "
+               "PRIMARY KEY(reading_list_id, comic_id))"
+            << "CREATE INDEX comic_reading_list_ordering_index ON label (ordering)"
+            // DEFAULT READING LISTS
+            << "CREATE TABLE default_reading_list ("
+               "id INTEGER PRIMARY KEY, "
+               "name TEXT NOT NULL"
+               // TODO icon????
+               ")"
+            // COMIC DEFAULT READING LISTS
+            << "CREATE TABLE comic_default_reading_list ("
+               "comic_id INTEGER, "
+               "default_reading_list_id INTEGER, "
+               "ordering INTEGER, " // order????
+               "FOREIGN KEY(default_reading_list_id) REFERENCES default_reading_list(id) ON DELETE CASCADE, "
+               "FOREIGN KEY(comic_id) REFERENCES comic(id) ON DELETE CASCADE,"
+               "PRIMARY KEY(default_reading_list_id, comic_id))"
+            << "CREATE INDEX comic_default_reading_list_ordering_index ON label (ordering)"
+            // INSERT DEFAULT READING LISTS
+            // 1 Favorites
+            << "INSERT INTO default_reading_list (name) VALUES (\"Favorites\")";
+    // Reading doesn't need its onw list
+}
+
+// 9.15> full text search. External content FTS5 tables, they only store the index and read the text from the indexed tables.
+// The trigram tokenizer indexes every 3 characters sequence, so a term matches anywhere in the text like the LIKE '%term%' it
+// replaces ("man" finds "Superman", "x-men" finds "X-Men"); shorter terms can't use it (see QueryParser::TreeNode::usesFullTextIndex).
+// The triggers keep them in sync, updates only touch the index when the value of an indexed column changes (comic_info is
+// updated all the time with the reading progress, and its updates set every column). The last statement of every index indexes
+// the existing rows
+inline QStringList fullTextIndexSchema()
+{
+    QStringList comicInfoColumns = QStringList() << "date"
+                                                 << "number"
+                                                 << "arcnumber"
+                                                 << "title"
+                                                 << "volume"
+                                                 << "storyarc"
+                                                 << "genere"
+                                                 << "writer"
+                                                 << "penciller"
+                                                 << "inker"
+                                                 << "colorist"
+                                                 << "letterer"
+                                                 << "coverartist"
+                                                 << "publisher"
+                                                 << "format"
+                                                 << "agerating"
+                                                 << "synopsis"
+                                                 << "characters"
+                                                 << "notes"
+                                                 << "editor"
+                                                 << "imprint"
+                                                 << "teams"
+                                                 << "locations"
+                                                 << "series"
+                                                 << "alternateSeries"
+                                                 << "alternateNumber"
+                                                 << "languageISO"
+                                                 << "seriesGroup"
+                                                 << "mainCharacterOrTeam"
+                                                 << "review"
+                                                 << "tags";
+
+    struct FullTextIndex {
+        QString name;
+        QString table;
+        QStringList columns;
+    };
+    QList<FullTextIndex> indexes = { { "comic_info_fts", "comic_info", comicInfoColumns },
+                                     { "comic_fts", "comic", { "fileName" } },
+                                     { "folder_fts", "folder", { "name" } } };
+
+    QStringList statements;
+    for (const auto &index : indexes) {
+        QStringList newValues, oldValues, changes;
+        for (const auto &column : index.columns) {
+            newValues << "new." + column;
+            oldValues << "old." + column;
+            changes << QString("old.%1 IS NOT new.%1").arg(column);
+        }
+        auto columns = index.columns.join(", ");
+        auto insertNew = QString("INSERT INTO %1(rowid, %2) VALUES (new.id, %3);").arg(index.name, columns, newValues.join(", "));
+        auto deleteOld = QString("INSERT INTO %1(%1, rowid, %2) VALUES ('delete', old.id, %3);").arg(index.name, columns, oldValues.join(", "));
+
+        statements << QString("CREATE VIRTUAL TABLE %1 USING fts5(%2, content='%3', content_rowid='id', tokenize='trigram')").arg(index.name, columns, index.table)
+                   << QString("CREATE TRIGGER %1_insert AFTER INSERT ON %2 BEGIN %3 END").arg(index.name, index.table, insertNew)
+                   << QString("CREATE TRIGGER %1_delete AFTER DELETE ON %2 BEGIN %3 END").arg(index.name, index.table, deleteOld)
+                   << QString("CREATE TRIGGER %1_update AFTER UPDATE OF %2 ON %3 WHEN %4 BEGIN %5 %6 END").arg(index.name, columns, index.table, changes.join(" OR "), deleteOld, insertNew)
+                   << QString("INSERT INTO %1(%1) VALUES ('rebuild')").arg(index.name);
+    }
+    return statements;
+}
+
+#endif // LIBRARY_SCHEMA_H
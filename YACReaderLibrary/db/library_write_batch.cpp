@@ -0,0 +1,181 @@
+#include "library_write_batch.h"
+
+#include <QDateTime>
+#include <QSqlError>
+#include <QStringList>
+
+#include <utility>
+
+#include "comic_db.h"
+#include "db_helper.h"
+#include "folder.h"
+#include "library_queries.h"
+
+#include "QsLog.h"
+
+LibraryWriteBatch::LibraryWriteBatch(QSqlDatabase &db, int maxPendingComics)
+    : db(db), maxPendingComics(maxPendingComics), insertFolderQuery(db), insertComicInfoQuery(db), insertComicQuery(db), updateComicInfoQuery(db), selectComicInfoQuery(db), lastUpdate(0)
+{
+    insertFolderQuery.prepare("INSERT INTO folder (parentId, name, path, added, numChildren) "
+                              "VALUES (:parentId, :name, :path, :added, 0)");
+    insertComicInfoQuery.prepare("INSERT INTO comic_info (hash,numPages,coverSizeRatio,originalCoverSize,added) "
+                                 "VALUES (:hash,:numPages,:coverSizeRatio,:originalCoverSize,:added)");
+    insertComicQuery.prepare("INSERT INTO comic (parentId, comicInfoId, fileName, path) "
+                             "VALUES (:parentId,:comicInfoId,:name, :path)");
+    selectComicInfoQuery.prepare(COMIC_INFO_BY_HASH_QUERY);
+    DBHelper::prepareComicInfoUpdate(updateComicInfoQuery);
+}
+
+LibraryWriteBatch::~LibraryWriteBatch()
+{
+    if (!parentIds.isEmpty()) {
+        QLOG_WARN() << "Discarding" << parentIds.size() << "comics that were not written to the library";
+    }
+}
+
+qulonglong LibraryWriteBatch::insert(Folder *folder)
+{
+    auto added = QDateTime::currentSecsSinceEpoch();
+    folder->added = added;
+
+    insertFolderQuery.bindValue(":parentId", folder->parentId);
+    insertFolderQuery.bindValue(":name", folder->name);
+    insertFolderQuery.bindValue(":path", folder->path);
+    insertFolderQuery.bindValue(":added", added);
+    insertFolderQuery.exec();
+
+    return insertFolderQuery.lastInsertId().toULongLong();
+}
+
+void LibraryWriteBatch::insert(ComicDB *comic, bool insertAllInfo)
+{
+    auto added = QDateTime::currentSecsSinceEpoch();
+
+    if (!comic->info.existOnDb) {
+        insertComicInfoQuery.bindValue(":hash", comic->info.hash);
+        insertComicInfoQuery.bindValue(":numPages", comic->info.numPages);
+        insertComicInfoQuery.bindValue(":coverSizeRatio", comic->info.coverSizeRatio);
+        insertComicInfoQuery.bindValue(":originalCoverSize", comic->info.originalCoverSize);
+        insertComicInfoQuery.bindValue(":added", added);
+        insertComicInfoQuery.exec();
+        comic->info.id = insertComicInfoQuery.lastInsertId().toULongLong();
+        comic->info.added = added;
+        comic->_hasCover = false;
+
+        if (insertAllInfo) {
+            update(&(comic->info));
+        }
+    } else
+        comic->_hasCover = true;
+
+    parentIds.append(comic->parentId);
+    comicInfoIds.append(comic->info.id);
+    fileNames.append(comic->name);
+    paths.append(comic->path);
+
+    if (comic->parentId != 1 && comic->parentId != 0) {
+        updatedFolders.insert(comic->parentId);
+        lastUpdate = added;
+    }
+
+    if (parentIds.size() >= maxPendingComics) {
+        flush();
+    }
+}
+
+bool LibraryWriteBatch::update(ComicInfo *comicInfo)
+{
+    if (comicInfo == nullptr)
+        return false;
+
+    if (!DBHelper::update(comicInfo, updateComicInfoQuery)) {
+        QLOG_ERROR() << "Unable to update comic info" << comicInfo->id << ":" << updateComicInfoQuery.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+ComicDB LibraryWriteBatch::loadComic(const QString &name, const QString &path, const QString &hash)
+{
+    ComicDB comic;
+
+    comic.name = name;
+    comic.path = path;
+
+    selectComicInfoQuery.bindValue(":hash", hash);
+    selectComicInfoQuery.exec();
+
+    if (selectComicInfoQuery.next()) {
+        comic.info = DBHelper::getComicInfoFromQuery(selectComicInfoQuery);
+    } else {
+        comic.info.existOnDb = false;
+    }
+    selectComicInfoQuery.finish();
+
+    if (!comic.info.existOnDb) {
+        comic.info.hash = hash;
+        comic.info.coverPage = 1;
+        comic._hasCover = false;
+    } else
+        comic._hasCover = true;
+
+    return comic;
+}
+
+// writes the pending comics, if something fails none of them is written
+bool LibraryWriteBatch::flush()
+{
+    if (parentIds.isEmpty()) {
+        return true;
+    }
+
+    QSqlQuery savepoint(db);
+    savepoint.exec("SAVEPOINT library_write_batch");
+
+    insertComicQuery.bindValue(":parentId", parentIds);
+    insertComicQuery.bindValue(":comicInfoId", comicInfoIds);
+    insertComicQuery.bindValue(":name", fileNames);
+    insertComicQuery.bindValue(":path", paths);
+
+    bool success = insertComicQuery.execBatch();
+    if (!success) {
+        QLOG_ERROR() << "Unable to insert" << parentIds.size() << "comics :" << insertComicQuery.lastError().text();
+    } else {
+        success = updateFolders();
+    }
+
+    if (!success) {
+        savepoint.exec("ROLLBACK TO library_write_batch");
+    }
+    savepoint.exec("RELEASE library_write_batch");
+
+    parentIds.clear();
+    comicInfoIds.clear();
+    fileNames.clear();
+    paths.clear();
+    updatedFolders.clear();
+
+    return success;
+}
+
+// sets the `updated` date of the folders with new comics and their ancestors (the root folder excluded), all in one statement
+bool LibraryWriteBatch::updateFolders()
+{
+    if (updatedFolders.isEmpty()) {
+        return true;
+    }
+
+    QStringList ids;
+    for (auto id : std::as_const(updatedFolders)) {
+        ids << QString::number(id);
+    }
+
+    QSqlQuery query(db);
+    query.prepare(updateFoldersAndAncestorsQuery(ids.join(",")));
+    query.bindValue(":updated", lastUpdate);
+    if (!query.exec()) {
+        QLOG_ERROR() << "Unable to update the folders of the new comics :" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef LIBRARY_WRITE_BATCH_H
+#define LIBRARY_WRITE_BATCH_H
+
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QVariantList>
+
+class ComicDB;
+class ComicInfo;
+class Folder;
+
+// Writes many rows in a library DB (library scans, metadata imports) preparing each statement only once.
+// Folders and comic infos are inserted right away because their ids are needed by the rows that follow, comic rows and
+// the `updated` date of their folders are accumulated and written together inside a savepoint.
+// The transaction is managed by the caller, pending rows must be written with flush() before it is committed,
+// the rows that haven't been flushed when the batch is destroyed are discarded.
+class LibraryWriteBatch
+{
+public:
+    explicit LibraryWriteBatch(QSqlDatabase &db, int maxPendingComics = 1000);
+    ~LibraryWriteBatch();
+
+    // same as DBHelper::insert(Folder *, QSqlDatabase &)
+    qulonglong insert(Folder *folder);
+    // same as DBHelper::insert(ComicDB *, QSqlDatabase &, bool) but the comic row is written in the next flush
+    void insert(ComicDB *comic, bool insertAllInfo);
+    // same as DBHelper::update(ComicInfo *, QSqlDatabase &), it is written right away
+    bool update(ComicInfo *comicInfo);
+    // same as DBHelper::loadComic(QString, QString, QString, QSqlDatabase &)
+    ComicDB loadComic(const QString &name, const QString &path, const QString &hash);
+
+    bool flush();
+    int pendingComics() const { return parentIds.size(); }
+
+private:
+    bool updateFolders();
+
+    QSqlDatabase db;
+    int maxPendingComics;
+
+    QSqlQuery insertFolderQuery;
+    QSqlQuery insertComicInfoQuery;
+    QSqlQuery insertComicQuery;
+    QSqlQuery updateComicInfoQuery;
+    QSqlQuery selectComicInfoQuery;
+
+    // pending comic rows, by column
+    QVariantList parentIds;
+    QVariantList comicInfoIds;
+    QVariantList fileNames;
+    QVariantList paths;
+    QSet<qulonglong> updatedFolders;
+    qint64 lastUpdate;
+};
+
+#endif // LIBRARY_WRITE_BATCH_H
@@ -1,6 +1,7 @@
 #include "query_parser.h"
 
 #include <QVariant>
+#include <algorithm>
 #include <type_traits>
 #include <numeric>
 #include <stdexcept>
@@ -39,12 +40,28 @@ std::string parseDate(const std::string &dateString, const std::string &expOpera
     return std::to_string(date);
 }
 
-int QueryParser::TreeNode::buildSqlString(std::string &sqlString, int bindPosition) const
+int QueryParser::TreeNode::buildSqlString(std::string &sqlString, int bindPosition, bool fullText) const
 {
     // TODO: add some semantic checks, not all operators apply to all fields
     if (t == "expression") {
         ++bindPosition;
-        if (toLower(children[0].t) == "all") {
+        if (fullText && usesFullTextIndex()) {
+            auto bind = ":bindPosition" + std::to_string(bindPosition);
+            auto type = fieldType(children[0].t);
+            // every condition is a lookup in one of the indexes of comic, so the conditions joined with OR can still use them
+            // (an OR of conditions on different tables scans all the comics)
+            if (toLower(children[0].t) == "all") {
+                sqlString += "(c.id IN (SELECT id FROM comic WHERE comicInfoId IN (SELECT rowid FROM comic_info_fts WHERE comic_info_fts MATCH " + bind + ") ";
+                sqlString += "UNION SELECT rowid FROM comic_fts WHERE comic_fts MATCH " + bind + " ";
+                sqlString += "UNION SELECT id FROM comic WHERE parentId IN (SELECT rowid FROM folder_fts WHERE folder_fts MATCH " + bind + "))) ";
+            } else if (type == FieldType::filename) {
+                sqlString += "(c.id IN (SELECT rowid FROM comic_fts WHERE comic_fts MATCH " + bind + ")) ";
+            } else if (type == FieldType::folder) {
+                sqlString += "(c.parentId IN (SELECT rowid FROM folder_fts WHERE folder_fts MATCH " + bind + ")) ";
+            } else {
+                sqlString += "(c.comicInfoId IN (SELECT rowid FROM comic_info_fts WHERE comic_info_fts MATCH " + bind + ")) ";
+            }
+        } else if (toLower(children[0].t) == "all") {
             sqlString += "(";
             for (const auto &field : fieldNames.at(FieldType::text)) {
                 sqlString += "UPPER(ci." + field + ") LIKE UPPER(:bindPosition" + std::to_string(bindPosition) + ") OR ";
@@ -83,24 +100,26 @@ int QueryParser::TreeNode::buildSqlString(std::string &sqlString, int bindPositi
         }
     } else if (t == "not") {
         sqlString += "(NOT ";
-        bindPosition = children[0].buildSqlString(sqlString, bindPosition);
+        bindPosition = children[0].buildSqlString(sqlString, bindPosition, fullText);
         sqlString += ")";
     } else {
         sqlString += "(";
-        bindPosition = children[0].buildSqlString(sqlString, bindPosition);
+        bindPosition = children[0].buildSqlString(sqlString, bindPosition, fullText);
         sqlString += " " + t + " ";
-        bindPosition = children[1].buildSqlString(sqlString, bindPosition);
+        bindPosition = children[1].buildSqlString(sqlString, bindPosition, fullText);
         sqlString += ")";
     }
 
     return bindPosition;
 }
 
-int QueryParser::TreeNode::bindValues(QSqlQuery &selectQuery, int bindPosition) const
+int QueryParser::TreeNode::bindValues(QSqlQuery &selectQuery, int bindPosition, bool fullText) const
 {
     if (t == "expression") {
         std::string bind_string(":bindPosition" + std::to_string(++bindPosition));
-        if (isIn(fieldType(children[0].t), { FieldType::numeric })) {
+        if (fullText && usesFullTextIndex()) {
+            selectQuery.bindValue(QString::fromStdString(bind_string), QString::fromStdString(fullTextQuery()));
+        } else if (isIn(fieldType(children[0].t), { FieldType::numeric })) {
             selectQuery.bindValue(QString::fromStdString(bind_string), std::stoi(children[1].t));
         } else if (isIn(fieldType(children[0].t), { FieldType::boolean, FieldType::booleanFolder })) {
             auto value = toLower(children[1].t);
@@ -139,15 +158,74 @@ int QueryParser::TreeNode::bindValues(QSqlQuery &selectQuery, int bindPosition)
             }
         }
     } else if (t == "not") {
-        bindPosition = children[0].bindValues(selectQuery, bindPosition);
+        bindPosition = children[0].bindValues(selectQuery, bindPosition, fullText);
     } else {
-        bindPosition = children[0].bindValues(selectQuery, bindPosition);
-        bindPosition = children[1].bindValues(selectQuery, bindPosition);
+        bindPosition = children[0].bindValues(selectQuery, bindPosition, fullText);
+        bindPosition = children[1].bindValues(selectQuery, bindPosition, fullText);
     }
 
     return bindPosition;
 }
 
+bool QueryParser::TreeNode::usesFullTextIndex() const
+{
+    if (t != "expression" || children[1].t.empty()) {
+        return false;
+    }
+
+    // exact matches and comparisons can't be answered by the index
+    if (toLower(children[0].t) != "all" && !(expOperator == "=" || expOperator == ":" || expOperator == "")) {
+        return false;
+    }
+
+    // the trigram index only finds terms of 3 characters or more, shorter ones keep using LIKE
+    if (QString::fromStdString(children[1].t).toUcs4().size() < 3) {
+        return false;
+    }
+
+    return toLower(children[0].t) == "all" || isIn(fieldType(children[0].t), { FieldType::text, FieldType::filename, FieldType::folder });
+}
+
+std::string QueryParser::TreeNode::fullTextQuery() const
+{
+    // the term is searched as a phrase, so FTS5 operators in it are just text; with the trigram tokenizer the phrase matches anywhere in the text
+    std::string phrase = "\"";
+    for (auto c : children[1].t) {
+        phrase += c;
+        if (c == '"') {
+            phrase += '"';
+        }
+    }
+    phrase += "\"";
+
+    auto type = fieldType(children[0].t);
+    if (toLower(children[0].t) == "all" || type == FieldType::filename || type == FieldType::folder) {
+        return phrase;
+    }
+
+    return "{" + toLower(children[0].t) + "} : " + phrase;
+}
+
+std::string QueryParser::TreeNode::rankingQuery() const
+{
+    if (t == "expression") {
+        auto type = fieldType(children[0].t);
+        if (usesFullTextIndex() && type != FieldType::filename && type != FieldType::folder) {
+            return fullTextQuery();
+        }
+        return "";
+    } else if (t == "not") {
+        return "";
+    }
+
+    auto lhs = children[0].rankingQuery();
+    auto rhs = children[1].rankingQuery();
+    if (lhs.empty() || rhs.empty()) {
+        return lhs + rhs;
+    }
+    return "(" + lhs + ") OR (" + rhs + ")";
+}
+
 QueryParser::QueryParser()
 {
 }
@@ -166,6 +244,28 @@ QueryParser::TreeNode QueryParser::parse(const std::string &expr)
     return prog;
 }
 
+std::string QueryParser::TreeNode::foldersSearchSql(bool fullText) const
+{
+    std::string sql(SEARCH_FOLDERS_QUERY);
+    buildSqlString(sql, 0, fullText);
+    sql += " AND f.id <> 1 ORDER BY f.parentId,f.name";
+    return sql;
+}
+
+std::string QueryParser::TreeNode::comicsSearchSql(bool fullText, bool ranked) const
+{
+    std::string sql(ranked ? SEARCH_COMICS_RANKED_QUERY : SEARCH_COMICS_QUERY);
+    buildSqlString(sql, 0, fullText);
+    if (ranked) {
+        // bm25 is lower for better matches
+        sql += " ORDER BY r.rank IS NULL, r.rank, c.id";
+    } else {
+        sql += " ORDER BY c.id";
+    }
+    sql += " LIMIT :limit OFFSET :offset";
+    return sql;
+}
+
 std::string QueryParser::toLower(const std::string &string)
 {
     std::string res(string);
@@ -232,7 +332,7 @@ bool QueryParser::isOperatorToken(Token::Type type)
 QueryParser::FieldType QueryParser::fieldType(const std::string &str)
 {
     for (const auto &names : fieldNames) {
-        if (std::find(names.second.begin(), names.second.end(), toLower(str)) != names.second.end()) {
+        if (std::find_if(names.second.begin(), names.second.end(), [&str](const std::string &name) { return toLower(name) == toLower(str); }) != names.second.end()) {
             return names.first;
         }
     }
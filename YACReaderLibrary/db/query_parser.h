@@ -11,6 +11,8 @@
 
 #define SEARCH_FOLDERS_QUERY "SELECT DISTINCT f.* FROM folder f LEFT JOIN comic c ON (f.id = c.parentId) INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE "
 #define SEARCH_COMICS_QUERY "SELECT ci.number,ci.title,c.fileName,ci.numPages,c.id,c.parentId,c.path,ci.hash,ci.read,ci.isBis,ci.currentPage,ci.rating,ci.hasBeenOpened,ci.date,ci.added,ci.type FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) LEFT JOIN folder f ON (f.id == c.parentId) WHERE "
+// the same query, with the bm25 rank of each comic for :rankQuery available as r.rank (NULL if it doesn't match)
+#define SEARCH_COMICS_RANKED_QUERY "SELECT ci.number,ci.title,c.fileName,ci.numPages,c.id,c.parentId,c.path,ci.hash,ci.read,ci.isBis,ci.currentPage,ci.rating,ci.hasBeenOpened,ci.date,ci.added,ci.type FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) LEFT JOIN folder f ON (f.id == c.parentId) LEFT JOIN (SELECT rowid AS id, bm25(comic_info_fts) AS rank FROM comic_info_fts WHERE comic_info_fts MATCH :rankQuery) r ON (r.id = ci.id) WHERE "
 
 /**
  * This class is used to generate an SQL query string from a search expression,
@@ -56,8 +58,19 @@ public:
         {
         }
 
-        int buildSqlString(std::string &sqlString, int bindPosition = 0) const;
-        int bindValues(QSqlQuery &selectQuery, int bindPosition = 0) const;
+        // with fullText the text terms are looked up in the FTS5 index (see DataBaseManagement::createFullTextIndex) instead of using LIKE
+        int buildSqlString(std::string &sqlString, int bindPosition = 0, bool fullText = false) const;
+        int bindValues(QSqlQuery &selectQuery, int bindPosition = 0, bool fullText = false) const;
+        // FTS5 query with the terms that contribute to the relevance of a comic (the ones that are not negated), it is empty if there are none
+        std::string rankingQuery() const;
+        // complete search statements (see search_query.h), the ranked comics are sorted by their relevance for :rankQuery,
+        // the comics are paged with :limit and :offset
+        std::string foldersSearchSql(bool fullText) const;
+        std::string comicsSearchSql(bool fullText, bool ranked) const;
+
+    private:
+        bool usesFullTextIndex() const;
+        std::string fullTextQuery() const;
     };
 
     explicit QueryParser();
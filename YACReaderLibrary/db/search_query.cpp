@@ -1,6 +1,6 @@
-
 #include "search_query.h"
 #include "query_parser.h"
+#include "data_base_management.h"
 
 #include <QtCore>
 #include <QSqlQuery>
@@ -9,33 +9,32 @@ QSqlQuery foldersSearchQuery(QSqlDatabase &db, const QString &filter)
 {
     QueryParser parser;
     auto result = parser.parse(filter.toStdString());
-
-    std::string queryString(SEARCH_FOLDERS_QUERY);
-    result.buildSqlString(queryString);
-    queryString += " AND f.id <> 1 ORDER BY f.parentId,f.name";
+    bool fullText = DataBaseManagement::hasFullTextIndex(db);
 
     QSqlQuery selectQuery(db);
-    selectQuery.prepare(queryString.c_str());
-    result.bindValues(selectQuery);
+    selectQuery.prepare(QString::fromStdString(result.foldersSearchSql(fullText)));
+    result.bindValues(selectQuery, 0, fullText);
 
     selectQuery.exec();
 
     return selectQuery;
 }
 
-QSqlQuery comicsSearchQuery(QSqlDatabase &db, const QString &filter)
+QSqlQuery comicsSearchQuery(QSqlDatabase &db, const QString &filter, int limit, int offset)
 {
     QueryParser parser;
     auto result = parser.parse(filter.toStdString());
-
-    std::string queryString(SEARCH_COMICS_QUERY);
-    result.buildSqlString(queryString);
-    queryString += " LIMIT :limit";
+    bool fullText = DataBaseManagement::hasFullTextIndex(db);
+    auto rankingQuery = fullText ? result.rankingQuery() : std::string();
 
     QSqlQuery selectQuery(db);
-    selectQuery.prepare(queryString.c_str());
-    selectQuery.bindValue(":limit", 500); // TODO, load this value from settings
-    result.bindValues(selectQuery);
+    selectQuery.prepare(QString::fromStdString(result.comicsSearchSql(fullText, !rankingQuery.empty())));
+    if (!rankingQuery.empty()) {
+        selectQuery.bindValue(":rankQuery", QString::fromStdString(rankingQuery));
+    }
+    selectQuery.bindValue(":limit", limit);
+    selectQuery.bindValue(":offset", offset);
+    result.bindValues(selectQuery, 0, fullText);
 
     selectQuery.exec();
 
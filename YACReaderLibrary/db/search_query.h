@@ -1,10 +1,10 @@
-
 #ifndef SEARCHQUERY_H
 #define SEARCHQUERY_H
 
 #include <QSqlDatabase>
 
 QSqlQuery foldersSearchQuery(QSqlDatabase &db, const QString &filter);
-QSqlQuery comicsSearchQuery(QSqlDatabase &db, const QString &filter);
+// comics are sorted by relevance, limit < 0 returns all the results
+QSqlQuery comicsSearchQuery(QSqlDatabase &db, const QString &filter, int limit = -1, int offset = 0);
 
 #endif // SEARCHQUERY_H
@@ -11,6 +11,8 @@
 #include <QSqlDatabase>
 #include <QSqlRecord>
 #include <QSqlQuery>
+#include <QSqlError>
+#include <QVersionNumber>
 
 #include <algorithm>
 #include <limits>
@@ -19,6 +21,8 @@
 #include "library_item.h"
 #include "comic_db.h"
 #include "data_base_management.h"
+#include "library_write_batch.h"
+#include "library_queries.h"
 #include "folder.h"
 #include "yacreader_libraries.h"
 
@@ -37,15 +41,11 @@ YACReaderLibraries DBHelper::getLibraries()
 QList<LibraryItem *> DBHelper::getFolderSubfoldersFromLibrary(qulonglong libraryId, qulonglong folderId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<LibraryItem *> list;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         list = DBHelper::getFoldersFromParent(folderId, db, false);
-
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
     return list;
 }
 
@@ -79,15 +79,11 @@ QList<LibraryItem *> DBHelper::getFolderComicsFromLibraryForReading(qulonglong l
 QList<LibraryItem *> DBHelper::getFolderComicsFromLibrary(qulonglong libraryId, qulonglong folderId, bool sort)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<LibraryItem *> list;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         list = DBHelper::getComicsFromParent(folderId, db, sort);
-
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
     return list;
 }
 
@@ -95,74 +91,61 @@ quint32 DBHelper::getNumChildrenFromFolder(qulonglong libraryId, qulonglong fold
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
     quint32 result = 0;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT count(*) FROM folder WHERE parentId = :parentId and id <> 1");
+        selectQuery.prepare(SUBFOLDERS_COUNT_QUERY);
         selectQuery.bindValue(":parentId", folderId);
         selectQuery.exec();
 
         result += selectQuery.record().value(0).toULongLong();
 
-        selectQuery.prepare("SELECT count(*) FROM comic c WHERE c.parentId = :parentId");
+        selectQuery.prepare(FOLDER_COMICS_COUNT_QUERY);
         selectQuery.bindValue(":parentId", folderId);
         selectQuery.exec();
 
         result += selectQuery.record().value(0).toULongLong();
-        connectionName = db.connectionName();
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
-
     return result;
 }
 
 qulonglong DBHelper::getParentFromComicFolderId(qulonglong libraryId, qulonglong id)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     Folder f;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
         f = DBHelper::loadFolder(id, db);
-        connectionName = db.connectionName();
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
     return f.parentId;
 }
 ComicDB DBHelper::getComicInfo(qulonglong libraryId, qulonglong id)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     ComicDB comic;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
         bool found;
         comic = DBHelper::loadComic(id, db, found);
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
     return comic;
 }
 
 QList<ComicDB> DBHelper::getSiblings(qulonglong libraryId, qulonglong parentId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<ComicDB> comics;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         comics = DBHelper::getSortedComicsFromParent(parentId, db);
-        connectionName = db.connectionName();
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
     return comics;
 }
 
@@ -171,10 +154,9 @@ QString DBHelper::getFolderName(qulonglong libraryId, qulonglong id)
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
 
     QString name = "";
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         QSqlQuery selectQuery(db); // TODO check
         selectQuery.prepare("SELECT name FROM folder WHERE id = :id");
         selectQuery.bindValue(":id", id);
@@ -183,16 +165,14 @@ QString DBHelper::getFolderName(qulonglong libraryId, qulonglong id)
         if (selectQuery.next()) {
             name = selectQuery.value(0).toString();
         }
-        connectionName = db.connectionName();
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
     return name;
 }
 QList<QString> DBHelper::getLibrariesNames()
 {
     auto names = getLibraries().getNames();
-    std::sort(names.begin(), names.end(), naturalSortLessThanCI);
+    naturalSort(names);
     return names;
 }
 QString DBHelper::getLibraryName(int id)
@@ -205,16 +185,11 @@ QList<ComicDB> DBHelper::getLabelComics(qulonglong libraryId, qulonglong labelId
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
 
     QList<ComicDB> list;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT c.id,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio "
-                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                            "INNER JOIN comic_label cl ON (c.id == cl.comic_id) "
-                            "WHERE cl.label_id = :parentLabelId "
-                            "ORDER BY cl.ordering");
+        selectQuery.prepare("SELECT c.id,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio " LABEL_COMICS_FROM);
         selectQuery.bindValue(":parentLabelId", labelId);
         selectQuery.exec();
 
@@ -233,9 +208,7 @@ QList<ComicDB> DBHelper::getLabelComics(qulonglong libraryId, qulonglong labelId
 
             list.append(comic);
         }
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -246,16 +219,11 @@ QList<ComicDB> DBHelper::getFavorites(qulonglong libraryId)
     QList<ComicDB> list;
 
     const int FAV_ID = 1;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT c.id,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio "
-                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                            "INNER JOIN comic_default_reading_list cdrl ON (c.id == cdrl.comic_id) "
-                            "WHERE cdrl.default_reading_list_id = :parentDefaultListId "
-                            "ORDER BY cdrl.ordering");
+        selectQuery.prepare("SELECT c.id,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio " DEFAULT_READING_LIST_COMICS_FROM);
         selectQuery.bindValue(":parentDefaultListId", FAV_ID);
         selectQuery.exec();
 
@@ -274,11 +242,8 @@ QList<ComicDB> DBHelper::getFavorites(qulonglong libraryId)
 
             list.append(comic);
         }
-
-        connectionName = db.connectionName();
     }
     // TODO ?
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -287,15 +252,11 @@ QList<ComicDB> DBHelper::getReading(qulonglong libraryId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
     QList<ComicDB> list;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT c.id,c.parentId,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio "
-                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                            "WHERE ci.hasBeenOpened = 1 AND ci.read = 0 "
-                            "ORDER BY ci.lastTimeOpened DESC");
+        selectQuery.prepare("SELECT c.id,c.parentId,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio " READING_COMICS_FROM);
         selectQuery.exec();
 
         while (selectQuery.next()) {
@@ -313,10 +274,8 @@ QList<ComicDB> DBHelper::getReading(qulonglong libraryId)
 
             list.append(comic);
         }
-        connectionName = db.connectionName();
     }
     // TODO ?
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -324,11 +283,10 @@ QList<ComicDB> DBHelper::getReading(qulonglong libraryId)
 QList<ReadingList> DBHelper::getReadingLists(qulonglong libraryId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<ReadingList> list;
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
         QSqlQuery selectQuery("SELECT * from reading_list WHERE parentId IS NULL ORDER BY name DESC", db);
 
@@ -352,10 +310,8 @@ QList<ReadingList> DBHelper::getReadingLists(qulonglong libraryId)
                 list.insert(i, item);
             }
         }
-        connectionName = db.connectionName();
     }
     // TODO ?
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -364,10 +320,9 @@ QList<ComicDB> DBHelper::getReadingListFullContent(qulonglong libraryId, qulongl
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
     QList<ComicDB> list;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         QList<qulonglong> ids;
         ids << readingListId;
 
@@ -391,11 +346,7 @@ QList<ComicDB> DBHelper::getReadingListFullContent(qulonglong libraryId, qulongl
                 params = "c.id,c.parentId,c.fileName,c.path,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio,ci.number";
             }
 
-            selectQuery.prepare("SELECT " + params + " "
-                                                     "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
-                                                     "INNER JOIN comic_reading_list crl ON (c.id == crl.comic_id) "
-                                                     "WHERE crl.reading_list_id = :parentReadingList "
-                                                     "ORDER BY crl.ordering");
+            selectQuery.prepare("SELECT " + params + " " READING_LIST_COMICS_FROM);
             selectQuery.bindValue(":parentReadingList", id);
             selectQuery.exec();
 
@@ -434,11 +385,9 @@ QList<ComicDB> DBHelper::getReadingListFullContent(qulonglong libraryId, qulongl
                 list.append(comic);
             }
         }
-        connectionName = db.connectionName();
     }
 
     // TODO ?
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -522,7 +471,7 @@ void DBHelper::deleteComicsFromLabel(const QList<ComicDB> &comicsList, qulonglon
     QLOG_DEBUG() << "deleteComicsFromLabel----------------------------------";
 
     QSqlQuery query(db);
-    query.prepare("DELETE FROM comic_label WHERE comic_id = :comic_id AND label_id = :label_id");
+    query.prepare(REMOVE_LABEL_FROM_COMIC_QUERY);
     foreach (ComicDB comic, comicsList) {
         query.bindValue(":comic_id", comic.id);
         query.bindValue(":label_id", labelId);
@@ -563,13 +512,10 @@ void DBHelper::update(ComicDB *comic, QSqlDatabase &db)
 void DBHelper::update(qulonglong libraryId, ComicInfo &comicInfo)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
         DBHelper::update(&comicInfo, db);
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 }
 
 void DBHelper::update(ComicInfo *comicInfo, QSqlDatabase &db)
@@ -578,6 +524,16 @@ void DBHelper::update(ComicInfo *comicInfo, QSqlDatabase &db)
         return;
 
     QSqlQuery updateComicInfo(db);
+    prepareComicInfoUpdate(updateComicInfo);
+    update(comicInfo, updateComicInfo);
+
+    QLOG_INFO() << updateComicInfo.lastError().databaseText();
+    QLOG_INFO() << updateComicInfo.lastError().text();
+    QLOG_INFO() << updateComicInfo.lastQuery();
+}
+
+void DBHelper::prepareComicInfoUpdate(QSqlQuery &updateComicInfo)
+{
     updateComicInfo.prepare("UPDATE comic_info SET "
                             "title = :title,"
 
@@ -659,7 +615,10 @@ void DBHelper::update(ComicInfo *comicInfo, QSqlDatabase &db)
 
                             //--
                             " WHERE id = :id");
+}
 
+bool DBHelper::update(ComicInfo *comicInfo, QSqlQuery &updateComicInfo)
+{
     updateComicInfo.bindValue(":title", comicInfo->title);
 
     updateComicInfo.bindValue(":coverPage", comicInfo->coverPage);
@@ -733,11 +692,7 @@ void DBHelper::update(ComicInfo *comicInfo, QSqlDatabase &db)
     updateComicInfo.bindValue(":review", comicInfo->review);
     updateComicInfo.bindValue(":tags", comicInfo->tags);
 
-    updateComicInfo.exec();
-
-    QLOG_INFO() << updateComicInfo.lastError().databaseText();
-    QLOG_INFO() << updateComicInfo.lastError().text();
-    QLOG_INFO() << updateComicInfo.lastQuery();
+    return updateComicInfo.exec();
 }
 
 void DBHelper::updateRead(ComicInfo *comicInfo, QSqlDatabase &db)
@@ -777,85 +732,117 @@ void DBHelper::update(const Folder &folder, QSqlDatabase &db)
     updateFolderInfo.exec();
 }
 
-void DBHelper::propagateFolderUpdatesToParent(const Folder &folder, QSqlDatabase &db)
+// computes numChildren and firstChildHash of a folder from its direct children, the subfolders are expected to be up to date
+// returns true if the stored values have changed
+static bool updateFolderAggregates(qulonglong folderId, QSqlDatabase &db)
 {
-    auto currentParentId = folder.parentId;
-    auto currentId = folder.id;
-    while (currentParentId != 1 && currentParentId != 0) { // currentParentId is 0 if `folder` is the root folder
-        auto f = loadFolder(currentParentId, db);
-        currentParentId = f.parentId;
-        currentId = f.id;
+    auto comicsQuery = DataBaseManagement::pooledQuery(db, "SELECT c.fileName, ci.hash " FOLDER_COMICS_FROM);
+    QSqlQuery &comics = *comicsQuery;
+    comics.bindValue(":parentId", folderId);
+    comics.exec();
+
+    int numChildren = 0;
+    QString firstComicName;
+    QString firstChildHash;
+    while (comics.next()) {
+        auto name = comics.value(0).toString();
+        if (numChildren == 0 || name.localeAwareCompare(firstComicName) < 0) {
+            firstComicName = name;
+            firstChildHash = comics.value(1).toString();
+        }
+        numChildren++;
+    }
+    bool hasComics = numChildren > 0;
+
+    auto foldersQuery = DataBaseManagement::pooledQuery(db, FOLDER_AGGREGATES_SUBFOLDERS_QUERY);
+    QSqlQuery &folders = *foldersQuery;
+    folders.bindValue(":parentId", folderId);
+    folders.exec();
+
+    QString firstFolderName;
+    while (folders.next()) {
+        numChildren++;
+        if (hasComics)
+            continue;
+        auto hash = folders.value(1).toString();
+        auto name = folders.value(0).toString();
+        if (!hash.isEmpty() && (firstFolderName.isNull() || naturalCompare(name, firstFolderName, Qt::CaseInsensitive) < 0)) {
+            firstFolderName = name;
+            firstChildHash = hash;
+        }
     }
 
-    if (currentId != folder.id) {
-        updateChildrenInfo(currentId, db);
+    auto currentQuery = DataBaseManagement::pooledQuery(db, FOLDER_AGGREGATES_QUERY);
+    QSqlQuery &current = *currentQuery;
+    current.bindValue(":id", folderId);
+    current.exec();
+    if (current.next() && !current.value(0).isNull() && current.value(0).toInt() == numChildren && current.value(1).toString() == firstChildHash) {
+        return false;
     }
+
+    auto updateQuery = DataBaseManagement::pooledQuery(db, UPDATE_FOLDER_AGGREGATES_QUERY);
+    QSqlQuery &updateFolderInfo = *updateQuery;
+    updateFolderInfo.bindValue(":numChildren", numChildren);
+    updateFolderInfo.bindValue(":firstChildHash", firstChildHash);
+    updateFolderInfo.bindValue(":id", folderId);
+    updateFolderInfo.exec();
+
+    return true;
 }
 
-Folder DBHelper::updateChildrenInfo(qulonglong folderId, QSqlDatabase &db)
+void DBHelper::updateChildrenInfo(const QSet<qulonglong> &folderIds, QSqlDatabase &db)
 {
-    auto folder = loadFolder(folderId, db);
-    QList<LibraryItem *> subfolders = DBHelper::getFoldersFromParent(folderId, db, true);
-    QList<LibraryItem *> comics = DBHelper::getComicsFromParent(folderId, db, true);
+    // the deepest folders go first, so every folder is computed once, after all its dirty subfolders
+    QMap<int, QSet<qulonglong>> pending;
+    QHash<qulonglong, qulonglong> parents;
+    auto schedule = [&](qulonglong folderId) {
+        if (folderId == 0 || folderId == 1 || parents.contains(folderId)) // the root folder doesn't store aggregates
+            return;
+        auto query = DataBaseManagement::pooledQuery(db, FOLDER_PARENT_QUERY);
+        query->bindValue(":id", folderId);
+        query->exec();
+        if (!query->next())
+            return;
+        parents.insert(folderId, query->value(0).toULongLong());
+        pending[-query->value(1).toString().count('/')].insert(folderId);
+    };
 
-    QList<LibraryItem *> updatedSubfolders;
-    for (auto sf : subfolders) {
-        updatedSubfolders.append(new Folder(updateChildrenInfo(static_cast<Folder *>(sf)->id, db)));
+    for (auto folderId : folderIds) {
+        schedule(folderId);
     }
 
-    QString coverHash = "";
-
-    if (!comics.isEmpty()) {
-        auto c = static_cast<ComicDB *>(comics[0]);
-        coverHash = c->info.hash;
-    } else {
-        for (auto item : updatedSubfolders) {
-            auto f = static_cast<Folder *>(item);
-            auto firstChildHash = f->firstChildHash;
-            if (!firstChildHash.isEmpty()) {
-                coverHash = firstChildHash;
-                break;
+    while (!pending.isEmpty()) {
+        auto folders = pending.take(pending.firstKey());
+        for (auto folderId : folders) {
+            if (updateFolderAggregates(folderId, db)) {
+                schedule(parents.value(folderId));
             }
         }
     }
+}
 
-    folder.numChildren = subfolders.count() + comics.count();
-    folder.firstChildHash = coverHash;
-
-    QSqlQuery updateFolderInfo(db);
-    updateFolderInfo.prepare("UPDATE folder SET "
-                             "numChildren = :numChildren, "
-                             "firstChildHash = :firstChildHash "
-                             "WHERE id = :id ");
-    updateFolderInfo.bindValue(":numChildren", folder.numChildren);
-    updateFolderInfo.bindValue(":firstChildHash", folder.firstChildHash);
-    updateFolderInfo.bindValue(":id", folderId);
-    updateFolderInfo.exec();
-
-    qDeleteAll(subfolders);
-    qDeleteAll(updatedSubfolders);
-    qDeleteAll(comics);
-
-    return folder;
+// UPDATE ... FROM is available since SQLite 3.33 (and window functions since 3.25), older system libraries use correlated subqueries
+static bool supportsUpdateFrom(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    return query.exec("SELECT sqlite_version()") && query.next() && QVersionNumber::fromString(query.value(0).toString()) >= QVersionNumber(3, 33);
 }
 
 void DBHelper::updateChildrenInfo(QSqlDatabase &db)
 {
-    QSqlQuery selectQuery(db); // TODO check
-    selectQuery.prepare("SELECT id FROM folder f WHERE f.parentId = 1 AND f.id <> 1");
-    selectQuery.exec();
-
-    while (selectQuery.next()) {
-        DBHelper::updateChildrenInfo(selectQuery.value(0).toULongLong(), db);
+    // repair pass, all the folders are recomputed in one statement
+    QSqlQuery repairQuery(db);
+    repairQuery.prepare(supportsUpdateFrom(db) ? repairFolderAggregatesQuery() : repairFolderAggregatesLegacyQuery());
+    if (!repairQuery.exec()) {
+        QLOG_ERROR() << "Unable to repair the folders info:" << repairQuery.lastError().databaseText();
     }
 }
 
 void DBHelper::updateProgress(qulonglong libraryId, const ComicInfo &comicInfo)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
         bool found;
         ComicDB comic = DBHelper::loadComic(comicInfo.id, db, found);
@@ -864,19 +851,15 @@ void DBHelper::updateProgress(qulonglong libraryId, const ComicInfo &comicInfo)
         comic.info.read = comic.info.read || comic.info.currentPage == comic.info.numPages;
 
         DBHelper::updateReadingRemoteProgress(comic.info, db);
-
-        connectionName = db.connectionName();
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
 }
 
 void DBHelper::setComicAsReading(qulonglong libraryId, const ComicInfo &comicInfo)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
         bool found;
         ComicDB comic = DBHelper::loadComic(comicInfo.id, db, found);
@@ -884,9 +867,7 @@ void DBHelper::setComicAsReading(qulonglong libraryId, const ComicInfo &comicInf
         comic.info.read = comic.info.read || comic.info.currentPage == comic.info.numPages;
 
         DBHelper::updateReadingRemoteProgress(comic.info, db);
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 }
 
 void DBHelper::updateReadingRemoteProgress(const ComicInfo &comicInfo, QSqlDatabase &db)
@@ -914,9 +895,8 @@ void DBHelper::updateReadingRemoteProgress(const ComicInfo &comicInfo, QSqlDatab
 void DBHelper::updateFromRemoteClient(qulonglong libraryId, const ComicInfo &comicInfo)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
         bool found;
         ComicDB comic = DBHelper::loadComic(comicInfo.id, db, found);
@@ -939,9 +919,7 @@ void DBHelper::updateFromRemoteClient(qulonglong libraryId, const ComicInfo &com
 
             DBHelper::updateReadingRemoteProgress(comic.info, db);
         }
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 }
 
 void DBHelper::updateFromRemoteClientWithHash(const ComicInfo &comicInfo)
@@ -949,13 +927,12 @@ void DBHelper::updateFromRemoteClientWithHash(const ComicInfo &comicInfo)
     YACReaderLibraries libraries = DBHelper::getLibraries();
 
     QStringList names = libraries.getNames();
-    QString connectionName = "";
 
     foreach (QString name, names) {
         QString libraryPath = DBHelper::getLibraries().getPath(libraries.getId(name));
 
         {
-            QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+            QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
             ComicInfo info = loadComicInfo(comicInfo.hash, db);
 
             if (!info.existOnDb) {
@@ -978,9 +955,7 @@ void DBHelper::updateFromRemoteClientWithHash(const ComicInfo &comicInfo)
                 info.rating = comicInfo.rating;
 
             DBHelper::update(&info, db);
-            connectionName = db.connectionName();
         }
-        QSqlDatabase::removeDatabase(connectionName);
     }
 }
 
@@ -993,9 +968,8 @@ QMap<qulonglong, QList<ComicDB>> DBHelper::updateFromRemoteClient(const QMap<qul
 
         QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
 
-        QString connectionName = "";
         {
-            QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+            QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
             db.transaction();
 
@@ -1058,10 +1032,7 @@ QMap<qulonglong, QList<ComicDB>> DBHelper::updateFromRemoteClient(const QMap<qul
             }
 
             db.commit();
-            connectionName = db.connectionName();
         }
-
-        QSqlDatabase::removeDatabase(connectionName);
     }
 
     return moreRecentComics;
@@ -1075,9 +1046,8 @@ void DBHelper::updateFromRemoteClientWithHash(const QList<ComicInfo> &comics)
 
     foreach (QString name, names) {
         QString libraryPath = DBHelper::getLibraries().getPath(libraries.getId(name));
-        QString connectionName = "";
         {
-            QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+            QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
             db.transaction();
 
@@ -1123,9 +1093,7 @@ void DBHelper::updateFromRemoteClientWithHash(const QList<ComicInfo> &comics)
             }
 
             db.commit();
-            connectionName = db.connectionName();
         }
-        QSqlDatabase::removeDatabase(connectionName);
     }
 }
 
@@ -1231,8 +1199,11 @@ void DBHelper::updateComicsInfo(QList<ComicDB> &comics, const QString &databaseP
         QSqlDatabase db = DataBaseManagement::loadDatabase(databasePath);
         db.open();
         db.transaction();
-        foreach (ComicDB comic, comics) {
-            DBHelper::update(&(comic.info), db);
+        {
+            LibraryWriteBatch batch(db);
+            for (auto &comic : comics) {
+                batch.update(&(comic.info));
+            }
         }
         db.commit();
         connectionName = db.connectionName();
@@ -1247,8 +1218,8 @@ qulonglong DBHelper::insert(Folder *folder, QSqlDatabase &db)
     folder->added = added;
 
     QSqlQuery query(db);
-    query.prepare("INSERT INTO folder (parentId, name, path, added) "
-                  "VALUES (:parentId, :name, :path, :added)");
+    query.prepare("INSERT INTO folder (parentId, name, path, added, numChildren) "
+                  "VALUES (:parentId, :name, :path, :added, 0)");
     query.bindValue(":parentId", folder->parentId);
     query.bindValue(":name", folder->name);
     query.bindValue(":path", folder->path);
@@ -1423,8 +1394,8 @@ QList<LibraryItem *> DBHelper::getFoldersFromParent(qulonglong parentId, QSqlDat
 {
     QList<LibraryItem *> list;
 
-    QSqlQuery selectQuery(db); // TODO check
-    selectQuery.prepare("SELECT * FROM folder WHERE parentId = :parentId and id <> 1");
+    auto query = DataBaseManagement::pooledQuery(db, SUBFOLDERS_QUERY);
+    QSqlQuery &selectQuery = *query;
     selectQuery.bindValue(":parentId", parentId);
     selectQuery.exec();
 
@@ -1458,26 +1429,11 @@ QList<LibraryItem *> DBHelper::getFoldersFromParent(qulonglong parentId, QSqlDat
         currentItem->added = selectQuery.value(added).toLongLong();
         currentItem->updated = selectQuery.value(updated).toLongLong();
 
-        int lessThan = 0;
-
-        if (list.isEmpty() || !sort)
-            list.append(currentItem);
-        else {
-            auto last = static_cast<Folder *>(list.back());
-            QString nameLast = last->name;
-            QString nameCurrent = currentItem->name;
-            QList<LibraryItem *>::iterator i;
-            i = list.end();
-            i--;
-            while ((0 > (lessThan = naturalCompare(nameCurrent, nameLast, Qt::CaseInsensitive))) && i != list.begin()) {
-                i--;
-                nameLast = (*i)->name;
-            }
-            if (lessThan >= 0) // si se ha encontrado un elemento menor que current, se inserta justo después
-                list.insert(++i, currentItem);
-            else
-                list.insert(i, currentItem);
-        }
+        list.append(currentItem);
+    }
+
+    if (sort) {
+        naturalSort(list, [](const LibraryItem *item) { return item->name; });
     }
 
     return list;
@@ -1490,7 +1446,7 @@ QList<ComicDB> DBHelper::getSortedComicsFromParent(qulonglong parentId, QSqlData
     QSqlQuery selectQuery(db);
 
     selectQuery.setForwardOnly(true);
-    selectQuery.prepare("select * from comic c inner join comic_info ci on (c.comicInfoId = ci.id) where c.parentId = :parentId");
+    selectQuery.prepare("SELECT * " FOLDER_COMICS_FROM);
     selectQuery.bindValue(":parentId", parentId);
     selectQuery.exec();
 
@@ -1532,8 +1488,8 @@ QList<LibraryItem *> DBHelper::getComicsFromParent(qulonglong parentId, QSqlData
 {
     QList<LibraryItem *> list;
 
-    QSqlQuery selectQuery(db);
-    selectQuery.prepare("select c.id,c.parentId,c.fileName,c.path,ci.hash from comic c inner join comic_info ci on (c.comicInfoId = ci.id) where c.parentId = :parentId");
+    auto query = DataBaseManagement::pooledQuery(db, "SELECT c.id,c.parentId,c.fileName,c.path,ci.hash " FOLDER_COMICS_FROM);
+    QSqlQuery &selectQuery = *query;
     selectQuery.bindValue(":parentId", parentId);
     selectQuery.exec();
 
@@ -1562,13 +1518,119 @@ QList<LibraryItem *> DBHelper::getComicsFromParent(qulonglong parentId, QSqlData
     return list;
 }
 
+namespace {
+QString idList(const QList<qulonglong> &ids)
+{
+    QStringList list;
+    list.reserve(ids.size());
+    for (auto id : ids) {
+        list << QString::number(id);
+    }
+    return list.join(",");
+}
+}
+
+QList<Folder> DBHelper::getFolders(const QList<qulonglong> &ids, QSqlDatabase &db)
+{
+    if (ids.isEmpty()) {
+        return {};
+    }
+
+    QHash<qulonglong, Folder> folders;
+
+    QSqlQuery selectQuery(db);
+    selectQuery.setForwardOnly(true);
+    selectQuery.exec(foldersByIdQuery(idList(ids)));
+
+    QSqlRecord record = selectQuery.record();
+
+    int id = record.indexOf("id");
+    int parentId = record.indexOf("parentId");
+    int name = record.indexOf("name");
+    int path = record.indexOf("path");
+    int finished = record.indexOf("finished");
+    int completed = record.indexOf("completed");
+    int numChildren = record.indexOf("numChildren");
+    int firstChildHash = record.indexOf("firstChildHash");
+    int customImage = record.indexOf("customImage");
+    int type = record.indexOf("type");
+    int added = record.indexOf("added");
+    int updated = record.indexOf("updated");
+
+    while (selectQuery.next()) {
+        Folder folder(selectQuery.value(id).toULongLong(), selectQuery.value(parentId).toULongLong(), selectQuery.value(name).toString(), selectQuery.value(path).toString());
+
+        folder.finished = selectQuery.value(finished).toBool();
+        folder.completed = selectQuery.value(completed).toBool();
+        if (!selectQuery.value(numChildren).isNull() && selectQuery.value(numChildren).isValid()) {
+            folder.numChildren = selectQuery.value(numChildren).toInt();
+        }
+        folder.firstChildHash = selectQuery.value(firstChildHash).toString();
+        folder.customImage = selectQuery.value(customImage).toString();
+        folder.type = selectQuery.value(type).value<YACReader::FileType>();
+        folder.added = selectQuery.value(added).toLongLong();
+        folder.updated = selectQuery.value(updated).toLongLong();
+
+        folders.insert(folder.id, folder);
+    }
+
+    QList<Folder> list;
+    for (auto folderId : ids) {
+        auto it = folders.constFind(folderId);
+        if (it != folders.constEnd()) {
+            list.append(it.value());
+        }
+    }
+    return list;
+}
+
+QList<ComicDB> DBHelper::getComics(const QList<qulonglong> &ids, QSqlDatabase &db)
+{
+    if (ids.isEmpty()) {
+        return {};
+    }
+
+    QHash<qulonglong, ComicDB> comics;
+
+    QSqlQuery selectQuery(db);
+    selectQuery.setForwardOnly(true);
+    selectQuery.exec(comicsByIdQuery(idList(ids)));
+
+    QSqlRecord record = selectQuery.record();
+
+    int id = record.indexOf("id");
+    int parentId = record.indexOf("parentId");
+    int fileName = record.indexOf("fileName");
+    int path = record.indexOf("path");
+
+    while (selectQuery.next()) {
+        ComicDB comic;
+        comic.id = selectQuery.value(id).toULongLong();
+        comic.parentId = selectQuery.value(parentId).toULongLong();
+        comic.name = selectQuery.value(fileName).toString();
+        comic.path = selectQuery.value(path).toString();
+
+        comic.info = getComicInfoFromQuery(selectQuery, "comicInfoId");
+
+        comics.insert(comic.id, comic);
+    }
+
+    QList<ComicDB> list;
+    for (auto comicId : ids) {
+        auto it = comics.constFind(comicId);
+        if (it != comics.constEnd()) {
+            list.append(it.value());
+        }
+    }
+    return list;
+}
+
 QList<Label> DBHelper::getLabels(qulonglong libraryId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<Label> labels;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryPath + "/.yacreaderlibrary");
 
         QSqlQuery selectQuery("SELECT * FROM label ORDER BY ordering,name", db); // TODO add some kind of
         QSqlRecord record = selectQuery.record();
@@ -1604,9 +1666,7 @@ QList<Label> DBHelper::getLabels(qulonglong libraryId)
                 }
             }
         }
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 
     return labels;
 }
@@ -1622,9 +1682,7 @@ void DBHelper::updateFolderTreeType(qulonglong id, QSqlDatabase &db, YACReader::
     updateFolderQuery.exec();
 
     QSqlQuery updateComicInfo(db);
-    updateComicInfo.prepare("UPDATE comic_info "
-                            "SET type = :type "
-                            "WHERE id IN (SELECT ci.id FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.parentId = :parentId)");
+    updateComicInfo.prepare(UPDATE_FOLDER_COMICS_TYPE_QUERY);
     updateComicInfo.bindValue(":type", static_cast<int>(type));
     updateComicInfo.bindValue(":parentId", id);
     updateComicInfo.exec();
@@ -1643,8 +1701,8 @@ void DBHelper::updateFolderTreeType(qulonglong id, QSqlDatabase &db, YACReader::
 
 Folder DBHelper::loadFolder(qulonglong id, QSqlDatabase &db)
 {
-    QSqlQuery query(db);
-    query.prepare("SELECT * FROM folder WHERE id = :id");
+    auto pooledQuery = DataBaseManagement::pooledQuery(db, "SELECT * FROM folder WHERE id = :id");
+    QSqlQuery &query = *pooledQuery;
     query.bindValue(":id", id);
     query.exec();
 
@@ -1660,8 +1718,8 @@ Folder DBHelper::loadFolder(qulonglong id, QSqlDatabase &db)
 
 Folder DBHelper::loadFolder(const QString &folderName, qulonglong parentId, QSqlDatabase &db)
 {
-    QSqlQuery query(db);
-    query.prepare("SELECT * FROM folder WHERE parentId = :parentId AND name = :folderName");
+    auto pooledQuery = DataBaseManagement::pooledQuery(db, FOLDER_BY_NAME_QUERY);
+    QSqlQuery &query = *pooledQuery;
     query.bindValue(":parentId", parentId);
     query.bindValue(":folderName", folderName);
     query.exec();
@@ -1724,8 +1782,8 @@ ComicDB DBHelper::loadComic(qulonglong id, QSqlDatabase &db, bool &found)
 {
     ComicDB comic;
 
-    QSqlQuery selectQuery(db);
-    selectQuery.prepare("select c.id,c.parentId,c.fileName,c.path,ci.hash from comic c inner join comic_info ci on (c.comicInfoId = ci.id) where c.id = :id");
+    auto query = DataBaseManagement::pooledQuery(db, COMIC_BY_ID_QUERY);
+    QSqlQuery &selectQuery = *query;
     selectQuery.bindValue(":id", id);
     selectQuery.exec();
 
@@ -1774,8 +1832,8 @@ ComicInfo DBHelper::loadComicInfo(QString hash, QSqlDatabase &db)
 {
     ComicInfo comicInfo;
 
-    QSqlQuery findComicInfo(db);
-    findComicInfo.prepare("SELECT * FROM comic_info WHERE hash = :hash");
+    auto query = DataBaseManagement::pooledQuery(db, COMIC_INFO_BY_HASH_QUERY);
+    QSqlQuery &findComicInfo = *query;
     findComicInfo.bindValue(":hash", hash);
     findComicInfo.exec();
 
@@ -1970,7 +2028,7 @@ QList<QString> DBHelper::loadSubfoldersNames(qulonglong folderId, QSqlDatabase &
 bool DBHelper::isFavoriteComic(qulonglong id, QSqlDatabase &db)
 {
     QSqlQuery selectQuery(db);
-    selectQuery.prepare("SELECT * FROM comic_default_reading_list cl WHERE cl.comic_id = :comic_id AND cl.default_reading_list_id = 1");
+    selectQuery.prepare(IS_FAVORITE_COMIC_QUERY);
     selectQuery.bindValue(":comic_id", id);
     selectQuery.exec();
 
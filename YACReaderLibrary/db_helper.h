@@ -4,6 +4,7 @@
 class QString;
 #include <QMap>
 #include <QList>
+#include <QSet>
 #include "yacreader_global.h"
 
 class ComicDB;
@@ -64,11 +65,15 @@ public:
     static void update(qulonglong libraryId, ComicInfo &comicInfo);
     static void update(ComicDB *comics, QSqlDatabase &db);
     static void update(ComicInfo *comicInfo, QSqlDatabase &db);
+    // the statement used by update(ComicInfo *, QSqlDatabase &) can be prepared once by callers that update many comics
+    static void prepareComicInfoUpdate(QSqlQuery &updateComicInfo);
+    static bool update(ComicInfo *comicInfo, QSqlQuery &updateComicInfo);
     static void updateRead(ComicInfo *comicInfo, QSqlDatabase &db);
     static void updateAdded(ComicInfo *comicInfo, QSqlDatabase &db);
     static void update(const Folder &folder, QSqlDatabase &db); // only for finished/completed fields
-    static void propagateFolderUpdatesToParent(const Folder &folder, QSqlDatabase &db);
-    static Folder updateChildrenInfo(qulonglong folderId, QSqlDatabase &db);
+    // updates numChildren and firstChildHash of the given folders and of their ancestors while the values keep changing
+    static void updateChildrenInfo(const QSet<qulonglong> &folderIds, QSqlDatabase &db);
+    // recomputes numChildren and firstChildHash of every folder, only needed to repair a library
     static void updateChildrenInfo(QSqlDatabase &db);
     static void updateProgress(qulonglong libraryId, const ComicInfo &comicInfo);
     static void setComicAsReading(qulonglong libraryId, const ComicInfo &comicInfo);
@@ -88,6 +93,9 @@ public:
     static QList<LibraryItem *> getFoldersFromParent(qulonglong parentId, QSqlDatabase &db, bool sort = true);
     static QList<ComicDB> getSortedComicsFromParent(qulonglong parentId, QSqlDatabase &db);
     static QList<LibraryItem *> getComicsFromParent(qulonglong parentId, QSqlDatabase &db, bool sort = true);
+    // the folders/comics with the given ids in the same order, the ids that no longer exist are skipped
+    static QList<Folder> getFolders(const QList<qulonglong> &ids, QSqlDatabase &db);
+    static QList<ComicDB> getComics(const QList<qulonglong> &ids, QSqlDatabase &db);
     static QList<Label> getLabels(qulonglong libraryId);
 
     static void updateFolderTreeType(qulonglong id, QSqlDatabase &db, YACReader::FileType type);
@@ -63,9 +63,14 @@ ExportComicsInfoDialog::~ExportComicsInfoDialog()
 
 void ExportComicsInfoDialog::findPath()
 {
-    QString s = QFileDialog::getSaveFileName(this, tr("Destination database name"), ".", "*.ydb");
+    QString jsonLinesFilter = tr("Comics info JSON lines (*.jsonl)");
+    QString selectedFilter;
+    QString s = QFileDialog::getSaveFileName(this, tr("Destination database name"), ".", "*.ydb;;" + jsonLinesFilter, &selectedFilter);
     if (!s.isEmpty()) {
-        path->setText(s.endsWith(".ydb") ? s : s + ".ydb");
+        if (!s.endsWith(".ydb") && !s.endsWith(".jsonl")) {
+            s += selectedFilter == jsonLinesFilter ? ".jsonl" : ".ydb";
+        }
+        path->setText(s);
         accept->setEnabled(true);
     }
 }
@@ -75,8 +80,11 @@ void ExportComicsInfoDialog::exportComicsInfo()
     QFileInfo f(path->text());
     QFileInfo fPath(f.absoluteDir().path());
     if (fPath.exists() && fPath.isDir() && fPath.isWritable()) {
-        DataBaseManagement::exportComicsInfo(source, path->text());
-        close();
+        if (DataBaseManagement::exportComicsInfo(source, path->text())) {
+            close();
+        } else {
+            QMessageBox::critical(NULL, tr("Problem found while writing"), tr("The comics info could not be exported to the selected file."));
+        }
     } else
         QMessageBox::critical(NULL, tr("Problem found while writing"), tr("The selected path for the output file does not exist or is not a valid path. Be sure that you have write access to this folder"));
 }
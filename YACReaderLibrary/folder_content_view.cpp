@@ -1,5 +1,6 @@
 #include "folder_content_view.h"
 
+#include "cover_image_provider.h"
 #include "folder_model.h"
 #include "grid_comics_view.h"
 #include "yacreader_global.h"
@@ -9,6 +10,7 @@
 #include "QsLog.h"
 
 #include <QQmlContext>
+#include <QQmlEngine>
 #include <QQuickItem>
 #include <QQuickWidget>
 
@@ -75,8 +77,12 @@ FolderContentView::FolderContentView(QAction *toogleRecentVisibilityAction, QWid
     l->addWidget(toolbar);
     this->setLayout(l);
 
+    view->engine()->addImageProvider(CoverImageProvider::id, new CoverImageProvider());
+
     QQmlContext *ctxt = view->rootContext();
 
+    ctxt->setContextProperty("coverPrefetcher", new CoverPrefetcher(this));
+
     LibraryUITheme theme;
 #ifdef Y_MAC_UI
     theme = Light;
@@ -71,7 +71,7 @@ ImportComicsInfoDialog::~ImportComicsInfoDialog()
 
 void ImportComicsInfoDialog::findPath()
 {
-    QString s = QFileDialog::getOpenFileName(0, "Comics Info", ".", tr("Comics info file (*.ydb)"));
+    QString s = QFileDialog::getOpenFileName(0, "Comics Info", ".", tr("Comics info file (*.ydb *.jsonl)"));
     if (!s.isEmpty()) {
         path->setText(s);
         accept->setEnabled(true);
@@ -87,13 +87,24 @@ void ImportComicsInfoDialog::import()
     importer->dest = dest;
     connect(importer, &QThread::finished, this, &ImportComicsInfoDialog::close);
     connect(importer, &QThread::finished, this, &QWidget::hide);
+    connect(importer, &QThread::finished, importer, &QObject::deleteLater);
+    connect(importer, &Importer::progress, this, &ImportComicsInfoDialog::updateProgress);
     importer->start();
 }
 
+void ImportComicsInfoDialog::updateProgress(qint64 done, qint64 total)
+{
+    if (total > 0) {
+        progressBar->setMaximum(1000);
+        progressBar->setValue(int(done * 1000 / total));
+    }
+}
+
 void ImportComicsInfoDialog::close()
 {
     path->clear();
     progressBar->hide();
+    progressBar->setMaximum(0);
     accept->setDisabled(true);
     QDialog::close();
     emit finished(0);
@@ -101,5 +112,7 @@ void ImportComicsInfoDialog::close()
 
 void Importer::run()
 {
-    DataBaseManagement::importComicsInfo(source, dest);
+    DataBaseManagement::importComicsInfo(source, dest, [this](qint64 done, qint64 total) {
+        emit progress(done, total);
+    });
 }
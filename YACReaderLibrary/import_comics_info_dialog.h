@@ -11,10 +11,14 @@
 
 class Importer : public QThread
 {
+    Q_OBJECT
 public:
     QString source;
     QString dest;
 
+signals:
+    void progress(qint64 done, qint64 total);
+
 private:
     void run() override;
 };
@@ -47,6 +51,7 @@ private:
 public slots:
     void findPath();
     void import();
+    void updateProgress(qint64 done, qint64 total);
     void close();
 };
 
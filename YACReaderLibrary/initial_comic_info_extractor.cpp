@@ -4,11 +4,26 @@
 #include "pdf_comic.h"
 #include "comic.h"
 #include "compressed_archive.h"
+#include "extract_delegate.h"
 #include "qnaturalsorting.h"
 
 using namespace YACReader;
 
-bool InitialComicInfoExtractor::crash = false;
+namespace {
+// keeps the files extracted in one pass
+class ExtractedFiles : public ExtractDelegate
+{
+public:
+    void fileExtracted(int index, const QByteArray &rawData) { files.insert(index, rawData); }
+    void crcError(int index) { Q_UNUSED(index) }
+    void unknownError(int index) { Q_UNUSED(index) }
+    bool isCancelled() { return false; }
+
+    QMap<int, QByteArray> files;
+};
+}
+
+std::atomic<bool> InitialComicInfoExtractor::crash(false);
 
 InitialComicInfoExtractor::InitialComicInfoExtractor(QString fileSource, QString target, int coverPage, bool getXMLMetadata)
     : _fileSource(fileSource), _target(target), _numPages(0), _coverPage(coverPage), getXMLMetadata(getXMLMetadata), _xmlInfoData()
@@ -93,22 +108,21 @@ void InitialComicInfoExtractor::extract()
 
     QList<QString> order = archive.getFileNames();
 
+    int infoIndex = -1;
     if (getXMLMetadata) {
         // Try to find embeded XML info (ComicRack or ComicTagger)
-        auto infoIndex = 0;
-        for (auto &fileName : order) {
-            if (fileName.endsWith(".xml", Qt::CaseInsensitive)) {
-                _xmlInfoData = archive.getRawDataAtIndex(infoIndex);
+        for (int i = 0; i < order.size(); i++) {
+            if (order.at(i).endsWith(".xml", Qt::CaseInsensitive)) {
+                infoIndex = i;
                 break;
             }
-
-            infoIndex++;
         }
     }
 
-    //--------------------------
-
     if (_target == "None") {
+        if (infoIndex != -1) {
+            _xmlInfoData = archive.getRawDataAtIndex(infoIndex);
+        }
         return;
     }
 
@@ -116,6 +130,9 @@ void InitialComicInfoExtractor::extract()
     QList<QString> fileNames = FileComic::filter(order);
     _numPages = fileNames.size();
     if (_numPages == 0) {
+        if (infoIndex != -1) {
+            _xmlInfoData = archive.getRawDataAtIndex(infoIndex);
+        }
         QLOG_WARN() << "Extracting cover: empty comic " << _fileSource;
         _cover.load(":/images/notCover.png");
         if (_target != "") {
@@ -125,17 +142,32 @@ void InitialComicInfoExtractor::extract()
         if (_coverPage > _numPages) {
             _coverPage = 1;
         }
-        std::sort(fileNames.begin(), fileNames.end(), naturalSortLessThanCI);
+        naturalSort(fileNames);
         int index = order.indexOf(fileNames.at(_coverPage - 1));
 
+        // in solid archives the XML and the cover are extracted in one pass if they share a block, so it is decompressed once
+        QByteArray coverData;
+        int block = archive.getSolidBlock(index);
+        if (infoIndex != -1 && block != -1 && block == archive.getSolidBlock(infoIndex)) {
+            ExtractedFiles extracted;
+            archive.getAllData(QVector<quint32> { quint32(qMin(infoIndex, index)), quint32(qMax(infoIndex, index)) }, &extracted);
+            _xmlInfoData = extracted.files.value(infoIndex);
+            coverData = extracted.files.value(index);
+        } else {
+            if (infoIndex != -1) {
+                _xmlInfoData = archive.getRawDataAtIndex(infoIndex);
+            }
+            coverData = archive.getRawDataAtIndex(index);
+        }
+
         if (_target == "") {
-            if (!_cover.loadFromData(archive.getRawDataAtIndex(index))) {
+            if (!_cover.loadFromData(coverData)) {
                 QLOG_WARN() << "Extracting cover: unable to load image from extracted cover " << _fileSource;
                 _cover.load(":/images/notCover.png");
             }
         } else {
             QImage p;
-            if (p.loadFromData(archive.getRawDataAtIndex(index))) {
+            if (p.loadFromData(coverData)) {
                 _coverSize = QPair<int, int>(p.width(), p.height());
                 saveCover(_target, p);
             } else {
@@ -3,6 +3,8 @@
 
 #include <QtGui>
 
+#include <atomic>
+
 namespace YACReader {
 class InitialComicInfoExtractor : public QObject
 {
@@ -20,7 +22,7 @@ private:
     QImage _cover;
     int _coverPage;
     int getXMLMetadata;
-    static bool crash;
+    static std::atomic<bool> crash; // extractions can run concurrently in LibraryCreator
     QByteArray _xmlInfoData;
     void saveCover(const QString &path, const QImage &cover);
 
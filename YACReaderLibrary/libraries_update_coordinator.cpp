@@ -1,6 +1,7 @@
 
 #include "libraries_update_coordinator.h"
 
+#include "library_change_journal.h"
 #include "library_creator.h"
 #include "yacreader_libraries.h"
 #include "yacreader_global.h"
@@ -96,6 +97,24 @@ void LibrariesUpdateCoordinator::startUpdate()
 
     canceled = false;
 
+    // the journals watch the library folders from this thread
+    QSet<QString> paths;
+    for (const auto &library : libraries.getLibraries()) {
+        auto path = QDir::cleanPath(QDir(library.getPath()).absolutePath());
+        paths.insert(path);
+        if (!journals.contains(path) && QDir(path).exists()) {
+            journals.insert(path, new LibraryChangeJournal(path, this));
+        }
+    }
+    for (auto it = journals.begin(); it != journals.end();) {
+        if (!paths.contains(it.key())) {
+            it.value()->deleteLater();
+            it = journals.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
     updateFuture = std::async(std::launch::async, [this] {
         emit updateStarted();
         for (auto library : libraries.getLibraries()) {
@@ -121,12 +140,33 @@ void LibrariesUpdateCoordinator::updateLibrary(const QString &path)
 
     QString cleanPath = QDir::cleanPath(pathDir.absolutePath());
 
-    libraryCreator->updateLibrary(cleanPath, QDir::cleanPath(pathDir.absolutePath() + "/.yacreaderlibrary"));
+    // comparing the modified dates of the comics needs to list every folder
+    auto journal = journals.value(cleanPath);
+    QSet<QString> changedFolders;
+    bool fullUpdate = journal == nullptr || !journal->changedFolders(changedFolders) || settings->value(COMPARE_MODIFIED_DATE_ON_LIBRARY_UPDATES, false).toBool();
+
+    if (!fullUpdate && changedFolders.isEmpty()) {
+        journal->commit();
+        return;
+    }
+
+    if (fullUpdate) {
+        libraryCreator->updateLibrary(cleanPath, QDir::cleanPath(pathDir.absolutePath() + "/.yacreaderlibrary"));
+    } else {
+        libraryCreator->updateLibrary(cleanPath, QDir::cleanPath(pathDir.absolutePath() + "/.yacreaderlibrary"), changedFolders);
+    }
 
+    bool failed = false;
+    connect(libraryCreator, &LibraryCreator::failedOpeningDB, libraryCreator, [&failed] { failed = true; }, Qt::DirectConnection);
     connect(libraryCreator, &LibraryCreator::finished, &eventLoop, &QEventLoop::quit);
 
     libraryCreator->start();
     eventLoop.exec();
+
+    // a stopped or canceled update didn't see all the changes
+    if (journal != nullptr && !failed && !canceled) {
+        journal->commit();
+    }
 }
 
 void LibrariesUpdateCoordinator::stop()
@@ -6,6 +6,7 @@
 
 class YACReaderLibraries;
 class LibraryCreator;
+class LibraryChangeJournal;
 
 class LibrariesUpdateCoordinator : public QObject
 {
@@ -38,6 +39,7 @@ private:
     std::future<void> updateFuture;
     bool canceled;
     std::weak_ptr<LibraryCreator> currentLibraryCreator;
+    QMap<QString, LibraryChangeJournal *> journals; // key: library path, they are only added or removed when no update is running
 
     std::function<bool()> canStartUpdateProvider;
 };
@@ -0,0 +1,262 @@
+#include "library_change_journal.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+#include "yacreader_global.h"
+
+#include "QsLog.h"
+
+namespace {
+const quint32 journalMagic = 0x59434a4c; // YCJL
+const quint32 journalVersion = 1;
+
+// a folder modified right before it is recorded could be modified again without changing its time (coarse timestamps)
+const qint64 unsettledTime = 2000;
+}
+
+LibraryChangeJournal::LibraryChangeJournal(const QString &libraryPath, QObject *parent)
+    : QObject(parent), libraryPath(QDir::cleanPath(QDir(libraryPath).absolutePath())), hasSnapshot(false), checkedSnapshot(false), reliableEvents(false)
+{
+    journalPath = this->libraryPath + "/.yacreaderlibrary/change_journal";
+
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, this, &LibraryChangeJournal::directoryChanged);
+
+    hasSnapshot = load();
+    if (hasSnapshot) {
+        updateWatches();
+    }
+}
+
+bool LibraryChangeJournal::changedFolders(QSet<QString> &folders)
+{
+    QMutexLocker locker(&mutex);
+    auto current = snapshot;
+    bool full = !hasSnapshot;
+    bool compareSnapshot = !reliableEvents || !checkedSnapshot;
+    // folders from an update that didn't finish are still changed
+    auto changed = notifiedFolders + pendingFolders;
+    notifiedFolders.clear();
+    locker.unlock();
+
+    // the new snapshot is taken before the update, anything that changes while it is running will be found next time
+    QHash<QString, FolderState> newSnapshot;
+    if (full) {
+        scan("/", newSnapshot);
+        changed.clear();
+    } else {
+        if (compareSnapshot) {
+            for (auto it = current.cbegin(); it != current.cend(); ++it) {
+                FolderState state;
+                if (it.value().lastModified == -1 || !folderState(absolutePath(it.key()), state) || state != it.value()) {
+                    changed.insert(it.key());
+                }
+            }
+        }
+
+        newSnapshot = current;
+        for (const auto &folder : std::as_const(changed)) {
+            FolderState state;
+            if (!folderState(absolutePath(folder), state)) {
+                auto prefix = folder + "/";
+                for (auto it = newSnapshot.begin(); it != newSnapshot.end();) {
+                    if (it.key() == folder || it.key().startsWith(prefix)) {
+                        it = newSnapshot.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                continue;
+            }
+
+            newSnapshot.insert(folder, state);
+
+            // new subfolders are recorded with all their content, the update creates them from scratch
+            const auto subfolders = QDir(absolutePath(folder)).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+            for (const auto &name : subfolders) {
+                auto subfolder = (folder == "/" ? "" : folder) + "/" + name;
+                if (subfolder != "/.yacreaderlibrary" && !newSnapshot.contains(subfolder)) {
+                    scan(subfolder, newSnapshot);
+                }
+            }
+        }
+    }
+
+    locker.relock();
+    pendingSnapshot = newSnapshot;
+    pendingFolders = changed;
+
+    folders = changed;
+    return !full;
+}
+
+void LibraryChangeJournal::commit()
+{
+    QMutexLocker locker(&mutex);
+    snapshot = pendingSnapshot;
+    pendingSnapshot.clear();
+    pendingFolders.clear();
+    hasSnapshot = true;
+    checkedSnapshot = true;
+    auto current = snapshot;
+    locker.unlock();
+
+    save(current);
+
+    // the watcher belongs to the thread of the journal
+    QMetaObject::invokeMethod(this, "updateWatches", Qt::QueuedConnection);
+}
+
+void LibraryChangeJournal::directoryChanged(const QString &path)
+{
+    QMutexLocker locker(&mutex);
+    notifiedFolders.insert(relativePath(path));
+}
+
+void LibraryChangeJournal::updateWatches()
+{
+    QMutexLocker locker(&mutex);
+    const auto folders = snapshot.keys();
+    locker.unlock();
+
+    QSet<QString> paths;
+    for (const auto &folder : folders) {
+        paths.insert(absolutePath(folder));
+    }
+
+    QStringList removed;
+    const auto watched = watcher.directories();
+    for (const auto &path : watched) {
+        if (!paths.remove(path)) {
+            removed << path;
+        }
+    }
+    if (!removed.isEmpty()) {
+        watcher.removePaths(removed);
+    }
+
+    auto failed = paths.isEmpty() ? QStringList() : watcher.addPaths(QStringList(paths.begin(), paths.end()));
+    if (!failed.isEmpty()) {
+        QLOG_WARN() << "Unable to watch" << failed.size() << "folders in" << libraryPath << ", their changes will be found comparing their modification times";
+    }
+
+    // changes made by other machines in network file systems are not notified
+    bool reliable = failed.isEmpty() && !YACReader::isNetworkFileSystem(libraryPath);
+
+    locker.relock();
+    reliableEvents = reliable;
+}
+
+QString LibraryChangeJournal::relativePath(const QString &absolutePath) const
+{
+    auto path = QDir::cleanPath(absolutePath).mid(libraryPath.length());
+    return path.isEmpty() ? "/" : path;
+}
+
+QString LibraryChangeJournal::absolutePath(const QString &relativePath) const
+{
+    return relativePath == "/" ? libraryPath : libraryPath + relativePath;
+}
+
+bool LibraryChangeJournal::folderState(const QString &absolutePath, FolderState &state)
+{
+#ifdef Q_OS_UNIX
+    struct stat info;
+    if (::stat(QFile::encodeName(absolutePath).constData(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        return false;
+    }
+    state.lastModified = static_cast<qint64>(info.st_mtime) * 1000;
+    state.inode = static_cast<quint64>(info.st_ino);
+#else
+    QFileInfo info(absolutePath);
+    if (!info.isDir()) {
+        return false;
+    }
+    state.lastModified = info.lastModified().toMSecsSinceEpoch();
+    state.inode = 0;
+#endif
+
+    // an unsettled folder is recorded with an invalid time, so it is compared again next time
+    if (QDateTime::currentMSecsSinceEpoch() - state.lastModified < unsettledTime) {
+        state.lastModified = -1;
+    }
+    return true;
+}
+
+void LibraryChangeJournal::scan(const QString &folder, QHash<QString, FolderState> &snapshot) const
+{
+    FolderState state;
+    if (!folderState(absolutePath(folder), state)) {
+        return;
+    }
+    snapshot.insert(folder, state);
+
+    const auto subfolders = QDir(absolutePath(folder)).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const auto &name : subfolders) {
+        auto subfolder = (folder == "/" ? "" : folder) + "/" + name;
+        if (subfolder != "/.yacreaderlibrary") {
+            scan(subfolder, snapshot);
+        }
+    }
+}
+
+bool LibraryChangeJournal::load()
+{
+    QFile file(journalPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic, version;
+    qint32 count;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != journalMagic || version != journalVersion || count < 0) {
+        return false;
+    }
+
+    QHash<QString, FolderState> loaded;
+    loaded.reserve(count);
+    for (qint32 i = 0; i < count; i++) {
+        QString folder;
+        FolderState state;
+        stream >> folder >> state.lastModified >> state.inode;
+        loaded.insert(folder, state);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        QLOG_WARN() << "Invalid change journal" << journalPath;
+        return false;
+    }
+
+    snapshot = loaded;
+    return true;
+}
+
+void LibraryChangeJournal::save(const QHash<QString, FolderState> &snapshot) const
+{
+    QSaveFile file(journalPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        QLOG_ERROR() << "Unable to save the change journal" << journalPath;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << journalMagic << journalVersion << static_cast<qint32>(snapshot.size());
+    for (auto it = snapshot.cbegin(); it != snapshot.cend(); ++it) {
+        stream << it.key() << it.value().lastModified << it.value().inode;
+    }
+
+    if (!file.commit()) {
+        QLOG_ERROR() << "Unable to save the change journal" << journalPath;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef LIBRARY_CHANGE_JOURNAL_H
+#define LIBRARY_CHANGE_JOURNAL_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+// Keeps track of the folders of a library whose entries changed since the last update, so automatic updates only
+// compare those folders with the DB instead of listing the whole library.
+// Folders are watched with QFileSystemWatcher (inotify, FSEvents, ...). Network file systems don't deliver the changes
+// made by other machines and watches can run out, in those cases the modification time and inode of every known folder
+// are compared with a snapshot instead, which only costs a stat per folder. The snapshot is stored in the library
+// folder, the first check after a restart always compares it to find the changes made while the app was closed.
+// Folders are identified by their path relative to the library, like Folder::path ("/" is the root folder).
+class LibraryChangeJournal : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LibraryChangeJournal(const QString &libraryPath, QObject *parent = nullptr);
+
+    // returns false if the journal can't tell what changed (there is no snapshot yet), a full update is needed
+    // the folders are kept as changed until commit() is called after updating them, it is safe to call from any thread
+    bool changedFolders(QSet<QString> &folders);
+    // the changes returned by the last changedFolders() are in the DB now
+    void commit();
+
+private slots:
+    void directoryChanged(const QString &path);
+    void updateWatches();
+
+private:
+    struct FolderState {
+        qint64 lastModified;
+        quint64 inode;
+        bool operator==(const FolderState &other) const { return lastModified == other.lastModified && inode == other.inode; }
+        bool operator!=(const FolderState &other) const { return !(*this == other); }
+    };
+
+    QString relativePath(const QString &absolutePath) const;
+    QString absolutePath(const QString &relativePath) const;
+    static bool folderState(const QString &absolutePath, FolderState &state);
+    // adds `folder` and all the folders under it
+    void scan(const QString &folder, QHash<QString, FolderState> &snapshot) const;
+    bool load();
+    void save(const QHash<QString, FolderState> &snapshot) const;
+
+    QString libraryPath;
+    QString journalPath;
+    QFileSystemWatcher watcher;
+
+    QMutex mutex;
+    QHash<QString, FolderState> snapshot;
+    QHash<QString, FolderState> pendingSnapshot; // snapshot taken before the running update
+    QSet<QString> notifiedFolders; // reported by the watcher
+    QSet<QString> pendingFolders; // returned by the last changedFolders()
+    bool hasSnapshot;
+    bool checkedSnapshot; // the snapshot has been compared since the app started
+    bool reliableEvents; // all the folders are watched in a local file system
+};
+
+#endif // LIBRARY_CHANGE_JOURNAL_H
@@ -17,6 +17,7 @@
 #include "comic.h"
 #include "pdf_comic.h"
 #include "yacreader_global.h"
+#include "cover_cache.h"
 
 #include "QsLog.h"
 
@@ -27,7 +28,7 @@ using namespace YACReader;
 
 //--------------------------------------------------------------------------------
 LibraryCreator::LibraryCreator(QSettings *settings)
-    : creation(false), partialUpdate(false), settings(settings)
+    : creation(false), partialUpdate(false), onlyChangedFolders(false), settings(settings), extractionWorkers(std::max(1, QThread::idealThreadCount()))
 {
     _nameFilter << Comic::comicExtensions;
 }
@@ -42,15 +43,35 @@ void LibraryCreator::updateLibrary(const QString &source, const QString &target)
 {
     checkModifiedDatesOnUpdate = settings->value(COMPARE_MODIFIED_DATE_ON_LIBRARY_UPDATES, false).toBool();
     partialUpdate = false;
+    onlyChangedFolders = false;
     _source = source;
     _target = target;
     _mode = UPDATER;
 }
 
+void LibraryCreator::updateLibrary(const QString &source, const QString &target, const QSet<QString> &changedFolders)
+{
+    updateLibrary(source, target);
+
+    onlyChangedFolders = true;
+    _changedFolders = changedFolders;
+    _foldersToVisit.clear();
+    for (auto path : changedFolders) {
+        while (!_foldersToVisit.contains(path)) {
+            _foldersToVisit.insert(path);
+            path = path.left(path.lastIndexOf('/'));
+            if (path.isEmpty()) {
+                path = "/";
+            }
+        }
+    }
+}
+
 void LibraryCreator::updateFolder(const QString &source, const QString &target, const QString &sourceFolder, const QModelIndex &dest)
 {
     checkModifiedDatesOnUpdate = settings->value(COMPARE_MODIFIED_DATE_ON_LIBRARY_UPDATES, false).toBool();
     partialUpdate = true;
+    onlyChangedFolders = false;
     folderDestinationModelIndex = dest;
 
     _currentPathFolders.clear();
@@ -158,10 +179,18 @@ void LibraryCreator::run()
 
             /*QSqlQuery pragma("PRAGMA foreign_keys = ON",_database);*/
             _database.transaction();
+            _writeBatch = std::make_unique<LibraryWriteBatch>(_database);
             // se crea la librería
+            extractionQueue = std::make_unique<ConcurrentQueue>(extractionWorkers);
             create(QDir(_source));
+            extractionQueue.reset();
+            _prefetched.clear();
+            _pendingExtractions.clear();
 
-            DBHelper::updateChildrenInfo(_database);
+            _writeBatch->flush();
+            _writeBatch.reset();
+            DBHelper::updateChildrenInfo(_dirtyFolders, _database);
+            _dirtyFolders.clear();
 
             _database.commit();
             _database.close();
@@ -200,27 +229,34 @@ void LibraryCreator::run()
             QSqlQuery pragma("PRAGMA foreign_keys = ON", _database);
             pragma.exec();
             _database.transaction();
+            _writeBatch = std::make_unique<LibraryWriteBatch>(_database);
 
+            extractionQueue = std::make_unique<ConcurrentQueue>(extractionWorkers);
             if (partialUpdate) {
                 update(QDir(_sourceFolder));
             } else {
                 update(QDir(_source));
             }
+            extractionQueue.reset();
+            _prefetched.clear();
+            _pendingExtractions.clear();
 
             if (!canceled) {
-                if (partialUpdate) {
-                    auto folder = DBHelper::updateChildrenInfo(folderDestinationModelIndex.data(FolderModel::IdRole).toULongLong(), _database);
-                    DBHelper::propagateFolderUpdatesToParent(folder, _database);
-                } else
-                    DBHelper::updateChildrenInfo(_database);
-
+                _writeBatch->flush();
+                DBHelper::updateChildrenInfo(_dirtyFolders, _database);
                 _database.commit();
             }
+            _writeBatch.reset();
+            _dirtyFolders.clear();
             _database.close();
         }
 
         QSqlDatabase::removeDatabase(_databaseConnection);
 
+        if (!canceled && !partialUpdate) {
+            CoverCache::pruneScaledCovers(_target + "/covers");
+        }
+
         // si estabamos en modo creación, se está añadiendo una librería que ya existía y se ha actualizado antes de añadirse.
         if (!partialUpdate) {
             if (!creation) {
@@ -256,7 +292,6 @@ void LibraryCreator::cancel()
 // retorna el id del ultimo de los folders
 qulonglong LibraryCreator::insertFolders()
 {
-    auto _database = QSqlDatabase::database(_databaseConnection);
     QList<Folder>::iterator i;
     int currentId = 0;
     Folder currentParent;
@@ -264,7 +299,8 @@ qulonglong LibraryCreator::insertFolders()
         if (!(i->knownId)) {
             i->setFather(currentId);
             i->type = currentParent.type;
-            currentId = DBHelper::insert(&(*i), _database); // insertFolder(currentId,*i);
+            _dirtyFolders.insert(i->parentId);
+            currentId = _writeBatch->insert(&(*i)); // insertFolder(currentId,*i);
             i->setId(currentId);
         } else {
             currentId = i->id;
@@ -280,6 +316,14 @@ void LibraryCreator::create(QDir dir)
     dir.setNameFilters(_nameFilter);
     dir.setFilter(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot);
     QFileInfoList list = dir.entryInfoList();
+
+    PrefetchWindow window;
+    for (const auto &fileInfo : list) {
+        if (!fileInfo.isDir()) {
+            window.files.append(fileInfo);
+        }
+    }
+
     for (int i = 0; i < list.size(); ++i) {
         if (stopRunning)
             return;
@@ -305,7 +349,7 @@ void LibraryCreator::create(QDir dir)
             _currentPathFolders.pop_back();
         } else {
             QLOG_TRACE() << "Parsing file" << fileInfo.filePath();
-            insertComic(relativePath, fileInfo);
+            insertComic(relativePath, fileInfo, window);
         }
     }
 }
@@ -328,55 +372,135 @@ QString pseudoHash(const QFileInfo &fileInfo)
 
 void LibraryCreator::insertComic(const QString &relativePath, const QFileInfo &fileInfo)
 {
-    auto _database = QSqlDatabase::database(_databaseConnection);
-
-    QString hash = pseudoHash(fileInfo);
+    auto prefetched = _prefetched.take(fileInfo.absoluteFilePath());
+    QString hash = prefetched.hash.isEmpty() ? pseudoHash(fileInfo) : prefetched.hash;
 
-    ComicDB comic = DBHelper::loadComic(fileInfo.fileName(), relativePath, hash, _database);
-    int numPages = 0;
-    QPair<int, int> originalCoverSize = { 0, 0 };
+    ComicDB comic = _writeBatch->loadComic(fileInfo.fileName(), relativePath, hash);
+    ComicExtraction extraction;
     bool exists = checkCover(hash);
 
-    YACReader::InitialComicInfoExtractor ie(QDir::cleanPath(fileInfo.absoluteFilePath()), _target + "/covers/" + hash + ".jpg", comic.info.coverPage.toInt(), settings->value(IMPORT_COMIC_INFO_XML_METADATA, false).toBool());
-
     if (!(comic.hasCover() && exists)) {
-        ie.extract();
-        numPages = ie.getNumPages();
-        originalCoverSize = ie.getOriginalCoverSize();
-        if (numPages > 0) {
+        // the DB may have changed since the comic was scheduled, the prefetched data is used only if it is still valid
+        if (prefetched.extraction.valid() && prefetched.coverPage == comic.info.coverPage.toInt()) {
+            extraction = prefetched.extraction.get();
+        } else {
+            extraction = extractComic(QDir::cleanPath(fileInfo.absoluteFilePath()), _target + "/covers/" + hash + ".jpg", comic.info.coverPage.toInt(), settings->value(IMPORT_COMIC_INFO_XML_METADATA, false).toBool());
+        }
+        if (extraction.numPages > 0) {
             emit comicAdded(relativePath, _target + "/covers/" + hash + ".jpg");
         }
     }
 
-    if (numPages > 0 || exists) {
+    if (prefetched.extraction.valid()) {
+        _pendingExtractions.remove(hash);
+    }
+
+    if (extraction.numPages > 0 || exists) {
         // en este punto sabemos que todos los folders que hay en _currentPath, deberían estar añadidos a la base de datos
         insertFolders();
 
-        bool parsed = YACReader::parseXMLIntoInfo(ie.getXMLInfoRawData(), comic.info);
+        bool parsed = YACReader::parseXMLIntoInfo(extraction.xmlInfoRawData, comic.info);
 
-        comic.info.numPages = numPages;
-        if (originalCoverSize.second > 0) {
-            comic.info.originalCoverSize = QString("%1x%2").arg(originalCoverSize.first).arg(originalCoverSize.second);
-            comic.info.coverSizeRatio = static_cast<float>(originalCoverSize.first) / originalCoverSize.second;
+        comic.info.numPages = extraction.numPages;
+        if (extraction.originalCoverSize.second > 0) {
+            comic.info.originalCoverSize = QString("%1x%2").arg(extraction.originalCoverSize.first).arg(extraction.originalCoverSize.second);
+            comic.info.coverSizeRatio = static_cast<float>(extraction.originalCoverSize.first) / extraction.originalCoverSize.second;
         }
 
         comic.parentId = _currentPathFolders.last().id;
         comic.info.type = QVariant::fromValue(_currentPathFolders.last().type); // TODO_METADATA test this
 
-        DBHelper::insert(&comic, _database, parsed);
+        _writeBatch->insert(&comic, parsed);
+        _dirtyFolders.insert(comic.parentId);
     }
 }
 
-void LibraryCreator::replaceComic(const QString &relativePath, const QFileInfo &fileInfo, ComicDB *comic)
+void LibraryCreator::insertComic(const QString &relativePath, const QFileInfo &fileInfo, PrefetchWindow &window)
 {
-    auto _database = QSqlDatabase::database(_databaseConnection);
+    // keep the workers busy with the next comics while this one is being inserted
+    auto isScheduled = _prefetched.contains(fileInfo.absoluteFilePath());
+    if ((!isScheduled || window.scheduled - window.consumed < 2 * extractionWorkers) && window.scheduled < window.files.size()) {
+        auto files = window.files.mid(window.scheduled, 4 * extractionWorkers);
+        window.scheduled += files.size();
+        prefetchComics(files);
+        isScheduled = _prefetched.contains(fileInfo.absoluteFilePath());
+    }
+
+    if (isScheduled) {
+        window.consumed++;
+    }
 
-    DBHelper::removeFromDB(comic, _database);
+    insertComic(relativePath, fileInfo);
+}
+
+void LibraryCreator::prefetchComics(const QFileInfoList &files)
+{
+    auto getXMLMetadata = settings->value(IMPORT_COMIC_INFO_XML_METADATA, false).toBool();
+
+    QList<std::shared_future<QString>> hashes;
+    for (const auto &fileInfo : files) {
+        auto hash = std::make_shared<std::promise<QString>>();
+        hashes.append(hash->get_future().share());
+        // QFileInfo caches its data lazily, so workers get their own instance
+        auto path = fileInfo.absoluteFilePath();
+        extractionQueue->enqueue([hash, path] {
+            hash->set_value(pseudoHash(QFileInfo(path)));
+        });
+    }
+
+    for (int i = 0; i < files.size(); i++) {
+        const auto &fileInfo = files.at(i);
+
+        PrefetchedComic prefetched;
+        prefetched.hash = hashes.at(i).get();
+
+        ComicDB comic = _writeBatch->loadComic(fileInfo.fileName(), "", prefetched.hash);
+        prefetched.coverPage = comic.info.coverPage.toInt();
+
+        if (!(comic.hasCover() && checkCover(prefetched.hash))) {
+            auto pending = _pendingExtractions.constFind(prefetched.hash);
+            if (pending != _pendingExtractions.constEnd() && pending->coverPage == prefetched.coverPage) {
+                prefetched.extraction = pending->extraction;
+            } else {
+                auto extraction = std::make_shared<std::promise<ComicExtraction>>();
+                prefetched.extraction = extraction->get_future().share();
+                _pendingExtractions.insert(prefetched.hash, prefetched);
+
+                auto path = QDir::cleanPath(fileInfo.absoluteFilePath());
+                auto coverPath = _target + "/covers/" + prefetched.hash + ".jpg";
+                auto coverPage = prefetched.coverPage;
+                extractionQueue->enqueue([extraction, path, coverPath, coverPage, getXMLMetadata] {
+                    extraction->set_value(extractComic(path, coverPath, coverPage, getXMLMetadata));
+                });
+            }
+        }
+
+        _prefetched.insert(fileInfo.absoluteFilePath(), prefetched);
+    }
+}
+
+LibraryCreator::ComicExtraction LibraryCreator::extractComic(const QString &path, const QString &coverPath, int coverPage, bool getXMLMetadata)
+{
+    ComicExtraction extraction;
+
+    YACReader::InitialComicInfoExtractor ie(path, coverPath, coverPage, getXMLMetadata);
+    ie.extract();
+
+    extraction.numPages = ie.getNumPages();
+    extraction.originalCoverSize = ie.getOriginalCoverSize();
+    extraction.xmlInfoRawData = ie.getXMLInfoRawData();
+
+    return extraction;
+}
+
+void LibraryCreator::replaceComic(const QString &relativePath, const QFileInfo &fileInfo, ComicDB *comic)
+{
+    removeFromDB(comic);
     insertComic(relativePath, fileInfo);
 
     QString hash = pseudoHash(fileInfo);
 
-    ComicDB insertedComic = DBHelper::loadComic(fileInfo.fileName(), relativePath, hash, _database);
+    ComicDB insertedComic = _writeBatch->loadComic(fileInfo.fileName(), relativePath, hash);
 
     if (!insertedComic.info.existOnDb) {
         return;
@@ -400,7 +524,15 @@ void LibraryCreator::replaceComic(const QString &relativePath, const QFileInfo &
     insertedComic.info.coverPage = 1;
     insertedComic.info.added = fileInfo.lastModified().toSecsSinceEpoch();
 
-    DBHelper::update(&(insertedComic.info), _database);
+    _writeBatch->update(&(insertedComic.info));
+}
+
+void LibraryCreator::removeFromDB(LibraryItem *item)
+{
+    auto _database = QSqlDatabase::database(_databaseConnection);
+
+    _dirtyFolders.insert(item->parentId);
+    DBHelper::removeFromDB(item, _database);
 }
 
 void LibraryCreator::update(QDir dirS)
@@ -410,6 +542,22 @@ void LibraryCreator::update(QDir dirS)
     }
 
     auto _database = QSqlDatabase::database(_databaseConnection);
+
+    // the entries of an unchanged folder are not listed, only the subfolders on the way to the changed ones are visited
+    if (onlyChangedFolders && !_changedFolders.contains(_currentPathFolders.last().path)) {
+        QList<LibraryItem *> folders = DBHelper::getFoldersFromParent(_currentPathFolders.last().id, _database, false);
+        for (auto item : folders) {
+            auto folder = static_cast<Folder *>(item);
+            if (!stopRunning && _foldersToVisit.contains(folder->path)) {
+                _currentPathFolders.append(*folder);
+                update(QDir(_source + folder->path));
+                _currentPathFolders.pop_back();
+            }
+        }
+        qDeleteAll(folders);
+        return;
+    }
+
     // QLOG_TRACE() << "Updating" << dirS.absolutePath();
     // QLOG_TRACE() << "Getting info from dir" << dirS.absolutePath();
     dirS.setNameFilters(_nameFilter);
@@ -420,8 +568,9 @@ void LibraryCreator::update(QDir dirS)
     dirS.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
     QFileInfoList listSFiles = dirS.entryInfoList();
 
-    std::sort(listSFolders.begin(), listSFolders.end(), naturalSortLessThanCIFileInfo);
-    std::sort(listSFiles.begin(), listSFiles.end(), naturalSortLessThanCIFileInfo);
+    auto fileName = [](const QFileInfo &fileInfo) { return fileInfo.fileName(); };
+    naturalSort(listSFolders, fileName);
+    naturalSort(listSFiles, fileName);
 
     QFileInfoList listS;
     listS.append(listSFolders);
@@ -437,9 +586,22 @@ void LibraryCreator::update(QDir dirS)
     QList<LibraryItem *> comics = DBHelper::getComicsFromParent(_currentPathFolders.last().id, _database);
     // QLOG_TRACE() << "END Getting info from DB" << dirS.absolutePath();
 
+    // files that are not in the DB yet are the candidates to be inserted
+    QSet<QString> comicNames;
+    for (auto comic : comics) {
+        comicNames.insert(comic->name);
+    }
+    PrefetchWindow window;
+    for (const auto &fileInfo : listSFiles) {
+        if (!comicNames.contains(fileInfo.fileName())) {
+            window.files.append(fileInfo);
+        }
+    }
+
     QList<LibraryItem *> listD;
-    std::sort(folders.begin(), folders.end(), naturalSortLessThanCILibraryItem);
-    std::sort(comics.begin(), comics.end(), naturalSortLessThanCILibraryItem);
+    auto name = [](const LibraryItem *item) { return item->name; };
+    naturalSort(folders, name);
+    naturalSort(comics, name);
     listD.append(folders);
     listD.append(comics);
     // QLOG_DEBUG() << "---------------------------------------------------------";
@@ -468,7 +630,7 @@ void LibraryCreator::update(QDir dirS)
                     qDeleteAll(listD);
                     return;
                 }
-                DBHelper::removeFromDB(listD.at(j), (_database));
+                removeFromDB(listD.at(j));
             }
             updated = true;
         }
@@ -512,7 +674,7 @@ void LibraryCreator::update(QDir dirS)
 
                     QString path = QDir::cleanPath(fileInfoS.absoluteFilePath()).remove(_source);
 #endif
-                    insertComic(path, fileInfoS);
+                    insertComic(path, fileInfoS, window);
                 }
             }
             updated = true;
@@ -527,9 +689,11 @@ void LibraryCreator::update(QDir dirS)
             if (fileInfoS.isDir() && fileInfoD->isDir())
                 if (comparation == 0) // same folder, update
                 {
-                    _currentPathFolders.append(*static_cast<Folder *>(fileInfoD)); // fileInfoD conoce su padre y su id
-                    update(QDir(fileInfoS.absoluteFilePath()));
-                    _currentPathFolders.pop_back();
+                    if (!onlyChangedFolders || _foldersToVisit.contains(static_cast<Folder *>(fileInfoD)->path)) {
+                        _currentPathFolders.append(*static_cast<Folder *>(fileInfoD)); // fileInfoD conoce su padre y su id
+                        update(QDir(fileInfoS.absoluteFilePath()));
+                        _currentPathFolders.pop_back();
+                    }
                     i++;
                     j++;
                 } else if (comparation < 0) // nameS doesn't exist on DB
@@ -557,7 +721,7 @@ void LibraryCreator::update(QDir dirS)
                 {
                     if (nameS != "/.yacreaderlibrary") {
                         // QLOG_WARN() << "dir source > dest" << nameS << nameD;
-                        DBHelper::removeFromDB(fileInfoD, _database);
+                        removeFromDB(fileInfoD);
                         j++;
                     } else
                         i++; // skip library directory
@@ -586,7 +750,7 @@ void LibraryCreator::update(QDir dirS)
                     i++;
                 } else if (fileInfoD->isDir()) // delete this folder from library
                 {
-                    DBHelper::removeFromDB(fileInfoD, _database);
+                    removeFromDB(fileInfoD);
                     j++;
                 } else // both are files  //BUG on windows (no case sensitive)
                 {
@@ -605,12 +769,12 @@ void LibraryCreator::update(QDir dirS)
 #else
                         QString path = QDir::cleanPath(fileInfoS.absoluteFilePath()).remove(_source);
 #endif
-                        insertComic(path, fileInfoS);
+                        insertComic(path, fileInfoS, window);
                         i++;
                     } else {
                         if (comparation > 0) // delete thumbnail
                         {
-                            DBHelper::removeFromDB(fileInfoD, _database);
+                            removeFromDB(fileInfoD);
                             j++;
                         } else // file with the same name
                         {
@@ -15,8 +15,13 @@
 #include <QSqlDatabase>
 #include <QModelIndex>
 
+#include <future>
+#include <memory>
+
 #include "folder.h"
 #include "comic_db.h"
+#include "concurrent_queue.h"
+#include "library_write_batch.h"
 
 class LibraryCreator : public QThread
 {
@@ -25,11 +30,31 @@ public:
     LibraryCreator(QSettings *settings);
     void createLibrary(const QString &source, const QString &target);
     void updateLibrary(const QString &source, const QString &target);
+    // only the entries of `changedFolders` (paths relative to the library, see LibraryChangeJournal) are compared with the DB
+    void updateLibrary(const QString &source, const QString &target, const QSet<QString> &changedFolders);
     void updateFolder(const QString &source, const QString &target, const QString &folder, const QModelIndex &dest);
     void stop(); // used to stop the process and keep the changes
     void cancel(); // cancels this run and changes in the DB are rolled back
 
 private:
+    // results of hashing and extracting a comic in a worker thread, they are consumed by the DB writer (the LibraryCreator thread)
+    struct ComicExtraction {
+        int numPages = 0;
+        QPair<int, int> originalCoverSize = { 0, 0 };
+        QByteArray xmlInfoRawData;
+    };
+    struct PrefetchedComic {
+        QString hash;
+        int coverPage = 1;
+        std::shared_future<ComicExtraction> extraction; // not valid if no extraction was needed when the comic was scheduled
+    };
+    // comics in a folder that are going to be inserted, in the same order they are going to be processed
+    struct PrefetchWindow {
+        QFileInfoList files;
+        int scheduled = 0;
+        int consumed = 0;
+    };
+
     void processLibrary(const QString &source, const QString &target);
     enum Mode { CREATOR,
                 UPDATER };
@@ -41,6 +66,8 @@ private:
     QStringList _nameFilter;
     QString _databaseConnection;
     QList<Folder> _currentPathFolders; // lista de folders en el orden en el que están siendo explorados, el último es el folder actual
+    QSet<qulonglong> _dirtyFolders; // folders with inserted or removed children, their numChildren/firstChildHash are updated at the end
+    std::unique_ptr<LibraryWriteBatch> _writeBatch; // all the inserts of a run go through it, it is flushed before the folders are updated
     // recursive method
     void create(QDir currentDirectory);
     void update(QDir currentDirectory);
@@ -48,7 +75,11 @@ private:
     qulonglong insertFolders(); // devuelve el id del último folder añadido (último en la ruta)
     bool checkCover(const QString &hash);
     void insertComic(const QString &relativePath, const QFileInfo &fileInfo);
+    void insertComic(const QString &relativePath, const QFileInfo &fileInfo, PrefetchWindow &window);
+    void prefetchComics(const QFileInfoList &files);
+    static ComicExtraction extractComic(const QString &path, const QString &coverPath, int coverPage, bool getXMLMetadata);
     void replaceComic(const QString &relativePath, const QFileInfo &fileInfo, ComicDB *comic);
+    void removeFromDB(LibraryItem *item);
     // qulonglong insertFolder(qulonglong parentId,const Folder & folder);
     // qulonglong insertComic(const Comic & comic);
     bool stopRunning;
@@ -56,10 +87,19 @@ private:
     // LibraryCreator está en modo creación si creation == true;
     bool creation;
     bool partialUpdate;
+    bool onlyChangedFolders;
+    QSet<QString> _changedFolders;
+    QSet<QString> _foldersToVisit; // changed folders and their ancestors
     QModelIndex folderDestinationModelIndex;
     QSettings *settings;
     bool checkModifiedDatesOnUpdate;
 
+    // hash and cover/xml extraction workers, the DB is only accessed from the LibraryCreator thread
+    std::unique_ptr<YACReader::ConcurrentQueue> extractionQueue;
+    int extractionWorkers;
+    QHash<QString, PrefetchedComic> _prefetched; // key: absolute file path
+    QHash<QString, PrefetchedComic> _pendingExtractions; // key: hash, used to extract duplicated files only once
+
 signals:
     void finished();
     void coverExtracted(QString);
@@ -1355,6 +1355,7 @@ void LibraryWindow::createConnections()
     connect(&comicQueryResultProcessor, &ComicQueryResultProcessor::newData, this, &LibraryWindow::setComicSearchFilterData);
     qRegisterMetaType<FolderItem *>("FolderItem *");
     qRegisterMetaType<QMap<unsigned long long int, FolderItem *> *>("QMap<unsigned long long int, FolderItem *> *");
+    qRegisterMetaType<ComicRows *>("ComicRows *");
     connect(folderQueryResultProcessor.get(), &FolderQueryResultProcessor::newData, this, &LibraryWindow::setFolderSearchFilterData);
 
     // ContextMenus
@@ -2596,7 +2597,7 @@ void LibraryWindow::setSearchFilter(QString filter)
     }
 }
 
-void LibraryWindow::setComicSearchFilterData(QList<ComicItem *> *data, const QString &databasePath)
+void LibraryWindow::setComicSearchFilterData(ComicRows *data, const QString &databasePath)
 {
     status = LibraryWindow::Searching;
 
@@ -362,7 +362,7 @@ public slots:
     void toNormal();
     void toFullScreen();
     void setSearchFilter(QString filter);
-    void setComicSearchFilterData(QList<ComicItem *> *, const QString &);
+    void setComicSearchFilterData(ComicRows *, const QString &);
     void setFolderSearchFilterData(QMap<unsigned long long int, FolderItem *> *filteredItems, FolderItem *root);
     void clearSearchFilter();
     void showProperties();
@@ -132,7 +132,9 @@ Rectangle {
                 Image {
                     id: coverElement
                     anchors.fill: parent
-                    source: cover_path
+                    source: cover_image
+                    sourceSize.width: width
+                    sourceSize.height: height
                     fillMode: Image.PreserveAspectCrop
                     smooth: true
                     mipmap: true
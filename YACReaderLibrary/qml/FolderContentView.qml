@@ -1,6 +1,7 @@
 import QtQuick 2.15
 
 import QtQuick.Controls 2.15
+import QtQuick.Window 2.15
 import QtQuick.Layouts 1.12
 
 import QtGraphicalEffects 1.0
@@ -111,7 +112,9 @@ Rectangle {
                 Image {
                     id: coverImage
                     anchors.fill: parent
-                    source: cover_path
+                    source: cover_image
+                    sourceSize.width: width
+                    sourceSize.height: height
                     fillMode: Image.PreserveAspectCrop
                     smooth: true
                     mipmap: true
@@ -305,7 +308,9 @@ Rectangle {
                                 Image {
                                     id: coverElement
                                     anchors.fill: parent
-                                    source: cover_path
+                                    source: cover_image
+                                    sourceSize.width: width
+                                    sourceSize.height: height
                                     fillMode: Image.PreserveAspectCrop
                                     smooth: true
                                     mipmap: true
@@ -392,6 +397,21 @@ Rectangle {
             currentIndex: 0
             cacheBuffer: 0
 
+            property real previousContentY: 0
+
+            onContentYChanged: prefetchCovers()
+
+            // decodes the covers of the next screen in the scroll direction before their delegates are created
+            function prefetchCovers() {
+                var columns = Math.max(1, Math.floor(width / cellWidth));
+                var screen = columns * Math.ceil(height / cellHeight);
+                var first = Math.max(0, indexAt(cellWidth / 2, contentY + cellHeight / 2));
+                var forward = contentY >= previousContentY;
+                previousContentY = contentY;
+
+                coverPrefetcher.prefetch(model, forward ? first + screen : first - screen, screen, Qt.size(coverWidth * Screen.devicePixelRatio, coverHeight * Screen.devicePixelRatio));
+            }
+
             interactive: true
 
             move: Transition {
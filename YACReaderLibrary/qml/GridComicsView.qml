@@ -1,6 +1,7 @@
 import QtQuick 2.15
 
 import QtQuick.Controls 2.15
+import QtQuick.Window 2.15
 import QtQuick.Layouts 1.12
 
 import QtGraphicalEffects 1.0
@@ -271,7 +272,9 @@ SplitView {
                     width: coverWidth
                     height: coverHeight
                     anchors {horizontalCenter: parent.horizontalCenter; top: realCell.top; topMargin: 0}
-                    source: cover_path
+                    source: cover_image
+                    sourceSize.width: width
+                    sourceSize.height: height
                     fillMode: Image.PreserveAspectCrop
                     smooth: true
                     mipmap: true
@@ -452,7 +455,9 @@ SplitView {
                             anchors.rightMargin: 15
                             horizontalAlignment: Image.AlignLeft
                             anchors {horizontalCenter: parent.horizontalCenter; top: parent.top; topMargin: 0}
-                            source: comicsList.getCoverUrlPathForComicHash(currentComicInfo.hash.toString())
+                            source: comicsList.getCoverImageUrlForComicHash(currentComicInfo.hash.toString())
+                            sourceSize.width: width
+                            sourceSize.height: height
                             fillMode: Image.PreserveAspectFit
                             smooth: true
                             mipmap: true
@@ -703,6 +708,21 @@ SplitView {
                 currentIndex: 0
                 cacheBuffer: 0
 
+                property real previousContentY: 0
+
+                onContentYChanged: prefetchCovers()
+
+                // decodes the covers of the next screen in the scroll direction before their delegates are created
+                function prefetchCovers() {
+                    var columns = Math.max(1, Math.floor(width / cellWidth));
+                    var screen = columns * Math.ceil(height / cellHeight);
+                    var first = Math.max(0, indexAt(cellWidth / 2, contentY + cellHeight / 2));
+                    var forward = contentY >= previousContentY;
+                    previousContentY = contentY;
+
+                    coverPrefetcher.prefetch(model, forward ? first + screen : first - screen, screen, Qt.size(coverWidth * Screen.devicePixelRatio, coverHeight * Screen.devicePixelRatio));
+                }
+
                 interactive: true
 
                 move: Transition {
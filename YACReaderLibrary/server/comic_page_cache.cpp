@@ -0,0 +1,200 @@
+#include "comic_page_cache.h"
+
+#include "comic.h"
+
+#include "QsLog.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+#include <limits>
+
+ComicPageCache::ComicPageCache(qint64 maxBytes, qint64 comicMemoryBudget)
+    : comicMemoryBudget(comicMemoryBudget)
+{
+    pages.setMaxCost(int(qBound<qint64>(0, maxBytes, std::numeric_limits<int>::max())));
+}
+
+ComicPageCache::~ComicPageCache()
+{
+    QMutexLocker locker(&mutex);
+    for (const auto &openComic : std::as_const(comics)) {
+        if (openComic.comic != nullptr)
+            close(openComic.comic);
+    }
+}
+
+bool ComicPageCache::acquire(const QString &hash, const QString &path)
+{
+    QMutexLocker locker(&mutex);
+
+    auto it = comics.find(hash);
+    if (it != comics.end()) {
+        it->references++;
+        return true;
+    }
+
+    Comic *comic = nullptr;
+    if (!isFullyCached(hash)) {
+        comic = open(hash, path);
+        if (comic == nullptr)
+            return false;
+    }
+
+    comics.insert(hash, OpenComic { path, comic, 1 });
+    return true;
+}
+
+void ComicPageCache::release(const QString &hash)
+{
+    QMutexLocker locker(&mutex);
+
+    auto it = comics.find(hash);
+    if (it == comics.end())
+        return;
+
+    if (--it->references > 0)
+        return;
+
+    if (it->comic != nullptr)
+        close(it->comic);
+    comics.erase(it);
+
+    prunePageCounts();
+}
+
+ComicPageCache::PageStatus ComicPageCache::page(const QString &hash, unsigned int page, QByteArray &data)
+{
+    QMutexLocker locker(&mutex);
+
+    auto it = comics.find(hash);
+    if (it == comics.end())
+        return PageStatus::NotFound;
+
+    auto cached = pages.object(PageKey(hash, page));
+    if (cached != nullptr) {
+        data = *cached;
+        return PageStatus::Ready;
+    }
+
+    if (pageCounts.contains(hash) && page >= pageCounts.value(hash))
+        return PageStatus::NotFound;
+
+    // the page has been evicted since the comic was found to be fully cached
+    if (it->comic == nullptr) {
+        it->comic = open(hash, it->path);
+        return it->comic != nullptr ? PageStatus::Loading : PageStatus::Error;
+    }
+
+    Comic *comic = it->comic;
+    if (comic->hasBeenAnErrorOpening())
+        return PageStatus::Error;
+
+    if (comic->numPages() == 0)
+        return PageStatus::Loading;
+
+    if (page >= comic->numPages())
+        return PageStatus::NotFound;
+
+    if (comic->pageIsLoaded(page)) {
+        data = comic->getRawPage(page);
+        insert(hash, page, data);
+        return PageStatus::Ready;
+    }
+
+    // moves the window of extracted pages if the comic doesn't fit in memory
+    comic->setIndex(page);
+    return PageStatus::Loading;
+}
+
+Comic *ComicPageCache::open(const QString &hash, const QString &path)
+{
+    Comic *comic = FactoryComic::newComic(path);
+    if (comic == nullptr)
+        return nullptr;
+
+    auto thread = new QThread();
+
+    comic->moveToThread(thread);
+
+    QObject::connect(comic, QOverload<>::of(&Comic::errorOpening), thread, &QThread::quit);
+    QObject::connect(comic, QOverload<QString>::of(&Comic::errorOpening), thread, &QThread::quit);
+    QObject::connect(comic, &Comic::imagesLoaded, thread, &QThread::quit);
+    QObject::connect(comic, &Comic::invalidated, thread, &QThread::quit);
+    QObject::connect(thread, &QThread::started, comic, &Comic::process);
+    QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    // called from the comic thread
+    QObject::connect(
+            comic, QOverload<unsigned int>::of(&Comic::numPages), comic, [this, hash](unsigned int numPages) {
+                QMutexLocker locker(&mutex);
+                pageCounts.insert(hash, numPages);
+            },
+            Qt::DirectConnection);
+    QObject::connect(
+            comic, QOverload<int, const QByteArray &>::of(&Comic::imageLoaded), comic, [this, hash](int page, const QByteArray &data) {
+                QMutexLocker locker(&mutex);
+                insert(hash, page, data);
+            },
+            Qt::DirectConnection);
+
+    comic->load(path);
+
+    // pages far from the ones requested by the clients are extracted again when needed
+    if (auto fileComic = qobject_cast<FileComic *>(comic))
+        fileComic->setMemoryBudget(comicMemoryBudget);
+#ifndef NO_PDF
+    if (auto pdfComic = qobject_cast<PDFComic *>(comic))
+        pdfComic->setMemoryBudget(comicMemoryBudget);
+#endif
+
+    thread->start();
+
+    QLOG_TRACE() << "comic opened for serving pages:" << path;
+
+    return comic;
+}
+
+void ComicPageCache::close(Comic *comic)
+{
+    // the comic thread may be waiting for page requests, it needs to be released before the comic is deleted
+    comic->invalidate();
+    comic->deleteLater();
+}
+
+bool ComicPageCache::isFullyCached(const QString &hash)
+{
+    if (!pageCounts.contains(hash))
+        return false;
+
+    unsigned int count = pageCounts.value(hash);
+    for (unsigned int page = 0; page < count; page++) {
+        if (!pages.contains(PageKey(hash, page)))
+            return false;
+    }
+
+    return count > 0;
+}
+
+// the mutex must be locked
+// the count of a closed comic is only useful while all its pages are cached, otherwise it has to be opened again anyway,
+// so the counts kept are bounded by the open comics and the pages that fit in the cache
+void ComicPageCache::prunePageCounts()
+{
+    for (auto it = pageCounts.begin(); it != pageCounts.end();) {
+        if (!comics.contains(it.key()) && !isFullyCached(it.key()))
+            it = pageCounts.erase(it);
+        else
+            ++it;
+    }
+}
+
+// the mutex must be locked
+void ComicPageCache::insert(const QString &hash, unsigned int page, const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+
+    // the data is shared with the comic while it is open, it doesn't use more memory until the comic releases the page
+    pages.insert(PageKey(hash, page), new QByteArray(data), data.size());
+}
@@ -0,0 +1,62 @@
+#ifndef COMIC_PAGE_CACHE_H
+#define COMIC_PAGE_CACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+
+class Comic;
+
+// Pages of the comics read by the clients, shared by all the sessions.
+//
+// Comics are opened once no matter how many sessions are reading them, sessions acquire and
+// release them by hash and the comic is closed when nobody is using it. The extracted pages are
+// kept in a byte-budgeted LRU keyed by (comic hash, page) that outlives the comics, so a comic that
+// is opened again is served from memory while its pages are still cached.
+class ComicPageCache
+{
+public:
+    enum class PageStatus {
+        Ready,
+        Loading, // the comic is being opened or the page hasn't been extracted yet
+        Error, // the comic can't be opened
+        NotFound
+    };
+
+    // maxBytes is the memory used by the pages cache, comicMemoryBudget is the memory budget of each open comic (see FileComic::setMemoryBudget)
+    ComicPageCache(qint64 maxBytes, qint64 comicMemoryBudget);
+    ~ComicPageCache();
+
+    // each successful call must be paired with a call to release
+    bool acquire(const QString &hash, const QString &path);
+    void release(const QString &hash);
+
+    PageStatus page(const QString &hash, unsigned int page, QByteArray &data);
+
+private:
+    using PageKey = QPair<QString, unsigned int>;
+    struct OpenComic {
+        QString path;
+        // it is null while all the pages are in the cache
+        Comic *comic;
+        int references;
+    };
+
+    Comic *open(const QString &hash, const QString &path);
+    void close(Comic *comic);
+    bool isFullyCached(const QString &hash);
+    void prunePageCounts();
+    void insert(const QString &hash, unsigned int page, const QByteArray &data);
+
+    qint64 comicMemoryBudget;
+    QHash<QString, OpenComic> comics;
+    QCache<PageKey, QByteArray> pages;
+    // number of pages of the open comics and the fully cached ones, needed for knowing if a comic is fully cached
+    QHash<QString, unsigned int> pageCounts;
+    QMutex mutex;
+};
+
+#endif // COMIC_PAGE_CACHE_H
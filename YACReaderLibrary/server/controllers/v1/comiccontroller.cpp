@@ -52,33 +52,15 @@ void ComicController::service(HttpRequest &request, HttpResponse &response)
     if (!remoteComic)
         ySession->setDownloadedComic(comic.info.hash);
 
-    Comic *comicFile = FactoryComic::newComic(libraries.getPath(libraryId) + comic.path);
-
-    if (comicFile != nullptr) {
-        QThread *thread = nullptr;
-
-        thread = new QThread();
-
-        comicFile->moveToThread(thread);
-
-        connect(comicFile, QOverload<>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, QOverload<QString>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, &Comic::imagesLoaded, thread, &QThread::quit);
-        connect(thread, &QThread::started, comicFile, &Comic::process);
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-
-        comicFile->load(libraries.getPath(libraryId) + comic.path);
-
-        if (thread != nullptr)
-            thread->start();
-
+    // the comic is shared with the other sessions reading it
+    if (Static::comicPageCache->acquire(comic.info.hash, libraries.getPath(libraryId) + comic.path)) {
         if (remoteComic) {
             QLOG_TRACE() << "remote comic requested";
-            ySession->setCurrentRemoteComic(comic.id, comicFile);
+            ySession->setCurrentRemoteComic(comic.id, comic.info.hash);
 
         } else {
             QLOG_TRACE() << "comic requested";
-            ySession->setCurrentComic(comic.id, comicFile);
+            ySession->setCurrentComic(comic.id, comic.info.hash);
         }
 
         response.setHeader("Content-Type", "text/plain; charset=utf-8");
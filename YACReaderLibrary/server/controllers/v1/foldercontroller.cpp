@@ -72,7 +72,7 @@ void FolderController::service(HttpRequest &request, HttpResponse &response)
 
     folderContent.append(folderComics);
 
-    std::sort(folderContent.begin(), folderContent.end(), LibraryItemSorter());
+    sortLibraryItems(folderContent);
     folderComics.clear();
 
     // qulonglong backId = DBHelper::getParentFromComicFolderId(libraryName,folderId);
@@ -254,7 +254,7 @@ void FolderController::service(HttpRequest &request, HttpResponse &response)
         if (index.length() > 1) {
             t.setCondition("alphaIndex", true);
 
-            std::sort(index.begin(), index.end(), naturalSortLessThanCI);
+            naturalSort(index);
             t.loop("index", index.length());
             int i = 0;
             int count = 0;
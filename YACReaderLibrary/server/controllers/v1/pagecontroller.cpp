@@ -7,7 +7,6 @@
 #include "yacreader_http_session.h"
 
 #include <QDataStream>
-#include <QPointer>
 
 #include <QsLog.h>
 
@@ -34,41 +33,34 @@ void PageController::service(HttpRequest &request, HttpResponse &response)
 
     // qDebug("lib name : %s",pathElements.at(2).data());
 
-    Comic *comicFile;
+    QString comicHash;
     qulonglong currentComicId;
     if (remote) {
         QLOG_TRACE() << "se recupera comic remoto para servir páginas";
-        comicFile = ySession->getCurrentRemoteComic();
+        comicHash = ySession->getCurrentRemoteComicHash();
         currentComicId = ySession->getCurrentRemoteComicId();
     } else {
         QLOG_TRACE() << "se recupera comic para servir páginas";
-        comicFile = ySession->getCurrentComic();
+        comicHash = ySession->getCurrentComicHash();
         currentComicId = ySession->getCurrentComicId();
     }
 
-    if (currentComicId != 0 && !QPointer<Comic>(comicFile).isNull()) {
-        if (comicId == currentComicId && page < comicFile->numPages()) {
-            if (comicFile->pageIsLoaded(page)) {
-                // qDebug("PageController: La página estaba cargada -> %s ",path.data());
-                response.setHeader("Content-Type", "image/jpeg");
-                response.setHeader("Transfer-Encoding", "chunked");
-                QByteArray pageData = comicFile->getRawPage(page);
-                QDataStream data(pageData);
-                char buffer[4096];
-                while (!data.atEnd()) {
-                    int len = data.readRawData(buffer, 4096);
-                    response.write(QByteArray(buffer, len));
-                }
-                // response.write(pageData,true);
-                response.write(QByteArray(), true);
-            } else {
-                // qDebug("PageController: La página NO estaba cargada 404 -> %s ",path.data());
-                response.setStatus(404, "not found"); // TODO qué mensaje enviar
-                response.write("404 not found", true);
+    if (currentComicId != 0 && !comicHash.isNull()) {
+        QByteArray pageData;
+        if (comicId == currentComicId && Static::comicPageCache->page(comicHash, page, pageData) == ComicPageCache::PageStatus::Ready) {
+            // qDebug("PageController: La página estaba cargada -> %s ",path.data());
+            response.setHeader("Content-Type", "image/jpeg");
+            response.setHeader("Transfer-Encoding", "chunked");
+            QDataStream data(pageData);
+            char buffer[4096];
+            while (!data.atEnd()) {
+                int len = data.readRawData(buffer, 4096);
+                response.write(QByteArray(buffer, len));
             }
+            // response.write(pageData,true);
+            response.write(QByteArray(), true);
         } else {
             if (comicId != currentComicId) {
-                // delete comicFile;
                 if (remote)
                     ySession->dismissCurrentRemoteComic();
                 else
@@ -11,6 +11,7 @@
 #include "comic.h"
 
 #include "qnaturalsorting.h"
+#include "yacreader_global.h"
 
 #include "QsLog.h"
 
@@ -57,33 +58,15 @@ void ComicControllerV2::service(HttpRequest &request, HttpResponse &response)
 
     ComicDB comic = DBHelper::getComicInfo(libraryId, comicId);
 
-    Comic *comicFile = FactoryComic::newComic(libraries.getPath(libraryId) + comic.path);
-
-    if (comicFile != nullptr) {
-        QThread *thread = nullptr;
-
-        thread = new QThread();
-
-        comicFile->moveToThread(thread);
-
-        connect(comicFile, QOverload<>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, QOverload<QString>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, &Comic::imagesLoaded, thread, &QThread::quit);
-        connect(thread, &QThread::started, comicFile, &Comic::process);
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-
-        comicFile->load(libraries.getPath(libraryId) + comic.path);
-
-        if (thread != nullptr)
-            thread->start();
-
+    // the comic is shared with the other sessions reading it
+    if (Static::comicPageCache->acquire(comic.info.hash, libraries.getPath(libraryId) + comic.path)) {
         if (remoteComic) {
             QLOG_TRACE() << "remote comic requested";
-            ySession->setCurrentRemoteComic(comic.id, comicFile);
+            ySession->setCurrentRemoteComic(comic.id, comic.info.hash);
 
         } else {
             QLOG_TRACE() << "comic requested";
-            ySession->setCurrentComic(comic.id, comicFile);
+            ySession->setCurrentComic(comic.id, comic.info.hash);
         }
 
         response.setHeader("Content-Type", "text/plain; charset=utf-8");
@@ -94,7 +77,7 @@ void ComicControllerV2::service(HttpRequest &request, HttpResponse &response)
         {
             QList<LibraryItem *> siblings = DBHelper::getFolderComicsFromLibrary(libraryId, comic.parentId, false);
 
-            std::sort(siblings.begin(), siblings.end(), LibraryItemSorter());
+            sortLibraryItems(siblings);
 
             bool found = false;
             int i;
@@ -11,6 +11,7 @@
 #include "comic.h"
 
 #include "qnaturalsorting.h"
+#include "yacreader_global.h"
 
 #include "QsLog.h"
 
@@ -44,28 +45,10 @@ void ComicControllerInReadingListV2::service(HttpRequest &request, HttpResponse
 
     ComicDB comic = DBHelper::getComicInfo(libraryId, comicId);
 
-    Comic *comicFile = FactoryComic::newComic(libraries.getPath(libraryId) + comic.path);
-
-    if (comicFile != nullptr) {
-        QThread *thread = nullptr;
-
-        thread = new QThread();
-
-        comicFile->moveToThread(thread);
-
-        connect(comicFile, QOverload<>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, QOverload<QString>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, &Comic::imagesLoaded, thread, &QThread::quit);
-        connect(thread, &QThread::started, comicFile, &Comic::process);
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-
-        comicFile->load(libraries.getPath(libraryId) + comic.path);
-
-        if (thread != nullptr)
-            thread->start();
-
+    // the comic is shared with the other sessions reading it
+    if (Static::comicPageCache->acquire(comic.info.hash, libraries.getPath(libraryId) + comic.path)) {
         QLOG_TRACE() << "remote comic requested";
-        ySession->setCurrentRemoteComic(comic.id, comicFile);
+        ySession->setCurrentRemoteComic(comic.id, comic.info.hash);
 
         response.setHeader("Content-Type", "text/plain; charset=utf-8");
         // TODO this field is not used by the client!
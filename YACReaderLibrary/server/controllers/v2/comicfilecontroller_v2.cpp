@@ -0,0 +1,36 @@
+#include "comicfilecontroller_v2.h"
+
+#include "db_helper.h"
+#include "yacreader_libraries.h"
+#include "http_content_helper.h"
+
+#include "comic_db.h"
+
+#include <QUrl>
+
+using stefanfrings::HttpRequest;
+using stefanfrings::HttpResponse;
+
+ComicFileControllerV2::ComicFileControllerV2() { }
+
+void ComicFileControllerV2::service(HttpRequest &request, HttpResponse &response)
+{
+    QString path = QUrl::fromPercentEncoding(request.getPath()).toUtf8();
+    QStringList pathElements = path.split('/');
+
+    qulonglong libraryId = pathElements.at(3).toLongLong();
+    qulonglong comicId = pathElements.at(5).toULongLong();
+
+    ComicDB comic = DBHelper::getComicInfo(libraryId, comicId);
+    if (comic.info.hash.isEmpty()) {
+        response.setStatus(404, "not found");
+        response.write("404 not found", true);
+        return;
+    }
+
+    response.setHeader("Content-Type", "application/octet-stream");
+    response.setHeader("Content-Disposition", "attachment; filename=\"" + comic.getFileName().replace('"', '_').toUtf8() + "\"");
+
+    // the hash changes if the file is replaced, a download can't be resumed with a different file
+    HttpContentHelper::sendFile(request, response, DBHelper::getLibraries().getPath(libraryId) + comic.path, HttpContentHelper::strongETag(comic.info.hash.toLatin1()));
+}
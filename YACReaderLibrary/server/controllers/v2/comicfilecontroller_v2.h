@@ -0,0 +1,21 @@
+#ifndef COMICFILECONTROLLER_V2_H
+#define COMICFILECONTROLLER_V2_H
+
+#include "httprequest.h"
+#include "httpresponse.h"
+#include "httprequesthandler.h"
+
+// Sends the file of a comic, supports byte ranges so clients can resume interrupted downloads
+class ComicFileControllerV2 : public stefanfrings::HttpRequestHandler
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(ComicFileControllerV2)
+public:
+    /** Constructor **/
+    ComicFileControllerV2();
+
+    /** Generates the response */
+    void service(stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response) override;
+};
+
+#endif // COMICFILECONTROLLER_V2_H
@@ -6,31 +6,73 @@
 #include "template.h"
 #include "../static.h"
 
+#include <QLocale>
+
 using stefanfrings::HttpRequest;
 using stefanfrings::HttpResponse;
 
+namespace {
+const char *httpDateFormat = "ddd, dd MMM yyyy hh:mm:ss 'GMT'";
+// covers keep their names when they are regenerated, clients revalidate them after this time
+const int coversMaxAge = 3600;
+
+QByteArray toHttpDate(const QDateTime &dateTime)
+{
+    return QLocale::c().toString(dateTime.toUTC(), httpDateFormat).toLatin1();
+}
+
+bool isNotModified(const HttpRequest &request, const CoverCache::Cover &cover)
+{
+    auto ifNoneMatch = request.getHeader("If-None-Match");
+    if (!ifNoneMatch.isEmpty()) {
+        for (const auto &etag : ifNoneMatch.split(',')) {
+            auto trimmed = etag.trimmed();
+            if (trimmed == "*" || trimmed == cover.etag || trimmed == "W/" + cover.etag)
+                return true;
+        }
+        return false; // If-Modified-Since is ignored when If-None-Match is present
+    }
+
+    auto ifModifiedSince = request.getHeader("If-Modified-Since");
+    if (!ifModifiedSince.isEmpty()) {
+        auto since = QLocale::c().toDateTime(QString::fromLatin1(ifModifiedSince), httpDateFormat);
+        since.setTimeSpec(Qt::UTC);
+        return since.isValid() && cover.lastModified.toSecsSinceEpoch() <= since.toSecsSinceEpoch();
+    }
+
+    return false;
+}
+}
+
 CoverControllerV2::CoverControllerV2() { }
 
 void CoverControllerV2::service(HttpRequest &request, HttpResponse &response)
 {
-    response.setHeader("Content-Type", "image/jpeg");
-
     YACReaderLibraries libraries = DBHelper::getLibraries();
 
     QString path = QUrl::fromPercentEncoding(request.getPath()).toUtf8();
     QStringList pathElements = path.split('/');
     QString libraryName = DBHelper::getLibraryName(pathElements.at(3).toInt());
     QString fileName = pathElements.at(5);
+    int width = request.getParameter("w").toInt();
 
-    QImage img(libraries.getPath(libraryName) + "/.yacreaderlibrary/covers/" + fileName);
-    if (!img.isNull()) {
-        QByteArray ba;
-        QBuffer buffer(&ba);
-        buffer.open(QIODevice::WriteOnly);
-        img.save(&buffer, "JPG");
-        response.write(ba, true);
-    } else {
+    auto cover = Static::coverCache->cover(libraries.getPath(libraryName) + "/.yacreaderlibrary/covers", fileName, width);
+    if (cover.isNull()) {
         response.setStatus(404, "not found");
         response.write("404 not found", true);
+        return;
     }
+
+    response.setHeader("ETag", cover.etag);
+    response.setHeader("Last-Modified", toHttpDate(cover.lastModified));
+    response.setHeader("Cache-Control", "max-age=" + QByteArray::number(coversMaxAge));
+
+    if (isNotModified(request, cover)) {
+        response.setStatus(304, "Not Modified");
+        response.write(QByteArray(), true);
+        return;
+    }
+
+    response.setHeader("Content-Type", "image/jpeg");
+    response.write(cover.data, true);
 }
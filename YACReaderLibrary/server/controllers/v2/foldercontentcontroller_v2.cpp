@@ -1,10 +1,15 @@
 #include "foldercontentcontroller_v2.h"
 
 #include <QUrl>
+#include <QSqlDatabase>
+#include <QSqlQuery>
 
+#include "data_base_management.h"
+#include "library_queries.h"
 #include "db_helper.h"
 #include "comic_db.h"
 #include "folder.h"
+#include "yacreader_libraries.h"
 
 #include "yacreader_server_data_helper.h"
 
@@ -19,6 +24,17 @@ using stefanfrings::HttpRequest;
 using stefanfrings::HttpResponse;
 using namespace std;
 
+namespace {
+// max number of ids used in each `IN (...)` query
+const int fetchSize = 500;
+
+struct ItemKey {
+    bool isFolder;
+    qulonglong id;
+    QString name;
+};
+}
+
 FolderContentControllerV2::FolderContentControllerV2() { }
 
 void FolderContentControllerV2::service(HttpRequest &request, HttpResponse &response)
@@ -30,48 +46,102 @@ void FolderContentControllerV2::service(HttpRequest &request, HttpResponse &resp
     int libraryId = pathElements.at(3).toInt();
     qulonglong parentId = pathElements.at(5).toULongLong();
 
-    serviceContent(libraryId, parentId, response);
+    serviceContent(libraryId, parentId, JsonListWriter::Options::fromRequest(request), response);
 
-    response.setStatus(200, "OK");
     response.write("", true);
 }
 
-void FolderContentControllerV2::serviceContent(const int &library, const qulonglong &folderId, HttpResponse &response)
+// the items are sorted using only their names, then the full rows are read only for the items in the requested page
+void FolderContentControllerV2::serviceContent(const int &library, const qulonglong &folderId, const JsonListWriter::Options &options, HttpResponse &response)
 {
 #ifdef QT_DEBUG
     auto started = std::chrono::high_resolution_clock::now();
 #endif
-    QList<LibraryItem *> folderContent = DBHelper::getFolderSubfoldersFromLibrary(library, folderId);
-    QList<LibraryItem *> folderComics = DBHelper::getFolderComicsFromLibrary(library, folderId);
+    QString libraryDBPath = DBHelper::getLibraries().getDBPath(library);
+    QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryDBPath);
+
+    QList<ItemKey> items;
+    {
+        QSqlQuery foldersQuery(db);
+        foldersQuery.setForwardOnly(true);
+        foldersQuery.prepare(FOLDER_CONTENT_SUBFOLDERS_QUERY);
+        foldersQuery.bindValue(":parentId", folderId);
+        foldersQuery.exec();
+        while (foldersQuery.next()) {
+            items.append({ true, foldersQuery.value(0).toULongLong(), foldersQuery.value(1).toString() });
+        }
 
-    folderContent.append(folderComics);
-    std::sort(folderContent.begin(), folderContent.end(), LibraryItemSorter());
+        QSqlQuery comicsQuery(db);
+        comicsQuery.setForwardOnly(true);
+        comicsQuery.prepare(FOLDER_CONTENT_COMICS_QUERY);
+        comicsQuery.bindValue(":parentId", folderId);
+        comicsQuery.exec();
+        while (comicsQuery.next()) {
+            items.append({ false, comicsQuery.value(0).toULongLong(), comicsQuery.value(1).toString() });
+        }
+    }
 
-    folderComics.clear();
+    // same order as sortLibraryItems
+    naturalSort(items, [](const ItemKey &item) { return item.name; });
 
-    QJsonArray items;
+    QStringList keys;
+    keys.reserve(items.size());
+    for (const auto &item : std::as_const(items)) {
+        keys.append((item.isFolder ? "f" : "c") + QString::number(item.id));
+    }
 
-    ComicDB *currentComic;
-    Folder *currentFolder;
-    for (QList<LibraryItem *>::const_iterator itr = folderContent.constBegin(); itr != folderContent.constEnd(); itr++) {
-        if ((*itr)->isDir()) {
-            currentFolder = (Folder *)(*itr);
-            items.append(YACReaderServerDataHelper::folderToJSON(library, *currentFolder));
-        } else {
-            currentComic = (ComicDB *)(*itr);
-            items.append(YACReaderServerDataHelper::comicToJSON(library, *currentComic));
-        }
+    JsonListWriter writer(response, options);
+
+    int begin, end;
+    QString nextCursor;
+    if (!writer.page(keys, begin, end, nextCursor)) {
+        response.setStatus(400, "invalid cursor");
+        return;
     }
 
-    qDeleteAll(folderContent);
+    response.setStatus(200, "OK");
+
+    for (int chunk = begin; chunk < end; chunk += fetchSize) {
+        auto chunkEnd = qMin(end, chunk + fetchSize);
+
+        QList<qulonglong> folderIds, comicIds;
+        for (int i = chunk; i < chunkEnd; i++) {
+            (items.at(i).isFolder ? folderIds : comicIds).append(items.at(i).id);
+        }
+
+        QHash<qulonglong, Folder> folders;
+        const auto folderRows = DBHelper::getFolders(folderIds, db);
+        for (const auto &folder : folderRows) {
+            folders.insert(folder.id, folder);
+        }
+
+        QHash<qulonglong, ComicDB> comics;
+        const auto comicRows = DBHelper::getComics(comicIds, db);
+        for (const auto &comic : comicRows) {
+            comics.insert(comic.id, comic);
+        }
 
-    QJsonDocument output(items);
+        for (int i = chunk; i < chunkEnd; i++) {
+            const auto &item = items.at(i);
+            if (item.isFolder) {
+                auto folder = folders.constFind(item.id);
+                if (folder != folders.constEnd()) {
+                    writer.append(YACReaderServerDataHelper::folderToJSON(library, folder.value()));
+                }
+            } else {
+                auto comic = comics.constFind(item.id);
+                if (comic != comics.constEnd()) {
+                    writer.append(YACReaderServerDataHelper::comicToJSON(library, comic.value()));
+                }
+            }
+        }
+    }
 
-    response.write(output.toJson(QJsonDocument::Compact));
+    writer.finish(nextCursor);
 #ifdef QT_DEBUG
     auto done = std::chrono::high_resolution_clock::now();
 
-    QLOG_TRACE() << "num items = " << items.count();
+    QLOG_TRACE() << "num items = " << end - begin;
     QLOG_TRACE() << std::chrono::duration_cast<std::chrono::milliseconds>(done - started).count();
 #endif
 }
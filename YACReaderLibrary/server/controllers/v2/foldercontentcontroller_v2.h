@@ -5,6 +5,8 @@
 #include "httpresponse.h"
 #include "httprequesthandler.h"
 
+#include "json_list_writer.h"
+
 class FolderContentControllerV2 : public stefanfrings::HttpRequestHandler
 {
     Q_OBJECT
@@ -17,7 +19,7 @@ public:
     void service(stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response) override;
 
 private:
-    void serviceContent(const int &library, const qulonglong &folderId, stefanfrings::HttpResponse &response);
+    void serviceContent(const int &library, const qulonglong &folderId, const JsonListWriter::Options &options, stefanfrings::HttpResponse &response);
 };
 
 #endif // FOLDERCONTENTCONTROLLER_H
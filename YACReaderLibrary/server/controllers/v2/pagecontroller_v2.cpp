@@ -5,9 +5,7 @@
 #include "comic.h"
 #include "comiccontroller.h"
 #include "yacreader_http_session.h"
-
-#include <QDataStream>
-#include <QPointer>
+#include "http_content_helper.h"
 
 #include <QsLog.h>
 
@@ -34,26 +32,25 @@ void PageControllerV2::service(HttpRequest &request, HttpResponse &response)
     qulonglong comicId = pathElements.at(5).toULongLong();
     unsigned int page = pathElements.at(7).toUInt();
 
-    Comic *comicFile;
+    QString comicHash;
     qulonglong currentComicId;
     if (remote) {
         QLOG_TRACE() << "se recupera comic remoto para servir páginas";
-        comicFile = ySession->getCurrentRemoteComic();
+        comicHash = ySession->getCurrentRemoteComicHash();
         currentComicId = ySession->getCurrentRemoteComicId();
     } else {
         QLOG_TRACE() << "se recupera comic para servir páginas";
-        comicFile = ySession->getCurrentComic();
+        comicHash = ySession->getCurrentComicHash();
         currentComicId = ySession->getCurrentComicId();
     }
 
-    if (comicFile == nullptr) {
+    if (currentComicId == 0 || comicHash.isNull()) {
         response.setStatus(404, "not found");
         response.write("404 not found", true);
         return;
     }
 
-    if (comicFile->hasBeenAnErrorOpening()) {
-        // delete comicFile;
+    if (comicId != currentComicId) {
         if (remote)
             ySession->dismissCurrentRemoteComic();
         else
@@ -64,41 +61,34 @@ void PageControllerV2::service(HttpRequest &request, HttpResponse &response)
         return;
     }
 
-    if (currentComicId != 0 && !QPointer<Comic>(comicFile).isNull()) {
-        if (comicFile->numPages() == 0) {
-            response.setStatus(412, "opening file");
-            response.write("412 opening file", true);
-        } else {
-            if (comicId == currentComicId && page < comicFile->numPages()) {
-                if (comicFile->pageIsLoaded(page)) {
-                    response.setHeader("Content-Type", "image/jpeg");
-                    response.setHeader("Transfer-Encoding", "chunked");
-                    QByteArray pageData = comicFile->getRawPage(page);
-                    QDataStream data(pageData);
-                    std::vector<char> buffer(100000);
-                    while (!data.atEnd()) {
-                        int len = data.readRawData(&buffer[0], buffer.size());
-                        response.write(QByteArray(&buffer[0], len));
-                    }
-                    response.write(QByteArray(), true);
-                } else {
-                    response.setStatus(412, "loading page");
-                    response.write("412 loading page", true);
-                }
-            } else {
-                if (comicId != currentComicId) {
-                    // delete comicFile;
-                    if (remote)
-                        ySession->dismissCurrentRemoteComic();
-                    else
-                        ySession->dismissCurrentComic();
-                }
-                response.setStatus(404, "not found");
-                response.write("404 not found", true);
-            }
-        }
-    } else {
+    // the hash identifies the content of the comic, so a page never changes and clients can revalidate it without loading it
+    auto etag = HttpContentHelper::strongETag(comicHash.toLatin1() + "-" + QByteArray::number(page));
+    if (HttpContentHelper::isNotModified(request, etag)) {
+        response.setHeader("ETag", etag);
+        response.setStatus(304, "Not Modified");
+        response.write(QByteArray(), true);
+        return;
+    }
+
+    QByteArray pageData;
+    switch (Static::comicPageCache->page(comicHash, page, pageData)) {
+    case ComicPageCache::PageStatus::Ready:
+        response.setHeader("Content-Type", "image/jpeg");
+        HttpContentHelper::sendData(request, response, pageData, etag);
+        break;
+    case ComicPageCache::PageStatus::Loading:
+        response.setStatus(412, "loading page");
+        response.write("412 loading page", true);
+        break;
+    case ComicPageCache::PageStatus::Error:
+        if (remote)
+            ySession->dismissCurrentRemoteComic();
+        else
+            ySession->dismissCurrentComic();
+        [[fallthrough]];
+    case ComicPageCache::PageStatus::NotFound:
         response.setStatus(404, "not found");
         response.write("404 not found", true);
+        break;
     }
 }
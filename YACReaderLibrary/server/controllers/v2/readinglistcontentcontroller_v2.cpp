@@ -1,13 +1,24 @@
 #include "readinglistcontentcontroller_v2.h"
 
+#include "data_base_management.h"
+#include "library_queries.h"
 #include "db_helper.h"
 #include "comic_db.h"
+#include "yacreader_libraries.h"
 
 #include "yacreader_server_data_helper.h"
 
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
 using stefanfrings::HttpRequest;
 using stefanfrings::HttpResponse;
 
+namespace {
+// max number of ids used in each `IN (...)` query
+const int fetchSize = 500;
+}
+
 ReadingListContentControllerV2::ReadingListContentControllerV2()
 {
 }
@@ -21,22 +32,58 @@ void ReadingListContentControllerV2::service(HttpRequest &request, HttpResponse
     int libraryId = pathElements.at(3).toInt();
     qulonglong readingListId = pathElements.at(5).toULongLong();
 
-    serviceContent(libraryId, readingListId, response);
+    serviceContent(libraryId, readingListId, JsonListWriter::Options::fromRequest(request), response);
 
     response.write("", true);
 }
 
-void ReadingListContentControllerV2::serviceContent(const int &library, const qulonglong &readingListId, HttpResponse &response)
+// same content as DBHelper::getReadingListFullContent, the comics of the list followed by the comics of its sublists
+void ReadingListContentControllerV2::serviceContent(const int &library, const qulonglong &readingListId, const JsonListWriter::Options &options, HttpResponse &response)
 {
-    QList<ComicDB> comics = DBHelper::getReadingListFullContent(library, readingListId);
+    QString libraryDBPath = DBHelper::getLibraries().getDBPath(library);
+    QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryDBPath);
+
+    QList<qulonglong> ids;
+    QStringList keys; // a comic can be in more than one of the lists, so the list id is part of the key
+    {
+        QList<qulonglong> lists;
+        lists << readingListId;
 
-    QJsonArray items;
+        QSqlQuery sublists(db);
+        sublists.prepare(READING_LIST_SUBLISTS_QUERY);
+        sublists.bindValue(":parentId", readingListId);
+        sublists.exec();
+        while (sublists.next())
+            lists << sublists.value(0).toULongLong();
 
-    for (const ComicDB &comic : comics) {
-        items.append(YACReaderServerDataHelper::comicToJSON(library, comic));
+        QSqlQuery selectQuery(db);
+        selectQuery.setForwardOnly(true);
+        selectQuery.prepare(READING_LIST_CONTENT_QUERY);
+        for (auto list : std::as_const(lists)) {
+            selectQuery.bindValue(":readingListId", list);
+            selectQuery.exec();
+            while (selectQuery.next()) {
+                ids.append(selectQuery.value(0).toULongLong());
+                keys.append(QString::number(list) + "-" + QString::number(ids.last()));
+            }
+        }
     }
 
-    QJsonDocument output(items);
+    JsonListWriter writer(response, options);
+
+    int begin, end;
+    QString nextCursor;
+    if (!writer.page(keys, begin, end, nextCursor)) {
+        response.setStatus(400, "invalid cursor");
+        return;
+    }
+
+    for (int chunk = begin; chunk < end; chunk += fetchSize) {
+        const auto comics = DBHelper::getComics(ids.mid(chunk, qMin(end, chunk + fetchSize) - chunk), db);
+        for (const ComicDB &comic : comics) {
+            writer.append(YACReaderServerDataHelper::comicToJSON(library, comic));
+        }
+    }
 
-    response.write(output.toJson(QJsonDocument::Compact));
+    writer.finish(nextCursor);
 }
@@ -5,6 +5,8 @@
 #include "httpresponse.h"
 #include "httprequesthandler.h"
 
+#include "json_list_writer.h"
+
 class ReadingListContentControllerV2 : public stefanfrings::HttpRequestHandler
 {
     Q_OBJECT
@@ -15,7 +17,7 @@ public:
     void service(stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response) override;
 
 private:
-    void serviceContent(const int &library, const qulonglong &readingListId, stefanfrings::HttpResponse &response);
+    void serviceContent(const int &library, const qulonglong &readingListId, const JsonListWriter::Options &options, stefanfrings::HttpResponse &response);
 };
 
 #endif // READINGLISTCONTENTCONTROLLER_H
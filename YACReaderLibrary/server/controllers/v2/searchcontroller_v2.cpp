@@ -5,8 +5,8 @@
 #include "db_helper.h"
 #include "yacreader_libraries.h"
 #include "search_query.h"
+#include "search_request.h"
 
-#include <QJsonDocument>
 #include <QSqlDatabase>
 #include <QUrl>
 
@@ -20,48 +20,46 @@ void SearchController::service(stefanfrings::HttpRequest &request, stefanfrings:
     QStringList pathElements = path.split('/');
     int libraryId = pathElements.at(3).toInt();
 
-    auto body = request.getBody();
-    QJsonDocument json = QJsonDocument::fromJson(body);
-    auto query = json["query"].toString();
+    auto search = SearchRequest::fromJson(request.getBody());
 
     response.setStatus(200, "OK");
-    serviceSearch(libraryId, query, response);
+    serviceSearch(libraryId, search.query, search.limit, search.offset, search.options, response);
+    response.write("", true);
 }
 
-void SearchController::serviceSearch(int libraryId, const QString &query, stefanfrings::HttpResponse &response)
+void SearchController::serviceSearch(int libraryId, const QString &query, int limit, int offset, const JsonListWriter::Options &options, stefanfrings::HttpResponse &response)
 {
-    QJsonArray results;
+    JsonListWriter writer(response, options);
+    QString nextCursor;
 
     // TODO replace + "/yacreaderlibrary" concatenations with getDBPath
     QString libraryDBPath = DBHelper::getLibraries().getDBPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryDBPath);
+        QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryDBPath);
 
         // folders
-        try {
-            auto sqlQuery = foldersSearchQuery(db, query);
-            getFolders(libraryId, sqlQuery, results);
-        } catch (const std::exception &e) {
+        if (offset == 0) {
+            try {
+                auto sqlQuery = foldersSearchQuery(db, query);
+                getFolders(libraryId, sqlQuery, writer);
+            } catch (const std::exception &e) {
+            }
         }
 
         // comics
         try {
-            auto sqlQuery = comicsSearchQuery(db, query);
-            getComics(libraryId, sqlQuery, results);
+            auto sqlQuery = comicsSearchQuery(db, query, limit, offset);
+            if (getComics(libraryId, sqlQuery, writer) == limit) {
+                nextCursor = QString::number(offset + limit);
+            }
         } catch (const std::exception &e) {
         }
-
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
-
-    QJsonDocument output(results);
 
-    response.write(output.toJson(QJsonDocument::Compact));
+    writer.finish(nextCursor);
 }
 
-void SearchController::getFolders(int libraryId, QSqlQuery &sqlQuery, QJsonArray &items)
+void SearchController::getFolders(int libraryId, QSqlQuery &sqlQuery, JsonListWriter &writer)
 {
     while (sqlQuery.next()) {
         QJsonObject folder;
@@ -80,12 +78,13 @@ void SearchController::getFolders(int libraryId, QSqlQuery &sqlQuery, QJsonArray
         folder["added"] = sqlQuery.value("added").toLongLong();
         folder["updated"] = sqlQuery.value("updated").toLongLong();
 
-        items.append(folder);
+        writer.append(folder);
     }
 }
 
-void SearchController::getComics(int libraryId, QSqlQuery &sqlQuery, QJsonArray &items)
+int SearchController::getComics(int libraryId, QSqlQuery &sqlQuery, JsonListWriter &writer)
 {
+    int count = 0;
     while (sqlQuery.next()) {
         QJsonObject json;
 
@@ -108,6 +107,8 @@ void SearchController::getComics(int libraryId, QSqlQuery &sqlQuery, QJsonArray
         json["manga"] = type == YACReader::FileType::Manga; // legacy, kept for compatibility with old clients
         json["file_type"] = typeVariant.toInt(); // 9.13
 
-        items.append(json);
+        writer.append(json);
+        count++;
     }
+    return count;
 }
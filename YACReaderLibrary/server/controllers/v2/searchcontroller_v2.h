@@ -8,6 +8,8 @@
 
 #include <QSqlQuery>
 
+#include "json_list_writer.h"
+
 class SearchController : public stefanfrings::HttpRequestHandler
 {
     Q_OBJECT
@@ -18,9 +20,10 @@ public:
     void service(stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response) override;
 
 private:
-    void serviceSearch(int libraryId, const QString &query, stefanfrings::HttpResponse &response);
-    void getFolders(int libraryId, QSqlQuery &sqlQuery, QJsonArray &items);
-    void getComics(int libraryId, QSqlQuery &sqlQuery, QJsonArray &items);
+    void serviceSearch(int libraryId, const QString &query, int limit, int offset, const JsonListWriter::Options &options, stefanfrings::HttpResponse &response);
+    void getFolders(int libraryId, QSqlQuery &sqlQuery, JsonListWriter &writer);
+    // returns the number of comics written
+    int getComics(int libraryId, QSqlQuery &sqlQuery, JsonListWriter &writer);
 };
 
 #endif // SEARCHCONTROLLER_H
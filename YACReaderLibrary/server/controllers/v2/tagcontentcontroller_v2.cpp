@@ -1,15 +1,25 @@
 #include "tagcontentcontroller_v2.h"
 
+#include "data_base_management.h"
+#include "library_queries.h"
 #include "db_helper.h"
 #include "comic_db.h"
+#include "yacreader_libraries.h"
 
 #include "yacreader_server_data_helper.h"
 
+#include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QUrl>
 
 using stefanfrings::HttpRequest;
 using stefanfrings::HttpResponse;
 
+namespace {
+// max number of ids used in each `IN (...)` query
+const int fetchSize = 500;
+}
+
 TagContentControllerV2::TagContentControllerV2()
 {
 }
@@ -23,22 +33,45 @@ void TagContentControllerV2::service(HttpRequest &request, HttpResponse &respons
     int libraryId = pathElements.at(3).toInt();
     qulonglong tagId = pathElements.at(5).toULongLong();
 
-    serviceContent(libraryId, tagId, response);
+    serviceContent(libraryId, tagId, JsonListWriter::Options::fromRequest(request), response);
 
     response.write("", true);
 }
 
-void TagContentControllerV2::serviceContent(const int &library, const qulonglong &tagId, HttpResponse &response)
+void TagContentControllerV2::serviceContent(const int &library, const qulonglong &tagId, const JsonListWriter::Options &options, HttpResponse &response)
 {
-    QList<ComicDB> comics = DBHelper::getLabelComics(library, tagId);
+    QString libraryDBPath = DBHelper::getLibraries().getDBPath(library);
+    QSqlDatabase db = DataBaseManagement::pooledDatabase(libraryDBPath);
 
-    QJsonArray items;
+    QList<qulonglong> ids;
+    QStringList keys;
+    {
+        QSqlQuery selectQuery(db);
+        selectQuery.setForwardOnly(true);
+        selectQuery.prepare(LABEL_CONTENT_QUERY);
+        selectQuery.bindValue(":labelId", tagId);
+        selectQuery.exec();
+        while (selectQuery.next()) {
+            ids.append(selectQuery.value(0).toULongLong());
+            keys.append(QString::number(ids.last()));
+        }
+    }
 
-    for (const ComicDB &comic : comics) {
-        items.append(YACReaderServerDataHelper::comicToJSON(library, comic));
+    JsonListWriter writer(response, options);
+
+    int begin, end;
+    QString nextCursor;
+    if (!writer.page(keys, begin, end, nextCursor)) {
+        response.setStatus(400, "invalid cursor");
+        return;
     }
 
-    QJsonDocument output(items);
+    for (int chunk = begin; chunk < end; chunk += fetchSize) {
+        const auto comics = DBHelper::getComics(ids.mid(chunk, qMin(end, chunk + fetchSize) - chunk), db);
+        for (const ComicDB &comic : comics) {
+            writer.append(YACReaderServerDataHelper::comicToJSON(library, comic));
+        }
+    }
 
-    response.write(output.toJson(QJsonDocument::Compact));
+    writer.finish(nextCursor);
 }
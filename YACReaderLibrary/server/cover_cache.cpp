@@ -0,0 +1,138 @@
+#include "cover_cache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "QsLog.h"
+
+#include <limits>
+
+namespace {
+// covers are stored up to 640px wide (see InitialComicInfoExtractor), bigger widths get the original cover
+const int widths[] = { 80, 120, 160, 240, 320, 480 };
+const int scaledCoversQuality = 75;
+
+QByteArray etagFor(const QFileInfo &info)
+{
+    return "\"" + QByteArray::number(info.size(), 16) + "-" + QByteArray::number(info.lastModified().toMSecsSinceEpoch(), 16) + "\"";
+}
+}
+
+CoverCache::CoverCache(qint64 maxBytes)
+{
+    cache.setMaxCost(int(qBound<qint64>(0, maxBytes, std::numeric_limits<int>::max())));
+}
+
+int CoverCache::availableWidth(int width)
+{
+    if (width <= 0)
+        return 0;
+
+    for (int available : widths) {
+        if (width <= available)
+            return available;
+    }
+
+    return 0;
+}
+
+CoverCache::Cover CoverCache::cover(const QString &coversPath, const QString &fileName, int width)
+{
+    QString filePath = coversPath + "/" + fileName;
+
+    width = availableWidth(width);
+    if (width > 0) {
+        auto scaledPath = scaledCover(coversPath, fileName, width);
+        if (!scaledPath.isEmpty())
+            filePath = scaledPath;
+    }
+
+    return load(filePath);
+}
+
+CoverCache::Cover CoverCache::load(const QString &filePath)
+{
+    QFileInfo info(filePath);
+    if (!info.exists())
+        return Cover();
+
+    auto etag = etagFor(info);
+
+    {
+        QMutexLocker locker(&mutex);
+        auto cached = cache.object(filePath);
+        if (cached != nullptr && cached->etag == etag)
+            return *cached; // copy, other threads may remove the entry once the mutex is unlocked
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return Cover();
+
+    auto cover = new Cover { file.readAll(), etag, info.lastModified() };
+    Cover result = *cover;
+
+    // covers bigger than the cache (or any cover if the cache is disabled) are deleted by QCache right away
+    QMutexLocker locker(&mutex);
+    cache.insert(filePath, cover, cover->data.size());
+
+    return result;
+}
+
+void CoverCache::pruneScaledCovers(const QString &coversPath)
+{
+    QDir sizesDir(coversPath + "/sizes");
+    const auto sizes = sizesDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const auto &size : sizes) {
+        const auto scaledCovers = QDir(size.filePath()).entryInfoList(QDir::Files);
+        for (const auto &scaled : scaledCovers) {
+            QFileInfo original(coversPath + "/" + scaled.fileName());
+            if (!original.exists() || original.lastModified() > scaled.lastModified())
+                QFile::remove(scaled.filePath());
+        }
+    }
+}
+
+QString CoverCache::scaledCover(const QString &coversPath, const QString &fileName, int width)
+{
+    auto scaledDir = QString("%1/sizes/%2").arg(coversPath).arg(width);
+    QFileInfo scaled(scaledDir + "/" + fileName);
+
+    QFileInfo original(coversPath + "/" + fileName);
+    if (!original.exists()) {
+        if (scaled.exists())
+            QFile::remove(scaled.filePath());
+        return QString();
+    }
+
+    if (scaled.exists() && scaled.lastModified() >= original.lastModified())
+        return scaled.filePath();
+
+    QImageReader reader(original.filePath());
+    auto size = reader.size();
+    if (!size.isValid() || size.width() <= width)
+        return QString();
+
+    // the JPEG decoder scales while decoding, this is much cheaper than decoding the full image and scaling it
+    reader.setScaledSize(QSize(width, qMax(1, size.height() * width / size.width())));
+    QImage image = reader.read();
+    if (image.isNull()) {
+        QLOG_WARN() << "Unable to read cover" << original.filePath() << ":" << reader.errorString();
+        return QString();
+    }
+
+    // several threads may create the same cover at the same time, QSaveFile makes each write atomic
+    QDir().mkpath(scaledDir);
+    QSaveFile file(scaled.filePath());
+    if (!file.open(QIODevice::WriteOnly) || !image.save(&file, "JPG", scaledCoversQuality) || !file.commit()) {
+        QLOG_WARN() << "Unable to save cover" << scaled.filePath();
+        return QString();
+    }
+
+    return scaled.filePath();
+}
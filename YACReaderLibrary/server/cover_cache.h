@@ -0,0 +1,46 @@
+#ifndef COVER_CACHE_H
+#define COVER_CACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+
+// Raw bytes of the covers served by the server, they are sent as they are stored in
+// .yacreaderlibrary/covers without being decoded. Shared by all the server threads.
+//
+// Reduced sizes (e.g. cover.jpg?w=240) are generated once and stored in
+// .yacreaderlibrary/covers/sizes/<width>/, they are regenerated if the original cover changes and
+// removed with pruneScaledCovers() once the original is gone.
+class CoverCache
+{
+public:
+    struct Cover {
+        QByteArray data;
+        // computed from the size and the modification time of the file
+        QByteArray etag;
+        QDateTime lastModified;
+        bool isNull() const { return etag.isEmpty(); }
+    };
+
+    // maxBytes is the memory used for caching covers, 0 disables the cache
+    explicit CoverCache(qint64 maxBytes);
+
+    // width 0 returns the original cover, other widths are rounded up to one of the available sizes
+    // a null cover is returned if the cover doesn't exist
+    Cover cover(const QString &coversPath, const QString &fileName, int width = 0);
+
+    static int availableWidth(int width);
+    // removes the reduced sizes of the covers that no longer exist or that have changed since they were created
+    static void pruneScaledCovers(const QString &coversPath);
+
+private:
+    Cover load(const QString &filePath);
+    QString scaledCover(const QString &coversPath, const QString &fileName, int width);
+
+    QCache<QString, Cover> cache;
+    QMutex mutex;
+};
+
+#endif // COVER_CACHE_H
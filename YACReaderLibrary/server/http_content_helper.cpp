@@ -0,0 +1,160 @@
+#include "http_content_helper.h"
+
+#include <QFile>
+
+#include <memory>
+
+#include "QsLog.h"
+
+using stefanfrings::HttpRequest;
+using stefanfrings::HttpResponse;
+
+namespace {
+
+enum class RangeStatus {
+    None, // the whole content is sent
+    Satisfiable,
+    NotSatisfiable
+};
+
+// only single ranges are supported, a request for several ranges gets the whole content (RFC 7233 allows ignoring Range)
+RangeStatus requestedRange(const HttpRequest &request, const QByteArray &etag, qint64 size, qint64 &begin, qint64 &end)
+{
+    auto range = request.getHeader("Range").trimmed();
+    if (!range.startsWith("bytes=") || range.contains(',') || size == 0) {
+        return RangeStatus::None;
+    }
+
+    // the range is only valid for the same version of the content
+    auto ifRange = request.getHeader("If-Range").trimmed();
+    if (!ifRange.isEmpty() && ifRange != etag) {
+        return RangeStatus::None;
+    }
+
+    auto spec = range.mid(6).trimmed();
+    auto separator = spec.indexOf('-');
+    if (separator == -1) {
+        return RangeStatus::None;
+    }
+    auto first = spec.left(separator).trimmed();
+    auto last = spec.mid(separator + 1).trimmed();
+
+    bool ok;
+    if (first.isEmpty()) {
+        // suffix range, the last N bytes
+        auto length = last.toLongLong(&ok);
+        if (!ok || length < 0) {
+            return RangeStatus::None;
+        }
+        if (length == 0) {
+            return RangeStatus::NotSatisfiable;
+        }
+        begin = qMax(qint64(0), size - length);
+        end = size - 1;
+        return RangeStatus::Satisfiable;
+    }
+
+    begin = first.toLongLong(&ok);
+    if (!ok || begin < 0) {
+        return RangeStatus::None;
+    }
+    end = size - 1;
+    if (!last.isEmpty()) {
+        auto lastByte = last.toLongLong(&ok);
+        if (!ok || lastByte < begin) {
+            return RangeStatus::None;
+        }
+        end = qMin(end, lastByte);
+    }
+
+    return begin < size ? RangeStatus::Satisfiable : RangeStatus::NotSatisfiable;
+}
+}
+
+bool HttpContentHelper::isNotModified(const HttpRequest &request, const QByteArray &etag)
+{
+    auto ifNoneMatch = request.getHeader("If-None-Match");
+    if (ifNoneMatch.isEmpty()) {
+        return false;
+    }
+
+    for (const auto &value : ifNoneMatch.split(',')) {
+        auto trimmed = value.trimmed();
+        if (trimmed == "*" || trimmed == etag || trimmed == "W/" + etag)
+            return true;
+    }
+    return false;
+}
+
+bool HttpContentHelper::writeHeaders(const HttpRequest &request, HttpResponse &response, const QByteArray &etag, qint64 size, qint64 &begin, qint64 &end)
+{
+    response.setHeader("ETag", etag);
+    response.setHeader("Accept-Ranges", "bytes");
+
+    if (isNotModified(request, etag)) {
+        response.setStatus(304, "Not Modified");
+        response.write(QByteArray(), true);
+        return false;
+    }
+
+    begin = 0;
+    end = size - 1;
+    switch (requestedRange(request, etag, size, begin, end)) {
+    case RangeStatus::None:
+        begin = 0;
+        end = size - 1;
+        break;
+    case RangeStatus::Satisfiable:
+        response.setStatus(206, "Partial Content");
+        response.setHeader("Content-Range", "bytes " + QByteArray::number(begin) + "-" + QByteArray::number(end) + "/" + QByteArray::number(size));
+        break;
+    case RangeStatus::NotSatisfiable:
+        response.setStatus(416, "Range Not Satisfiable");
+        response.setHeader("Content-Range", "bytes */" + QByteArray::number(size));
+        response.write(QByteArray(), true);
+        return false;
+    }
+
+    response.setHeader("Content-Length", QByteArray::number(end - begin + 1));
+    return true;
+}
+
+void HttpContentHelper::sendData(const HttpRequest &request, HttpResponse &response, const QByteArray &data, const QByteArray &etag)
+{
+    qint64 begin, end;
+    if (!writeHeaders(request, response, etag, data.size(), begin, end)) {
+        return;
+    }
+
+    if (begin == 0 && end == data.size() - 1) {
+        response.write(data, true);
+    } else {
+        response.write(data.mid(begin, end - begin + 1), true);
+    }
+}
+
+void HttpContentHelper::sendFile(const HttpRequest &request, HttpResponse &response, const QString &filePath, const QByteArray &etag)
+{
+    auto file = std::make_unique<QFile>(filePath);
+    if (!file->open(QIODevice::ReadOnly)) {
+        response.setStatus(404, "not found");
+        response.write("404 not found", true);
+        return;
+    }
+
+    qint64 begin, end;
+    if (!writeHeaders(request, response, etag, file->size(), begin, end)) {
+        return;
+    }
+
+    if (!file->seek(begin)) {
+        QLOG_ERROR() << "Unable to read" << filePath;
+        response.setStatus(500, "server error");
+        response.write(QByteArray(), true);
+        return;
+    }
+
+    // the I/O thread of the connection reads the file as the client receives it,
+    // the worker thread is free right away no matter how slow the client is
+    response.writeFile(file.release(), end - begin + 1);
+}
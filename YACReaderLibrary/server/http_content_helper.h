@@ -0,0 +1,31 @@
+#ifndef HTTP_CONTENT_HELPER_H
+#define HTTP_CONTENT_HELPER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "httprequest.h"
+#include "httpresponse.h"
+
+// Sends content identified by a strong ETag: the response has a Content-Length instead of being chunked,
+// `If-None-Match` is answered with 304 and single byte ranges (`Range: bytes=...`, `If-Range`) with 206,
+// so interrupted downloads can be resumed. The Content-Type is set by the caller.
+class HttpContentHelper
+{
+public:
+    static QByteArray strongETag(const QByteArray &value) { return "\"" + value + "\""; }
+
+    static bool isNotModified(const stefanfrings::HttpRequest &request, const QByteArray &etag);
+
+    static void sendData(const stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response, const QByteArray &data, const QByteArray &etag);
+    // the file is read by the I/O thread of the connection while the client receives it, it is never loaded completely in memory
+    static void sendFile(const stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response, const QString &filePath, const QByteArray &etag);
+
+private:
+    HttpContentHelper();
+
+    // begins the response, returns false if there is no body to send
+    static bool writeHeaders(const stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response, const QByteArray &etag, qint64 size, qint64 &begin, qint64 &end);
+};
+
+#endif // HTTP_CONTENT_HELPER_H
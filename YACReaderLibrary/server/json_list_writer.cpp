@@ -0,0 +1,100 @@
+#include "json_list_writer.h"
+
+#include <QJsonDocument>
+#include <QJsonValue>
+
+#include <utility>
+
+using stefanfrings::HttpRequest;
+using stefanfrings::HttpResponse;
+
+namespace {
+const int chunkSize = 64 * 1024;
+}
+
+JsonListWriter::Options JsonListWriter::Options::fromRequest(HttpRequest &request)
+{
+    Options options;
+
+    options.limit = qMax(0, request.getParameter("limit").toInt());
+    options.cursor = QString::fromUtf8(request.getParameter("cursor"));
+
+    auto fields = QString::fromUtf8(request.getParameter("fields"));
+    if (!fields.isEmpty()) {
+        options.fields = fields.split(',', Qt::SkipEmptyParts);
+        options.fields << "type"
+                       << "id";
+    }
+
+    return options;
+}
+
+JsonListWriter::JsonListWriter(HttpResponse &response, const Options &options)
+    : response(response), options(options), empty(true)
+{
+    buffer.reserve(chunkSize);
+    buffer.append(options.paginated() ? "{\"items\":[" : "[");
+}
+
+bool JsonListWriter::page(const QStringList &keys, int &begin, int &end, QString &nextCursor) const
+{
+    begin = 0;
+    if (!options.cursor.isEmpty()) {
+        begin = keys.indexOf(options.cursor);
+        if (begin == -1) {
+            return false;
+        }
+        begin++;
+    }
+
+    end = keys.size();
+    if (options.paginated()) {
+        end = qMin(end, begin + options.limit);
+    }
+
+    nextCursor = (end < keys.size() && end > 0) ? keys.at(end - 1) : QString();
+    return true;
+}
+
+void JsonListWriter::append(const QJsonObject &item)
+{
+    QJsonObject projection;
+    if (options.fields.isEmpty()) {
+        projection = item;
+    } else {
+        for (const auto &field : std::as_const(options.fields)) {
+            auto value = item.value(field);
+            if (!value.isUndefined()) {
+                projection.insert(field, value);
+            }
+        }
+    }
+
+    if (!empty) {
+        buffer.append(',');
+    }
+    buffer.append(QJsonDocument(projection).toJson(QJsonDocument::Compact));
+    empty = false;
+
+    if (buffer.size() >= chunkSize) {
+        writeBuffer();
+    }
+}
+
+void JsonListWriter::finish(const QString &nextCursor)
+{
+    buffer.append(']');
+    if (options.paginated()) {
+        buffer.append(",\"next_cursor\":");
+        // cursors are generated by the server (ids and positions), they don't need to be escaped
+        buffer.append(nextCursor.isEmpty() ? QByteArray("null") : QByteArray("\"" + nextCursor.toUtf8() + "\""));
+        buffer.append('}');
+    }
+    writeBuffer();
+}
+
+void JsonListWriter::writeBuffer()
+{
+    response.write(buffer);
+    buffer.clear();
+}
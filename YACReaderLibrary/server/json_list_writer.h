@@ -0,0 +1,46 @@
+#ifndef JSON_LIST_WRITER_H
+#define JSON_LIST_WRITER_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QStringList>
+
+#include "httprequest.h"
+#include "httpresponse.h"
+
+// Writes the items of a v2 list endpoint as they are produced, the response is sent in chunks instead of building the whole JSON document first.
+// The query string can ask for a page of the list (`limit` and `cursor`) and for some fields only (`fields=id,hash,title`, "type" and "id" are always included).
+// Without `limit` the response is a JSON array like it always was, with it the response is {"items": [...], "next_cursor": "..."},
+// next_cursor is null in the last page and its value is passed as `cursor` to get the next one.
+class JsonListWriter
+{
+public:
+    struct Options {
+        int limit = 0; // 0 means the whole list
+        QString cursor;
+        QStringList fields;
+
+        bool paginated() const { return limit > 0; }
+        static Options fromRequest(stefanfrings::HttpRequest &request);
+    };
+
+    JsonListWriter(stefanfrings::HttpResponse &response, const Options &options);
+
+    // range [begin, end) of `keys` (the cursors of the items in the order they are listed) in the requested page
+    // returns false if the cursor is not in the list
+    bool page(const QStringList &keys, int &begin, int &end, QString &nextCursor) const;
+
+    void append(const QJsonObject &item);
+    // writes what is left, the response is ended by the caller
+    void finish(const QString &nextCursor = QString());
+
+private:
+    void writeBuffer();
+
+    stefanfrings::HttpResponse &response;
+    Options options;
+    QByteArray buffer;
+    bool empty;
+};
+
+#endif // JSON_LIST_WRITER_H
@@ -22,6 +22,7 @@
 #include "controllers/v2/pagecontroller_v2.h"
 #include "controllers/v2/updatecomiccontroller_v2.h"
 #include "controllers/v2/comicdownloadinfocontroller_v2.h"
+#include "controllers/v2/comicfilecontroller_v2.h"
 #include "controllers/v2/synccontroller_v2.h"
 #include "controllers/v2/foldercontentcontroller_v2.h"
 #include "controllers/v2/tagscontroller_v2.h"
@@ -240,6 +241,7 @@ void RequestMapper::serviceV2(HttpRequest &request, HttpResponse &response)
     QRegExp folderInfo("/v2/library/.+/folder/[0-9]+/info/?"); // get folder info
     QRegExp comicDownloadInfo("/v2/library/.+/comic/[0-9]+/info/?"); // get comic info (full download info)
     QRegExp comicOpenForDownloading("/v2/library/.+/comic/[0-9]+/?"); // get comic info (full info + opening)
+    QRegExp comicFile("/v2/library/.+/comic/[0-9]+/file/?"); // get the comic file (download, supports Range requests)
     QRegExp comicOpenForRemoteReading("/v2/library/.+/comic/[0-9]+/remote/?"); // the server will open for reading the comic
     QRegExp comicOpenForRemoteReadingInAReadingList("/v2/library/.+/reading_list/[0-9]+/comic/[0-9]+/remote/?"); // the server will open for reading the comic
     QRegExp comicFullInfo("/v2/library/.+/comic/[0-9]+/fullinfo/?"); // get comic info
@@ -287,6 +289,8 @@ void RequestMapper::serviceV2(HttpRequest &request, HttpResponse &response)
                     CoverControllerV2().service(request, response);
                 } else if (comicDownloadInfo.exactMatch(path)) {
                     ComicDownloadInfoControllerV2().service(request, response);
+                } else if (comicFile.exactMatch(path)) {
+                    ComicFileControllerV2().service(request, response);
                 } else if (comicOpenForRemoteReadingInAReadingList.exactMatch(path)) {
                     ComicControllerInReadingListV2().service(request, response);
                 } else if (comicOpenForDownloading.exactMatch(path) || comicOpenForRemoteReading.exactMatch(path)) { // start download or start remote reading
@@ -0,0 +1,32 @@
+#include "search_request.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+SearchRequest SearchRequest::fromJson(const QByteArray &body)
+{
+    SearchRequest request;
+
+    QJsonDocument json = QJsonDocument::fromJson(body);
+    request.query = json["query"].toString();
+    request.limit = qBound(1, json["limit"].toInt(defaultLimit), maxLimit);
+    request.offset = qMax(0, json["offset"].toInt(0));
+
+    // `cursor` (the `next_cursor` of the previous page, or "" for the first one) is the offset of the page,
+    // with it the response uses the paginated format of JsonListWriter
+    if (json["cursor"].isString()) {
+        request.options.limit = request.limit;
+        request.options.cursor = json["cursor"].toString();
+        request.offset = qMax(0, request.options.cursor.toInt());
+    }
+    const auto fields = json["fields"].toArray();
+    for (const auto &field : fields) {
+        request.options.fields << field.toString();
+    }
+    if (!request.options.fields.isEmpty()) {
+        request.options.fields << "type"
+                               << "id";
+    }
+
+    return request;
+}
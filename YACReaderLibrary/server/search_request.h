@@ -0,0 +1,24 @@
+#ifndef SEARCH_REQUEST_H
+#define SEARCH_REQUEST_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "json_list_writer.h"
+
+// Parameters of the v2 search API, read from the JSON body of the request.
+// `limit` is always clamped to [1, maxLimit] before it is used, so the `next_cursor` of a page is always past its own offset.
+struct SearchRequest {
+    static constexpr int defaultLimit = 500;
+    static constexpr int maxLimit = 1000;
+
+    QString query;
+    // comics are paginated, folders are always returned with the first page
+    int limit = defaultLimit;
+    int offset = 0;
+    JsonListWriter::Options options;
+
+    static SearchRequest fromJson(const QByteArray &body);
+};
+
+#endif // SEARCH_REQUEST_H
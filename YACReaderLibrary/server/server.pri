@@ -11,6 +11,11 @@ DEPENDPATH += $$PWD/controllers/v2
 HEADERS += \
     $$PWD/controllers/v2/searchcontroller_v2.h \
     $$PWD/static.h \
+    $$PWD/cover_cache.h \
+    $$PWD/comic_page_cache.h \
+    $$PWD/http_content_helper.h \
+    $$PWD/json_list_writer.h \
+    $$PWD/search_request.h \
     $$PWD/requestmapper.h \
     $$PWD/yacreader_http_server.h \
     $$PWD/yacreader_http_session.h \
@@ -37,6 +42,7 @@ HEADERS += \
     $$PWD/controllers/v2/covercontroller_v2.h \
     $$PWD/controllers/v2/updatecomiccontroller_v2.h \
     $$PWD/controllers/v2/comicdownloadinfocontroller_v2.h \
+    $$PWD/controllers/v2/comicfilecontroller_v2.h \
     $$PWD/controllers/v2/synccontroller_v2.h \
     $$PWD/controllers/v2/foldercontentcontroller_v2.h \
     $$PWD/controllers/v2/tagscontroller_v2.h \
@@ -56,6 +62,11 @@ HEADERS += \
 SOURCES += \
     $$PWD/controllers/v2/searchcontroller_v2.cpp \
     $$PWD/static.cpp \
+    $$PWD/cover_cache.cpp \
+    $$PWD/comic_page_cache.cpp \
+    $$PWD/http_content_helper.cpp \
+    $$PWD/json_list_writer.cpp \
+    $$PWD/search_request.cpp \
     $$PWD/requestmapper.cpp \
     $$PWD/yacreader_http_server.cpp \
     $$PWD/yacreader_http_session.cpp \
@@ -82,6 +93,7 @@ SOURCES += \
     $$PWD/controllers/v2/covercontroller_v2.cpp \
     $$PWD/controllers/v2/updatecomiccontroller_v2.cpp \
     $$PWD/controllers/v2/comicdownloadinfocontroller_v2.cpp \
+    $$PWD/controllers/v2/comicfilecontroller_v2.cpp \
     $$PWD/controllers/v2/synccontroller_v2.cpp \
     $$PWD/controllers/v2/foldercontentcontroller_v2.cpp \
     $$PWD/controllers/v2/tagscontroller_v2.cpp \
@@ -24,6 +24,10 @@ StaticFileController *Static::staticFileController = 0;
 
 YACReaderHttpSessionStore *Static::yacreaderSessionStore = nullptr;
 
+CoverCache *Static::coverCache = nullptr;
+
+ComicPageCache *Static::comicPageCache = nullptr;
+
 QString Static::getConfigFileName()
 {
     return QString("%1/%2.ini").arg(getConfigDir()).arg(QCoreApplication::applicationName());
@@ -12,6 +12,8 @@
 #include "staticfilecontroller.h"
 
 #include "yacreader_http_session_store.h"
+#include "cover_cache.h"
+#include "comic_page_cache.h"
 
 /**
   This class contains some static resources that are used by the application.
@@ -57,6 +59,12 @@ public:
     /** Controller for static files */
     static stefanfrings::StaticFileController *staticFileController;
 
+    /** Raw bytes of the comic covers */
+    static CoverCache *coverCache;
+
+    /** Pages of the comics opened by the clients */
+    static ComicPageCache *comicPageCache;
+
 private:
     /** Directory of the main config file */
     static QString configDir;
@@ -89,6 +89,13 @@ void YACReaderHttpServer::start(quint16 port)
 
     Static::staticFileController = new StaticFileController(fileSettings, app);
 
+    // Configure the covers and pages caches
+    QSettings librarySettings(YACReader::getSettingsPath() + "/YACReaderLibrary.ini", QSettings::IniFormat);
+    librarySettings.beginGroup("libraryConfig");
+    Static::coverCache = new CoverCache(librarySettings.value(COVERS_MEMORY_CACHE, 32).toLongLong() * 1024 * 1024);
+    Static::comicPageCache = new ComicPageCache(librarySettings.value(PAGES_CACHE_SIZE, 512).toLongLong() * 1024 * 1024,
+                                                librarySettings.value(PAGES_MEMORY_BUDGET, 256).toLongLong() * 1024 * 1024);
+
     // Configure and start the TCP listener
     qDebug("ServiceHelper: Starting service");
     auto listenerSettings = new QSettings(configFileName, QSettings::IniFormat, app);
@@ -100,14 +107,10 @@ void YACReaderHttpServer::start(quint16 port)
     if (listenerSettings->value("maxMultiPartSize").isNull())
         listenerSettings->setValue("maxMultiPartSize", "32000000");
 
-    if (listenerSettings->value("cleanupInterval").isNull())
-        listenerSettings->setValue("cleanupInterval", 10000);
-
-    if (listenerSettings->value("minThreads").isNull())
-        listenerSettings->setValue("maxThreads", 1000);
-
-    if (listenerSettings->value("minThreads").isNull())
-        listenerSettings->setValue("minThreads", 50);
+    // connections are multiplexed over a few I/O threads and the requests run in a bounded worker pool,
+    // ioThreads and workerThreads are chosen from the number of cores unless they are set
+    if (listenerSettings->value("maxConnections").isNull())
+        listenerSettings->setValue("maxConnections", 1000);
 
     if (listenerSettings->value("port").isNull())
         listenerSettings->setValue("port", 8080);
@@ -1,17 +1,16 @@
 #include "yacreader_http_session.h"
 
+#include "static.h"
+
 YACReaderHttpSession::YACReaderHttpSession(QObject *parent)
-    : QObject(parent), comicId(0), remoteComicId(0), comic(nullptr), remoteComic(nullptr)
+    : QObject(parent), comicId(0), remoteComicId(0)
 {
 }
 
 YACReaderHttpSession::~YACReaderHttpSession()
 {
-    if (comic != nullptr)
-        delete comic;
-
-    if (remoteComic != nullptr)
-        delete remoteComic;
+    dismissCurrentComic();
+    dismissCurrentRemoteComic();
 }
 
 bool YACReaderHttpSession::isComicOnDevice(const QString &hash)
@@ -60,24 +59,24 @@ qulonglong YACReaderHttpSession::getCurrentComicId()
     return comicId;
 }
 
-Comic *YACReaderHttpSession::getCurrentComic()
+QString YACReaderHttpSession::getCurrentComicHash()
 {
-    return comic;
+    return comicHash;
 }
 
 void YACReaderHttpSession::dismissCurrentComic()
 {
-    if (comic != nullptr) {
-        comic->deleteLater();
-        comic = nullptr;
+    if (!comicHash.isNull()) {
+        Static::comicPageCache->release(comicHash);
+        comicHash = QString();
     }
 }
 
-void YACReaderHttpSession::setCurrentComic(qulonglong id, Comic *comic)
+void YACReaderHttpSession::setCurrentComic(qulonglong id, const QString &hash)
 {
     dismissCurrentComic();
     comicId = id;
-    this->comic = comic;
+    comicHash = hash;
 }
 
 // current comic (read)
@@ -86,24 +85,24 @@ qulonglong YACReaderHttpSession::getCurrentRemoteComicId()
     return remoteComicId;
 }
 
-Comic *YACReaderHttpSession::getCurrentRemoteComic()
+QString YACReaderHttpSession::getCurrentRemoteComicHash()
 {
-    return remoteComic;
+    return remoteComicHash;
 }
 
 void YACReaderHttpSession::dismissCurrentRemoteComic()
 {
-    if (remoteComic != nullptr) {
-        remoteComic->deleteLater();
-        remoteComic = nullptr;
+    if (!remoteComicHash.isNull()) {
+        Static::comicPageCache->release(remoteComicHash);
+        remoteComicHash = QString();
     }
 }
 
-void YACReaderHttpSession::setCurrentRemoteComic(qulonglong id, Comic *comic)
+void YACReaderHttpSession::setCurrentRemoteComic(qulonglong id, const QString &hash)
 {
     dismissCurrentRemoteComic();
     remoteComicId = id;
-    remoteComic = comic;
+    remoteComicHash = hash;
 }
 
 QString YACReaderHttpSession::getDeviceType()
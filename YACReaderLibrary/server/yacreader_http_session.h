@@ -22,16 +22,17 @@ public:
     void clearComics();
 
     // current comic (import)
+    // the comics are opened in Static::comicPageCache, the session holds a reference to them until they are dismissed
     qulonglong getCurrentComicId();
-    Comic *getCurrentComic();
+    QString getCurrentComicHash();
     void dismissCurrentComic();
-    void setCurrentComic(qulonglong id, Comic *comic);
+    void setCurrentComic(qulonglong id, const QString &hash);
 
     // current comic (read)
     qulonglong getCurrentRemoteComicId();
-    Comic *getCurrentRemoteComic();
+    QString getCurrentRemoteComicHash();
     void dismissCurrentRemoteComic();
-    void setCurrentRemoteComic(qulonglong id, Comic *comic);
+    void setCurrentRemoteComic(qulonglong id, const QString &hash);
 
     // device identification
     QString getDeviceType();
@@ -61,8 +62,8 @@ private:
 
     qulonglong comicId;
     qulonglong remoteComicId;
-    Comic *comic;
-    Comic *remoteComic;
+    QString comicHash;
+    QString remoteComicHash;
 
     QStack<QPair<qulonglong, quint32>> navigationPath; /* folder_id, page_number */
 };
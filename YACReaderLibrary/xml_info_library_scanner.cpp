@@ -3,6 +3,8 @@
 #include "comic_db.h"
 #include "data_base_management.h"
 #include "db_helper.h"
+#include "library_write_batch.h"
+#include "library_queries.h"
 #include "initial_comic_info_extractor.h"
 #include "xml_info_parser.h"
 #include "yacreader_global.h"
@@ -67,12 +69,13 @@ void XMLInfoLibraryScanner::run()
         databaseConnection = database.connectionName();
 
         database.transaction();
+        LibraryWriteBatch batch(database);
 
         if (!partialUpdate) {
             QSqlQuery comicsInfo("SELECT * FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id)", database);
             comicsInfo.exec();
 
-            updateFromSQLQuery(database, comicsInfo);
+            updateFromSQLQuery(batch, comicsInfo);
         } else {
             if (folderDestinationModelIndex.isValid()) {
                 YACReader::iterate(folderDestinationModelIndex, folderDestinationModelIndex.model(), [&](const QModelIndex &idx) {
@@ -83,11 +86,11 @@ void XMLInfoLibraryScanner::run()
                     auto item = static_cast<FolderItem *>(idx.internalPointer());
 
                     QSqlQuery comicsInfo(database);
-                    comicsInfo.prepare("SELECT * FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.parentId = :parentId");
+                    comicsInfo.prepare("SELECT * " FOLDER_COMICS_FROM);
                     comicsInfo.bindValue(":parentId", item->id);
                     comicsInfo.exec();
 
-                    updateFromSQLQuery(database, comicsInfo);
+                    updateFromSQLQuery(batch, comicsInfo);
 
                     return true;
                 });
@@ -106,7 +109,7 @@ void XMLInfoLibraryScanner::stop()
     stopRunning = true;
 }
 
-void XMLInfoLibraryScanner::updateFromSQLQuery(QSqlDatabase &db, QSqlQuery &query)
+void XMLInfoLibraryScanner::updateFromSQLQuery(LibraryWriteBatch &batch, QSqlQuery &query)
 {
     QSqlRecord record = query.record();
 
@@ -131,7 +134,7 @@ void XMLInfoLibraryScanner::updateFromSQLQuery(QSqlDatabase &db, QSqlQuery &quer
         ie.extract();
 
         if (parseXMLIntoInfo(ie.getXMLInfoRawData(), info)) {
-            DBHelper::update(&info, db);
+            batch.update(&info);
         }
     }
 }
@@ -4,6 +4,8 @@
 #include <QtCore>
 #include <QSqlQuery>
 
+class LibraryWriteBatch;
+
 namespace YACReader {
 
 class XMLInfoLibraryScanner : public QThread
@@ -30,7 +32,7 @@ private:
     bool partialUpdate;
     QModelIndex folderDestinationModelIndex;
 
-    void updateFromSQLQuery(QSqlDatabase &db, QSqlQuery &query);
+    void updateFromSQLQuery(LibraryWriteBatch &batch, QSqlQuery &query);
 };
 
 }
@@ -45,6 +45,10 @@ HEADERS += ../YACReaderLibrary/library_creator.h \
            ../YACReaderLibrary/bundle_creator.h \
            ../YACReaderLibrary/db_helper.h \
            ../YACReaderLibrary/db/data_base_management.h \
+           ../YACReaderLibrary/db/library_write_batch.h \
+           ../YACReaderLibrary/db/library_indexes.h \
+           ../YACReaderLibrary/db/library_queries.h \
+           ../YACReaderLibrary/db/library_schema.h \
            ../YACReaderLibrary/db/reading_list.h \
            ../YACReaderLibrary/initial_comic_info_extractor.h \
            ../YACReaderLibrary/xml_info_parser.h \
@@ -56,6 +60,7 @@ HEADERS += ../YACReaderLibrary/library_creator.h \
            ../common/pdf_comic.h \
            ../common/bookmarks.h \
            ../common/qnaturalsorting.h \
+           ../common/concurrent_queue.h \
            ../common/yacreader_global.h \
            ../YACReaderLibrary/yacreader_local_server.h \
            ../YACReaderLibrary/comics_remover.h \
@@ -69,6 +74,7 @@ HEADERS += ../YACReaderLibrary/library_creator.h \
            ../YACReaderLibrary/db/query_parser.h \
            ../YACReaderLibrary/db/search_query.h \
            ../YACReaderLibrary/libraries_update_coordinator.h \
+           ../YACReaderLibrary/library_change_journal.h \
 
 
 SOURCES += ../YACReaderLibrary/library_creator.cpp \
@@ -76,6 +82,7 @@ SOURCES += ../YACReaderLibrary/library_creator.cpp \
            ../YACReaderLibrary/bundle_creator.cpp \
            ../YACReaderLibrary/db_helper.cpp \
            ../YACReaderLibrary/db/data_base_management.cpp \
+           ../YACReaderLibrary/db/library_write_batch.cpp \
            ../YACReaderLibrary/db/reading_list.cpp \
            ../YACReaderLibrary/initial_comic_info_extractor.cpp \
            ../YACReaderLibrary/xml_info_parser.cpp \
@@ -86,6 +93,7 @@ SOURCES += ../YACReaderLibrary/library_creator.cpp \
            ../common/comic.cpp \
            ../common/bookmarks.cpp \
            ../common/qnaturalsorting.cpp \
+           ../common/concurrent_queue.cpp \
            ../YACReaderLibrary/yacreader_local_server.cpp \
            ../YACReaderLibrary/comics_remover.cpp \
            ../common/http_worker.cpp \
@@ -100,6 +108,7 @@ SOURCES += ../YACReaderLibrary/library_creator.cpp \
            ../YACReaderLibrary/db/query_parser.cpp \
            ../YACReaderLibrary/db/search_query.cpp \
            ../YACReaderLibrary/libraries_update_coordinator.cpp \
+           ../YACReaderLibrary/library_change_journal.cpp \
 
 include(../YACReaderLibrary/server/server.pri)
 
@@ -3,10 +3,16 @@
 #include <QPixmap>
 #include <QRegularExpression>
 #include <QString>
+#include <QMap>
 #include <algorithm>
 #include <QDir>
 #include <QFileInfoList>
 #include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+#include <QtEndian>
+
+#include <thread>
 
 #include "bookmarks.h" //TODO desacoplar la dependencia con bookmarks
 #include "qnaturalsorting.h"
@@ -23,6 +29,19 @@ enum YACReaderPageSortingMode {
 
 void comic_pages_sort(QList<QString> &pageNames, YACReaderPageSortingMode sortingMode);
 
+// version of the pages order saved with the archive indexes (see FileComic::process). The order depends on comic_pages_sort and on
+// FileComic::filter, that keeps the image formats supported by the installed Qt plugins: pageOrderLogicVersion has to be increased
+// whenever any of them changes the pages of a comic or their order, the supported formats are part of the version
+static quint32 pageOrderVersion()
+{
+    static const quint32 pageOrderLogicVersion = 1;
+    static const quint32 version = [] {
+        auto key = QByteArray::number(pageOrderLogicVersion) + ":" + Comic::getSupportedImageLiteralFormats().join(",").toUtf8();
+        return qFromBigEndian<quint32>(QCryptographicHash::hash(key, QCryptographicHash::Sha1).constData());
+    }();
+    return version;
+}
+
 QStringList Comic::getSupportedImageFormats()
 {
     QList<QByteArray> supportedImageFormats = QImageReader::supportedImageFormats();
@@ -211,8 +230,7 @@ void Comic::loadFinished()
 //-----------------------------------------------------------------------------
 void Comic::setBookmark()
 {
-    QImage p;
-    p.loadFromData(_pages[_index]);
+    QImage p = getPageImage(_index);
     bm->setBookmark(_index, p);
     // emit bookmarksLoaded(*bm);
     emit bookmarksUpdated();
@@ -227,8 +245,7 @@ void Comic::removeBookmark()
 //-----------------------------------------------------------------------------
 void Comic::saveBookmarks()
 {
-    QImage p;
-    p.loadFromData(_pages[_index]);
+    QImage p = getPageImage(_index);
     bm->setLastPage(_index, p);
     bm->save();
 }
@@ -245,15 +262,13 @@ void Comic::updateBookmarkImage(int index)
     }
 
     if (bm->isBookmark(index)) {
-        QImage p;
-        p.loadFromData(_pages[index]);
+        QImage p = getPageImage(index);
         bm->setBookmark(index, p);
         emit bookmarksUpdated();
         // emit bookmarksLoaded(*bm);
     }
     if (bm->getLastPage() == index) {
-        QImage p;
-        p.loadFromData(_pages[index]);
+        QImage p = getPageImage(index);
         bm->setLastPage(index, p);
         emit bookmarksUpdated();
         // emit bookmarksLoaded(*bm);
@@ -262,6 +277,7 @@ void Comic::updateBookmarkImage(int index)
 //-----------------------------------------------------------------------------
 void Comic::setPageLoaded(int page)
 {
+    QMutexLocker locker(&_pagesMutex);
     _loadedPages[page] = true;
 }
 
@@ -273,14 +289,23 @@ void Comic::invalidate()
 //-----------------------------------------------------------------------------
 QByteArray Comic::getRawPage(int page)
 {
+    QMutexLocker locker(&_pagesMutex);
     if (page < 0 || page >= _pages.size()) {
         return QByteArray();
     }
     return _pages[page];
 }
 //-----------------------------------------------------------------------------
+QImage Comic::getPageImage(int page)
+{
+    QImage image;
+    image.loadFromData(getRawPage(page));
+    return image;
+}
+//-----------------------------------------------------------------------------
 bool Comic::pageIsLoaded(int page)
 {
+    QMutexLocker locker(&_pagesMutex);
     if (page < 0 || page >= _pages.size()) {
         return false;
     }
@@ -345,16 +370,38 @@ QList<QString> Comic::findValidComicFilesInFolder(const QString &path)
 ////////////////////////////////////////////////////////////////////////////////
 
 FileComic::FileComic()
-    : Comic()
+    : Comic(), _memoryBudget(0), _memoryUsed(0)
 {
+    setupWindow();
 }
 
 FileComic::FileComic(const QString &path, int atPage)
-    : Comic(path, atPage)
+    : Comic(path, atPage), _memoryBudget(0), _memoryUsed(0)
 {
+    setupWindow();
     FileComic::load(path, atPage);
 }
 
+void FileComic::setupWindow()
+{
+    // the comic thread may be waiting for the reader to move away from the pages already in memory
+    auto wakeUp = [this] {
+        QMutexLocker locker(&_windowMutex);
+        _windowMoved.wakeAll();
+    };
+    connect(this, &Comic::pageChanged, this, wakeUp, Qt::DirectConnection);
+    connect(this, &Comic::invalidated, this, wakeUp, Qt::DirectConnection);
+}
+
+void FileComic::setMemoryBudget(qint64 bytes)
+{
+    _memoryBudget = bytes;
+
+    // the comic thread may be waiting for the window to move, a bigger budget lets it extract more pages
+    QMutexLocker locker(&_windowMutex);
+    _windowMoved.wakeAll();
+}
+
 FileComic::~FileComic()
 {
     _pages.clear();
@@ -444,9 +491,13 @@ void FileComic::fileExtracted(int index, const QByteArray &rawData)
     if (sortedIndex == -1) {
         return;
     }
-    _pages[sortedIndex] = rawData;
+    {
+        QMutexLocker locker(&_pagesMutex);
+        _memoryUsed += rawData.size() - _pages[sortedIndex].size();
+        _pages[sortedIndex] = rawData;
+    }
     emit imageLoaded(sortedIndex);
-    emit imageLoaded(sortedIndex, _pages[sortedIndex]);
+    emit imageLoaded(sortedIndex, rawData);
 }
 
 void FileComic::crcError(int index)
@@ -554,6 +605,52 @@ QList<QVector<quint32>> FileComic::getSections(int &sectionIndex)
     return sections;
 }
 
+// Solid archives (7z, RAR) compress many files together: extracting any of them decompresses its
+// block from the start. The pages are grouped by block so each block is decompressed only once,
+// starting with the block that contains the first page to show.
+// It returns an empty list if the archive doesn't report the blocks.
+QList<QVector<quint32>> FileComic::getSolidBlocks(CompressedArchive &archive, int &blockIndex)
+{
+    QMap<int, QVector<quint32>> pagesByBlock;
+    int firstBlock = -1;
+    for (int page = 0; page < _fileNames.size(); page++) {
+        quint32 index = _order.indexOf(_fileNames.at(page));
+        int block = archive.getSolidBlock(index);
+        if (block == -1) {
+            return QList<QVector<quint32>>();
+        }
+
+        pagesByBlock[block].append(index);
+        if (page == _firstPage) {
+            firstBlock = block;
+        }
+    }
+
+    QList<QVector<quint32>> blocks;
+    blockIndex = 0;
+    for (auto block = pagesByBlock.begin(); block != pagesByBlock.end(); ++block) {
+        if (block.key() == firstBlock) {
+            blockIndex = blocks.size();
+        }
+        std::sort(block->begin(), block->end());
+        blocks.append(*block);
+    }
+
+    return blocks;
+}
+
+void FileComic::extractSection(CompressedArchive &archive, const QVector<quint32> &section, bool solidBlock)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    archive.getAllData(section, this);
+
+    if (solidBlock) {
+        QLOG_DEBUG() << "Solid block with" << section.size() << "pages extracted in" << timer.elapsed() << "ms";
+    }
+}
+
 void FileComic::process()
 {
     CompressedArchive archive(_path);
@@ -569,9 +666,27 @@ void FileComic::process()
         return;
     }
 
-    // se filtran para obtener s�lo los formatos soportados
     _order = archive.getFileNames();
-    _fileNames = filter(_order);
+
+    // the pages order is saved with the archive index the first time the comic is opened
+    QVector<int> pageOrder = archive.getPageOrder(pageOrderVersion());
+    if (!pageOrder.isEmpty()) {
+        _fileNames.clear();
+        for (int position : pageOrder) {
+            _fileNames.append(_order.at(position));
+        }
+    } else {
+        // se filtran para obtener s�lo los formatos soportados
+        _fileNames = filter(_order);
+
+        // TODO, add a setting for choosing the type of page sorting used.
+        comic_pages_sort(_fileNames, YACReaderHeuristicSorting);
+
+        for (const QString &name : _fileNames) {
+            pageOrder.append(_order.indexOf(name));
+        }
+        archive.setPageOrder(pageOrder, pageOrderVersion());
+    }
 
     if (_fileNames.size() == 0) {
         // QMessageBox::critical(NULL,tr("File error"),tr("File not found or not images in file"));
@@ -583,8 +698,11 @@ void FileComic::process()
     // TODO, cambiar por listas
     //_order = _fileNames;
 
-    _pages.resize(_fileNames.size());
-    _loadedPages = QVector<bool>(_fileNames.size(), false);
+    {
+        QMutexLocker locker(&_pagesMutex);
+        _pages.resize(_fileNames.size());
+        _loadedPages = QVector<bool>(_fileNames.size(), false);
+    }
 
     emit pageChanged(0); // this indicates new comic, index=0
     emit numPages(_pages.size());
@@ -592,9 +710,6 @@ void FileComic::process()
 
     _cfi = 0;
 
-    // TODO, add a setting for choosing the type of page sorting used.
-    comic_pages_sort(_fileNames, YACReaderHeuristicSorting);
-
     if (_firstPage == -1) {
         _firstPage = bm->getLastPage();
     }
@@ -606,22 +721,36 @@ void FileComic::process()
     _index = _firstPage;
     emit openAt(_index);
 
+    if (_memoryBudget > 0) {
+        processWithinBudget(archive);
+
+        moveToThread(QCoreApplication::instance()->thread());
+        if (!_invalidated) {
+            emit imagesLoaded();
+        }
+        return;
+    }
+
     int sectionIndex;
-    QList<QVector<quint32>> sections = getSections(sectionIndex);
+    QList<QVector<quint32>> sections = getSolidBlocks(archive, sectionIndex);
+    bool solid = !sections.isEmpty();
+    if (!solid) {
+        sections = getSections(sectionIndex);
+    }
 
     for (int i = sectionIndex; i < sections.count(); i++) {
         if (_invalidated) {
             moveToThread(QCoreApplication::instance()->thread());
             return;
         }
-        archive.getAllData(sections.at(i), this);
+        extractSection(archive, sections.at(i), solid);
     }
     for (int i = 0; i < sectionIndex; i++) {
         if (_invalidated) {
             moveToThread(QCoreApplication::instance()->thread());
             return;
         }
-        archive.getAllData(sections.at(i), this);
+        extractSection(archive, sections.at(i), solid);
     }
     // archive.getAllData(QVector<quint32>(),this);
     /*
@@ -637,6 +766,114 @@ void FileComic::process()
     emit imagesLoaded();
 }
 
+// Reading is mostly forward, so previous pages are considered twice as far as the next ones.
+static int pageDistance(int page, int index)
+{
+    return page >= index ? page - index : 2 * (index - page);
+}
+
+QList<int> FileComic::pagesByDistance(int index) const
+{
+    QList<int> pages;
+    pages.reserve(_pages.size());
+    for (int i = 0; i < _pages.size(); i++) {
+        pages.append(i);
+    }
+    std::stable_sort(pages.begin(), pages.end(), [index](int p1, int p2) {
+        return pageDistance(p1, index) < pageDistance(p2, index);
+    });
+    return pages;
+}
+
+void FileComic::releasePage(int page)
+{
+    {
+        QMutexLocker locker(&_pagesMutex);
+        _memoryUsed -= _pages[page].size();
+        _pages[page] = QByteArray();
+        _loadedPages[page] = false;
+    }
+    _requestedPages[page] = false;
+    emit imageUnloaded(page);
+}
+
+// Keeps a sliding window of extracted pages around the current index. Pages are extracted
+// closest first and the farthest ones are released while the budget is exceeded. It returns
+// once every page is in memory or when the comic is invalidated.
+void FileComic::processWithinBudget(CompressedArchive &archive)
+{
+    const int batchSize = 4; // pages extracted in one pass, so compressed streams are read sequentially
+
+    QVector<quint32> archiveIndexes;
+    for (const QString &name : _fileNames) {
+        archiveIndexes.append(_order.indexOf(name));
+    }
+
+    _requestedPages = QVector<bool>(_pages.size(), false);
+
+    while (!_invalidated) {
+        int requestedIndex = _index;
+        qint64 budget = _memoryBudget;
+        int index = qBound(0, requestedIndex, _pages.size() - 1);
+
+        QList<int> pages = pagesByDistance(index);
+        QList<int> missingPages;
+        int farthestLoadedPage = -1;
+        for (int page : pages) {
+            if (!_requestedPages[page]) {
+                missingPages.append(page);
+            } else if (pageIsLoaded(page)) {
+                farthestLoadedPage = page;
+            }
+        }
+
+        if (missingPages.isEmpty()) {
+            break; // the whole comic is in memory
+        }
+
+        if (_memoryUsed >= budget) {
+            if (farthestLoadedPage != -1 && farthestLoadedPage != index &&
+                pageDistance(farthestLoadedPage, index) > pageDistance(missingPages.first(), index)) {
+                releasePage(farthestLoadedPage);
+                continue;
+            }
+
+            // the window is full, wait until the reader moves
+            QMutexLocker locker(&_windowMutex);
+            while (!_invalidated && _index == requestedIndex && _memoryBudget == budget) {
+                _windowMoved.wait(&_windowMutex);
+            }
+            continue;
+        }
+
+        // in solid archives the pages of the same block that fit in the budget are extracted together,
+        // otherwise the block would be decompressed again from its start for every batch
+        int block = archive.getSolidBlock(archiveIndexes.at(missingPages.first()));
+        qint64 available = budget - _memoryUsed;
+        QVector<quint32> indexes;
+        for (int page : missingPages) {
+            if (block == -1) {
+                if (indexes.size() == batchSize) {
+                    break;
+                }
+            } else {
+                if (archive.getSolidBlock(archiveIndexes.at(page)) != block) {
+                    continue;
+                }
+                qint64 size = qMax<qint64>(0, archive.getFileSize(archiveIndexes.at(page)));
+                if (!indexes.isEmpty() && size > available) {
+                    break;
+                }
+                available -= size;
+            }
+            _requestedPages[page] = true;
+            indexes.append(archiveIndexes.at(page));
+        }
+        std::sort(indexes.begin(), indexes.end());
+        extractSection(archive, indexes, block != -1);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -678,7 +915,7 @@ void FolderComic::process()
     QFileInfoList list = d.entryInfoList();
 
     // don't fix double page files sorting, because the user can see how the SO sorts the files in the folder.
-    std::sort(list.begin(), list.end(), naturalSortLessThanCIFileInfo);
+    naturalSort(list, [](const QFileInfo &fileInfo) { return fileInfo.fileName(); });
 
     int nPages = list.size();
     _pages.clear();
@@ -737,17 +974,45 @@ void FolderComic::process()
 
 #ifndef NO_PDF
 
+// Poppler keeps global state that is set up and torn down when documents are created and destroyed
+static QMutex pdfDocumentsMutex;
+// the goto flow only needs a small version of the pages
+static const int pdfThumbnailHeight = 512;
+// every worker keeps its own copy of the document
+static const int maxPDFRenderWorkers = 4;
+
 PDFComic::PDFComic()
-    : Comic()
+    : Comic(), _imagePassthrough(false), _memoryBudget(0), _memoryUsed(0)
 {
+    setupWindow();
 }
 
 PDFComic::PDFComic(const QString &path, int atPage)
-    : Comic(path, atPage)
+    : Comic(path, atPage), _imagePassthrough(false), _memoryBudget(0), _memoryUsed(0)
 {
+    setupWindow();
     PDFComic::load(path, atPage);
 }
 
+void PDFComic::setupWindow()
+{
+    // the render workers may be waiting for the reader to move away from the pages already in memory
+    auto wakeUp = [this] {
+        QMutexLocker locker(&_renderQueueMutex);
+        _windowMoved.wakeAll();
+    };
+    connect(this, &Comic::pageChanged, this, wakeUp, Qt::DirectConnection);
+    connect(this, &Comic::invalidated, this, wakeUp, Qt::DirectConnection);
+}
+
+void PDFComic::setMemoryBudget(qint64 bytes)
+{
+    _memoryBudget = bytes;
+
+    QMutexLocker locker(&_renderQueueMutex);
+    _windowMoved.wakeAll();
+}
+
 PDFComic::~PDFComic()
 {
 }
@@ -793,52 +1058,87 @@ bool PDFComic::load(const QString &path, const ComicDB &comic)
     }
 }
 
-void PDFComic::process()
+void PDFComic::setImagePassthrough(bool passthrough)
+{
+    _imagePassthrough = passthrough;
+}
+
+void PDFComic::setTargetSize(const QSize &size)
 {
+    QMutexLocker locker(&_renderQueueMutex);
+    _targetSize = size;
+}
+
+QImage PDFComic::getPageImage(int page)
+{
+    if (!_imagePassthrough) {
+        return Comic::getPageImage(page);
+    }
+
+    QMutexLocker locker(&_pagesMutex);
+    if (page < 0 || page >= _images.size()) {
+        return QImage();
+    }
+    return _images[page];
+}
+
+std::unique_ptr<PDFComic::Document> PDFComic::openDocument()
+{
+    QMutexLocker locker(&pdfDocumentsMutex);
 #if defined Q_OS_MACOS && defined USE_PDFKIT
-    pdfComic = std::make_unique<MacOSXPDFComic>();
-    if (!pdfComic->openComic(_path)) {
-        emit errorOpening();
-        return;
+    auto document = std::make_unique<MacOSXPDFComic>();
+    if (!document->openComic(_path)) {
+        return nullptr;
     }
 #elif defined USE_PDFIUM
-    pdfComic = std::make_unique<PdfiumComic>();
-    if (!pdfComic->openComic(_path)) {
-        emit errorOpening();
-        return;
+    auto document = std::make_unique<PdfiumComic>();
+    if (!document->openComic(_path)) {
+        return nullptr;
     }
 #else
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    pdfComic = Poppler::Document::load(_path);
+    auto document = Poppler::Document::load(_path);
 #else
-    auto _pdfComic = Poppler::Document::load(_path);
-    pdfComic = std::unique_ptr<Poppler::Document>(_pdfComic);
+    auto document = std::unique_ptr<Poppler::Document>(Poppler::Document::load(_path));
 #endif
 
-    if (!pdfComic) {
-        moveToThread(QCoreApplication::instance()->thread());
-        emit errorOpening();
-        return;
+    if (!document || document->isLocked()) {
+        return nullptr;
     }
-    if (pdfComic->isLocked()) {
+
+    document->setRenderHint(Poppler::Document::TextAntialiasing, true);
+#endif
+    return document;
+}
+
+void PDFComic::process()
+{
+    pdfComic = openDocument();
+    if (!pdfComic) {
         moveToThread(QCoreApplication::instance()->thread());
         emit errorOpening();
         return;
     }
 
-    pdfComic->setRenderHint(Poppler::Document::TextAntialiasing, true);
-#endif
-
     int nPages = pdfComic->numPages();
     emit pageChanged(0); // this indicates new comic, index=0
     emit numPages(nPages);
     _loaded = true;
     // QMessageBox::critical(NULL,QString("%1").arg(nPages),tr("Invalid PDF file"));
 
-    _pages.clear();
-    _pages.resize(nPages);
-    _loadedPages = QVector<bool>(nPages, false);
+    {
+        QMutexLocker locker(&_pagesMutex);
+        _pages.clear();
+        _pages.resize(nPages);
+        _images.clear();
+        if (_imagePassthrough) {
+            _images.resize(nPages);
+        }
+        _loadedPages = QVector<bool>(nPages, false);
+        _memoryUsed = 0;
+    }
+    _renderClaimed = QVector<bool>(nPages, false);
 
     if (_firstPage == -1) {
         _firstPage = bm->getLastPage();
@@ -851,49 +1151,155 @@ void PDFComic::process()
     _index = _firstPage;
     emit openAt(_index);
 
-    // buffer index to avoid race conditions
-    int buffered_index = _index;
-    for (int i = buffered_index; i < nPages; i++) {
-        if (_invalidated) {
-            moveToThread(QCoreApplication::instance()->thread());
-            return;
+    // Poppler can render in parallel as long as every thread uses its own document, pdfium and PDFKit are not thread safe
+#if defined USE_PDFIUM || (defined Q_OS_MACOS && defined USE_PDFKIT)
+    int workers = 1;
+#else
+    int workers = qBound(1, QThread::idealThreadCount(), qMin(nPages, maxPDFRenderWorkers));
+#endif
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workers; i++) {
+        threads.emplace_back([this] {
+            auto document = openDocument();
+            if (document) {
+                renderPages(document.get());
+            }
+            QMutexLocker locker(&pdfDocumentsMutex);
+            document.reset();
+        });
+    }
+    renderPages(pdfComic.get());
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    moveToThread(QCoreApplication::instance()->thread());
+    if (!_invalidated) {
+        emit imagesLoaded();
+    }
+}
+
+// The pages closest to the current one are rendered first, the current page can change while rendering.
+// With a memory budget the farthest rendered pages are released while it is exceeded, like in
+// FileComic::processWithinBudget, and the workers wait for the reader to move when the window is full.
+int PDFComic::claimNextPage()
+{
+    QMutexLocker locker(&_renderQueueMutex);
+    while (!_invalidated) {
+        int requestedIndex = _index;
+        qint64 budget = _memoryBudget;
+        int index = qBound(0, requestedIndex, _renderClaimed.size() - 1);
+
+        int next = -1;
+        int farthestLoadedPage = -1;
+        qint64 memoryUsed;
+        {
+            QMutexLocker pagesLocker(&_pagesMutex);
+            memoryUsed = _memoryUsed;
+            for (int page = 0; page < _renderClaimed.size(); page++) {
+                if (!_renderClaimed[page]) {
+                    if (next == -1 || pageDistance(page, index) < pageDistance(next, index)) {
+                        next = page;
+                    }
+                } else if (_loadedPages[page] && (farthestLoadedPage == -1 || pageDistance(page, index) > pageDistance(farthestLoadedPage, index))) {
+                    farthestLoadedPage = page;
+                }
+            }
         }
 
-        renderPage(i);
+        if (next == -1) {
+            return -1; // every page is rendered or being rendered
+        }
+
+        if (budget <= 0 || memoryUsed < budget) {
+            _renderClaimed[next] = true;
+            return next;
+        }
+
+        if (farthestLoadedPage != -1 && farthestLoadedPage != index &&
+            pageDistance(farthestLoadedPage, index) > pageDistance(next, index)) {
+            releasePage(farthestLoadedPage);
+            continue;
+        }
+
+        while (!_invalidated && _index == requestedIndex && _memoryBudget == budget) {
+            _windowMoved.wait(&_renderQueueMutex);
+        }
     }
-    for (int i = 0; i < buffered_index; i++) {
-        if (_invalidated) {
-            moveToThread(QCoreApplication::instance()->thread());
-            return;
+    return -1;
+}
+
+// called with _renderQueueMutex locked
+void PDFComic::releasePage(int page)
+{
+    {
+        QMutexLocker locker(&_pagesMutex);
+        if (_imagePassthrough) {
+            _memoryUsed -= _images[page].sizeInBytes();
+            _images[page] = QImage();
+        } else {
+            _memoryUsed -= _pages[page].size();
+            _pages[page] = QByteArray();
         }
-        renderPage(i);
+        _loadedPages[page] = false;
     }
+    _renderClaimed[page] = false;
+    emit imageUnloaded(page);
+}
 
-    moveToThread(QCoreApplication::instance()->thread());
-    emit imagesLoaded();
+void PDFComic::renderPages(Document *document)
+{
+    int page;
+    while (!_invalidated && (page = claimNextPage()) != -1) {
+        renderPage(document, page);
+    }
 }
 
-void PDFComic::renderPage(int page)
+void PDFComic::renderPage(Document *document, int page)
 {
+    QSize targetSize;
+    {
+        QMutexLocker locker(&_renderQueueMutex);
+        targetSize = _targetSize;
+    }
+
 #if defined Q_OS_MACOS && defined USE_PDFKIT
-    QImage img = pdfComic->getPage(page);
+    QImage img = document->getPage(page, targetSize);
     if (!img.isNull()) {
 #elif defined USE_PDFIUM
-    QImage img = pdfComic->getPage(page);
+    QImage img = document->getPage(page, targetSize);
     if (!img.isNull()) {
 #else
-    std::unique_ptr<Poppler::Page> pdfpage(pdfComic->page(page));
+    std::unique_ptr<Poppler::Page> pdfpage(document->page(page));
     if (pdfpage) {
-        QImage img = pdfpage->renderToImage(150, 150);
+        double dpi = pdfRenderDpi(pdfpage->pageSizeF(), targetSize);
+        QImage img = pdfpage->renderToImage(dpi, dpi);
 #endif
         QByteArray ba;
         QBuffer buf(&ba);
         buf.open(QIODevice::WriteOnly);
-        img.save(&buf, "jpg", 96);
-        _pages[page] = ba;
+        if (_imagePassthrough) {
+            img.scaledToHeight(qMin(img.height(), pdfThumbnailHeight), Qt::SmoothTransformation).save(&buf, "jpg", 90);
+        } else {
+            img.save(&buf, "jpg", 96);
+        }
         buf.close();
+
+        {
+            QMutexLocker locker(&_pagesMutex);
+            if (_imagePassthrough) {
+                _images[page] = img;
+                _memoryUsed += img.sizeInBytes();
+            } else {
+                _pages[page] = ba;
+                _memoryUsed += ba.size();
+            }
+            _loadedPages[page] = true;
+        }
+
         emit imageLoaded(page);
-        emit imageLoaded(page, _pages[page]);
+        emit imageLoaded(page, ba);
     }
 }
 
@@ -1061,11 +1467,11 @@ void comic_pages_sort(QList<QString> &pageNames, YACReaderPageSortingMode sortin
 {
     switch (sortingMode) {
     case YACReaderNumericalSorting:
-        std::sort(pageNames.begin(), pageNames.end(), naturalSortLessThanCI);
+        naturalSort(pageNames);
         break;
 
     case YACReaderHeuristicSorting: {
-        std::sort(pageNames.begin(), pageNames.end(), naturalSortLessThanCI);
+        naturalSort(pageNames);
 
         QList<QString> singlePageNames;
         QList<QString> doublePageNames;
@@ -6,12 +6,15 @@
 #include <QByteArray>
 #include <QMap>
 
+#include <atomic>
+
 #include "extract_delegate.h"
 #include "bookmarks.h"
 #ifndef NO_PDF
 #include "pdf_comic.h"
 #endif // NO_PDF
 class ComicDB;
+class CompressedArchive;
 
 // #define EXTENSIONS_LITERAL << ".jpg" << ".jpeg" << ".png" << ".gif" << ".tiff" << ".tif" << ".bmp" //Comic::getSupportedImageLiteralFormats()
 class Comic : public QObject
@@ -41,6 +44,9 @@ protected:
 
     bool _errorOpening;
 
+    // guards _pages and _loadedPages, pages are extracted in the comic thread and read from others
+    mutable QMutex _pagesMutex;
+
 public:
     static const QStringList imageExtensions;
     static const QStringList literalImageExtensions;
@@ -71,6 +77,8 @@ public:
     // QPixmap * operator[](unsigned int index);
     QVector<QByteArray> *getRawData() { return &_pages; }
     QByteArray getRawPage(int page);
+    // decoded page, comics that keep their pages decoded return them without a decoding round trip
+    virtual QImage getPageImage(int page);
     bool pageIsLoaded(int page);
 
     // check if the comic has failed loading
@@ -100,6 +108,7 @@ signals:
     void imagesLoaded();
     void imageLoaded(int index);
     void imageLoaded(int index, const QByteArray &image);
+    void imageUnloaded(int index);
     void pageChanged(int index);
     void openAt(int index);
     void numPages(unsigned int numPages);
@@ -118,6 +127,20 @@ class FileComic : public Comic, public ExtractDelegate
 
 private:
     QList<QVector<quint32>> getSections(int &sectionIndex);
+    QList<QVector<quint32>> getSolidBlocks(CompressedArchive &archive, int &blockIndex);
+    void extractSection(CompressedArchive &archive, const QVector<quint32> &section, bool solidBlock);
+
+    // memory budget for the extracted pages, 0 means that all the pages are kept in memory
+    std::atomic<qint64> _memoryBudget;
+    qint64 _memoryUsed;
+    QVector<bool> _requestedPages;
+    QMutex _windowMutex;
+    QWaitCondition _windowMoved;
+
+    void setupWindow();
+    void processWithinBudget(CompressedArchive &archive);
+    QList<int> pagesByDistance(int index) const;
+    void releasePage(int page);
 
 public:
     FileComic();
@@ -127,6 +150,13 @@ public:
     bool load(const QString &path, const ComicDB &comic);
     static QList<QString> filter(const QList<QString> &src);
 
+    //! @brief Limits the memory used by the extracted pages to @p bytes (0 means no limit).
+    //! If the comic doesn't fit, only the pages around the current index are kept in memory
+    //! and the comic thread extracts them on demand while the index moves.
+    //! A limited budget can be changed while the comic is being processed (e.g. a comic prefetched
+    //! with a small budget gets the budget of the reader when it is opened).
+    void setMemoryBudget(qint64 bytes);
+
     // ExtractDelegate
     void fileExtracted(int index, const QByteArray &rawData);
     void crcError(int index);
@@ -165,13 +195,31 @@ class PDFComic : public Comic
 private:
 // pdf
 #if defined Q_OS_MACOS && defined USE_PDFKIT
-    std::unique_ptr<MacOSXPDFComic> pdfComic;
+    using Document = MacOSXPDFComic;
 #elif defined USE_PDFIUM
-    std::unique_ptr<PdfiumComic> pdfComic;
+    using Document = PdfiumComic;
 #else
-    std::unique_ptr<Poppler::Document> pdfComic;
+    using Document = Poppler::Document;
 #endif
-    void renderPage(int page);
+    std::unique_ptr<Document> pdfComic;
+
+    // decoded pages, only used when the images are passed through
+    QVector<QImage> _images;
+    bool _imagePassthrough;
+    QSize _targetSize;
+    QVector<bool> _renderClaimed;
+    QMutex _renderQueueMutex;
+    // memory budget for the rendered pages like in FileComic, 0 means that all the pages are kept in memory
+    std::atomic<qint64> _memoryBudget;
+    qint64 _memoryUsed;
+    QWaitCondition _windowMoved;
+
+    void setupWindow();
+    std::unique_ptr<Document> openDocument();
+    int claimNextPage();
+    void releasePage(int page);
+    void renderPages(Document *document);
+    void renderPage(Document *document, int page);
 
     // void run();
 
@@ -183,6 +231,16 @@ public:
     bool load(const QString &path, int atPage = -1);
     bool load(const QString &path, const ComicDB &comic);
 
+    //! @brief Keeps the rendered pages as QImages instead of encoding them, getRawPage() returns
+    //! nothing for them and imageLoaded(int, QByteArray) carries a thumbnail. Set it before loading.
+    void setImagePassthrough(bool passthrough);
+    //! @brief Size in pixels the pages are rendered to cover, the default renders them at 150 dpi.
+    void setTargetSize(const QSize &size);
+    //! @brief Limits the memory used by the rendered pages to @p bytes (0 means no limit), see FileComic::setMemoryBudget.
+    //! Released pages are rendered again when the reader gets close to them.
+    void setMemoryBudget(qint64 bytes);
+    QImage getPageImage(int page) override;
+
 public slots:
 
     void process();
@@ -0,0 +1,182 @@
+#include "cover_image_cache.h"
+
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
+
+namespace {
+const qint64 defaultMaxBytes = 128 * 1024 * 1024;
+}
+
+CoverImageCache &CoverImageCache::instance()
+{
+    static CoverImageCache cache;
+    return cache;
+}
+
+CoverImageCache::CoverImageCache()
+    : bytes(0), maxBytes(defaultMaxBytes)
+{
+}
+
+QImage CoverImageCache::load(const QString &fileName, const QSize &size)
+{
+    // taken before decoding, if the file is replaced meanwhile the next lookup decodes it again
+    auto stamp = fileStamp(fileName);
+    QImage image = find(fileName, stamp, size);
+    if (!image.isNull()) {
+        auto target = scaledSize(image.size(), size);
+        if (target == image.size()) {
+            return image;
+        }
+        image = image.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    } else {
+        image = decode(fileName, size);
+        if (image.isNull()) {
+            return image;
+        }
+    }
+
+    insert(fileName, stamp, size, image);
+    return image;
+}
+
+bool CoverImageCache::contains(const QString &fileName, const QSize &size)
+{
+    auto stamp = fileStamp(fileName);
+
+    QMutexLocker locker(&mutex);
+    auto it = entries.constFind(key(fileName, size));
+    return it != entries.constEnd() && it->stamp == stamp;
+}
+
+void CoverImageCache::remove(const QString &fileName)
+{
+    QMutexLocker locker(&mutex);
+    eraseFile(fileName);
+}
+
+QImage CoverImageCache::decode(const QString &fileName, const QSize &size)
+{
+    QImageReader reader(fileName);
+
+    // the JPEG decoder scales while decoding, much faster than decoding the full cover and scaling it
+    auto original = reader.size();
+    auto target = scaledSize(original, size);
+    if (target.isValid() && target != original) {
+        reader.setScaledSize(target);
+    }
+
+    return reader.read();
+}
+
+CoverImageCache::Key CoverImageCache::key(const QString &fileName, const QSize &size)
+{
+    return fileName + '|' + QString::number(size.width()) + 'x' + QString::number(size.height());
+}
+
+QSize CoverImageCache::scaledSize(const QSize &original, const QSize &size)
+{
+    if (!original.isValid() || !size.isValid()) {
+        return original;
+    }
+
+    double scale = qMax(size.width() > 0 ? double(size.width()) / original.width() : 0.0,
+                        size.height() > 0 ? double(size.height()) / original.height() : 0.0);
+    if (scale <= 0 || scale >= 1) {
+        return original;
+    }
+
+    return QSize(qMax(1, qRound(original.width() * scale)), qMax(1, qRound(original.height() * scale)));
+}
+
+CoverImageCache::FileStamp CoverImageCache::fileStamp(const QString &fileName)
+{
+    QFileInfo info(fileName);
+    return { info.lastModified(), info.size() };
+}
+
+// the cover at `size` or the smallest cached version that fills it
+QImage CoverImageCache::find(const QString &fileName, const FileStamp &stamp, const QSize &size)
+{
+    QMutexLocker locker(&mutex);
+
+    // all the versions of a cover come from the same file, so checking one of them is enough
+    const auto keys = keysByFile.values(fileName);
+    if (!keys.isEmpty() && entries.constFind(keys.first())->stamp != stamp) {
+        eraseFile(fileName);
+        return QImage();
+    }
+
+    auto it = entries.find(key(fileName, size));
+    if (it == entries.end() && size.isValid()) {
+        qint64 bestArea = -1;
+        for (const auto &candidateKey : keys) {
+            auto candidate = entries.find(candidateKey);
+            const auto &image = candidate->image;
+            qint64 area = qint64(image.width()) * image.height();
+            if (image.width() >= size.width() && image.height() >= size.height() && (bestArea == -1 || area < bestArea)) {
+                it = candidate;
+                bestArea = area;
+            }
+        }
+    }
+
+    if (it == entries.end()) {
+        return QImage();
+    }
+
+    lru.splice(lru.begin(), lru, it->lruPosition);
+    return it->image;
+}
+
+void CoverImageCache::insert(const QString &fileName, const FileStamp &stamp, const QSize &size, const QImage &image)
+{
+    qint64 imageBytes = image.sizeInBytes();
+    if (imageBytes > maxBytes / 4) {
+        return;
+    }
+
+    QMutexLocker locker(&mutex);
+
+    // versions decoded from an older file
+    const auto keys = keysByFile.values(fileName);
+    if (!keys.isEmpty() && entries.constFind(keys.first())->stamp != stamp) {
+        eraseFile(fileName);
+    }
+
+    auto imageKey = key(fileName, size);
+    erase(imageKey); // it could have been decoded by another thread at the same time
+
+    lru.push_front(imageKey);
+    entries.insert(imageKey, { fileName, stamp, image, lru.begin() });
+    keysByFile.insert(fileName, imageKey);
+    bytes += imageBytes;
+
+    while (bytes > maxBytes && !lru.empty()) {
+        Key oldest = lru.back();
+        erase(oldest);
+    }
+}
+
+// the mutex must be locked
+void CoverImageCache::eraseFile(const QString &fileName)
+{
+    const auto keys = keysByFile.values(fileName);
+    for (const auto &key : keys) {
+        erase(key);
+    }
+}
+
+void CoverImageCache::erase(const Key &key)
+{
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return;
+    }
+
+    bytes -= it->image.sizeInBytes();
+    keysByFile.remove(it->fileName, key);
+    lru.erase(it->lruPosition);
+    entries.erase(it);
+}
@@ -0,0 +1,69 @@
+#ifndef COVER_IMAGE_CACHE_H
+#define COVER_IMAGE_CACHE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+
+#include <list>
+
+// Decoded covers shared by the cover flows and the QML views of the process, bounded by the bytes of the images kept
+// (least recently used covers are evicted first).
+// Covers are decoded at the size they are shown: `size` is the box the cover has to fill keeping its aspect ratio,
+// a 0 width or height doesn't constrain that dimension and an invalid size means the original size. Covers are never
+// scaled up. If a bigger version of a cover is cached it is scaled down instead of decoding the file again.
+// The cached versions of a cover are dropped when the modification time or the size of its file change, so covers
+// rewritten by any part of the app (library updates, imports, the properties dialog...) are decoded again.
+// All the methods are thread-safe.
+class CoverImageCache
+{
+public:
+    static CoverImageCache &instance();
+
+    // decodes the cover in the calling thread if it is not cached
+    QImage load(const QString &fileName, const QSize &size = QSize());
+    bool contains(const QString &fileName, const QSize &size = QSize());
+    // forgets all the versions of a cover
+    void remove(const QString &fileName);
+
+    static QImage decode(const QString &fileName, const QSize &size = QSize());
+
+private:
+    CoverImageCache();
+
+    using Key = QString;
+    // identifies the version of the file a cover was decoded from
+    struct FileStamp {
+        QDateTime modified;
+        qint64 size;
+
+        bool operator==(const FileStamp &other) const { return modified == other.modified && size == other.size; }
+        bool operator!=(const FileStamp &other) const { return !(*this == other); }
+    };
+    struct Entry {
+        QString fileName;
+        FileStamp stamp;
+        QImage image;
+        std::list<Key>::iterator lruPosition;
+    };
+
+    static Key key(const QString &fileName, const QSize &size);
+    static QSize scaledSize(const QSize &original, const QSize &size);
+    static FileStamp fileStamp(const QString &fileName);
+    QImage find(const QString &fileName, const FileStamp &stamp, const QSize &size);
+    void insert(const QString &fileName, const FileStamp &stamp, const QSize &size, const QImage &image);
+    void eraseFile(const QString &fileName);
+    void erase(const Key &key);
+
+    QMutex mutex;
+    QHash<Key, Entry> entries;
+    QMultiHash<QString, Key> keysByFile;
+    std::list<Key> lru; // most recently used first
+    qint64 bytes;
+    qint64 maxBytes;
+};
+
+#endif // COVER_IMAGE_CACHE_H
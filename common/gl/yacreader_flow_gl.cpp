@@ -1,7 +1,10 @@
 #include "yacreader_flow_gl.h"
 
+#include "cover_image_cache.h"
+
 #include <QtGui>
 #include <QMatrix4x4>
+#include <algorithm>
 #include <cmath>
 
 /*** Animation Settings ***/
@@ -192,7 +195,6 @@ struct Preset pressetYACReaderFlowDownConfig = {
 YACReaderFlowGL::YACReaderFlowGL(QWidget *parent, struct Preset p)
     : QOpenGLWidget(/*QOpenGLWidget migration QGLFormat(QGL::SampleBuffers),*/ parent), numObjects(0), lazyPopulateObjects(-1), hasBeenInitialized(false), bUseVSync(false), flowRightToLeft(false)
 {
-    updateCount = 0;
     config = p;
 
     currentSelected = 0;
@@ -657,15 +659,10 @@ void YACReaderFlowGL::updatePositions()
     if (fabs(images[currentSelected].current.x - images[currentSelected].animEnd.x) < 1) // viewRotate < 0.2)
     {
         cleanupAnimation();
-        if (updateCount >= 0) // TODO parametrizar
-        {
+    }
 
-            updateCount = 0;
-            updateImageData();
-        } else
-            updateCount++;
-    } else
-        updateCount++;
+    // covers are requested every frame so they keep up with fast scrolls
+    updateImageData();
 
     if (stopAnimation)
         stopAnimationTimer();
@@ -1134,17 +1131,27 @@ QVector3D YACReaderFlowGL::getPlaneIntersection(int x, int y, YACReader3DImage p
     return ray_origin + ray_vector * (intersection_ray_determinant / intersection_LES_determinant);
 }
 
+namespace {
+// textures uploaded in each frame, the rest wait for the next frames so the animation doesn't stutter
+const int maxUploadsPerFrame = 4;
+}
+
 YACReaderComicFlowGL::YACReaderComicFlowGL(QWidget *parent, struct Preset p)
-    : YACReaderFlowGL(parent, p)
+    : YACReaderFlowGL(parent, p), frame(0), texturesCount(0)
 {
     worker = new ImageLoaderGL(this);
-    worker->flow = this;
+}
+
+YACReaderComicFlowGL::~YACReaderComicFlowGL()
+{
+    delete worker;
 }
 
 void YACReaderComicFlowGL::setImagePaths(QStringList paths)
 {
     worker->reset();
     reset();
+    texturesCount = 0;
     numObjects = 0;
     if (lazyPopulateObjects != -1 || hasBeenInitialized)
         YACReaderFlowGL::populate(paths.size());
@@ -1161,30 +1168,10 @@ void YACReaderComicFlowGL::setImagePaths(QStringList paths)
 
 void YACReaderComicFlowGL::updateImageData()
 {
-    // can't do anything, wait for the next possibility
-    if (worker->busy())
+    if (paths.isEmpty())
         return;
 
-    // set image of last one
-    int idx = worker->index();
-    if (idx >= 0 && !worker->result().isNull()) {
-        if (!loaded[idx]) {
-            float x = 1;
-            QImage img = worker->result();
-            QOpenGLTexture *texture = new QOpenGLTexture(img);
-
-            if (performance == high || performance == ultraHigh) {
-                texture->setAutoMipMapGenerationEnabled(true);
-                texture->setMinMagFilters(QOpenGLTexture::LinearMipMapLinear, QOpenGLTexture::LinearMipMapLinear);
-            } else {
-                texture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
-            }
-
-            float y = 1 * (float(img.height()) / img.width());
-            QString s = "cover";
-            replace(s.toLocal8Bit().data(), texture, x, y, idx);
-        }
-    }
+    frame++;
 
     // try to load only few images on the left and right side
     // i.e. all visible ones plus some extra
@@ -1203,62 +1190,119 @@ void YACReaderComicFlowGL::updateImageData()
         count = 14;
         break;
     }
-    int *indexes = new int[2 * count + 1];
+
+    // the visible covers go first, the ones after them are decoded in advance for the next frames
+    QStringList requests;
+    auto consider = [&](int i, int distance) {
+        if (i < 0 || i >= numObjects)
+            return;
+        if (distance <= count)
+            images[i].lastUsed = frame;
+        // items with the same cover share the request
+        if (!loaded[i] && !requests.contains(paths.at(i)))
+            requests << paths.at(i);
+    };
+
     int center = currentSelected;
-    indexes[0] = center;
-    for (int j = 0; j < count; j++) {
-        indexes[j * 2 + 1] = center + j + 1;
-        indexes[j * 2 + 2] = center - j - 1;
+    consider(center, 0);
+    for (int j = 1; j <= 2 * count; j++) {
+        consider(center + j, j);
+        consider(center - j, j);
     }
-    for (int c = 0; c < 2 * count + 1; c++) {
-        int i = indexes[c];
-        if ((i >= 0) && (i < numObjects))
-            if (!loaded[i]) // slide(i).isNull())
-            {
-                // loader->loadTexture(i);
-                // loaded[i]=true;
-                //  schedule thumbnail generation
-                if (paths.size() > 0) {
-                    QString fname = paths.at(i);
-                    // loaded[i]=true;
-
-                    worker->generate(i, fname);
-                }
-                delete[] indexes;
-                return;
+
+    // upload the covers decoded since the last frame
+    const auto results = worker->takeResults(maxUploadsPerFrame);
+    for (const auto &result : results) {
+        // covers can be moved while they are decoded, find where they are now;
+        // several items can share the same cover file, all of them get it
+        bool uploaded = false;
+        for (int item = 0; item < numObjects && item < paths.size(); item++) {
+            if (!loaded[item] && paths.at(item) == result.first) {
+                uploadCover(item, result.second);
+                uploaded = true;
             }
+        }
+        if (uploaded)
+            requests.removeAll(result.first);
     }
 
-    delete[] indexes;
+    worker->request(requests);
+
+    evictTextures(8 * count);
+}
+
+void YACReaderComicFlowGL::uploadCover(int item, const QImage &image)
+{
+    float x = 1;
+    QOpenGLTexture *texture = new QOpenGLTexture(image);
+
+    if (performance == high || performance == ultraHigh) {
+        texture->setAutoMipMapGenerationEnabled(true);
+        texture->setMinMagFilters(QOpenGLTexture::LinearMipMapLinear, QOpenGLTexture::LinearMipMapLinear);
+    } else {
+        texture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
+    }
+
+    float y = 1 * (float(image.height()) / image.width());
+    QString s = "cover";
+    replace(s.toLocal8Bit().data(), texture, x, y, item);
+    if (loaded[item])
+        texturesCount++;
+    else
+        delete texture;
+}
+
+// keeps the textures of the covers used most recently, the rest go back to the default texture
+void YACReaderComicFlowGL::evictTextures(int maxTextures)
+{
+    if (texturesCount <= maxTextures)
+        return;
+
+    QVector<int> items;
+    for (int i = 0; i < numObjects; i++) {
+        if (loaded[i] && images[i].texture != defaultTexture)
+            items << i;
+    }
+
+    int toEvict = items.size() - maxTextures;
+    if (toEvict <= 0) {
+        texturesCount = items.size();
+        return;
+    }
+
+    std::nth_element(items.begin(), items.begin() + toEvict, items.end(), [this](int a, int b) {
+        return images[a].lastUsed < images[b].lastUsed;
+    });
+
+    for (int k = 0; k < toEvict; k++) {
+        int i = items.at(k);
+        delete images[i].texture;
+        images[i].texture = defaultTexture;
+        loaded[i] = false;
+    }
+
+    texturesCount = maxTextures;
 }
 
 void YACReaderComicFlowGL::remove(int item)
 {
-    worker->lock();
-    worker->reset();
+    if (item >= 0 && item < numObjects && loaded[item] && images[item].texture != defaultTexture)
+        texturesCount--;
     YACReaderFlowGL::remove(item);
     if (item >= 0 && item < paths.size()) {
         paths.removeAt(item);
     }
-    worker->unlock();
 }
 
 void YACReaderComicFlowGL::add(const QString &path, int index)
 {
-    worker->lock();
-    worker->reset();
-
     paths.insert(index, path);
 
     YACReaderFlowGL::add(index);
-
-    worker->unlock();
 }
 
 void YACReaderComicFlowGL::resortCovers(QList<int> newOrder)
 {
-    worker->lock();
-    worker->reset(); // is this necesary?
     startAnimationTimer();
     QList<QString> pathsNew;
     QVector<bool> loadedNew;
@@ -1282,8 +1326,6 @@ void YACReaderComicFlowGL::resortCovers(QList<int> newOrder)
     loaded = loadedNew;
     marks = marksNew;
     images = imagesNew;
-
-    worker->unlock();
 }
 
 YACReaderPageFlowGL::YACReaderPageFlowGL(QWidget *parent, struct Preset p)
@@ -1350,6 +1392,7 @@ void YACReaderPageFlowGL::updateImageData()
             QString s = "cover";
             replace(s.toLocal8Bit().data(), texture, x, y, idx);
             loaded[idx] = true;
+            rawImages[idx].clear(); // the page data is not needed anymore, it can be released by the comic
         }
     }
 
@@ -1410,104 +1453,98 @@ void YACReaderPageFlowGL::populate(int n)
 //-----------------------------------------------------------------------------
 QImage ImageLoaderGL::loadImage(const QString &fileName)
 {
-    QImage image;
-
-    if (!image.load(fileName)) {
-        return QImage();
-    }
-
+    int width = 0;
     switch (flow->performance) {
     case low:
-        image = image.scaledToWidth(200, Qt::SmoothTransformation);
+        width = 200;
         break;
     case medium:
-        image = image.scaledToWidth(256, Qt::SmoothTransformation);
+        width = 256;
         break;
     case high:
-        image = image.scaledToWidth(320, Qt::SmoothTransformation);
+        width = 320;
         break;
     case ultraHigh:
         break; // no scaling in ultraHigh
     }
 
-    return image;
+    // covers are shared with the other flows and the grid views
+    return CoverImageCache::instance().load(fileName, width > 0 ? QSize(width, 0) : QSize());
 }
 
 ImageLoaderGL::ImageLoaderGL(YACReaderFlowGL *flow)
-    : QThread(), flow(flow), restart(false), working(false), idx(-1)
+    : flow(flow), activeWorkers(0), generation(0)
 {
+    pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount() / 2, 6));
 }
 
 ImageLoaderGL::~ImageLoaderGL()
 {
-    mutex.lock();
-    condition.wakeOne();
-    mutex.unlock();
-    wait();
+    reset();
+    pool.waitForDone();
 }
 
-bool ImageLoaderGL::busy() const
+void ImageLoaderGL::request(const QStringList &fileNames)
 {
-    return isRunning() ? working : false;
-}
+    QMutexLocker locker(&mutex);
 
-void ImageLoaderGL::generate(int index, const QString &fileName)
-{
-    mutex.lock();
-    this->idx = index;
-    this->fileName = fileName;
-    this->size = size;
-    this->img = QImage();
-    mutex.unlock();
+    pending.clear();
+    for (const auto &fileName : fileNames) {
+        if (!decoding.contains(fileName)) {
+            pending << fileName;
+        }
+    }
+    for (const auto &result : std::as_const(results)) {
+        pending.removeOne(result.first);
+    }
 
-    if (!isRunning())
-        start();
-    else {
-        // already running, wake up whenever ready
-        restart = true;
-        condition.wakeOne();
+    while (activeWorkers < pool.maxThreadCount() && activeWorkers < pending.size()) {
+        activeWorkers++;
+        pool.start([this] { work(); });
     }
 }
 
-void ImageLoaderGL::lock()
+QList<QPair<QString, QImage>> ImageLoaderGL::takeResults(int max)
 {
-    mutex.lock();
+    QMutexLocker locker(&mutex);
+    QList<QPair<QString, QImage>> taken = results.mid(0, max);
+    results.erase(results.begin(), results.begin() + taken.size());
+    return taken;
 }
 
-void ImageLoaderGL::unlock()
+void ImageLoaderGL::reset()
 {
-    mutex.unlock();
+    QMutexLocker locker(&mutex);
+    pending.clear();
+    results.clear();
+    decoding.clear();
+    generation++;
 }
 
-void ImageLoaderGL::run()
+void ImageLoaderGL::work()
 {
-    for (;;) {
-        // copy necessary data
-        mutex.lock();
-        this->working = true;
-        QString fileName = this->fileName;
-        mutex.unlock();
+    QMutexLocker locker(&mutex);
+    while (!pending.isEmpty()) {
+        QString fileName = pending.takeFirst();
+        decoding.insert(fileName);
+        quint64 requestGeneration = generation;
+        locker.unlock();
 
         QImage image = loadImage(fileName);
 
-        // let everyone knows it is ready
-        mutex.lock();
-        this->working = false;
-        this->img = image;
-        mutex.unlock();
-
-        // put to sleep
-        mutex.lock();
-        if (!this->restart)
-            condition.wait(&mutex);
-        restart = false;
-        mutex.unlock();
+        locker.relock();
+        if (requestGeneration == generation) {
+            decoding.remove(fileName);
+            if (!image.isNull()) {
+                results.append(qMakePair(fileName, image));
+            }
+        }
     }
-}
+    activeWorkers--;
+    locker.unlock();
 
-QImage ImageLoaderGL::result()
-{
-    return img;
+    // the flow may be idle, wake it up to upload the new covers
+    QMetaObject::invokeMethod(flow, [flow = flow] { flow->startAnimationTimer(); }, Qt::QueuedConnection);
 }
 
 //-----------------------------------------------------------------------------
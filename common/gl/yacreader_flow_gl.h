@@ -46,6 +46,9 @@ struct YACReader3DImage {
 
     int index;
 
+    // last frame in which the cover was close to the center, used for evicting textures
+    quint64 lastUsed;
+
     YACReader3DVector current;
     YACReader3DVector animEnd;
 };
@@ -294,6 +297,7 @@ class YACReaderComicFlowGL : public YACReaderFlowGL
 {
 public:
     YACReaderComicFlowGL(QWidget *parent = 0, struct Preset p = defaultYACReaderFlowConfig);
+    ~YACReaderComicFlowGL();
     void setImagePaths(QStringList paths);
     void updateImageData();
     void remove(int item);
@@ -303,6 +307,11 @@ public:
 
 private:
     ImageLoaderGL *worker;
+    quint64 frame;
+    int texturesCount;
+
+    void uploadCover(int item, const QImage &image);
+    void evictTextures(int maxTextures);
 
 protected:
     QList<QString> paths;
@@ -324,40 +333,34 @@ private:
     ImageLoaderByteArrayGL *worker;
 };
 
-class ImageLoaderGL : public QThread
+// Decodes the covers of YACReaderComicFlowGL in a pool of threads.
+// The requests are prioritized by the flow (closest to the center first) and replaced every frame,
+// so the covers that scroll out of view before being decoded are skipped.
+class ImageLoaderGL
 {
 public:
     ImageLoaderGL(YACReaderFlowGL *flow);
     ~ImageLoaderGL();
-    // returns FALSE if worker is still busy and can't take the task
-    bool busy() const;
-    void generate(int index, const QString &fileName);
-    void reset()
-    {
-        idx = -1;
-        fileName = "";
-    }
-    int index() const { return idx; }
-    void lock();
-    void unlock();
-    QImage result();
+    // replaces the pending covers, fileNames are sorted by priority
+    void request(const QStringList &fileNames);
+    // covers decoded since the last call, up to max
+    QList<QPair<QString, QImage>> takeResults(int max);
+    // discards the pending covers and the results
+    void reset();
     YACReaderFlowGL *flow;
-    GLuint resultTexture;
     QImage loadImage(const QString &fileName);
 
-protected:
-    void run();
-
 private:
-    QMutex mutex;
-    QWaitCondition condition;
+    void work();
 
-    bool restart;
-    bool working;
-    int idx;
-    QString fileName;
-    QSize size;
-    QImage img;
+    QThreadPool pool;
+    QMutex mutex;
+    QStringList pending;
+    QSet<QString> decoding;
+    QList<QPair<QString, QImage>> results;
+    int activeWorkers;
+    // results of covers requested before a reset are discarded
+    quint64 generation;
 };
 
 class ImageLoaderByteArrayGL : public QThread
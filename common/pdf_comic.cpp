@@ -86,7 +86,7 @@ unsigned int PdfiumComic::numPages()
     }
 }
 
-QImage PdfiumComic::getPage(const int page)
+QImage PdfiumComic::getPage(const int page, const QSize &targetSize)
 {
     if (!doc) {
         return QImage();
@@ -105,9 +105,10 @@ QImage PdfiumComic::getPage(const int page)
         return QImage();
     }
 
-    // TODO: make target DPI configurable
-    QSize pagesize((FPDF_GetPageWidth(pdfpage) / 72) * 150,
-                   (FPDF_GetPageHeight(pdfpage) / 72) * 150);
+    QSizeF pointsSize(FPDF_GetPageWidth(pdfpage), FPDF_GetPageHeight(pdfpage));
+    double dpi = pdfRenderDpi(pointsSize, targetSize);
+    QSize pagesize((pointsSize.width() / 72) * dpi,
+                   (pointsSize.height() / 72) * dpi);
     // TODO: max render size too
     if (pagesize.width() > 3840 || pagesize.height() > 3840) {
         pagesize.scale(3840, 3840, Qt::KeepAspectRatio);
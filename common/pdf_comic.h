@@ -5,8 +5,20 @@
 #include <QImage>
 #include <QFile>
 #include <QMutex>
+#include <QSize>
 #include <QtGlobal>
 
+// Resolution needed to cover targetSize (in pixels) with a page of pageSize points,
+// 150 dpi is used when there is no target size (e.g. pages served to remote clients).
+inline double pdfRenderDpi(const QSizeF &pageSize, const QSize &targetSize)
+{
+    if (targetSize.isEmpty() || pageSize.isEmpty()) {
+        return 150;
+    }
+    double dpi = qMax(targetSize.width() * 72.0 / pageSize.width(), targetSize.height() * 72.0 / pageSize.height());
+    return qBound(72.0, dpi, 300.0);
+}
+
 #if defined Q_OS_MACOS && defined USE_PDFKIT
 class MacOSXPDFComic
 {
@@ -16,7 +28,7 @@ public:
     bool openComic(const QString &path);
     void closeComic();
     unsigned int numPages();
-    QImage getPage(const int page);
+    QImage getPage(const int page, const QSize &targetSize = QSize());
     // void releaseLastPageData();
 
 private:
@@ -35,7 +47,7 @@ public:
     bool openComic(const QString &path);
     void closeComic();
     unsigned int numPages();
-    QImage getPage(const int page);
+    QImage getPage(const int page, const QSize &targetSize = QSize());
 
 private:
     static int refcount;
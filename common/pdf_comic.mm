@@ -48,17 +48,19 @@ unsigned int MacOSXPDFComic::numPages()
     return (int)CGPDFDocumentGetNumberOfPages((CGPDFDocumentRef)document);
 }
 
-QImage MacOSXPDFComic::getPage(const int pageNum)
+QImage MacOSXPDFComic::getPage(const int pageNum, const QSize &targetSize)
 {
     CGPDFPageRef page = CGPDFDocumentGetPage((CGPDFDocumentRef)document, pageNum + 1);
     // Changed this line for the line above which is a generic line
     // CGPDFPageRef page = [self getPage:page_number];
 
     CGRect pageRect = CGPDFPageGetBoxRect(page, kCGPDFMediaBox);
-    int width = 1200;
 
     // NSLog(@"-----%f",pageRect.size.width);
-    CGFloat pdfScale = float(width) / pageRect.size.width;
+    CGFloat pdfScale = 1200.0 / pageRect.size.width;
+    if (!targetSize.isEmpty()) {
+        pdfScale = pdfRenderDpi(QSizeF(pageRect.size.width, pageRect.size.height), targetSize) / 72.0;
+    }
 
     pageRect.size = CGSizeMake(pageRect.size.width * pdfScale, pageRect.size.height * pdfScale);
     pageRect.origin = CGPointZero;
@@ -1,15 +1,27 @@
 #include "qnaturalsorting.h"
 
-#include <QCollator>
+const QCollator &naturalCollator(Qt::CaseSensitivity caseSensitivity)
+{
+    // QCollator instances can't be shared between threads
+    static thread_local const auto collators = [] {
+        std::pair<QCollator, QCollator> collators;
+        collators.first.setCaseSensitivity(Qt::CaseInsensitive);
+        collators.second.setCaseSensitivity(Qt::CaseSensitive);
+        for (auto collator : { &collators.first, &collators.second }) {
+            collator->setNumericMode(true);
+            collator->setIgnorePunctuation(false);
+        }
+        return collators;
+    }();
+
+    return caseSensitivity == Qt::CaseInsensitive ? collators.first : collators.second;
+}
 
 int naturalCompare(const QString &s1, const QString &s2, Qt::CaseSensitivity caseSensitivity)
 {
-    QCollator c;
-    c.setCaseSensitivity(caseSensitivity);
-    c.setNumericMode(true);
-    c.setIgnorePunctuation(false);
-    return c.compare(s1, s2);
+    return naturalCollator(caseSensitivity).compare(s1, s2);
 }
+
 bool naturalSortLessThanCS(const QString &left, const QString &right)
 {
     return (naturalCompare(left, right, Qt::CaseSensitive) < 0);
@@ -4,24 +4,69 @@
 #define __QNATURALSORTING_H
 
 #include <QString>
+#include <QStringList>
 #include <QFileInfo>
+#include <QCollator>
+#include <QCollatorSortKey>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "library_item.h"
 
+// collator used for natural sorting, there is one per thread and case sensitivity so it is created only once
+const QCollator &naturalCollator(Qt::CaseSensitivity caseSensitivity);
+
 int naturalCompare(const QString &s1, const QString &s2, Qt::CaseSensitivity caseSensitivity);
 bool naturalSortLessThanCS(const QString &left, const QString &right);
 bool naturalSortLessThanCI(const QString &left, const QString &right);
 bool naturalSortLessThanCIFileInfo(const QFileInfo &left, const QFileInfo &right);
 bool naturalSortLessThanCILibraryItem(LibraryItem *left, LibraryItem *right);
 
+// Sorts `items` by the natural order of `key(item)`. The collation sort key of each item is computed once,
+// so sorting only compares bytes instead of collating the strings again in every comparison.
+template<typename Container, typename KeyFunction>
+void naturalSort(Container &items, KeyFunction key, Qt::CaseSensitivity caseSensitivity = Qt::CaseInsensitive)
+{
+    const auto &collator = naturalCollator(caseSensitivity);
+#ifdef Q_OS_DARWIN
+    // QCollator::sortKey is not supported on Apple platforms
+    std::stable_sort(items.begin(), items.end(), [&](const auto &left, const auto &right) {
+        return collator.compare(key(left), key(right)) < 0;
+    });
+#else
+    std::vector<std::pair<QCollatorSortKey, int>> keys;
+    keys.reserve(items.size());
+    for (int i = 0; i < items.size(); i++) {
+        keys.emplace_back(collator.sortKey(key(items.at(i))), i);
+    }
+
+    std::stable_sort(keys.begin(), keys.end(), [](const auto &left, const auto &right) {
+        return left.first.compare(right.first) < 0;
+    });
+
+    Container sorted;
+    sorted.reserve(items.size());
+    for (const auto &sortKey : keys) {
+        sorted.append(items.at(sortKey.second));
+    }
+    items = sorted;
+#endif
+}
+
+inline void naturalSort(QList<QString> &strings, Qt::CaseSensitivity caseSensitivity = Qt::CaseInsensitive)
+{
+    naturalSort(strings, [](const QString &string) { return string; }, caseSensitivity);
+}
+
 /* TODO, update to use the issue number once the iOS client supports it
  * see DBHelper::getFolderComicsFromLibraryForReading
  * NOTE, use this only in the server side for now, this way of sorting just matchs what's used in the iOS client
  **/
-struct LibraryItemSorter {
-    bool operator()(const LibraryItem *a, const LibraryItem *b) const
-    {
-        return naturalSortLessThanCI(a->name, b->name);
-    }
-};
+inline void sortLibraryItems(QList<LibraryItem *> &items)
+{
+    naturalSort(items, [](const LibraryItem *item) { return item->name; });
+}
 
 #endif
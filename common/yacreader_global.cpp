@@ -1,6 +1,7 @@
 #include "yacreader_global.h"
 
 #include <QModelIndex>
+#include <QStorageInfo>
 
 using namespace YACReader;
 
@@ -9,6 +10,15 @@ QString YACReader::getSettingsPath()
     return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
 }
 
+bool YACReader::isNetworkFileSystem(const QString &path)
+{
+    static const QStringList networkFileSystems = { "nfs", "nfs4", "cifs", "smbfs", "smb2", "smb3", "afpfs", "webdav", "davfs", "ncpfs", "afs", "9p", "ceph", "glusterfs", "fuse.sshfs", "fuse.rclone" };
+
+    QStorageInfo storage(path);
+    auto device = QString::fromLocal8Bit(storage.device());
+    return networkFileSystems.contains(QString::fromLatin1(storage.fileSystemType()).toLower()) || device.startsWith("//") || device.startsWith("\\\\");
+}
+
 QString YACReader::colorToName(LabelColors colors)
 {
     switch (colors) {
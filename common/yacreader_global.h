@@ -10,7 +10,7 @@
 
 // Used to check if the database needs to be updated, the version is stored in the database.
 // This value is only incremented when the database structure changes.
-#define DB_VERSION "9.14.0"
+#define DB_VERSION "9.16.0"
 
 #define IMPORT_COMIC_INFO_XML_METADATA "IMPORT_COMIC_INFO_XML_METADATA"
 #define COMPARE_MODIFIED_DATE_ON_LIBRARY_UPDATES "COMPARE_MODIFIED_DATE_ON_LIBRARY_UPDATES"
@@ -24,6 +24,28 @@
 #define NUM_DAYS_BETWEEN_VERSION_CHECKS "NUM_DAYS_BETWEEN_VERSION_CHECKS"
 #define LAST_VERSION_CHECK "LAST_VERSION_CHECK"
 
+// MB of compressed page data kept in memory for an open comic, pages far from the current one are extracted again when needed
+#define PAGES_MEMORY_BUDGET "PAGES_MEMORY_BUDGET"
+
+// the reader keeps the pages where the last comics were left in a disk cache of PAGES_DISK_CACHE_SIZE MB to show them right away when they are reopened
+#define PAGES_DISK_CACHE "PAGES_DISK_CACHE"
+#define PAGES_DISK_CACHE_SIZE "PAGES_DISK_CACHE_SIZE"
+
+// once PREFETCH_NEXT_COMIC_AT % of a comic has been read (0 disables it) the reader starts extracting the next one, keeping up to PREFETCH_NEXT_COMIC_SIZE MB of its first pages
+#define PREFETCH_NEXT_COMIC_AT "PREFETCH_NEXT_COMIC_AT"
+#define PREFETCH_NEXT_COMIC_SIZE "PREFETCH_NEXT_COMIC_SIZE"
+
+// MB of pages kept in memory by the server, shared by all the comics opened by the clients
+#define PAGES_CACHE_SIZE "PAGES_CACHE_SIZE"
+
+// MB of cover files kept in memory by the server
+#define COVERS_MEMORY_CACHE "COVERS_MEMORY_CACHE"
+
+// tuning of the database connections kept open by the server threads
+#define DB_WAL_JOURNAL "DB_WAL_JOURNAL"
+#define DB_CACHE_SIZE "DB_CACHE_SIZE"
+#define DB_MMAP_SIZE "DB_MMAP_SIZE"
+
 #define YACREADERLIBRARY_GUID "ea343ff3-2005-4865-b212-7fa7c43999b8"
 
 #define LIBRARIES "LIBRARIES"
@@ -98,6 +120,8 @@ QDataStream &operator<<(QDataStream &stream, const OpenComicSource &source);
 QDataStream &operator>>(QDataStream &stream, OpenComicSource &source);
 
 QString getSettingsPath();
+// other machines can change these file systems without notice and they don't support shared memory (SQLite WAL)
+bool isNetworkFileSystem(const QString &path);
 QString colorToName(LabelColors colors);
 QString labelColorToRGBString(LabelColors color);
 
@@ -0,0 +1,134 @@
+#include "archive_index.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <atomic>
+#include <utility>
+
+namespace {
+const quint32 indexMagic = 0x59414958; // YAIX
+const quint32 indexVersion = 2;
+
+const qint64 maxIndexesSize = 64 * 1024 * 1024;
+const int maxIndexAgeDays = 180;
+// the folder is checked with the first save and then every `pruneInterval` saves, a library scan saves one index per comic
+const int pruneInterval = 256;
+std::atomic<int> savesSincePrune(pruneInterval);
+}
+
+QString ArchiveIndex::indexesFolder()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/archive_index";
+}
+
+QString ArchiveIndex::indexPath(const QString &archivePath)
+{
+    auto key = QCryptographicHash::hash(QFileInfo(archivePath).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return indexesFolder() + "/" + key;
+}
+
+// the modification time of an index is the last time it was used, the oldest ones are removed first
+void ArchiveIndex::prune()
+{
+    const auto indexes = QDir(indexesFolder()).entryInfoList(QDir::Files, QDir::Time);
+    auto now = QDateTime::currentDateTime();
+    qint64 totalSize = 0;
+    for (const auto &index : indexes) {
+        if (index.fileName().size() != 40) {
+            continue; // not an index (e.g. a QSaveFile being written)
+        }
+        totalSize += index.size();
+        if (totalSize > maxIndexesSize || index.lastModified().daysTo(now) > maxIndexAgeDays) {
+            QFile::remove(index.absoluteFilePath());
+        }
+    }
+}
+
+bool ArchiveIndex::load(const QString &archivePath)
+{
+    QFileInfo archive(archivePath);
+    QFile file(indexPath(archivePath));
+    if (!archive.exists() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    quint32 magic, version;
+    qint64 archiveSize, archiveModified;
+    stream >> magic >> version >> archiveSize >> archiveModified;
+    if (magic != indexMagic || version != indexVersion || archiveSize != archive.size() || archiveModified != archive.lastModified().toMSecsSinceEpoch()) {
+        return false;
+    }
+
+    quint32 count;
+    stream >> count;
+    QVector<Entry> loadedEntries;
+    loadedEntries.reserve(count);
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        Entry entry;
+        stream >> entry.name >> entry.location >> entry.size >> entry.block;
+        loadedEntries.append(entry);
+    }
+    QVector<int> loadedPageOrder;
+    quint32 loadedPageOrderVersion;
+    stream >> loadedPageOrder >> loadedPageOrderVersion;
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    for (int position : std::as_const(loadedPageOrder)) {
+        if (position < 0 || position >= loadedEntries.size()) {
+            return false;
+        }
+    }
+
+    entries = loadedEntries;
+    pageOrder = loadedPageOrder;
+    pageOrderVersion = loadedPageOrderVersion;
+
+    // the index has been used, prune() keeps it over the older ones
+    file.close();
+    if (file.open(QIODevice::Append)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+    return true;
+}
+
+bool ArchiveIndex::save(const QString &archivePath) const
+{
+    QFileInfo archive(archivePath);
+    auto path = indexPath(archivePath);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!archive.exists() || !file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << indexMagic << indexVersion << qint64(archive.size()) << qint64(archive.lastModified().toMSecsSinceEpoch());
+    stream << quint32(entries.size());
+    for (const auto &entry : entries) {
+        stream << entry.name << entry.location << entry.size << entry.block;
+    }
+    stream << pageOrder << pageOrderVersion;
+
+    if (!file.commit()) {
+        return false;
+    }
+
+    if (++savesSincePrune >= pruneInterval) {
+        savesSincePrune = 0;
+        prune();
+    }
+    return true;
+}
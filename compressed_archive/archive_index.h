@@ -0,0 +1,41 @@
+#ifndef ARCHIVE_INDEX_H
+#define ARCHIVE_INDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QDateTime>
+
+// List of the files in an archive as found by a CompressedArchive backend. It is persisted in the
+// cache folder so archives that have already been opened don't need to be listed again.
+// The index is only valid while the archive keeps the same size and modification time.
+// The cache folder is bounded: the least recently used indexes are removed once it grows too big
+// (indexes of archives that have been deleted or moved are never used again).
+class ArchiveIndex
+{
+public:
+    struct Entry {
+        QString name;
+        qint64 location; // what the backend needs to find the entry (item index, header offset...)
+        qint64 size; // uncompressed size, -1 if unknown
+        qint32 block; // solid block the entry belongs to, -1 if the archive is not solid or it is unknown
+    };
+
+    QVector<Entry> entries;
+    // positions in `entries` of the pages in reading order, empty until a comic sets it
+    QVector<int> pageOrder;
+    // version of the filtering and sorting of the pages that produced pageOrder, a comic ignores orders from other versions
+    quint32 pageOrderVersion = 0;
+
+    bool isEmpty() const { return entries.isEmpty(); }
+
+    // loads the index of `archivePath`, returns false if there isn't one or if the archive has changed
+    bool load(const QString &archivePath);
+    bool save(const QString &archivePath) const;
+
+private:
+    static QString indexesFolder();
+    static QString indexPath(const QString &archivePath);
+    static void prune();
+};
+
+#endif // ARCHIVE_INDEX_H
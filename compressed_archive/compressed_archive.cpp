@@ -78,7 +78,7 @@ const unsigned char tar[6] = "ustar";
 const unsigned char arj[2] = { static_cast<unsigned char>(0x60), static_cast<unsigned char>(0xEA) };
 
 CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
-    : QObject(parent), sevenzLib(0), valid(false), tools(false)
+    : QObject(parent), sevenzLib(0), tools(false), valid(false), filePath(filePath)
 {
     szInterface = new SevenZipInterface;
     // load functions
@@ -214,30 +214,53 @@ bool CompressedArchive::loadFunctions()
 
 void CompressedArchive::setupFilesNames()
 {
-    quint32 numItems = getNumEntries();
-    quint32 p = 0;
-    for (quint32 i = 0; i < numItems; i++) {
-
-        // Get name of file
-        NWindows::NCOM::CPropVariant prop;
-        szInterface->archive->GetProperty(i, kpidIsDir, &prop);
-        bool isDir;
-        if (prop.vt == VT_BOOL)
-            isDir = VARIANT_BOOLToBool(prop.boolVal);
-        else if (prop.vt == VT_EMPTY)
-            isDir = false;
-        else
-            continue;
-
-        if (!isDir) {
-            szInterface->archive->GetProperty(i, kpidPath, &prop);
-            UString s = prop.bstrVal;
-            const wchar_t *chars = s.operator const wchar_t *();
-            files.append(QString::fromWCharArray(chars));
-            offsets.append(i);
-            indexesToPages.insert(i, p);
-            p++;
+    if (!archiveIndex.load(filePath)) {
+        archiveIndex = ArchiveIndex();
+
+        quint32 numItems = getNumEntries();
+        for (quint32 i = 0; i < numItems; i++) {
+
+            // Get name of file
+            NWindows::NCOM::CPropVariant prop;
+            szInterface->archive->GetProperty(i, kpidIsDir, &prop);
+            bool isDir;
+            if (prop.vt == VT_BOOL)
+                isDir = VARIANT_BOOLToBool(prop.boolVal);
+            else if (prop.vt == VT_EMPTY)
+                isDir = false;
+            else
+                continue;
+
+            if (!isDir) {
+                ArchiveIndex::Entry entry;
+                szInterface->archive->GetProperty(i, kpidPath, &prop);
+                UString s = prop.bstrVal;
+                const wchar_t *chars = s.operator const wchar_t *();
+                entry.name = QString::fromWCharArray(chars);
+                entry.location = i;
+
+                NWindows::NCOM::CPropVariant sizeProp;
+                UInt64 size;
+                szInterface->archive->GetProperty(i, kpidSize, &sizeProp);
+                entry.size = (sizeProp.vt != VT_EMPTY && ConvertPropVariantToUInt64(sizeProp, size)) ? qint64(size) : -1;
+
+                // only 7z archives report the block (folder) of each item
+                NWindows::NCOM::CPropVariant blockProp;
+                szInterface->archive->GetProperty(i, kpidBlock, &blockProp);
+                entry.block = blockProp.vt == VT_UI4 ? qint32(blockProp.ulVal) : -1;
+
+                archiveIndex.entries.append(entry);
+            }
         }
+
+        archiveIndex.save(filePath);
+    }
+
+    for (int p = 0; p < archiveIndex.entries.size(); p++) {
+        const auto &entry = archiveIndex.entries.at(p);
+        files.append(entry.name);
+        offsets.append(qint32(entry.location));
+        indexesToPages.insert(qint32(entry.location), p);
     }
 }
 
@@ -301,8 +324,65 @@ QList<QByteArray> CompressedArchive::getAllData(const QVector<quint32> &indexes,
     return extractCallbackSpec->allFiles;
 }
 
+qint64 CompressedArchive::getFileSize(int index)
+{
+    if (index < 0 || index >= archiveIndex.entries.size())
+        return -1;
+    return archiveIndex.entries.at(index).size;
+}
+
+int CompressedArchive::getSolidBlock(int index)
+{
+    if (index < 0 || index >= archiveIndex.entries.size())
+        return -1;
+    return archiveIndex.entries.at(index).block;
+}
+
+bool CompressedArchive::extract(int index, char *buffer, qint64 size)
+{
+    if (index < 0 || index >= getNumFiles() || size < 0)
+        return false;
+
+    YCArchiveExtractCallback *extractCallbackSpec = new YCArchiveExtractCallback(indexesToPages);
+    CMyComPtr<IArchiveExtractCallback> extractCallback(extractCallbackSpec);
+    extractCallbackSpec->Init(szInterface->archive, L""); // second parameter is output folder path
+    extractCallbackSpec->PasswordIsDefined = false;
+    extractCallbackSpec->outBuffer = reinterpret_cast<Byte *>(buffer);
+    extractCallbackSpec->outBufferSize = size;
+
+    UInt32 indices[1] = { UInt32(offsets.at(index)) };
+    HRESULT result = szInterface->archive->Extract(indices, 1, false, extractCallback);
+    if (result != S_OK) {
+        qDebug() << "Extract Error" << Qt::endl;
+    }
+
+    // a smaller entry than declared would leave part of the buffer uninitialized
+    return result == S_OK && extractCallbackSpec->extracted && extractCallbackSpec->outBufferWritten() == UInt64(size);
+}
+
+QVector<int> CompressedArchive::getPageOrder(quint32 version)
+{
+    return archiveIndex.pageOrderVersion == version ? archiveIndex.pageOrder : QVector<int>();
+}
+
+void CompressedArchive::setPageOrder(const QVector<int> &order, quint32 version)
+{
+    if (!valid || (archiveIndex.pageOrder == order && archiveIndex.pageOrderVersion == version))
+        return;
+
+    archiveIndex.pageOrder = order;
+    archiveIndex.pageOrderVersion = version;
+    archiveIndex.save(filePath);
+}
+
 QByteArray CompressedArchive::getRawDataAtIndex(int index)
 {
+    qint64 size = getFileSize(index);
+    if (size >= 0) {
+        QByteArray data(size, Qt::Uninitialized);
+        return extract(index, data.data(), size) ? data : QByteArray();
+    }
+
     if (index >= 0 && index < getNumFiles()) {
         YCArchiveExtractCallback *extractCallbackSpec = new YCArchiveExtractCallback(indexesToPages);
         CMyComPtr<IArchiveExtractCallback> extractCallback(extractCallbackSpec);
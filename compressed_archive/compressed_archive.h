@@ -9,6 +9,9 @@ class QLibrary;
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QVector>
+
+#include "archive_index.h"
 
 struct SevenZipInterface;
 
@@ -32,6 +35,17 @@ public slots:
     bool isValid();
     bool toolsLoaded();
 
+    // uncompressed size of a file, -1 if it is unknown
+    qint64 getFileSize(int index);
+    // solid block that contains a file, -1 if the archive is not solid or its format doesn't report blocks (only 7z does, solid RAR files are -1)
+    int getSolidBlock(int index);
+    // decompresses a file straight into `buffer`, it must be getFileSize(index) bytes long
+    bool extract(int index, char *buffer, qint64 size);
+    // order of the pages saved with the archive index, it is empty until setPageOrder is called for this archive
+    // with the same `version` (see FileComic::process)
+    QVector<int> getPageOrder(quint32 version);
+    void setPageOrder(const QVector<int> &order, quint32 version);
+
 private:
     SevenZipInterface *szInterface;
 
@@ -42,6 +56,8 @@ private:
     QList<QString> files;
     QList<qint32> offsets;
     QMap<qint32, qint32> indexesToPages;
+    QString filePath;
+    ArchiveIndex archiveIndex;
 
     void setupFilesNames();
     QVector<quint32> translateIndexes(const QVector<quint32> &indexes);
@@ -67,6 +67,10 @@ private:
     COutFileStream *_outFileStreamSpec;
     CMyComPtr<ISequentialOutStream> _outFileStream;
 
+    // kept alive after the archive releases it to know how much was written
+    CBufPtrSeqOutStream *outBufferStreamSpec;
+    CMyComPtr<ISequentialOutStream> outBufferStream;
+
 public:
     void Init(IInArchive *archiveHandler, const UString &directoryPath);
 
@@ -77,9 +81,15 @@ public:
     Byte *data;
     UInt64 newFileSize;
     QMap<qint32, qint32> indexesToPages;
+    // when set, the file is decompressed here instead of in `data`
+    Byte *outBuffer;
+    UInt64 outBufferSize;
+    bool extracted;
+    // bytes written in `outBuffer`
+    UInt64 outBufferWritten() const { return outBufferStreamSpec != 0 ? outBufferStreamSpec->GetPos() : 0; }
 
     YCArchiveExtractCallback(const QMap<qint32, qint32> &indexesToPages, bool c = false, ExtractDelegate *d = 0)
-        : PasswordIsDefined(false), all(c), delegate(d), indexesToPages(indexesToPages) { }
+        : PasswordIsDefined(false), all(c), delegate(d), data(0), newFileSize(0), indexesToPages(indexesToPages), outBuffer(0), outBufferSize(0), extracted(false), outBufferStreamSpec(0) { }
     ~YCArchiveExtractCallback() { MidFree(data); }
 };
 
@@ -200,7 +210,13 @@ Z7_COM7F_IMF(YCArchiveExtractCallback::GetStream(UInt32 index,
       return E_ABORT;
       }
       }*/
-        if (newFileSizeDefined) {
+        if (outBuffer != 0) {
+            outBufferStreamSpec = new CBufPtrSeqOutStream;
+            outBufferStream = outBufferStreamSpec;
+            outBufferStreamSpec->Init(outBuffer, outBufferSize);
+            CMyComPtr<ISequentialOutStream> outStreamLocal(outBufferStream);
+            *outStream = outStreamLocal.Detach();
+        } else if (newFileSizeDefined) {
             CBufPtrSeqOutStream *outStreamSpec = new CBufPtrSeqOutStream;
             CMyComPtr<ISequentialOutStream> outStreamLocal(outStreamSpec);
             data = (Byte *)MidAlloc(newFileSize);
@@ -234,6 +250,7 @@ Z7_COM7F_IMF(YCArchiveExtractCallback::SetOperationResult(Int32 operationResult)
 {
     switch (operationResult) {
     case NArchive::NExtract::NOperationResult::kOK:
+        extracted = true;
         if (all && !_processedFileInfo.isDir) {
             QByteArray rawData((char *)data, newFileSize);
             MidFree(data);
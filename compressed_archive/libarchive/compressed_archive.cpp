@@ -5,6 +5,16 @@
 CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
     : QObject(parent), a(nullptr), num_entries(0), valid(false), idx(0), filename(filePath)
 {
+    // listing the archive reads it from the start to the end, it is skipped if the archive has been indexed before
+    if (archiveIndex.load(filename)) {
+        for (const auto &entry : archiveIndex.entries) {
+            entries.append(entry.name);
+        }
+        num_entries = entries.size();
+        valid = num_entries > 0;
+        return;
+    }
+
     if (!open_archive()) {
         qWarning() << "error opening archive:" << filename;
         return;
@@ -14,6 +24,8 @@ CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
     int result;
     while ((result = archive_read_next_header(a, &entry)) == ARCHIVE_OK) {
         entries.append(archive_entry_pathname(entry));
+        qint64 size = archive_entry_size_is_set(entry) ? archive_entry_size(entry) : -1;
+        archiveIndex.entries.append({ entries.last(), idx, size, -1 });
         archive_read_data_skip(a);
         idx++;
     }
@@ -28,6 +40,7 @@ CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
     } else {
         qDebug() << "# of pages in archive:" << num_entries;
         valid = true;
+        archiveIndex.save(filename);
     }
 
     close_archive();
@@ -69,6 +82,11 @@ void CompressedArchive::close_archive()
 
 bool CompressedArchive::archive_seek(quint32 index)
 {
+    // the archive is closed after listing it, or never opened if it was indexed before
+    if (a == nullptr && !open_archive()) {
+        return false;
+    }
+
     if (idx == index) {
         return true;
     }
@@ -143,8 +161,58 @@ QByteArray CompressedArchive::read_entry()
     return bytes;
 }
 
+qint64 CompressedArchive::getFileSize(int index)
+{
+    if (index < 0 || index >= archiveIndex.entries.size())
+        return -1;
+    return archiveIndex.entries.at(index).size;
+}
+
+int CompressedArchive::getSolidBlock(int index)
+{
+    Q_UNUSED(index)
+    // libarchive reads the archives as a stream, the solid blocks are not exposed
+    return -1;
+}
+
+bool CompressedArchive::extract(int index, char *buffer, qint64 size)
+{
+    if (index < 0 || index >= num_entries || size < 0)
+        return false;
+
+    if (!archive_seek(index))
+        return false;
+
+    archive_entry *entry;
+    bool extracted = false;
+    if (archive_read_next_header(a, &entry) == ARCHIVE_OK) {
+        extracted = archive_read_data(a, buffer, size) == size;
+    } else {
+        qWarning() << archive_error("error reading entry");
+    }
+
+    idx++;
+    return extracted;
+}
+
+void CompressedArchive::setPageOrder(const QVector<int> &order, quint32 version)
+{
+    if (!valid || (archiveIndex.pageOrder == order && archiveIndex.pageOrderVersion == version))
+        return;
+
+    archiveIndex.pageOrder = order;
+    archiveIndex.pageOrderVersion = version;
+    archiveIndex.save(filename);
+}
+
 QByteArray CompressedArchive::getRawDataAtIndex(int index)
 {
+    qint64 size = getFileSize(index);
+    if (size >= 0) {
+        QByteArray bytes(size, Qt::Uninitialized);
+        return extract(index, bytes.data(), size) ? bytes : QByteArray();
+    }
+
     QByteArray bytes;
     if (archive_seek(index)) {
         bytes = read_entry();
@@ -2,6 +2,7 @@
 #define COMPRESSED_ARCHIVE_H
 
 #include "extract_delegate.h"
+#include "../archive_index.h"
 
 #include <QObject>
 #include <QDebug>
@@ -27,6 +28,17 @@ public slots:
     bool isValid() { return valid; }
     bool toolsLoaded() { return true; }
 
+    // uncompressed size of a file, -1 if it is unknown
+    qint64 getFileSize(int index);
+    // solid block that contains a file, -1 if the archive is not solid
+    int getSolidBlock(int index);
+    // decompresses a file straight into `buffer`, it must be getFileSize(index) bytes long
+    bool extract(int index, char *buffer, qint64 size);
+    // order of the pages saved with the archive index, it is empty until setPageOrder is called for this archive
+    // with the same `version` (see FileComic::process)
+    QVector<int> getPageOrder(quint32 version) { return archiveIndex.pageOrderVersion == version ? archiveIndex.pageOrder : QVector<int>(); }
+    void setPageOrder(const QVector<int> &order, quint32 version);
+
 private:
     archive *a;
     QStringList entries;
@@ -34,6 +46,7 @@ private:
     bool valid;
     quint32 idx;
     QString filename;
+    ArchiveIndex archiveIndex;
 
     bool open_archive();
     void close_archive();
@@ -2,9 +2,11 @@ INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD
 
 HEADERS += $$PWD/extract_delegate.h \
-           $$PWD/compressed_archive.h
+           $$PWD/compressed_archive.h \
+           $$PWD/../archive_index.h
 
-SOURCES += $$PWD/compressed_archive.cpp
+SOURCES += $$PWD/compressed_archive.cpp \
+           $$PWD/../archive_index.cpp
 
 if(mingw|unix):!macx:!contains(QT_CONFIG, no-pkg-config):packagesExist(libarchive) {
   message(Using system provided libarchive installation found by pkg-config.)
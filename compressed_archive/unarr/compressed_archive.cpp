@@ -7,7 +7,7 @@
 #include <unarr.h>
 
 CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
-    : QObject(parent), tools(true), valid(false), numFiles(0), ar(NULL), stream(NULL)
+    : QObject(parent), tools(true), valid(false), numFiles(0), ar(NULL), stream(NULL), filePath(filePath)
 {
     // open file
 #ifdef Q_OS_WIN
@@ -33,20 +33,30 @@ CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
         return;
     }
 
-    // initial parse
-    while (ar_parse_entry(ar)) {
-        // make sure we really got a file header
-        if (ar_entry_get_size(ar) > 0) {
-            fileNames.append(ar_entry_get_name(ar));
-            offsets.append(ar_entry_get_offset(ar));
-            numFiles++;
+    // the initial parse reads every header in the archive, it is skipped if the archive has been indexed before
+    if (!archiveIndex.load(filePath)) {
+        archiveIndex = ArchiveIndex();
+        while (ar_parse_entry(ar)) {
+            // make sure we really got a file header
+            if (ar_entry_get_size(ar) > 0) {
+                archiveIndex.entries.append({ ar_entry_get_name(ar), ar_entry_get_offset(ar), qint64(ar_entry_get_size(ar)), -1 });
+            }
+        }
+        if (!ar_at_eof(ar)) {
+            // fail if the initial parse didn't reach EOF
+            // this might be a bit too drastic
+            qDebug() << "Error while parsing archive";
+            return;
+        }
+        if (!archiveIndex.isEmpty()) {
+            archiveIndex.save(filePath);
         }
     }
-    if (!ar_at_eof(ar)) {
-        // fail if the initial parse didn't reach EOF
-        // this might be a bit too drastic
-        qDebug() << "Error while parsing archive";
-        return;
+
+    for (const auto &entry : archiveIndex.entries) {
+        fileNames.append(entry.name);
+        offsets.append(entry.location);
+        numFiles++;
     }
     if (numFiles > 0) {
         valid = true;
@@ -94,9 +104,8 @@ void CompressedArchive::getAllData(const QVector<quint32> &indexes, ExtractDeleg
         }
 
         // use the offset list so we generated so we're not getting any non-page files
-        ar_parse_entry_at(ar, offsets.at(indexes.at(i))); // set ar_entry to start of indexes
-        buffer.resize(ar_entry_get_size(ar));
-        if (ar_entry_uncompress(ar, buffer.data(), buffer.size())) // did we extract it?
+        buffer.resize(qMax<qint64>(0, getFileSize(indexes.at(i))));
+        if (extract(indexes.at(i), buffer.data(), buffer.size())) // did we extract it?
         {
             delegate->fileExtracted(indexes.at(i), buffer); // return extracted file
         } else {
@@ -109,10 +118,10 @@ void CompressedArchive::getAllData(const QVector<quint32> &indexes, ExtractDeleg
 QByteArray CompressedArchive::getRawDataAtIndex(int index)
 {
     QByteArray buffer;
-    if (index >= 0 && index < getNumFiles()) {
-        ar_parse_entry_at(ar, offsets.at(index));
-        buffer.resize(ar_entry_get_size(ar));
-        if (ar_entry_uncompress(ar, buffer.data(), buffer.size())) {
+    qint64 size = getFileSize(index);
+    if (size >= 0) {
+        buffer.resize(size);
+        if (extract(index, buffer.data(), buffer.size())) {
             return buffer;
         } else {
             return QByteArray();
@@ -120,3 +129,43 @@ QByteArray CompressedArchive::getRawDataAtIndex(int index)
     }
     return buffer;
 }
+
+qint64 CompressedArchive::getFileSize(int index)
+{
+    if (index < 0 || index >= archiveIndex.entries.size())
+        return -1;
+    return archiveIndex.entries.at(index).size;
+}
+
+int CompressedArchive::getSolidBlock(int index)
+{
+    Q_UNUSED(index)
+    // unarr doesn't expose the solid blocks
+    return -1;
+}
+
+bool CompressedArchive::extract(int index, char *buffer, qint64 size)
+{
+    if (index < 0 || index >= getNumFiles() || size < 0)
+        return false;
+
+    if (!ar_parse_entry_at(ar, offsets.at(index)))
+        return false;
+
+    return size == qint64(ar_entry_get_size(ar)) && ar_entry_uncompress(ar, buffer, size);
+}
+
+QVector<int> CompressedArchive::getPageOrder(quint32 version)
+{
+    return archiveIndex.pageOrderVersion == version ? archiveIndex.pageOrder : QVector<int>();
+}
+
+void CompressedArchive::setPageOrder(const QVector<int> &order, quint32 version)
+{
+    if (!valid || (archiveIndex.pageOrder == order && archiveIndex.pageOrderVersion == version))
+        return;
+
+    archiveIndex.pageOrder = order;
+    archiveIndex.pageOrderVersion = version;
+    archiveIndex.save(filePath);
+}
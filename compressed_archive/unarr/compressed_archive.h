@@ -2,7 +2,9 @@
 #define COMPRESSED_ARCHIVE_H
 
 #include <QObject>
+#include <QVector>
 #include "extract_delegate.h"
+#include "../archive_index.h"
 extern "C" {
 #include <unarr.h>
 }
@@ -24,6 +26,17 @@ public slots:
     bool isValid();
     bool toolsLoaded();
 
+    // uncompressed size of a file, -1 if it is unknown
+    qint64 getFileSize(int index);
+    // solid block that contains a file, -1 if the archive is not solid
+    int getSolidBlock(int index);
+    // decompresses a file straight into `buffer`, it must be getFileSize(index) bytes long
+    bool extract(int index, char *buffer, qint64 size);
+    // order of the pages saved with the archive index, it is empty until setPageOrder is called for this archive
+    // with the same `version` (see FileComic::process)
+    QVector<int> getPageOrder(quint32 version);
+    void setPageOrder(const QVector<int> &order, quint32 version);
+
 private:
     bool tools;
     bool valid;
@@ -32,6 +45,8 @@ private:
     ar_archive *ar;
     ar_stream *stream;
     QList<qint64> offsets;
+    QString filePath;
+    ArchiveIndex archiveIndex;
 };
 
 #endif // COMPRESSED_ARCHIVE_H
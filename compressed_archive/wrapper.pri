@@ -13,6 +13,7 @@ INCLUDEPATH += \
 
 SOURCES += \
     $$PWD/compressed_archive.cpp \
+    $$PWD/archive_index.cpp \
     $$PWD/lib7zip/CPP/Windows/FileIO.cpp \
     $$PWD/lib7zip/CPP/Windows/PropVariant.cpp \
     $$PWD/lib7zip/CPP/Windows/PropVariantConv.cpp \
@@ -40,6 +41,7 @@ SOURCES += \
 HEADERS += \
     $$PWD/lib7zip/CPP/Common/Common.h \
     $$PWD/compressed_archive.h \
+    $$PWD/archive_index.h \
     $$PWD/extract_delegate.h \
     $$PWD/7z_includes.h \
     $$PWD/open_callbacks.h \
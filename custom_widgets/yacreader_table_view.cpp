@@ -15,7 +15,6 @@
 
 #include "QsLog.h"
 
-#include "comic_item.h"
 #include "comic_model.h"
 
 YACReaderTableView::YACReaderTableView(QWidget *parent)
@@ -243,7 +242,7 @@ void YACReaderTableView::resizeEvent(QResizeEvent *event)
 void YACReaderRatingDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
                                     const QModelIndex &index) const
 {
-    int rating = ((ComicItem *)index.internalPointer())->data(ComicModel::Rating).toInt();
+    int rating = index.data(ComicModel::RatingRole).toInt();
 
     StarRating starRating(rating);
 
@@ -263,7 +262,7 @@ QSize YACReaderRatingDelegate::sizeHint(const QStyleOptionViewItem &option,
                                         const QModelIndex &index) const
 {
     Q_UNUSED(option)
-    int rating = ((ComicItem *)index.internalPointer())->data(ComicModel::Rating).toInt();
+    int rating = index.data(ComicModel::RatingRole).toInt();
     StarRating starRating(rating);
     return starRating.sizeHint();
 }
@@ -285,7 +284,7 @@ QWidget *YACReaderRatingDelegate::createEditor(QWidget *parent,
 void YACReaderRatingDelegate::setEditorData(QWidget *editor,
                                             const QModelIndex &index) const
 {
-    int rating = ((ComicItem *)index.internalPointer())->data(11).toInt();
+    int rating = index.data(ComicModel::RatingRole).toInt();
 
     StarRating starRating(rating);
 
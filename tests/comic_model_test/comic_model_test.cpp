@@ -0,0 +1,118 @@
+#include "comic_model.h"
+#include "data_base_management.h"
+#include "yacreader_comics_selection_helper.h"
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QVariantList>
+
+//! Checks that the views of ComicModel see every comic of big lists, the actions on the selection
+//! (select all, mark as read, delete, add to a list...) work with the rows the views know about.
+class ComicModelTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void rowCount();
+    void selectAll();
+    void indexFromId();
+
+private:
+    QTemporaryDir libraryDir;
+    QString databasePath;
+    ComicModel *model = nullptr;
+};
+
+namespace {
+const qulonglong folderId = 2;
+const int numComics = 2500; // more than the rows a view asks for at once
+}
+
+void ComicModelTest::initTestCase()
+{
+    QVERIFY(libraryDir.isValid());
+    databasePath = libraryDir.path();
+
+    QString connectionName;
+    {
+        QSqlDatabase db = DataBaseManagement::createDatabase("library", databasePath);
+        QVERIFY2(db.isOpen(), qPrintable(db.lastError().text()));
+        QVERIFY(db.transaction());
+
+        QSqlQuery folderQuery(db);
+        QVERIFY(folderQuery.exec(QString("INSERT INTO folder (id, parentId, name, path) VALUES (%1, 1, 'Folder', '/Folder')").arg(folderId)));
+
+        QVariantList infoIds, hashes, comicIds, parentIds, fileNames, paths;
+        for (int id = 1; id <= numComics; id++) {
+            infoIds << id;
+            hashes << QString("%1%2").arg(id, 40, 16, QChar('0')).arg(id * 1000);
+            comicIds << id;
+            parentIds << folderId;
+            fileNames << QString("Comic %1.cbz").arg(id);
+            paths << QString("/Folder/Comic %1.cbz").arg(id);
+        }
+
+        QSqlQuery infoQuery(db);
+        infoQuery.prepare("INSERT INTO comic_info (id, hash) VALUES (?, ?)");
+        infoQuery.addBindValue(infoIds);
+        infoQuery.addBindValue(hashes);
+        QVERIFY2(infoQuery.execBatch(), qPrintable(infoQuery.lastError().text()));
+
+        QSqlQuery comicQuery(db);
+        comicQuery.prepare("INSERT INTO comic (id, parentId, comicInfoId, fileName, path) VALUES (?, ?, ?, ?, ?)");
+        comicQuery.addBindValue(comicIds);
+        comicQuery.addBindValue(parentIds);
+        comicQuery.addBindValue(infoIds);
+        comicQuery.addBindValue(fileNames);
+        comicQuery.addBindValue(paths);
+        QVERIFY2(comicQuery.execBatch(), qPrintable(comicQuery.lastError().text()));
+
+        QVERIFY(db.commit());
+        connectionName = db.connectionName();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    model = new ComicModel(this);
+    model->setupFolderModelData(folderId, databasePath);
+}
+
+void ComicModelTest::cleanupTestCase()
+{
+    delete model;
+    model = nullptr;
+}
+
+void ComicModelTest::rowCount()
+{
+    QCOMPARE(model->rowCount(), numComics);
+    QVERIFY(!model->canFetchMore(QModelIndex()));
+}
+
+void ComicModelTest::selectAll()
+{
+    YACReaderComicsSelectionHelper selectionHelper;
+    selectionHelper.setModel(model);
+
+    selectionHelper.selectAll();
+
+    QCOMPARE(selectionHelper.numItemsSelected(), numComics);
+    QCOMPARE(selectionHelper.selectedRows().size(), numComics);
+    QVERIFY(selectionHelper.isSelectedIndex(numComics - 1));
+}
+
+void ComicModelTest::indexFromId()
+{
+    auto index = model->getIndexFromId(numComics);
+    QVERIFY(index.isValid());
+    QCOMPARE(index.data(ComicModel::IdRole).toULongLong(), qulonglong(numComics));
+}
+
+QTEST_GUILESS_MAIN(ComicModelTest)
+
+#include "comic_model_test.moc"
@@ -0,0 +1,65 @@
+include(../qt_test.pri)
+
+QT += gui widgets sql network quick
+
+DEFINES += NO_PDF YACREADER_LIBRARY
+
+PATH_TO_library = ../../YACReaderLibrary
+PATH_TO_common = ../../common
+
+INCLUDEPATH += $$PATH_TO_library \
+               $${PATH_TO_library}/db \
+               $$PATH_TO_common
+
+HEADERS += $${PATH_TO_library}/db/comic_model.h \
+           $${PATH_TO_library}/db/comic_rows.h \
+           $${PATH_TO_library}/db/data_base_management.h \
+           $${PATH_TO_library}/db/library_write_batch.h \
+           $${PATH_TO_library}/db/reading_list.h \
+           $${PATH_TO_library}/db_helper.h \
+           $${PATH_TO_library}/cover_image_provider.h \
+           $${PATH_TO_library}/initial_comic_info_extractor.h \
+           $${PATH_TO_library}/yacreader_comics_selection_helper.h \
+           $${PATH_TO_library}/yacreader_libraries.h \
+           $${PATH_TO_common}/bookmarks.h \
+           $${PATH_TO_common}/comic.h \
+           $${PATH_TO_common}/comic_db.h \
+           $${PATH_TO_common}/cover_image_cache.h \
+           $${PATH_TO_common}/folder.h \
+           $${PATH_TO_common}/library_item.h \
+           $${PATH_TO_common}/qnaturalsorting.h \
+           $${PATH_TO_common}/yacreader_global.h \
+           $${PATH_TO_common}/yacreader_global_gui.h
+
+SOURCES += $${PATH_TO_library}/db/comic_model.cpp \
+           $${PATH_TO_library}/db/comic_rows.cpp \
+           $${PATH_TO_library}/db/data_base_management.cpp \
+           $${PATH_TO_library}/db/library_write_batch.cpp \
+           $${PATH_TO_library}/db/reading_list.cpp \
+           $${PATH_TO_library}/db_helper.cpp \
+           $${PATH_TO_library}/cover_image_provider.cpp \
+           $${PATH_TO_library}/initial_comic_info_extractor.cpp \
+           $${PATH_TO_library}/yacreader_comics_selection_helper.cpp \
+           $${PATH_TO_library}/yacreader_libraries.cpp \
+           $${PATH_TO_common}/bookmarks.cpp \
+           $${PATH_TO_common}/comic.cpp \
+           $${PATH_TO_common}/comic_db.cpp \
+           $${PATH_TO_common}/cover_image_cache.cpp \
+           $${PATH_TO_common}/folder.cpp \
+           $${PATH_TO_common}/library_item.cpp \
+           $${PATH_TO_common}/qnaturalsorting.cpp \
+           $${PATH_TO_common}/yacreader_global.cpp \
+           $${PATH_TO_common}/yacreader_global_gui.cpp \
+           comic_model_test.cpp
+
+include(../../third_party/QsLog/QsLog.pri)
+
+CONFIG(7zip) {
+include(../../compressed_archive/wrapper.pri)
+} else:CONFIG(unarr) {
+include(../../compressed_archive/unarr/unarr-wrapper.pri)
+} else:CONFIG(libarchive) {
+include(../../compressed_archive/libarchive/libarchive-wrapper.pri)
+} else {
+include(../../compressed_archive/wrapper.pri)
+}
@@ -0,0 +1,363 @@
+#include "library_indexes.h"
+#include "library_queries.h"
+#include "library_schema.h"
+#include "query_parser.h"
+
+#include <QObject>
+#include <QRegularExpression>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QTest>
+#include <QVariantList>
+
+#include <random>
+
+//! Runs the queries used by DBHelper, the models, the search and the server controllers through EXPLAIN QUERY PLAN
+//! against a library with 200k comics, and fails if any of them reads a whole table instead of using an index.
+//! The library is created with the statements of library_schema.h and the queries come from library_queries.h and
+//! QueryParser, the same ones the apps run; a new query in a hot path should be added to library_queries.h and checked here.
+//! The plans are checked twice: without statistics (the libraries are never analyzed) and after ANALYZE.
+class LibraryQueryPlanTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void queryPlan_data();
+    void queryPlan();
+    void queryPlanWithStatistics_data();
+    void queryPlanWithStatistics();
+
+private:
+    void addQueries();
+    void checkQueryPlan();
+    void exec(const QString &sql);
+    void insert(const QString &sql, const QList<QVariantList> &columns);
+
+    QSqlDatabase db;
+};
+
+namespace {
+const char *connectionName = "library_query_plan_test";
+
+const int numFolders = 10000;
+const int numComics = 200000;
+const int numLabels = 10;
+const int numComicsPerLabel = 2000;
+const int numReadingLists = 100; // the first 20 are top level lists
+const int numComicsPerReadingList = 500;
+const int numFavorites = 3000;
+
+QVariantList sample(std::mt19937 &random, int count)
+{
+    std::uniform_int_distribution<int> comics(1, numComics);
+    QSet<int> ids;
+    while (ids.size() < count) {
+        ids.insert(comics(random));
+    }
+
+    QVariantList list;
+    for (auto id : ids) {
+        list << id;
+    }
+    return list;
+}
+}
+
+void LibraryQueryPlanTest::initTestCase()
+{
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(":memory:");
+    QVERIFY2(db.open(), qPrintable(db.lastError().text()));
+
+    // same statements as DataBaseManagement::createTables
+    exec(comicInfoTableSchema());
+    exec(folderTableSchema());
+    exec(comicTableSchema());
+    const auto v8Tables = v8TablesSchema();
+    for (const auto &statement : v8Tables) {
+        exec(statement);
+    }
+
+    const auto indexes = libraryIndexes();
+    for (const auto &index : indexes) {
+        exec(index);
+    }
+
+    std::mt19937 random(42);
+    QVERIFY(db.transaction());
+
+    {
+        QList<QVariantList> columns({ {}, {}, {}, {} });
+        columns[0] << 1;
+        columns[1] << 1;
+        columns[2] << "root";
+        columns[3] << "/";
+        for (int id = 2; id < numFolders + 2; id++) {
+            // a tree with 100 folders at the top level
+            columns[0] << id;
+            columns[1] << (id < 100 ? 1 : std::uniform_int_distribution<int>(2, id - 1)(random));
+            columns[2] << QString("Folder %1").arg(id);
+            columns[3] << QString("/Folder %1").arg(id);
+        }
+        insert("INSERT INTO folder (id, parentId, name, path) VALUES (?, ?, ?, ?)", columns);
+    }
+
+    {
+        QList<QVariantList> infoColumns({ {}, {}, {}, {}, {}, {} });
+        QList<QVariantList> comicColumns({ {}, {}, {}, {}, {} });
+        std::uniform_int_distribution<int> folders(2, numFolders + 1);
+        for (int id = 1; id <= numComics; id++) {
+            infoColumns[0] << id;
+            infoColumns[1] << QString("%1%2").arg(id, 40, 16, QChar('0')).arg(id * 1000);
+            infoColumns[2] << id; // added
+            infoColumns[3] << (id % 100 == 0); // hasBeenOpened
+            infoColumns[4] << (id % 200 == 0); // read
+            infoColumns[5] << id; // lastTimeOpened
+
+            comicColumns[0] << id;
+            comicColumns[1] << folders(random);
+            comicColumns[2] << id;
+            comicColumns[3] << QString("Comic %1.cbz").arg(id);
+            comicColumns[4] << QString("/Comic %1.cbz").arg(id);
+        }
+        insert("INSERT INTO comic_info (id, hash, added, hasBeenOpened, read, lastTimeOpened) VALUES (?, ?, ?, ?, ?, ?)", infoColumns);
+        insert("INSERT INTO comic (id, parentId, comicInfoId, fileName, path) VALUES (?, ?, ?, ?, ?)", comicColumns);
+    }
+
+    {
+        QList<QVariantList> labelColumns({ {}, {}, {}, {} });
+        QList<QVariantList> comicLabelColumns({ {}, {}, {} });
+        for (int id = 1; id <= numLabels; id++) {
+            labelColumns[0] << id;
+            labelColumns[1] << QString("Label %1").arg(id);
+            labelColumns[2] << "red";
+            labelColumns[3] << id;
+
+            const auto comics = sample(random, numComicsPerLabel);
+            for (int i = 0; i < comics.size(); i++) {
+                comicLabelColumns[0] << comics.at(i);
+                comicLabelColumns[1] << id;
+                comicLabelColumns[2] << i;
+            }
+        }
+        insert("INSERT INTO label (id, name, color, ordering) VALUES (?, ?, ?, ?)", labelColumns);
+        insert("INSERT INTO comic_label (comic_id, label_id, ordering) VALUES (?, ?, ?)", comicLabelColumns);
+    }
+
+    {
+        QList<QVariantList> listColumns({ {}, {}, {}, {} });
+        QList<QVariantList> comicListColumns({ {}, {}, {} });
+        std::uniform_int_distribution<int> topLevelLists(1, 20);
+        for (int id = 1; id <= numReadingLists; id++) {
+            listColumns[0] << id;
+            listColumns[1] << (id <= 20 ? QVariant() : QVariant(topLevelLists(random)));
+            listColumns[2] << id;
+            listColumns[3] << QString("Reading list %1").arg(id);
+
+            const auto comics = sample(random, numComicsPerReadingList);
+            for (int i = 0; i < comics.size(); i++) {
+                comicListColumns[0] << id;
+                comicListColumns[1] << comics.at(i);
+                comicListColumns[2] << i;
+            }
+        }
+        insert("INSERT INTO reading_list (id, parentId, ordering, name) VALUES (?, ?, ?, ?)", listColumns);
+        insert("INSERT INTO comic_reading_list (reading_list_id, comic_id, ordering) VALUES (?, ?, ?)", comicListColumns);
+    }
+
+    {
+        // Favorites is created with the tables
+        QList<QVariantList> columns({ {}, {} });
+        const auto comics = sample(random, numFavorites);
+        for (int i = 0; i < comics.size(); i++) {
+            columns[0] << comics.at(i);
+            columns[1] << i;
+        }
+        insert("INSERT INTO comic_default_reading_list (comic_id, default_reading_list_id, ordering) VALUES (?, 1, ?)", columns);
+    }
+
+    QVERIFY(db.commit());
+
+    // created after the data, as DataBaseManagement::createFullTextIndex does when a library is updated
+    const auto fullTextIndex = fullTextIndexSchema();
+    for (const auto &statement : fullTextIndex) {
+        exec(statement);
+    }
+
+    // comics info packs in JSON lines format are imported through this table
+    exec(createComicsInfoStagingTableQuery());
+}
+
+void LibraryQueryPlanTest::cleanupTestCase()
+{
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void LibraryQueryPlanTest::exec(const QString &sql)
+{
+    QSqlQuery query(db);
+    QVERIFY2(query.exec(sql), qPrintable(sql + ": " + query.lastError().text()));
+}
+
+void LibraryQueryPlanTest::insert(const QString &sql, const QList<QVariantList> &columns)
+{
+    QSqlQuery query(db);
+    QVERIFY2(query.prepare(sql), qPrintable(sql + ": " + query.lastError().text()));
+    for (const auto &column : columns) {
+        query.addBindValue(column);
+    }
+    QVERIFY2(query.execBatch(), qPrintable(sql + ": " + query.lastError().text()));
+}
+
+void LibraryQueryPlanTest::addQueries()
+{
+    QTest::addColumn<QString>("sql");
+    // tables that the query is expected to scan (CTEs)
+    QTest::addColumn<QStringList>("allowedScans");
+
+    // DBHelper
+    QTest::newRow("getFoldersFromParent") << SUBFOLDERS_QUERY << QStringList();
+    QTest::newRow("getFoldersFromParent (count)") << SUBFOLDERS_COUNT_QUERY << QStringList();
+    QTest::newRow("getComicsFromParent") << "SELECT * " FOLDER_COMICS_FROM << QStringList();
+    QTest::newRow("getComicsFromParent (siblings)") << "SELECT c.id,c.parentId,c.fileName,c.path,ci.hash " FOLDER_COMICS_FROM << QStringList();
+    QTest::newRow("getComicsFromParent (count)") << FOLDER_COMICS_COUNT_QUERY << QStringList();
+    QTest::newRow("loadFolder(name, parentId)") << FOLDER_BY_NAME_QUERY << QStringList();
+    QTest::newRow("loadComic(name, path, hash)") << COMIC_INFO_BY_HASH_QUERY << QStringList();
+    QTest::newRow("loadComic(id)") << COMIC_BY_ID_QUERY << QStringList();
+    QTest::newRow("getComicsFromHash") << COMIC_BY_HASH_QUERY << QStringList();
+    QTest::newRow("getComics(ids)") << comicsByIdQuery("1, 2, 3") << QStringList();
+    QTest::newRow("getFolders(ids)") << foldersByIdQuery("1, 2, 3") << QStringList();
+    QTest::newRow("updateFolderTreeType") << UPDATE_FOLDER_COMICS_TYPE_QUERY << QStringList();
+    QTest::newRow("isFavoriteComic") << IS_FAVORITE_COMIC_QUERY << QStringList();
+    QTest::newRow("removeLabelFromComic") << REMOVE_LABEL_FROM_COMIC_QUERY << QStringList();
+    QTest::newRow("getLabelComics") << "SELECT * " LABEL_COMICS_FROM << QStringList();
+
+    // DBHelper::updateChildrenInfo
+    QTest::newRow("updateChildrenInfo (parent)") << FOLDER_PARENT_QUERY << QStringList();
+    QTest::newRow("updateChildrenInfo (subfolders)") << FOLDER_AGGREGATES_SUBFOLDERS_QUERY << QStringList();
+    QTest::newRow("updateChildrenInfo (aggregates)") << FOLDER_AGGREGATES_QUERY << QStringList();
+    QTest::newRow("updateChildrenInfo (update)") << UPDATE_FOLDER_AGGREGATES_QUERY << QStringList();
+    // the repair pass recomputes every folder, it is expected to read all of them (and all the comics once)
+    QTest::newRow("updateChildrenInfo (repair)") << repairFolderAggregatesQuery()
+                                                 << (QStringList() << "folder"
+                                                                   << "f"
+                                                                   << "s"
+                                                                   << "c");
+    QTest::newRow("updateChildrenInfo (repair, SQLite < 3.33)") << repairFolderAggregatesLegacyQuery()
+                                                                << (QStringList() << "folder"
+                                                                                  << "s");
+
+    // LibraryWriteBatch
+    QTest::newRow("LibraryWriteBatch::updateFolders") << updateFoldersAndAncestorsQuery("5, 6")
+                                                      << (QStringList() << "a"
+                                                                        << "ancestors");
+
+    // DataBaseManagement::importComicsInfo
+    const auto fields = comicsInfoFields();
+    QTest::newRow("importComicsInfo (upsert)") << comicsInfoUpsertQuery("temp.imported_info", fields, false) << QStringList();
+    QTest::newRow("importComicsInfo (upsert, keep missing)") << comicsInfoUpsertQuery("temp.imported_info", fields, true) << QStringList();
+    QTest::newRow("importComicsInfo (changed covers)") << comicsInfoChangedCoversQuery("temp.imported_info") << QStringList();
+
+    // ComicModel
+    QTest::newRow("ComicModel label") << "SELECT * " LABEL_COMICS_FROM << QStringList();
+    QTest::newRow("ComicModel reading list") << "SELECT * " READING_LIST_COMICS_FROM << QStringList();
+    QTest::newRow("ComicModel favorites") << "SELECT * " DEFAULT_READING_LIST_COMICS_FROM << QStringList();
+    QTest::newRow("ComicModel reading") << "SELECT * " READING_COMICS_FROM << QStringList();
+    QTest::newRow("ComicModel recent") << "SELECT * " RECENT_COMICS_FROM << QStringList();
+    QTest::newRow("ComicModel sublists") << READING_LIST_SUBLISTS_QUERY << QStringList();
+
+    // search (foldersSearchQuery and comicsSearchQuery), with the full text index
+    const auto filters = QStringList() << "spider"
+                                       << "title:batman"
+                                       << "filename:cbz"
+                                       << "folder:marvel"
+                                       << "spider or writer:moore"
+                                       << "title:batman or folder:dc or filename:annual"
+                                       << "batman and read:true";
+    QueryParser parser;
+    for (const auto &filter : filters) {
+        auto result = parser.parse(filter.toStdString());
+        auto ranked = !result.rankingQuery().empty();
+        QTest::newRow(qPrintable("search folders: " + filter)) << QString::fromStdString(result.foldersSearchSql(true)) << QStringList();
+        QTest::newRow(qPrintable("search comics: " + filter)) << QString::fromStdString(result.comicsSearchSql(true, false)) << QStringList();
+        if (ranked) {
+            QTest::newRow(qPrintable("search comics (ranked): " + filter)) << QString::fromStdString(result.comicsSearchSql(true, true)) << QStringList();
+        }
+    }
+
+    // server
+    QTest::newRow("FolderContentControllerV2 folders") << FOLDER_CONTENT_SUBFOLDERS_QUERY << QStringList();
+    QTest::newRow("FolderContentControllerV2 comics") << FOLDER_CONTENT_COMICS_QUERY << QStringList();
+    QTest::newRow("TagContentControllerV2") << LABEL_CONTENT_QUERY << QStringList();
+    QTest::newRow("ReadingListContentControllerV2") << READING_LIST_CONTENT_QUERY << QStringList();
+}
+
+void LibraryQueryPlanTest::checkQueryPlan()
+{
+    QFETCH(QString, sql);
+    QFETCH(QStringList, allowedScans);
+
+    // partial indexes only contain the rows the query looks for
+    QStringList partialIndexes;
+    QSqlQuery indexesQuery("SELECT name FROM sqlite_master WHERE type = 'index' AND sql LIKE '% WHERE %'", db);
+    while (indexesQuery.next()) {
+        partialIndexes << indexesQuery.value(0).toString();
+    }
+
+    QSqlQuery query(db);
+    QVERIFY2(query.prepare("EXPLAIN QUERY PLAN " + sql), qPrintable(query.lastError().text()));
+    auto parameters = QRegularExpression(":\\w+").globalMatch(sql);
+    while (parameters.hasNext()) {
+        query.bindValue(parameters.next().captured(0), 1);
+    }
+    QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+
+    // "SCAN c", "SCAN TABLE comic AS c" in older versions of SQLite
+    QRegularExpression scan("^SCAN (?:TABLE )?(\\w+)(?:.* USING (?:COVERING )?INDEX (\\w+))?");
+    QRegularExpression fullTextMatch("VIRTUAL TABLE INDEX \\d+:M");
+    while (query.next()) {
+        auto detail = query.value("detail").toString();
+        auto match = scan.match(detail);
+        // FTS5 MATCH lookups are reported as scans of the virtual table
+        if (!match.hasMatch() || detail == "SCAN CONSTANT ROW" || fullTextMatch.match(detail).hasMatch()) {
+            continue;
+        }
+        if (allowedScans.contains(match.captured(1)) || partialIndexes.contains(match.captured(2))) {
+            continue;
+        }
+        QFAIL(qPrintable("full scan: " + detail));
+    }
+}
+
+void LibraryQueryPlanTest::queryPlan_data()
+{
+    addQueries();
+}
+
+void LibraryQueryPlanTest::queryPlan()
+{
+    checkQueryPlan();
+}
+
+void LibraryQueryPlanTest::queryPlanWithStatistics_data()
+{
+    exec("ANALYZE");
+    addQueries();
+}
+
+void LibraryQueryPlanTest::queryPlanWithStatistics()
+{
+    checkQueryPlan();
+}
+
+QTEST_GUILESS_MAIN(LibraryQueryPlanTest)
+
+#include "library_query_plan_test.moc"
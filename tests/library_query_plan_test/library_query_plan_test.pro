@@ -0,0 +1,16 @@
+include(../qt_test.pri)
+
+QT += sql
+
+PATH_TO_db = ../../YACReaderLibrary/db
+
+INCLUDEPATH += $$PATH_TO_db \
+               ../../third_party/QsLog
+HEADERS += $${PATH_TO_db}/library_indexes.h \
+           $${PATH_TO_db}/library_queries.h \
+           $${PATH_TO_db}/library_schema.h \
+           $${PATH_TO_db}/query_lexer.h \
+           $${PATH_TO_db}/query_parser.h
+SOURCES += $${PATH_TO_db}/query_lexer.cpp \
+           $${PATH_TO_db}/query_parser.cpp \
+           library_query_plan_test.cpp
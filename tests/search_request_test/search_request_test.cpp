@@ -0,0 +1,71 @@
+#include "search_request.h"
+
+#include <QObject>
+#include <QTest>
+
+class SearchRequestTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void limit_data();
+    void limit();
+    void cursor_data();
+    void cursor();
+};
+
+void SearchRequestTest::limit_data()
+{
+    QTest::addColumn<QByteArray>("body");
+    QTest::addColumn<int>("limit");
+
+    QTest::newRow("default") << QByteArray(R"({"query": "batman"})") << SearchRequest::defaultLimit;
+    QTest::newRow("valid") << QByteArray(R"({"query": "batman", "limit": 20})") << 20;
+    QTest::newRow("zero") << QByteArray(R"({"query": "batman", "limit": 0})") << 1;
+    QTest::newRow("negative") << QByteArray(R"({"query": "batman", "limit": -5})") << 1;
+    QTest::newRow("too big") << QByteArray(R"({"query": "batman", "limit": 1000000})") << SearchRequest::maxLimit;
+}
+
+void SearchRequestTest::limit()
+{
+    QFETCH(QByteArray, body);
+    QFETCH(int, limit);
+
+    auto request = SearchRequest::fromJson(body);
+    QCOMPARE(request.query, QString("batman"));
+    QCOMPARE(request.limit, limit);
+    QVERIFY(!request.options.paginated());
+}
+
+void SearchRequestTest::cursor_data()
+{
+    QTest::addColumn<QByteArray>("body");
+    QTest::addColumn<int>("limit");
+    QTest::addColumn<int>("offset");
+
+    QTest::newRow("first page") << QByteArray(R"({"limit": 50, "cursor": ""})") << 50 << 0;
+    QTest::newRow("next page") << QByteArray(R"({"limit": 50, "cursor": "100"})") << 50 << 100;
+    QTest::newRow("zero limit") << QByteArray(R"({"limit": 0, "cursor": "100"})") << 1 << 100;
+    QTest::newRow("negative limit") << QByteArray(R"({"limit": -1, "cursor": "100"})") << 1 << 100;
+    QTest::newRow("negative cursor") << QByteArray(R"({"limit": 50, "cursor": "-100"})") << 50 << 0;
+}
+
+void SearchRequestTest::cursor()
+{
+    QFETCH(QByteArray, body);
+    QFETCH(int, limit);
+    QFETCH(int, offset);
+
+    auto request = SearchRequest::fromJson(body);
+    QVERIFY(request.options.paginated());
+    QCOMPARE(request.limit, limit);
+    QCOMPARE(request.options.limit, limit);
+    QCOMPARE(request.offset, offset);
+
+    // the next_cursor of a full page (offset + limit) must move forward, or clients following it never end
+    QVERIFY(request.offset + request.limit > request.offset);
+}
+
+QTEST_APPLESS_MAIN(SearchRequestTest)
+
+#include "search_request_test.moc"
@@ -0,0 +1,12 @@
+include(../qt_test.pri)
+
+QT += network
+
+PATH_TO_server = ../../YACReaderLibrary/server
+
+INCLUDEPATH += $$PATH_TO_server \
+               ../../third_party/QtWebApp/httpserver
+HEADERS += $${PATH_TO_server}/search_request.h \
+           $${PATH_TO_server}/json_list_writer.h
+SOURCES += $${PATH_TO_server}/search_request.cpp \
+           search_request_test.cpp
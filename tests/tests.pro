@@ -1,2 +1,5 @@
 TEMPLATE = subdirs
-SUBDIRS += concurrent_queue_test
+SUBDIRS += comic_model_test \
+    concurrent_queue_test \
+    library_query_plan_test \
+    search_request_test
@@ -0,0 +1,483 @@
+/**
+  @file
+  @author Stefan Frings
+*/
+
+#include "httpconnection.h"
+#include "httpconnectionpool.h"
+#include "httpresponse.h"
+#include <QDeadlineTimer>
+
+using namespace stefanfrings;
+
+/** Data passed to the socket while it has less than this size waiting to be sent */
+static const qint64 socketBufferSize=65536;
+
+HttpConnection::HttpConnection(const QSettings *settings, HttpRequestHandler *requestHandler,
+                               const QSslConfiguration* sslConfiguration, HttpConnectionPool* pool)
+    : QObject()
+{
+    Q_ASSERT(settings!=nullptr);
+    Q_ASSERT(requestHandler!=nullptr);
+    Q_ASSERT(pool!=nullptr);
+    this->settings=settings;
+    this->requestHandler=requestHandler;
+    this->sslConfiguration=sslConfiguration;
+    this->pool=pool;
+    socket=nullptr;
+    readTimer=nullptr;
+    writeTimer=nullptr;
+    currentRequest=nullptr;
+    busy=false;
+    closeWhenSent=false;
+    readWhenSent=false;
+    pendingBytes=0;
+    outputFile=nullptr;
+    outputFileRemaining=0;
+    maxPendingBytes=settings->value("maxPendingBytes",1048576).toLongLong();
+    writeTimeout=settings->value("writeTimeout",60000).toInt();
+    open=false;
+    sendScheduled=false;
+}
+
+
+HttpConnection::~HttpConnection()
+{
+    delete currentRequest;
+    delete outputFile;
+    qDebug("HttpConnection (%p): destroyed", static_cast<void*>(this));
+}
+
+
+void HttpConnection::createSocket()
+{
+    // If SSL is supported and configured, then create an instance of QSslSocket
+    #ifndef QT_NO_SSL
+        if (sslConfiguration)
+        {
+            QSslSocket* sslSocket=new QSslSocket(this);
+            sslSocket->setSslConfiguration(*sslConfiguration);
+            socket=sslSocket;
+            qDebug("HttpConnection (%p): SSL is enabled", static_cast<void*>(this));
+            return;
+        }
+    #endif
+    // else create an instance of QTcpSocket
+    socket=new QTcpSocket(this);
+}
+
+
+void HttpConnection::handleConnection(tSocketDescriptor socketDescriptor)
+{
+    qDebug("HttpConnection (%p): handle new connection", static_cast<void*>(this));
+
+    // the socket and the timer are created here, in the I/O thread that handles their events
+    createSocket();
+    readTimer=new QTimer(this);
+    readTimer->setSingleShot(true);
+    writeTimer=new QTimer(this);
+    writeTimer->setSingleShot(true);
+
+    if (!socket->setSocketDescriptor(socketDescriptor))
+    {
+        qCritical("HttpConnection (%p): cannot initialize socket: %s",
+                  static_cast<void*>(this),qPrintable(socket->errorString()));
+        pool->release(this);
+        return;
+    }
+
+    {
+        QMutexLocker locker(&outputMutex);
+        open=true;
+    }
+
+    connect(socket, &QTcpSocket::readyRead, this, &HttpConnection::read);
+    connect(socket, &QTcpSocket::disconnected, this, &HttpConnection::disconnected);
+    connect(socket, &QTcpSocket::bytesWritten, this, &HttpConnection::sendOutput);
+    connect(readTimer, &QTimer::timeout, this, &HttpConnection::readTimeout);
+    connect(writeTimer, &QTimer::timeout, this, &HttpConnection::writeFileTimeout);
+
+    #ifndef QT_NO_SSL
+        // Switch on encryption, if SSL is configured
+        if (sslConfiguration)
+        {
+            qDebug("HttpConnection (%p): Starting encryption", static_cast<void*>(this));
+            (static_cast<QSslSocket*>(socket))->startServerEncryption();
+        }
+    #endif
+
+    // Start timer for read timeout
+    int readTimeout=settings->value("readTimeout",10000).toInt();
+    readTimer->start(readTimeout);
+}
+
+
+bool HttpConnection::write(const QByteArray& data)
+{
+    QMutexLocker locker(&outputMutex);
+
+    // wait until the client has read enough of the data already queued
+    QDeadlineTimer deadline(writeTimeout);
+    while (open && pendingBytes>=maxPendingBytes)
+    {
+        if (!outputDrained.wait(&outputMutex, deadline))
+        {
+            qDebug("HttpConnection (%p): write timeout occured", static_cast<void*>(this));
+            open=false;
+            QMetaObject::invokeMethod(this, "abort", Qt::QueuedConnection);
+            return false;
+        }
+    }
+
+    if (!open)
+    {
+        return false;
+    }
+
+    output.append(data);
+    pendingBytes+=data.size();
+    if (!sendScheduled)
+    {
+        sendScheduled=true;
+        QMetaObject::invokeMethod(this, "sendOutput", Qt::QueuedConnection);
+    }
+    return true;
+}
+
+
+bool HttpConnection::writeFile(QFile* file, qint64 length)
+{
+    QMutexLocker locker(&outputMutex);
+    Q_ASSERT(outputFile==nullptr);
+    if (!open)
+    {
+        locker.unlock();
+        delete file;
+        return false;
+    }
+
+    if (length<=0)
+    {
+        locker.unlock();
+        delete file;
+        return true;
+    }
+
+    // from now on the file is only used by the I/O thread
+    file->setParent(nullptr);
+    file->moveToThread(thread());
+    outputFile=file;
+    outputFileRemaining=length;
+    if (!sendScheduled)
+    {
+        sendScheduled=true;
+        QMetaObject::invokeMethod(this, "sendOutput", Qt::QueuedConnection);
+    }
+    return true;
+}
+
+
+bool HttpConnection::isOpen() const
+{
+    QMutexLocker locker(&outputMutex);
+    return open;
+}
+
+
+void HttpConnection::sendOutput()
+{
+    QMutexLocker locker(&outputMutex);
+    sendScheduled=false;
+    if (!open)
+    {
+        return;
+    }
+
+    while (!output.isEmpty() && socket->bytesToWrite()<socketBufferSize)
+    {
+        QByteArray data=output.takeFirst();
+        pendingBytes-=data.size();
+        socket->write(data);
+    }
+
+    if (pendingBytes<maxPendingBytes)
+    {
+        outputDrained.wakeAll();
+    }
+
+    // the file follows the data queued before it, it is read as the socket buffer drains
+    bool readError=false;
+    while (outputFile && output.isEmpty() && socket->bytesToWrite()<socketBufferSize)
+    {
+        QByteArray data=outputFile->read(qMin(outputFileRemaining,socketBufferSize));
+        if (data.isEmpty())
+        {
+            readError=true;
+            break;
+        }
+        outputFileRemaining-=data.size();
+        socket->write(data);
+        if (outputFileRemaining<=0)
+        {
+            delete outputFile;
+            outputFile=nullptr;
+        }
+    }
+
+    if (readError)
+    {
+        // the Content-Length has already been sent, the client will see that the response is incomplete
+        qCritical("HttpConnection (%p): cannot read %s",
+                  static_cast<void*>(this),qPrintable(outputFile->fileName()));
+        open=false;
+        locker.unlock();
+        socket->abort();
+        return;
+    }
+
+    bool sendingFile=outputFile!=nullptr;
+    bool sent=output.isEmpty() && !sendingFile;
+    locker.unlock();
+
+    // a client that stops reading the file must not keep the connection forever
+    if (sent)
+    {
+        writeTimer->stop();
+    }
+    else if (sendingFile)
+    {
+        writeTimer->start(writeTimeout);
+    }
+
+    if (sent && !busy)
+    {
+        // disconnectFromHost() waits until the socket buffer has been sent
+        if (closeWhenSent)
+        {
+            socket->disconnectFromHost();
+        }
+        else if (readWhenSent)
+        {
+            readWhenSent=false;
+            int readTimeout=settings->value("readTimeout",10000).toInt();
+            readTimer->start(readTimeout);
+            read();
+        }
+    }
+}
+
+
+void HttpConnection::readTimeout()
+{
+    qDebug("HttpConnection (%p): read timeout occured",static_cast<void*>(this));
+
+    //Commented out because QWebView cannot handle this.
+    //socket->write("HTTP/1.1 408 request timeout\r\nConnection: close\r\n\r\n408 request timeout\r\n");
+
+    socket->disconnectFromHost();
+    delete currentRequest;
+    currentRequest=nullptr;
+}
+
+
+void HttpConnection::writeFileTimeout()
+{
+    qDebug("HttpConnection (%p): write timeout occured", static_cast<void*>(this));
+    socket->abort();
+}
+
+
+void HttpConnection::abort()
+{
+    socket->abort();
+}
+
+
+void HttpConnection::disconnected()
+{
+    qDebug("HttpConnection (%p): disconnected", static_cast<void*>(this));
+    readTimer->stop();
+    writeTimer->stop();
+    closed();
+}
+
+
+void HttpConnection::closed()
+{
+    {
+        QMutexLocker locker(&outputMutex);
+        open=false;
+        output.clear();
+        pendingBytes=0;
+        delete outputFile;
+        outputFile=nullptr;
+        outputDrained.wakeAll();
+    }
+
+    // a worker may still be using the connection, it is released when the request is finished
+    if (!busy)
+    {
+        pool->release(this);
+    }
+}
+
+
+void HttpConnection::read()
+{
+    // The loop adds support for HTTP pipelinig, the next request is read once the current one is finished
+    while (!busy && !closeWhenSent && !readWhenSent && socket->bytesAvailable())
+    {
+        #ifdef SUPERVERBOSE
+            qDebug("HttpConnection (%p): read input",static_cast<void*>(this));
+        #endif
+
+        // Create new HttpRequest object if necessary
+        if (!currentRequest)
+        {
+            currentRequest=new HttpRequest(settings);
+        }
+
+        // Collect data for the request object
+        while (socket->bytesAvailable() && currentRequest->getStatus()!=HttpRequest::complete && currentRequest->getStatus()!=HttpRequest::abort)
+        {
+            currentRequest->readFromSocket(socket);
+            if (currentRequest->getStatus()==HttpRequest::waitForBody)
+            {
+                // Restart timer for read timeout, otherwise it would
+                // expire during large file uploads.
+                int readTimeout=settings->value("readTimeout",10000).toInt();
+                readTimer->start(readTimeout);
+            }
+        }
+
+        // If the request is aborted, return error message and close the connection
+        if (currentRequest->getStatus()==HttpRequest::abort)
+        {
+            socket->write("HTTP/1.1 413 entity too large\r\nConnection: close\r\n\r\n413 Entity too large\r\n");
+            socket->disconnectFromHost();
+            delete currentRequest;
+            currentRequest=nullptr;
+            return;
+        }
+
+        // If the request is complete, let a worker thread dispatch it
+        if (currentRequest->getStatus()==HttpRequest::complete)
+        {
+            processRequest();
+        }
+    }
+}
+
+
+void HttpConnection::processRequest()
+{
+    readTimer->stop();
+    qDebug("HttpConnection (%p): received request",static_cast<void*>(this));
+
+    HttpRequest* request=currentRequest;
+    currentRequest=nullptr;
+    busy=true;
+
+    // Copy the Connection:close header to the response
+    bool closeConnection=QString::compare(request->getHeader("Connection"),"close",Qt::CaseInsensitive)==0;
+
+    // In case of HTTP 1.0 protocol add the Connection:close header.
+    // This ensures that the HttpResponse does not activate chunked mode, which is not spported by HTTP 1.0.
+    if (!closeConnection)
+    {
+        closeConnection=QString::compare(request->getVersion(),"HTTP/1.0",Qt::CaseInsensitive)==0;
+    }
+
+    pool->run([this, request, closeConnection]()
+    {
+        HttpResponse response(this);
+        bool close=closeConnection;
+        if (close)
+        {
+            response.setHeader("Connection","close");
+        }
+
+        // Call the request mapper
+        try
+        {
+            requestHandler->service(*request, response);
+        }
+        catch (...)
+        {
+            qCritical("HttpConnection (%p): An uncatched exception occured in the request handler",
+                      static_cast<void*>(this));
+        }
+
+        // Finalize sending the response if not already done
+        if (!response.hasSentLastPart())
+        {
+            response.write(QByteArray(),true);
+        }
+
+        qDebug("HttpConnection (%p): finished request",static_cast<void*>(this));
+
+        // Find out whether the connection must be closed
+        if (!close)
+        {
+            // Maybe the request handler or mapper added a Connection:close header in the meantime
+            bool closeResponse=QString::compare(response.getHeaders().value("Connection"),"close",Qt::CaseInsensitive)==0;
+            if (closeResponse==true)
+            {
+                close=true;
+            }
+            else
+            {
+                // If we have no Content-Length header and did not use chunked mode, then we have to close the
+                // connection to tell the HTTP client that the end of the response has been reached.
+                bool hasContentLength=response.getHeaders().contains("Content-Length");
+                if (!hasContentLength)
+                {
+                    bool hasChunkedMode=QString::compare(response.getHeaders().value("Transfer-Encoding"),"chunked",Qt::CaseInsensitive)==0;
+                    if (!hasChunkedMode)
+                    {
+                        close=true;
+                    }
+                }
+            }
+        }
+
+        delete request;
+        QMetaObject::invokeMethod(this, "requestFinished", Qt::QueuedConnection, Q_ARG(bool, close));
+    });
+}
+
+
+void HttpConnection::requestFinished(bool closeConnection)
+{
+    busy=false;
+
+    if (!isOpen())
+    {
+        pool->release(this);
+        return;
+    }
+
+    // Close the connection or prepare for the next request on the same connection.
+    if (closeConnection)
+    {
+        closeWhenSent=true;
+        sendOutput();
+    }
+    else
+    {
+        // The next request is read once the file of this response has been sent, so their data can't be mixed
+        {
+            QMutexLocker locker(&outputMutex);
+            readWhenSent=outputFile!=nullptr;
+        }
+        if (readWhenSent)
+        {
+            return;
+        }
+
+        // Start timer for next request
+        int readTimeout=settings->value("readTimeout",10000).toInt();
+        readTimer->start(readTimeout);
+        read();
+    }
+}
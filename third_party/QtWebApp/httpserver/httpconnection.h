@@ -0,0 +1,217 @@
+/**
+  @file
+  @author Stefan Frings
+*/
+
+#ifndef HTTPCONNECTION_H
+#define HTTPCONNECTION_H
+
+#ifndef QT_NO_SSL
+   #include <QSslConfiguration>
+#endif
+#include <QTcpSocket>
+#include <QFile>
+#include <QSettings>
+#include <QTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include "httpglobal.h"
+#include "httprequest.h"
+#include "httprequesthandler.h"
+
+namespace stefanfrings {
+
+/** Alias type definition, for compatibility to different Qt versions */
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    typedef qintptr tSocketDescriptor;
+#else
+    typedef int tSocketDescriptor;
+#endif
+
+/** Alias for QSslConfiguration if OpenSSL is not supported */
+#ifdef QT_NO_SSL
+  #define QSslConfiguration QObject
+#endif
+
+class HttpConnectionPool;
+
+/**
+  A connection to a HTTP client. Connections live in one of the I/O threads of the
+  HttpConnectionPool, which handles the events of many connections. The socket is
+  only used from that thread.
+  <p>
+  Complete requests are processed by the worker threads of the pool, one request at a time
+  (HTTP pipelining is supported, the following requests wait in the socket until the
+  current one is finished). The response is queued by HttpResponse and sent by the I/O
+  thread as fast as the client reads it, so slow clients don't block any thread unless the
+  queued data exceeds maxPendingBytes. Files passed to writeFile() are read by the I/O thread
+  as well, the worker doesn't wait for them at all.
+  <p>
+  Example for the required configuration settings:
+  <code><pre>
+  readTimeout=60000
+  writeTimeout=60000
+  maxPendingBytes=1048576
+  maxRequestSize=16000
+  maxMultiPartSize=1000000
+  </pre></code>
+  <p>
+  The readTimeout value defines the maximum time to wait for a complete HTTP request.
+  <p>
+  The writeTimeout value defines the maximum time a worker waits for the client to read
+  queued response data, or the maximum time the client may stop reading a file that is
+  being sent. The connection is closed when it expires.
+  <p>
+  MaxRequestSize is the maximum size of a HTTP request. In case of
+  multipart/form-data requests (also known as file-upload), the maximum
+  size of the body must not exceed maxMultiPartSize.
+*/
+class DECLSPEC HttpConnection : public QObject {
+    Q_OBJECT
+    Q_DISABLE_COPY(HttpConnection)
+
+public:
+
+    /**
+      Constructor.
+      @param settings Configuration settings of the HTTP webserver
+      @param requestHandler Handler that will process each incoming HTTP request
+      @param sslConfiguration SSL (HTTPS) will be used if not NULL
+      @param pool The pool that owns the connection and runs the requests
+    */
+    HttpConnection(const QSettings* settings, HttpRequestHandler* requestHandler,
+                   const QSslConfiguration* sslConfiguration, HttpConnectionPool* pool);
+
+    /** Destructor */
+    virtual ~HttpConnection();
+
+    /**
+      Queues response data, it is sent by the I/O thread. Called from the worker threads.
+      Blocks while more than maxPendingBytes are waiting to be sent.
+      @return false if the connection has been closed
+    */
+    bool write(const QByteArray& data);
+
+    /**
+      Queues the end of the response body, it is read from the file by the I/O thread while
+      the client reads the data. Called from the worker threads, it never blocks.
+      The connection takes the ownership of the file, nothing else can be written after it.
+      @param file Open file, positioned at the first byte to send
+      @param length Number of bytes to send
+      @return false if the connection has been closed
+    */
+    bool writeFile(QFile* file, qint64 length);
+
+    /** Returns true until the connection is closed, can be called from any thread */
+    bool isOpen() const;
+
+public slots:
+
+    /**
+      Received from the pool, when the connection shall start processing a new socket.
+      @param socketDescriptor references the accepted connection.
+    */
+    void handleConnection(const tSocketDescriptor socketDescriptor);
+
+private:
+
+    /** Configuration settings */
+    const QSettings* settings;
+
+    /** Dispatches received requests to services */
+    HttpRequestHandler* requestHandler;
+
+    /** Configuration for SSL */
+    const QSslConfiguration* sslConfiguration;
+
+    /** Pool that runs the requests */
+    HttpConnectionPool* pool;
+
+    /** TCP socket of the connection */
+    QTcpSocket* socket;
+
+    /** Time for read timeout detection */
+    QTimer* readTimer;
+
+    /** Time for write timeout detection while a file is being sent */
+    QTimer* writeTimer;
+
+    /** Storage for the current incoming HTTP request */
+    HttpRequest* currentRequest;
+
+    /** A request is being processed by a worker thread */
+    bool busy;
+
+    /** Close the connection once the queued data has been sent */
+    bool closeWhenSent;
+
+    /** Read the next request once the queued data has been sent */
+    bool readWhenSent;
+
+    /** Response data waiting to be passed to the socket, shared with the worker threads */
+    QList<QByteArray> output;
+
+    /** Size of the data in output */
+    qint64 pendingBytes;
+
+    /** File sent after the data in output, owned by the connection */
+    QFile* outputFile;
+
+    /** Bytes of outputFile that still have to be sent */
+    qint64 outputFileRemaining;
+
+    /** Maximum size of the data in output before the workers block */
+    qint64 maxPendingBytes;
+
+    /** Maximum time a worker waits for the client to read the queued data */
+    int writeTimeout;
+
+    /** Whether the connection is still open */
+    bool open;
+
+    /** Whether sendOutput() has already been scheduled */
+    bool sendScheduled;
+
+    /** Guards the output queue, the output file and the open state */
+    mutable QMutex outputMutex;
+
+    /** Wakes the workers waiting for the output queue to drain */
+    QWaitCondition outputDrained;
+
+    /**  Create SSL or TCP socket */
+    void createSocket();
+
+    /** Hands the current request to a worker thread */
+    void processRequest();
+
+    /** Marks the connection as closed and releases it once no worker is using it */
+    void closed();
+
+private slots:
+
+    /** Received from the socket when a read-timeout occured */
+    void readTimeout();
+
+    /** Received from the write timer when the client stopped reading a file */
+    void writeFileTimeout();
+
+    /** Received from the socket when incoming data can be read */
+    void read();
+
+    /** Received from the socket when a connection has been closed */
+    void disconnected();
+
+    /** Passes the queued output to the socket, as much as it accepts without growing its buffer */
+    void sendOutput();
+
+    /** Received from the worker thread when a request has been processed */
+    void requestFinished(bool closeConnection);
+
+    /** Closes the connection without sending the pending data */
+    void abort();
+};
+
+} // end of namespace
+
+#endif // HTTPCONNECTION_H
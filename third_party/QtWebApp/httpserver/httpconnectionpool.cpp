@@ -5,11 +5,11 @@
     #include <QSslConfiguration>
 #endif
 #include <QDir>
-#include "httpconnectionhandlerpool.h"
+#include "httpconnectionpool.h"
 
 using namespace stefanfrings;
 
-HttpConnectionHandlerPool::HttpConnectionHandlerPool(const QSettings *settings, HttpRequestHandler *requestHandler)
+HttpConnectionPool::HttpConnectionPool(const QSettings *settings, HttpRequestHandler *requestHandler)
     : QObject()
 {
     Q_ASSERT(settings!=0);
@@ -17,77 +17,88 @@ HttpConnectionHandlerPool::HttpConnectionHandlerPool(const QSettings *settings,
     this->requestHandler=requestHandler;
     this->sslConfiguration=NULL;
     loadSslConfig();
-    cleanupTimer.start(settings->value("cleanupInterval",1000).toInt());
-    connect(&cleanupTimer, SIGNAL(timeout()), SLOT(cleanup()));
+
+    int cores=QThread::idealThreadCount();
+    int ioThreadCount=settings->value("ioThreads",qBound(1,cores/4,4)).toInt();
+    for (int i=0; i<qMax(1,ioThreadCount); i++)
+    {
+        QThread* thread=new QThread();
+        thread->start();
+        ioThreads.append(thread);
+    }
+    nextIoThread=0;
+
+    // the workers are kept alive, the controllers keep per thread resources like database connections
+    workers.setMaxThreadCount(qMax(1,settings->value("workerThreads",qMax(4,cores*2)).toInt()));
+    workers.setExpiryTimeout(-1);
+
+    maxConnections=settings->value("maxConnections",1000).toInt();
+    qDebug("HttpConnectionPool: %i I/O threads, %i worker threads",ioThreads.size(),workers.maxThreadCount());
 }
 
 
-HttpConnectionHandlerPool::~HttpConnectionHandlerPool()
+HttpConnectionPool::~HttpConnectionPool()
 {
-    // delete all connection handlers and wait until their threads are closed
-    foreach(HttpConnectionHandler* handler, pool)
+    // wait until the running requests are finished, then stop the I/O threads and delete the connections
+    workers.waitForDone();
+    foreach(QThread* thread, ioThreads)
     {
-       delete handler;
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    foreach(HttpConnection* connection, connections)
+    {
+        delete connection;
     }
     delete sslConfiguration;
-    qDebug("HttpConnectionHandlerPool (%p): destroyed", this);
+    qDebug("HttpConnectionPool (%p): destroyed", this);
 }
 
 
-HttpConnectionHandler* HttpConnectionHandlerPool::getConnectionHandler()
+bool HttpConnectionPool::handleConnection(tSocketDescriptor socketDescriptor)
 {
-    HttpConnectionHandler* freeHandler=0;
+    HttpConnection* connection=nullptr;
     mutex.lock();
-    // find a free handler in pool
-    foreach(HttpConnectionHandler* handler, pool)
+    if (connections.size()<maxConnections)
     {
-        if (!handler->isBusy())
-        {
-            freeHandler=handler;
-            freeHandler->setBusy();
-            break;
-        }
+        connection=new HttpConnection(settings,requestHandler,sslConfiguration,this);
+        connection->moveToThread(ioThreads.at(nextIoThread));
+        nextIoThread=(nextIoThread+1)%ioThreads.size();
+        connections.insert(connection);
     }
-    // create a new handler, if necessary
-    if (!freeHandler)
+    mutex.unlock();
+
+    if (!connection)
     {
-        int maxConnectionHandlers=settings->value("maxThreads",100).toInt();
-        if (pool.count()<maxConnectionHandlers)
-        {
-            freeHandler=new HttpConnectionHandler(settings,requestHandler,sslConfiguration);
-            freeHandler->setBusy();
-            pool.append(freeHandler);
-        }
+        return false;
     }
-    mutex.unlock();
-    return freeHandler;
+
+    // The descriptor is passed via event queue because the connection lives in another thread
+    QMetaObject::invokeMethod(connection, "handleConnection", Qt::QueuedConnection, Q_ARG(tSocketDescriptor, socketDescriptor));
+    return true;
+}
+
+
+void HttpConnectionPool::run(std::function<void()> request)
+{
+    workers.start(request);
 }
 
 
-void HttpConnectionHandlerPool::cleanup()
+void HttpConnectionPool::release(HttpConnection* connection)
 {
-    int maxIdleHandlers=settings->value("minThreads",1).toInt();
-    int idleCounter=0;
     mutex.lock();
-    foreach(HttpConnectionHandler* handler, pool)
+    bool removed=connections.remove(connection);
+    mutex.unlock();
+    if (removed)
     {
-        if (!handler->isBusy())
-        {
-            if (++idleCounter > maxIdleHandlers)
-            {
-                delete handler;
-                pool.removeOne(handler);
-                long int poolSize=(long int)pool.size();
-                qDebug("HttpConnectionHandlerPool: Removed connection handler (%p), pool size is now %li",handler,poolSize);
-                break; // remove only one handler in each interval
-            }
-        }
+        connection->deleteLater();
     }
-    mutex.unlock();
 }
 
 
-void HttpConnectionHandlerPool::loadSslConfig()
+void HttpConnectionPool::loadSslConfig()
 {
     // If certificate and key files are configured, then load them
     QString sslKeyFileName=settings->value("sslKeyFile","").toString();
@@ -98,7 +109,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
     if (!sslKeyFileName.isEmpty() && !sslCertFileName.isEmpty())
     {
         #ifdef QT_NO_SSL
-            qWarning("HttpConnectionHandlerPool: SSL is not supported");
+            qWarning("HttpConnectionPool: SSL is not supported");
         #else
             // Convert relative fileNames to absolute, based on the directory of the config file.
             QFileInfo configFile(settings->fileName());
@@ -124,7 +135,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
             QFile certFile(sslCertFileName);
             if (!certFile.open(QIODevice::ReadOnly))
             {
-                qCritical("HttpConnectionHandlerPool: cannot open sslCertFile %s", qPrintable(sslCertFileName));
+                qCritical("HttpConnectionPool: cannot open sslCertFile %s", qPrintable(sslCertFileName));
                 return;
             }
             QSslCertificate certificate(&certFile, QSsl::Pem);
@@ -134,7 +145,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
             QFile keyFile(sslKeyFileName);
             if (!keyFile.open(QIODevice::ReadOnly))
             {
-                qCritical("HttpConnectionHandlerPool: cannot open sslKeyFile %s", qPrintable(sslKeyFileName));
+                qCritical("HttpConnectionPool: cannot open sslKeyFile %s", qPrintable(sslKeyFileName));
                 return;
             }
             QSslKey sslKey(&keyFile, QSsl::Rsa, QSsl::Pem);
@@ -150,7 +161,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
             if (!caCertFileName.isEmpty())
             {
                 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
-                    qCritical("HttpConnectionHandlerPool: Using a caCertFile requires Qt 5.15 or newer");
+                    qCritical("HttpConnectionPool: Using a caCertFile requires Qt 5.15 or newer");
                 #else
 
                     // Convert relative fileName to absolute, based on the directory of the config file.
@@ -167,7 +178,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
                     QFile caCertFile(caCertFileName);
                     if (!caCertFile.open(QIODevice::ReadOnly))
                     {
-                        qCritical("HttpConnectionHandlerPool: cannot open caCertFile %s", qPrintable(caCertFileName));
+                        qCritical("HttpConnectionPool: cannot open caCertFile %s", qPrintable(caCertFileName));
                         return;
                     }
                     QSslCertificate caCertificate(&caCertFile, QSsl::Pem);
@@ -188,7 +199,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
                 sslConfiguration->setPeerVerifyMode(QSslSocket::VerifyNone);
             }
 
-            qDebug("HttpConnectionHandlerPool: SSL settings loaded");
+            qDebug("HttpConnectionPool: SSL settings loaded");
          #endif
     }
 }
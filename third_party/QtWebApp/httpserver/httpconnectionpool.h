@@ -1,18 +1,22 @@
-#ifndef HTTPCONNECTIONHANDLERPOOL_H
-#define HTTPCONNECTIONHANDLERPOOL_H
+#ifndef HTTPCONNECTIONPOOL_H
+#define HTTPCONNECTIONPOOL_H
 
 #include <QList>
-#include <QTimer>
+#include <QSet>
 #include <QObject>
 #include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <functional>
 #include "httpglobal.h"
-#include "httpconnectionhandler.h"
+#include "httpconnection.h"
 
 namespace stefanfrings {
 
 /**
-  Pool of http connection handlers. The size of the pool grows and
-  shrinks on demand.
+  Runs the HTTP connections. A few I/O threads handle the sockets of all the connections
+  with their event loops and a bounded pool of worker threads processes the requests, so
+  the number of threads doesn't grow with the number of clients.
   <p>
   Example for the required configuration settings:
   <code><pre>
@@ -20,9 +24,9 @@ namespace stefanfrings {
   maxRequestSize=16000
   maxMultiPartSize=1000000
 
-  minThreads=4
-  maxThreads=100
-  cleanupInterval=60000  
+  ioThreads=2
+  workerThreads=16
+  maxConnections=1000
   </pre></code>
   <p>
   The readTimeout value defines the maximum time to wait for a complete HTTP request.
@@ -31,10 +35,8 @@ namespace stefanfrings {
   multipart/form-data requests (also known as file-upload), the maximum
   size of the body must not exceed maxMultiPartSize.
   <p>
-  After server start, the size of the thread pool is always 0. Threads
-  are started on demand when requests come in. The cleanup timer reduces
-  the number of idle threads slowly by closing one thread in each interval.
-  But the configured minimum number of threads are kept running.
+  ioThreads and workerThreads default to values based on the number of cores. New
+  connections are rejected once maxConnections clients are connected.
   <p>
   Additional settings for SSL (HTTPS):
   <code><pre>
@@ -81,9 +83,9 @@ namespace stefanfrings {
   one with SLL and one without SSL (usually on public ports 80 and 443, or locally on 8080 and 8443).
 */
 
-class DECLSPEC HttpConnectionHandlerPool : public QObject {
+class DECLSPEC HttpConnectionPool : public QObject {
     Q_OBJECT
-    Q_DISABLE_COPY(HttpConnectionHandlerPool)
+    Q_DISABLE_COPY(HttpConnectionPool)
 public:
 
     /**
@@ -91,27 +93,45 @@ public:
       @param settings Configuration settings for the HTTP server. Must not be 0.
       @param requestHandler The handler that will process each received HTTP request.
     */
-    HttpConnectionHandlerPool(const QSettings* settings, HttpRequestHandler *requestHandler);
+    HttpConnectionPool(const QSettings* settings, HttpRequestHandler *requestHandler);
 
-    /** Destructor */
-    virtual ~HttpConnectionHandlerPool();
+    /** Destructor, waits until the running requests are finished */
+    virtual ~HttpConnectionPool();
 
-    /** Get a free connection handler, or 0 if not available. */
-    HttpConnectionHandler* getConnectionHandler();
+    /**
+      Hands a new connection to one of the I/O threads.
+      @return false if the maximum number of connections has been reached
+    */
+    bool handleConnection(tSocketDescriptor socketDescriptor);
+
+    /** Runs a request in a worker thread, used by the connections */
+    void run(std::function<void()> request);
+
+    /** Deletes a closed connection, used by the connections from their I/O thread */
+    void release(HttpConnection* connection);
 
 private:
 
     /** Settings for this pool */
     const QSettings* settings;
 
-    /** Will be assigned to each Connectionhandler during their creation */
+    /** Will be assigned to each connection during their creation */
     HttpRequestHandler* requestHandler;
 
-    /** Pool of connection handlers */
-    QList<HttpConnectionHandler*> pool;
+    /** Threads that handle the events of the sockets */
+    QList<QThread*> ioThreads;
+
+    /** I/O thread used by the next connection */
+    int nextIoThread;
 
-    /** Timer to clean-up unused connection handler */
-    QTimer cleanupTimer;
+    /** Threads that process the requests */
+    QThreadPool workers;
+
+    /** Open connections */
+    QSet<HttpConnection*> connections;
+
+    /** Maximum number of open connections */
+    int maxConnections;
 
     /** Used to synchronize threads */
     QMutex mutex;
@@ -122,13 +142,8 @@ private:
     /** Load SSL configuration */
     void loadSslConfig();
 
-private slots:
-
-    /** Received from the clean-up timer.  */
-    void cleanup();
-
 };
 
 } // end of namespace
 
-#endif // HTTPCONNECTIONHANDLERPOOL_H
+#endif // HTTPCONNECTIONPOOL_H
@@ -4,8 +4,8 @@
 */
 
 #include "httplistener.h"
-#include "httpconnectionhandler.h"
-#include "httpconnectionhandlerpool.h"
+#include "httpconnection.h"
+#include "httpconnectionpool.h"
 #include <QCoreApplication>
 
 using namespace stefanfrings;
@@ -36,7 +36,7 @@ void HttpListener::listen()
 {
     if (!pool)
     {
-        pool=new HttpConnectionHandlerPool(settings,requestHandler);
+        pool=new HttpConnectionPool(settings,requestHandler);
     }
     QString host = settings->value("host").toString();
     quint16 port=settings->value("port").toUInt() & 0xFFFF;
@@ -65,19 +65,14 @@ void HttpListener::incomingConnection(tSocketDescriptor socketDescriptor) {
     qDebug("HttpListener: New connection");
 #endif
 
-    HttpConnectionHandler* freeHandler=nullptr;
+    // Let the pool process the new connection.
+    bool accepted=false;
     if (pool)
     {
-        freeHandler=pool->getConnectionHandler();
+        accepted=pool->handleConnection(socketDescriptor);
     }
 
-    // Let the handler process the new connection.
-    if (freeHandler)
-    {
-        // The descriptor is passed via event queue because the handler lives in another thread
-        QMetaObject::invokeMethod(freeHandler, "handleConnection", Qt::QueuedConnection, Q_ARG(tSocketDescriptor, socketDescriptor));
-    }
-    else
+    if (!accepted)
     {
         // Reject the connection
         qDebug("HttpListener: Too many incoming connections");
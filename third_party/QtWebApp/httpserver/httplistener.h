@@ -10,8 +10,8 @@
 #include <QSettings>
 #include <QBasicTimer>
 #include "httpglobal.h"
-#include "httpconnectionhandler.h"
-#include "httpconnectionhandlerpool.h"
+#include "httpconnection.h"
+#include "httpconnectionpool.h"
 #include "httprequesthandler.h"
 
 namespace stefanfrings {
@@ -29,9 +29,9 @@ namespace stefanfrings {
   maxRequestSize=16000
   maxMultiPartSize=1000000
 
-  minThreads=1
-  maxThreads=10
-  cleanupInterval=1000
+  ioThreads=2
+  workerThreads=16
+  maxConnections=1000
 
   ;sslKeyFile=ssl/server.key
   ;sslCertFile=ssl/server.crt
@@ -47,11 +47,9 @@ namespace stefanfrings {
   multipart/form-data requests (also known as file-upload), the maximum
   size of the body must not exceed maxMultiPartSize.
   <p>
-  After server start, the size of the thread pool is always 0. Threads
-  are started on demand when requests come in. The cleanup timer reduces
-  the number of idle threads slowly by closing one thread in each interval.
-  But the configured minimum number of threads are kept running.
-  @see HttpConnectionHandlerPool for description of the optional ssl settings
+  The connections are handled by a few I/O threads and the requests are processed by a
+  bounded pool of worker threads, see HttpConnectionPool.
+  @see HttpConnectionPool for description of the optional ssl settings
 */
 
 class DECLSPEC HttpListener : public QTcpServer {
@@ -101,13 +99,13 @@ private:
     /** Point to the reuqest handler which processes all HTTP requests */
     HttpRequestHandler* requestHandler;
 
-    /** Pool of connection handlers */
-    HttpConnectionHandlerPool* pool;
+    /** Pool of connections */
+    HttpConnectionPool* pool;
 
 signals:
 
     /**
-      Sent to the connection handler to process a new incoming connection.
+      Sent to the connection to process a new incoming connection.
       @param socketDescriptor references the accepted connection.
     */
 
@@ -4,12 +4,13 @@
 */
 
 #include "httpresponse.h"
+#include "httpconnection.h"
 
 using namespace stefanfrings;
 
-HttpResponse::HttpResponse(QTcpSocket *socket)
+HttpResponse::HttpResponse(HttpConnection *connection)
 {
-    this->socket=socket;
+    this->connection=connection;
     statusCode=200;
     statusText="OK";
     sentHeaders=false;
@@ -69,31 +70,12 @@ void HttpResponse::writeHeaders()
     }
     buffer.append("\r\n");
     writeToSocket(buffer);
-    socket->flush();
     sentHeaders=true;
 }
 
 bool HttpResponse::writeToSocket(QByteArray data)
 {
-    int remaining=data.size();
-    char* ptr=data.data();
-    while (socket->isOpen() && remaining>0)
-    {
-        // If the output buffer has become large, then wait until it has been sent.
-        if (socket->bytesToWrite()>16384)
-        {
-            socket->waitForBytesWritten(-1);
-        }
-
-        qint64 written=socket->write(ptr,remaining);
-        if (written==-1)
-        {
-          return false;
-        }
-        ptr+=written;
-        remaining-=written;
-    }
-    return true;
+    return connection->write(data);
 }
 
 void HttpResponse::write(QByteArray data, bool lastPart)
@@ -111,8 +93,8 @@ void HttpResponse::write(QByteArray data, bool lastPart)
            headers.insert("Content-Length",QByteArray::number(data.size()));
         }
 
-        // else if we will not close the connection at the end, them we must use the chunked mode.
-        else
+        // else if we will not close the connection at the end and the size is not known, them we must use the chunked mode.
+        else if (!headers.contains("Content-Length"))
         {
             QByteArray connectionValue=headers.value("Connection",headers.value("connection"));
             bool connectionClose=QString::compare(connectionValue,"close",Qt::CaseInsensitive)==0;
@@ -133,11 +115,12 @@ void HttpResponse::write(QByteArray data, bool lastPart)
         {
             if (data.size()>0)
             {
-                QByteArray size=QByteArray::number(data.size(),16);
-                writeToSocket(size);
-                writeToSocket("\r\n");
-                writeToSocket(data);
-                writeToSocket("\r\n");
+                QByteArray chunk=QByteArray::number(data.size(),16);
+                chunk.reserve(chunk.size()+data.size()+4);
+                chunk.append("\r\n");
+                chunk.append(data);
+                chunk.append("\r\n");
+                writeToSocket(chunk);
             }
         }
         else
@@ -153,12 +136,25 @@ void HttpResponse::write(QByteArray data, bool lastPart)
         {
             writeToSocket("0\r\n\r\n");
         }
-        socket->flush();
         sentLastPart=true;
     }
 }
 
 
+void HttpResponse::writeFile(QFile* file, qint64 length)
+{
+    Q_ASSERT(sentLastPart==false);
+    Q_ASSERT(headers.contains("Content-Length"));
+
+    if (sentHeaders==false)
+    {
+        writeHeaders();
+    }
+    connection->writeFile(file, length);
+    sentLastPart=true;
+}
+
+
 bool HttpResponse::hasSentLastPart() const
 {
     return sentLastPart;
@@ -191,11 +187,11 @@ void HttpResponse::redirect(const QByteArray& url)
 
 void HttpResponse::flush()
 {
-    socket->flush();
+    // the connection sends the queued data as soon as its I/O thread is free
 }
 
 
 bool HttpResponse::isConnected() const
 {
-    return socket->isOpen();
+    return connection->isOpen();
 }
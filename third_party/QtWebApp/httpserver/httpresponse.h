@@ -8,12 +8,14 @@
 
 #include <QMap>
 #include <QString>
-#include <QTcpSocket>
+#include <QFile>
 #include "httpglobal.h"
 #include "httpcookie.h"
 
 namespace stefanfrings {
 
+class HttpConnection;
+
 /**
   This object represents a HTTP response, used to return something to the web client.
   <p>
@@ -39,9 +41,9 @@ public:
 
     /**
       Constructor.
-      @param socket used to write the response
+      @param connection used to write the response
     */
-    HttpResponse(QTcpSocket *socket);
+    HttpResponse(HttpConnection *connection);
 
     /**
       Set a HTTP response header.
@@ -89,6 +91,17 @@ public:
     */
     void write(const QByteArray data, const bool lastPart=false);
 
+    /**
+      Write the rest of the body from a file and finish the response.
+      <p>
+      A Content-Length header must have been set. The file is read by the I/O thread of the
+      connection while the client receives it, so this method returns immediately no matter
+      how big the file or how slow the client is.
+      @param file Open file, positioned at the first byte to send. The response takes the ownership.
+      @param length Number of bytes to send
+    */
+    void writeFile(QFile* file, const qint64 length);
+
     /**
       Indicates whether the body has been sent completely (write() has been called with lastPart=true).
     */
@@ -125,8 +138,8 @@ private:
     /** Request headers */
     QMap<QByteArray,QByteArray> headers;
 
-    /** Socket for writing output */
-    QTcpSocket* socket;
+    /** Connection for writing output */
+    HttpConnection* connection;
 
     /** HTTP status code*/
     int statusCode;
@@ -146,7 +159,10 @@ private:
     /** Cookies */
     QMap<QByteArray,HttpCookie> cookies;
 
-    /** Write raw data to the socket. This method blocks until all bytes have been passed to the TCP buffer */
+    /**
+      Queue raw data in the connection, it is sent by its I/O thread.
+      This method blocks only if the client is not reading the data already queued.
+    */
     bool writeToSocket(QByteArray data);
 
     /**
@@ -10,8 +10,8 @@ CONFIG(debug, debug|release) {
 
 HEADERS += $$PWD/httpglobal.h \
            $$PWD/httplistener.h \
-           $$PWD/httpconnectionhandler.h \
-           $$PWD/httpconnectionhandlerpool.h \
+           $$PWD/httpconnection.h \
+           $$PWD/httpconnectionpool.h \
            $$PWD/httprequest.h \
            $$PWD/httpresponse.h \
            $$PWD/httpcookie.h \
@@ -22,8 +22,8 @@ HEADERS += $$PWD/httpglobal.h \
 
 SOURCES += $$PWD/httpglobal.cpp \
            $$PWD/httplistener.cpp \
-           $$PWD/httpconnectionhandler.cpp \
-           $$PWD/httpconnectionhandlerpool.cpp \
+           $$PWD/httpconnection.cpp \
+           $$PWD/httpconnectionpool.cpp \
            $$PWD/httprequest.cpp \
            $$PWD/httpresponse.cpp \
            $$PWD/httpcookie.cpp \